@@ -0,0 +1,52 @@
+/*******************************************************************************************
+ * Archivo: include/AdcSampler.h
+ * Descripción: Adquisición ADC sobremuestreada para todos los sensores analógicos.
+ * Cada sensor registra su canal en begin(); la primera lectura del ciclo adquiere todos
+ * los canales registrados en una sola ráfaga (HalAdc::readBurst, por DMA en el ESP32),
+ * calcula la media recortada de cada uno y la convierte a milivoltios calibrados. El resto
+ * de los sensores del ciclo consume ese mismo lote sin volver a muestrear. Si la ráfaga
+ * falla, los canales del lote devuelven NAN.
+ *******************************************************************************************/
+
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include <stdint.h>
+#include "config.h"
+
+class AdcSampler {
+public:
+    /**
+     * @brief Olvida los canales registrados (antes de volver a registrar sensores)
+     */
+    static void clearChannels();
+
+    /**
+     * @brief Agrega un canal a la ráfaga del ciclo (ignora duplicados)
+     * @return false si se superó Sensors::ADC_MAX_CHANNELS
+     */
+    static bool addChannel(uint8_t pin);
+
+    /**
+     * @brief Marca el lote como obsoleto: la próxima lectura adquiere uno nuevo
+     */
+    static void invalidate();
+
+    /**
+     * @brief Milivoltios del canal en el lote del ciclo. La primera llamada dispara la
+     *        ráfaga de todos los canales; un canal no registrado se muestrea aparte.
+     */
+    static float milliVolts(uint8_t pin);
+
+    /**
+     * @brief Muestreo sobremuestreado inmediato de un canal, fuera del lote (para
+     *        canales que necesitan preparar el circuito justo antes, como la batería)
+     */
+    static float sampleNow(uint8_t pin);
+
+private:
+    static void acquire();
+    static float trimmedMilliVolts(uint8_t pin, uint16_t* samples);
+};
+
+#endif
@@ -90,6 +90,12 @@ private:
         void onRead(BLECharacteristic *pCharacteristic) override;
     };
 
+    // Callback para sensores Modbus (dirección y descriptor de registros)
+    class ModbusConfigCallback: public BLECharacteristicCallbacks {
+        void onWrite(BLECharacteristic *pCharacteristic) override;
+        void onRead(BLECharacteristic *pCharacteristic) override;
+    };
+
     // Callback para configuración de LoRa
     class LoRaConfigCallback: public BLECharacteristicCallbacks {
         void onWrite(BLECharacteristic *pCharacteristic) override;
@@ -0,0 +1,103 @@
+/*******************************************************************************************
+ * Archivo: include/CalibrationFixed.h
+ * Descripción: Versiones en punto fijo de los kernels de calibración (Steinhart-Hart,
+ * pH y conductividad). Trabajan con enteros de 32/64 bits: sin logf ni divisiones en
+ * coma flotante por lectura. Los coeficientes escalados se derivan de los float una
+ * sola vez, al resolver la calibración (CalibrationStore), y se eligen frente a los
+ * evaluate*() de CalibrationMath con Calibration::FIXED_POINT_KERNELS.
+ *
+ * Entradas en microvoltios y temperaturas en centésimas de °C; salidas en °C x100,
+ * pH x1000 y ppm x100. No depende de Arduino (se prueba en el entorno native).
+ *******************************************************************************************/
+
+#ifndef CALIBRATION_FIXED_H
+#define CALIBRATION_FIXED_H
+
+#include <stdint.h>
+#include "CalibrationMath.h"
+
+/**
+ * @brief Steinhart-Hart con A, B y C en Q48 (1/K)
+ */
+struct SteinhartHartFixed {
+    int64_t a;
+    int64_t b;
+    int64_t c;
+    uint8_t valid;
+};
+
+/**
+ * @brief Recta de pH: E0 en µV, pendiente en nV/pH y temperatura de calibración en K x100
+ */
+struct PhFixed {
+    int32_t e0Uv;
+    int32_t slopeNv;
+    int32_t calTempK100;
+    int32_t calTempC100;
+    uint8_t valid;
+};
+
+/**
+ * @brief Cuadrática de conductividad en ppm x100 con Vc en µV. a y b van escalados por
+ *        2^aShift y 2^bShift (elegidos al derivarlos para aprovechar los 64 bits);
+ *        el término cuadrático usa Vc^2 / 2^16.
+ */
+struct ConductivityFixed {
+    int64_t a;
+    int64_t b;
+    int32_t c;
+    int32_t calTempC100;
+    int32_t coefCompPpm;    // Coeficiente de compensación en 1e-6/°C
+    uint8_t aShift;
+    uint8_t bShift;
+    uint8_t valid;
+};
+
+class CalibrationFixed {
+public:
+    // Resultado no válido (voltaje fuera de rango o coeficientes degenerados)
+    static constexpr int32_t INVALID = INT32_MIN;
+    // Temperatura desconocida: se usa la de calibración (equivale a NAN en float)
+    static constexpr int32_t NO_TEMPERATURE = INT32_MIN;
+
+    /**
+     * @brief Derivan los coeficientes escalados de los float resueltos
+     */
+    static SteinhartHartFixed fromFloat(const SteinhartHartCoeffs& coeffs);
+    static PhFixed fromFloat(const PhCoeffs& coeffs);
+    static ConductivityFixed fromFloat(const ConductivityCoeffs& coeffs);
+
+    /**
+     * @brief ln(x) en Q20 por CLZ + tabla de log2 de 33 puntos con interpolación lineal
+     *        (error < 2e-4). x debe ser > 0.
+     */
+    static int32_t lnQ20(uint64_t x);
+
+    /**
+     * @brief Temperatura del NTC en °C x100 a partir del punto medio del divisor.
+     *        ln(R) = ln(rFixed * (vRef - v)) - ln(v): sin dividir para obtener R.
+     * @param microVolts Voltaje medido
+     * @param vRefMicroVolts Voltaje de referencia del divisor
+     * @param rFixed Resistencia fija del divisor en ohms
+     * @param ntcTop true si el NTC está conectado a Vref
+     * @return °C x100, o INVALID si el voltaje está fuera de (0, vRef)
+     */
+    static int32_t ntcTemperatureC100(int32_t microVolts, int32_t vRefMicroVolts, uint32_t rFixed,
+                                      bool ntcTop, const SteinhartHartFixed& coeffs);
+
+    /**
+     * @brief pH x1000 con compensación de temperatura, limitado a 0-14000
+     * @param electrodeMicroVolts Voltaje del electrodo (ya sin el offset de 1.65 V)
+     * @param tempC100 Temperatura de la solución, o NO_TEMPERATURE
+     */
+    static int32_t phMilli(int32_t electrodeMicroVolts, int32_t tempC100, const PhFixed& coeffs);
+
+    /**
+     * @brief Conductividad/TDS en ppm x100 (>= 0) con compensación de temperatura
+     * @param tempC100 Temperatura de la solución, o NO_TEMPERATURE
+     */
+    static int32_t conductivityPpm100(int32_t microVolts, int32_t tempC100,
+                                      const ConductivityFixed& coeffs);
+};
+
+#endif
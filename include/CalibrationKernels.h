@@ -0,0 +1,74 @@
+/*******************************************************************************************
+ * Archivo: include/CalibrationKernels.h
+ * Descripción: Punto único por el que los drivers evalúan la calibración. Elige en
+ * compilación (Calibration::FIXED_POINT_KERNELS) entre los evaluate*() en float de
+ * CalibrationMath y los kernels enteros de CalibrationFixed, con los coeficientes ya
+ * resueltos de CalibrationStore. Misma firma que los evaluate*() (voltios y °C).
+ * Los NTC se leen por la tabla generada al calibrar (NtcTable), con la topología de
+ * divisor de cada canal.
+ *******************************************************************************************/
+
+#ifndef CALIBRATION_KERNELS_H
+#define CALIBRATION_KERNELS_H
+
+#include <math.h>
+#include <stdint.h>
+#include "config.h"
+#include "CalibrationMath.h"
+#include "CalibrationFixed.h"
+#include "CalibrationStore.h"
+#include "NtcTable.h"
+
+namespace CalibrationKernels {
+
+    inline int32_t toMicroVolts(float voltage) {
+        return (int32_t)lroundf(voltage * 1000000.0f);
+    }
+
+    inline int32_t toC100(float tempC) {
+        return isnan(tempC) ? CalibrationFixed::NO_TEMPERATURE : (int32_t)lroundf(tempC * 100.0f);
+    }
+
+    /**
+     * @brief Temperatura de un canal NTC interpolando su tabla
+     * @return NAN si el voltaje está fuera del rango del divisor
+     */
+    inline float ntcTableTemperature(float voltage, const NtcLut& lut) {
+        int32_t c100 = NtcTable::temperatureC100(lut, toMicroVolts(voltage));
+        return c100 == NtcTable::INVALID ? NAN : c100 / 100.0f;
+    }
+
+    inline float ntc100kTemperature(float voltage) {
+        return ntcTableTemperature(voltage, CalibrationStore::ntc100kLut());
+    }
+
+    inline float ntc10kTemperature(float voltage) {
+        return ntcTableTemperature(voltage, CalibrationStore::ntc10kLut());
+    }
+
+    /**
+     * @brief pH (0-14) del electrodo ya sin offset; tempC NAN usa la de calibración
+     */
+    inline float ph(float voltage, float tempC) {
+        if (Calibration::FIXED_POINT_KERNELS) {
+            int32_t milli = CalibrationFixed::phMilli(toMicroVolts(voltage), toC100(tempC),
+                                                      CalibrationStore::phFixed());
+            return milli == CalibrationFixed::INVALID ? NAN : milli / 1000.0f;
+        }
+        return CalibrationMath::evaluatePh(voltage, tempC, CalibrationStore::ph());
+    }
+
+    /**
+     * @brief Conductividad/TDS en ppm; tempC NAN usa la de calibración
+     */
+    inline float conductivity(float voltage, float tempC) {
+        if (Calibration::FIXED_POINT_KERNELS) {
+            int32_t ppm100 = CalibrationFixed::conductivityPpm100(toMicroVolts(voltage), toC100(tempC),
+                                                                  CalibrationStore::conductivityFixed());
+            return ppm100 == CalibrationFixed::INVALID ? NAN : ppm100 / 100.0f;
+        }
+        return CalibrationMath::evaluateConductivity(voltage, tempC, CalibrationStore::conductivity());
+    }
+}
+
+#endif
@@ -0,0 +1,152 @@
+/*******************************************************************************************
+ * Archivo: include/CalibrationMath.h
+ * Descripción: Matemática de calibración de los sensores analógicos (NTC, pH,
+ * conductividad, batería). No depende de Arduino para poder compilarse en el entorno
+ * native y medirse en un PC.
+ *
+ * Los solve*() resuelven los coeficientes una sola vez (en double, al escribir la
+ * calibración) y los evaluate*() son la ruta por lectura: un polinomio en float, que
+ * el FPU del S3 ejecuta por hardware (double se emula por software).
+ *******************************************************************************************/
+
+#ifndef CALIBRATION_MATH_H
+#define CALIBRATION_MATH_H
+
+/**
+ * @brief Coeficientes de Steinhart-Hart: 1/T = A + B*ln(R) + C*ln(R)^3 (T en Kelvin)
+ */
+struct SteinhartHartCoeffs {
+    float A;
+    float B;
+    float C;
+};
+
+/**
+ * @brief Recta del electrodo de pH ajustada a los buffers: pH = (E0 + V) / (S * T/Tcal)
+ */
+struct PhCoeffs {
+    float e0;         // Término independiente (V)
+    float slope;      // Pendiente a la temperatura de calibración (V/pH)
+    float calTempK;   // Temperatura de calibración en Kelvin
+    float calTempC;   // Temperatura de calibración en °C (sustituye a una lectura NAN)
+};
+
+/**
+ * @brief Cuadrática de conductividad: ppm = a*Vc^2 + b*Vc + c, Vc = V / (1 + k*(T - Tcal))
+ */
+struct ConductivityCoeffs {
+    float a;
+    float b;
+    float c;
+    float calTempC;
+    float coefComp;
+};
+
+class CalibrationMath {
+public:
+    /**
+     * Calcula los coeficientes A, B, C para la ecuación de Steinhart-Hart
+     * basado en tres pares de puntos temperatura-resistencia
+     * @param T1,T2,T3 Temperaturas en Kelvin
+     * @param R1,R2,R3 Resistencias en ohms
+     */
+    static void steinhartHartCoeffs(double T1, double R1,
+                                    double T2, double R2,
+                                    double T3, double R3,
+                                    double &A, double &B, double &C);
+
+    /**
+     * Calcula la temperatura usando la ecuación de Steinhart-Hart
+     * @param resistance La resistencia del termistor en ohms
+     * @param A,B,C Los coeficientes de Steinhart-Hart
+     * @return Temperatura en grados Celsius
+     */
+    static double steinhartHartTemperature(double resistance, double A, double B, double C);
+
+    /**
+     * Calcula la resistencia del NTC basado en un divisor de voltaje
+     * @param voltage Voltaje medido en el punto medio del divisor
+     * @param vRef Voltaje de referencia
+     * @param rFixed Resistencia fija del divisor
+     * @param ntcTop true si el NTC está conectado a Vref, false si está conectado a GND
+     * @return Resistencia del NTC en ohms, o -1 si hay error
+     */
+    static double ntcResistanceFromDivider(double voltage, double vRef, double rFixed, bool ntcTop);
+
+    /**
+     * @brief Convierte el voltaje del electrodo a pH con compensación de temperatura.
+     *        Ajusta por mínimos cuadrados la recta V/pH de los tres buffers.
+     * @param voltage Voltaje del electrodo (ya sin offset de 1.65V)
+     * @param tempC Temperatura de la solución; NAN usa tempCal
+     * @param V1,T1,V2,T2,V3,T3 Pares voltaje/pH de calibración
+     * @param tempCal Temperatura de calibración en °C
+     * @return pH limitado a 0-14
+     */
+    static float phFromVoltage(float voltage, float tempC,
+                               float V1, float T1, float V2, float T2, float V3, float T3,
+                               float tempCal);
+
+    /**
+     * @brief Convierte el voltaje del sensor a conductividad/TDS con compensación de temperatura.
+     *        Resuelve la cuadrática que pasa por los tres puntos de calibración.
+     * @param voltage Voltaje medido
+     * @param tempC Temperatura de la solución; NAN usa calTemp
+     * @param calTemp Temperatura de calibración en °C
+     * @param coefComp Coeficiente de compensación por °C
+     * @param V1,T1,V2,T2,V3,T3 Pares voltaje/valor de calibración
+     * @return Valor en ppm (>= 0), o NAN si los puntos son degenerados
+     */
+    static float conductivityFromVoltage(float voltage, float tempC, float calTemp, float coefComp,
+                                         float V1, float T1, float V2, float T2, float V3, float T3);
+
+    /**
+     * @brief Voltaje de batería a partir del voltaje en el divisor R1 (a GND) / R2 (a batería)
+     */
+    static float batteryVoltage(float adcVoltage, float r1, float r2);
+
+    /**
+     * @brief Resuelve Steinhart-Hart a partir de tres puntos (temperaturas en °C).
+     *        Puntos degenerados dejan los coeficientes en NAN.
+     */
+    static SteinhartHartCoeffs solveSteinhartHart(double t1C, double r1,
+                                                  double t2C, double r2,
+                                                  double t3C, double r3);
+
+    /**
+     * @brief Ajuste por mínimos cuadrados de la recta V/pH (mismo cálculo que phFromVoltage)
+     */
+    static PhCoeffs solvePh(float V1, float T1, float V2, float T2, float V3, float T3, float tempCal);
+
+    /**
+     * @brief Cuadrática por los tres puntos de calibración (mismo cálculo que
+     *        conductivityFromVoltage). Puntos degenerados dejan a, b, c en NAN.
+     */
+    static ConductivityCoeffs solveConductivity(float calTemp, float coefComp,
+                                                float V1, float T1, float V2, float T2,
+                                                float V3, float T3);
+
+    /**
+     * @brief Temperatura en °C a partir de la resistencia del NTC, en float
+     * @return NAN si la resistencia no es válida
+     */
+    static float evaluateSteinhartHart(float resistance, const SteinhartHartCoeffs& coeffs);
+
+    /**
+     * @brief Resistencia del NTC en el divisor, en float (ver ntcResistanceFromDivider)
+     * @return Resistencia en ohms, o -1 si el voltaje está fuera de rango
+     */
+    static float ntcResistanceFromDividerF(float voltage, float vRef, float rFixed, bool ntcTop);
+
+    /**
+     * @brief pH con compensación de temperatura; tempC NAN usa la de calibración
+     * @return pH limitado a 0-14
+     */
+    static float evaluatePh(float voltage, float tempC, const PhCoeffs& coeffs);
+
+    /**
+     * @brief Conductividad/TDS en ppm (>= 0); tempC NAN usa la de calibración
+     */
+    static float evaluateConductivity(float voltage, float tempC, const ConductivityCoeffs& coeffs);
+};
+
+#endif
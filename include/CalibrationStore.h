@@ -0,0 +1,95 @@
+/*******************************************************************************************
+ * Archivo: include/CalibrationStore.h
+ * Descripción: Coeficientes de calibración ya resueltos (Steinhart-Hart de los NTC, recta
+ * de pH y cuadrática de conductividad). Se resuelven una sola vez cuando BLE escribe los
+ * puntos de calibración, se guardan como blob binario con CRC en NVS y se reflejan en
+ * RTC RAM, de modo que una lectura solo evalúa el polinomio: sin abrir NVS, sin
+ * deserializar JSON y sin resolver sistemas en double. Junto a los float se guardan sus
+ * versiones escaladas para los kernels en punto fijo (CalibrationFixed) y la tabla
+ * voltaje -> temperatura de cada NTC (NtcTable), generada con la topología de su divisor.
+ *******************************************************************************************/
+
+#ifndef CALIBRATION_STORE_H
+#define CALIBRATION_STORE_H
+
+#include <stdint.h>
+#include "CalibrationMath.h"
+#include "CalibrationFixed.h"
+#include "NtcTable.h"
+
+/**
+ * @brief Blob persistido en NVS (JsonKeys::NS_CALIBRATION) y reflejado en RTC RAM
+ */
+struct CalibrationCoeffs {
+    uint8_t version;        // Calibration::COEFFS_VERSION
+    uint8_t reserved;
+    uint16_t crc;           // CRC16 de los campos siguientes
+    SteinhartHartCoeffs ntc100k;
+    SteinhartHartCoeffs ntc10k;
+    PhCoeffs ph;
+    ConductivityCoeffs conductivity;
+    // Derivados de los anteriores en commit(), para Calibration::FIXED_POINT_KERNELS
+    SteinhartHartFixed ntc100kFixed;
+    SteinhartHartFixed ntc10kFixed;
+    PhFixed phFixed;
+    ConductivityFixed conductivityFixed;
+    // Generadas en setNtc100k()/setNtc10k() con el divisor de cada canal
+    NtcLut ntc100kLut;
+    NtcLut ntc10kLut;
+};
+
+class CalibrationStore {
+public:
+    /**
+     * @brief Carga los coeficientes: primero la copia en RTC RAM y, si no es válida
+     *        (arranque en frío), el blob de NVS.
+     * @return false si no hay blob válido; hay que resolverlos con los set*()
+     */
+    static bool load();
+
+    /**
+     * @brief Resuelven los coeficientes de cada sensor y los guardan en NVS y RTC.
+     *        Se llaman al escribir la calibración, nunca en la ruta de lectura.
+     */
+    static void setNtc100k(double t1, double r1, double t2, double r2, double t3, double r3,
+                           const NtcDivider& divider);
+    static void setNtc10k(double t1, double r1, double t2, double r2, double t3, double r3,
+                          const NtcDivider& divider);
+    static void setPh(float v1, float t1, float v2, float t2, float v3, float t3, float tempCal);
+    static void setConductivity(float calTemp, float coefComp,
+                                float v1, float t1, float v2, float t2, float v3, float t3);
+
+    /**
+     * @brief Borra el blob de NVS y la copia en RTC
+     */
+    static void clear();
+
+    /**
+     * @brief Coeficientes para la ruta de lectura. Si no se cargaron, usan los
+     *        valores por defecto de Calibration:: (sin escribir NVS).
+     */
+    static const SteinhartHartCoeffs& ntc100k();
+    static const SteinhartHartCoeffs& ntc10k();
+    static const PhCoeffs& ph();
+    static const ConductivityCoeffs& conductivity();
+
+    /**
+     * @brief Los mismos coeficientes escalados para los kernels en punto fijo
+     */
+    static const SteinhartHartFixed& ntc100kFixed();
+    static const SteinhartHartFixed& ntc10kFixed();
+    static const PhFixed& phFixed();
+    static const ConductivityFixed& conductivityFixed();
+
+    /**
+     * @brief Tablas voltaje -> temperatura de los NTC (ver NtcTable::temperatureC100)
+     */
+    static const NtcLut& ntc100kLut();
+    static const NtcLut& ntc10kLut();
+
+private:
+    static const CalibrationCoeffs& current();
+    static void commit();
+};
+
+#endif
@@ -0,0 +1,86 @@
+/*******************************************************************************************
+ * Archivo: include/ConfigStore.h
+ * Descripción: Imagen binaria de la configuración (sistema, LoRaWAN y listas de sensores)
+ * con versión y CRC. Se lee de NVS con una sola apertura por arranque y queda en una
+ * estructura estática; los getters de ConfigManager la consultan sin volver a NVS ni
+ * deserializar JSON. El JSON queda solo para la interfaz BLE y para migrar los
+ * namespaces de firmwares anteriores.
+ * Cada save() incrementa un contador de generación en RTC RAM; los cachés derivados de
+ * la configuración (SensorPlan) lo comparan para saber si quedaron obsoletos.
+ *******************************************************************************************/
+
+#ifndef CONFIG_STORE_H
+#define CONFIG_STORE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sensor_types.h"
+
+/**
+ * @brief Imagen persistida en NVS (JsonKeys::NS_CONFIG). Estructura de tamaño fijo:
+ *        cualquier cambio de campos requiere subir System::CONFIG_IMAGE_VERSION.
+ */
+struct ConfigImage {
+    uint8_t version;        // System::CONFIG_IMAGE_VERSION
+    uint8_t reserved;
+    uint16_t crc;           // CRC16 desde 'size' hasta el final
+    uint16_t size;          // sizeof(ConfigImage) al guardarla
+
+    // Sistema
+    bool initialized;
+    uint32_t sleepTime;
+    char deviceId[32];
+    char stationId[32];
+    char waterTempSourceId[20];   // sensorId de la temperatura de compensación ("" = N10K)
+
+    // LoRaWAN, en el mismo formato de texto que recibe BLE ("00,11,...")
+    char joinEUI[24];
+    char devEUI[24];
+    char nwkKey[48];
+    char appKey[48];
+
+    // Listas de sensores
+    uint8_t sensorCount;
+    uint8_t modbusSensorCount;
+    uint8_t adcSensorCount;
+    SensorConfig sensors[System::CONFIG_MAX_SENSORS];
+    ModbusSensorConfig modbusSensors[System::CONFIG_MAX_MODBUS_SENSORS];
+    SensorConfig adcSensors[System::CONFIG_MAX_ADC_SENSORS];
+};
+
+class ConfigStore {
+public:
+    /**
+     * @brief Lee la imagen de NVS (una sola apertura) y valida versión, tamaño y CRC
+     * @return false si no existe o no es válida; la imagen queda a cero
+     */
+    static bool load();
+
+    /**
+     * @brief Recalcula el CRC y escribe la imagen en NVS
+     */
+    static bool save();
+
+    /**
+     * @brief Borra la imagen de NVS y de RAM
+     */
+    static void clear();
+
+    /**
+     * @brief Indica si la imagen en RAM es válida (cargada o guardada en este arranque)
+     */
+    static bool isLoaded();
+
+    /**
+     * @brief Imagen en RAM; los cambios se persisten con save()
+     */
+    static ConfigImage& image();
+
+    /**
+     * @brief Generación de la configuración: cambia con cada save() o clear() y
+     *        sobrevive al deep sleep (se reinicia en un arranque en frío junto con la RTC)
+     */
+    static uint32_t generation();
+};
+
+#endif
@@ -0,0 +1,60 @@
+/*******************************************************************************************
+ * Archivo: include/DeltaEncoder.h
+ * Descripción: Codificación delta de las lecturas (LoRa::PayloadType::DELTA). Cada
+ * LoRa::DELTA_KEYFRAME_INTERVAL uplinks se envía un keyframe completo por
+ * LoRa::FPORT_KEYFRAME; los demás van por LoRa::FPORT_DELTA con solo la diferencia de
+ * cada canal en punto fijo frente al keyframe, en varint zigzag (ver PayloadFormat.h).
+ * El keyframe de referencia se guarda en RTC RAM y solo se adopta cuando se transmitió.
+ *
+ * Las diferencias van siempre contra el keyframe y no contra el frame anterior: un delta
+ * perdido no afecta a los siguientes. Cada delta lleva la secuencia de su keyframe y su
+ * número de frame, de modo que el servidor (tools/decode_payload.py --stream) detecta
+ * los frames perdidos y los deltas de un keyframe que no recibió. También se envía un
+ * keyframe cuando cambia el esquema o la presencia de algún canal.
+ *******************************************************************************************/
+
+#ifndef DELTA_ENCODER_H
+#define DELTA_ENCODER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "sensor_types.h"
+
+class DeltaEncoder {
+public:
+    // El número de frame del delta ocupa 5 bits
+    static_assert(LoRa::DELTA_KEYFRAME_INTERVAL >= 1 && LoRa::DELTA_KEYFRAME_INTERVAL <= 32,
+                  "DELTA_KEYFRAME_INTERVAL debe estar entre 1 y 32");
+
+    /**
+     * @brief Indica si el payload configurado es el delta
+     */
+    static bool isEnabled() { return LoRa::PAYLOAD_TYPE == LoRa::PayloadType::DELTA; }
+
+    /**
+     * @brief Arma el uplink del despertar: keyframe o delta
+     * @param fPort Puerto por el que debe enviarse (FPORT_KEYFRAME o FPORT_DELTA)
+     * @return Tamaño del uplink, o 0 si no cabe en el buffer
+     */
+    static size_t build(const ReadingSet& readings, uint32_t timestamp, uint8_t* buffer, size_t bufferSize,
+                        uint8_t& fPort);
+
+    /**
+     * @brief Confirma que el último build() se transmitió: un keyframe pasa a ser la
+     *        referencia y un delta avanza el contador de frames
+     */
+    static void commit();
+
+    /**
+     * @brief Olvida la referencia (el próximo uplink es un keyframe)
+     */
+    static void reset();
+
+    /**
+     * @brief Deltas transmitidos desde el último keyframe
+     */
+    static uint8_t framesSinceKeyframe();
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*******************************************************************************************
+ * Archivo: include/FixedVector.h
+ * Descripción: Contenedor de capacidad fija con almacenamiento en línea y la interfaz
+ * mínima de std::vector que usan los drivers y los payloads (push_back, size, [], rango).
+ * No usa el heap: vive dentro de la estructura que lo contiene (lectura, arena estática).
+ *******************************************************************************************/
+
+#ifndef FIXED_VECTOR_H
+#define FIXED_VECTOR_H
+
+#include <stddef.h>
+#include <initializer_list>
+
+template <typename T, size_t N>
+class FixedVector {
+public:
+    FixedVector() = default;
+
+    FixedVector(std::initializer_list<T> items) {
+        for (const T& item : items) {
+            push_back(item);
+        }
+    }
+
+    /**
+     * @brief Agrega un elemento al final
+     * @return false si el contenedor está lleno (el elemento se descarta)
+     */
+    bool push_back(const T& item) {
+        if (_size >= N) {
+            return false;
+        }
+        _items[_size++] = item;
+        return true;
+    }
+
+    /**
+     * @brief Cambia el tamaño; los elementos nuevos se inicializan por valor
+     */
+    void resize(size_t size) {
+        if (size > N) {
+            size = N;
+        }
+        for (size_t i = _size; i < size; i++) {
+            _items[i] = T();
+        }
+        _size = size;
+    }
+
+    void clear() { _size = 0; }
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    bool full() const { return _size >= N; }
+    static constexpr size_t capacity() { return N; }
+
+    T& operator[](size_t index) { return _items[index]; }
+    const T& operator[](size_t index) const { return _items[index]; }
+    T& back() { return _items[_size - 1]; }
+    const T& back() const { return _items[_size - 1]; }
+
+    T* begin() { return _items; }
+    T* end() { return _items + _size; }
+    const T* begin() const { return _items; }
+    const T* end() const { return _items + _size; }
+
+private:
+    T _items[N] = {};
+    size_t _size = 0;
+};
+
+#endif
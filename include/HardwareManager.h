@@ -7,16 +7,12 @@
 #ifndef HARDWARE_MANAGER_H
 #define HARDWARE_MANAGER_H
 
-#include <Arduino.h>
-#include <Wire.h>
-#include <SPI.h>
 #include "config.h"
 #include "PowerManager.h"
 #include "sensors/ISensor.h"
 #include "sensor_types.h"
-#include <vector>
-#include <map>
-#include <string>
+
+class SPIClass;
 
 class HardwareManager {
 public:
@@ -0,0 +1,39 @@
+/*******************************************************************************************
+ * Archivo: include/HeapCounter.h
+ * Descripción: Contador de asignaciones de heap para verificar que la ruta de lectura y
+ * de armado del payload no usa el heap en un despertar normal. Con -DHEAP_COUNTER,
+ * HeapCounter.cpp reemplaza los operator new/delete globales y cuenta cada asignación
+ * (contenedores STL, std::string, make_unique); malloc directo, como el de String de
+ * Arduino, no pasa por aquí. Sin el flag no reemplaza nada y allocations() devuelve 0.
+ * El entorno native lo activa y test/test_heap falla si la ruta medida asigna memoria.
+ *******************************************************************************************/
+
+#ifndef HEAP_COUNTER_H
+#define HEAP_COUNTER_H
+
+#include <stdint.h>
+
+class HeapCounter {
+public:
+    /**
+     * @brief Indica si el contador está compilado (-DHEAP_COUNTER)
+     */
+    static bool isEnabled();
+
+    /**
+     * @brief Asignaciones hechas con operator new desde el último reset()
+     */
+    static uint32_t allocations();
+
+    /**
+     * @brief Bytes pedidos con operator new desde el último reset()
+     */
+    static uint32_t bytes();
+
+    /**
+     * @brief Pone los contadores a cero (inicio de la sección medida)
+     */
+    static void reset();
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*******************************************************************************************
+ * Archivo: include/JoinScheduler.h
+ * Descripción: Planificación de los intentos de join OTAA entre despertares. Sin ella,
+ * cada despertar sin sesión repetía el join a costo completo. El estado vive en RTC RAM:
+ *   - tras cada fallo el siguiente intento espera un backoff exponencial con jitter
+ *     (mitad fija, mitad aleatoria), para que un grupo de nodos que perdió el gateway a
+ *     la vez no vuelva a transmitir sincronizado;
+ *   - cada intento baja un DR (más alcance, más tiempo en el aire) y al llegar a
+ *     LoRa::JOIN_DR_MIN vuelve a LoRa::JOIN_DR_MAX;
+ *   - el tiempo en el aire de los Join-Request se suma en una ventana de 24 h y no
+ *     puede pasar de LoRa::JOIN_DAILY_AIRTIME_MS.
+ * Los tiempos son epoch del RTC y el número aleatorio lo da quien llama, de modo que se
+ * prueba en native sin radio.
+ *******************************************************************************************/
+
+#ifndef JOIN_SCHEDULER_H
+#define JOIN_SCHEDULER_H
+
+#include <stdint.h>
+#include "config.h"
+
+class JoinScheduler {
+public:
+    static constexpr uint32_t BUDGET_WINDOW_S = 86400;
+
+    /**
+     * @brief Tiempo en el aire (ms) de un Join-Request (23 bytes, CR 4/5, preámbulo de
+     *        8 símbolos) en un DR de uplink de US915
+     */
+    static constexpr uint16_t joinAirtimeMs(uint8_t datarate) {
+        return datarate == 0 ? 371 : datarate == 1 ? 206 : datarate == 2 ? 114 :
+               datarate == 3 ? 62 : datarate == 4 ? 29 : 371;
+    }
+
+    /**
+     * @brief Indica si se puede intentar el join: venció el backoff y el intento cabe en
+     *        el presupuesto diario
+     */
+    static bool isDue(uint32_t now);
+
+    /**
+     * @brief Segundos hasta que isDue() pueda dar true (0 si ya es momento)
+     */
+    static uint32_t secondsUntilDue(uint32_t now);
+
+    /**
+     * @brief DR del próximo intento
+     */
+    static uint8_t datarate();
+
+    /**
+     * @brief Registra un intento: suma su tiempo en el aire y, si falló, programa el
+     *        siguiente
+     * @param random Número aleatorio para el jitter del backoff
+     */
+    static void recordAttempt(uint32_t now, uint8_t datarate, bool joined, uint32_t random);
+
+    /**
+     * @brief Backoff tras un número de fallos consecutivos: la mitad de
+     *        min(BASE * 2^(fallos-1), MAX) más una parte aleatoria de la otra mitad
+     */
+    static uint32_t backoffSeconds(uint8_t failures, uint32_t random);
+
+    /**
+     * @brief Fallos consecutivos desde el último join exitoso
+     */
+    static uint8_t failures();
+
+    /**
+     * @brief Tiempo en el aire de join usado en la ventana de 24 h actual
+     */
+    static uint32_t airtimeUsedMs(uint32_t now);
+
+    /**
+     * @brief Olvida los fallos y el presupuesto usado
+     */
+    static void reset();
+};
+
+#endif
@@ -9,7 +9,6 @@
 
 #include <Arduino.h>
 #include <RadioLib.h>
-#include <vector>
 #include <ArduinoJson.h>
 #include "config_manager.h"
 #include "utilities.h"
@@ -17,6 +16,8 @@
 #include <ESP32Time.h>
 #include "SensorManager.h"
 
+extern ESP32Time rtc;
+
 // Código de error personalizado para fallo en sincronización RTC
 #define RADIOLIB_ERR_RTC_SYNC_FAILED -5000
 
@@ -38,27 +39,37 @@ public:
     static int16_t begin(SX1262* radio, const LoRaWANBand_t* region, uint8_t subBand);
 
     /**
-     * @brief Activa el nodo LoRaWAN restaurando la sesión o realizando un nuevo join
+     * @brief Activa el nodo LoRaWAN restaurando la sesión o realizando un nuevo join.
+     *        El join solo se intenta si JoinScheduler lo permite (backoff y presupuesto
+     *        diario); tras el join la hora del servidor se pide una vez por despertar.
      * @param node Referencia al nodo LoRaWAN
-     * @return Estado de la activación
+     * @return Estado de la activación: RADIOLIB_ERR_NETWORK_NOT_JOINED si el join se
+     *         difirió, RADIOLIB_ERR_RTC_SYNC_FAILED si falta la hora del servidor
      */
     static int16_t lwActivate(LoRaWANNode& node);
 
+    /**
+     * @brief Guarda la sesión en flash (SessionStore) si FCntUp avanzó lo suficiente
+     *        desde la última copia. No hace nada si la sesión no se activó.
+     * @param force Guardar aunque no toque (sesión nueva o restaurada desde flash)
+     */
+    static void checkpointSession(LoRaWANNode& node, bool force = false);
+
     /**
      * @brief Crea un payload optimizado con formato delimitado por | y , en lugar de JSON.
-     * @param readings Vector con lecturas de sensores.
+     * @param readings Lecturas de sensores.
      * @param deviceId ID del dispositivo.
      * @param stationId ID de la estación.
      * @param battery Valor de la batería.
      * @param timestamp Timestamp del sistema.
      * @param buffer Buffer donde se almacenará el payload.
      * @param bufferSize Tamaño del buffer.
-     * @return Tamaño del payload generado.
+     * @return Tamaño del payload generado, o 0 si no cabe completo en el buffer.
      */
     static size_t createDelimitedPayload(
-        const std::vector<SensorReading>& readings,
-        const String& deviceId,
-        const String& stationId,
+        const ReadingSet& readings,
+        const char* deviceId,
+        const char* stationId,
         float battery,
         uint32_t timestamp,
         char* buffer,
@@ -66,19 +77,102 @@ public:
     );
 
 
+    /**
+     * @brief Envía las lecturas con el formato configurado en LoRa::PAYLOAD_TYPE.
+     * @param readings Lecturas de sensores.
+     * @param node Referencia al nodo LoRaWAN
+     * @param deviceId ID del dispositivo
+     * @param stationId ID de la estación
+     * @param rtc Referencia al RTC para obtener timestamp
+     * @param sentMask Lecturas que salieron en algún uplink (bit i = readings[i])
+     * @return true si el payload se transmitió
+     */
+    static bool sendPayload(const ReadingSet& readings,
+                            LoRaWANNode& node,
+                            const char* deviceId,
+                            const char* stationId,
+                            ESP32Time& rtc,
+                            uint32_t& sentMask);
+
+    /**
+     * @brief Envía el payload binario compacto. Antes envía el anuncio de esquema
+     *        si la lista de sensores cambió o cada LoRa::SCHEMA_ANNOUNCE_INTERVAL envíos.
+     * @param readings Lecturas de sensores.
+     * @param node Referencia al nodo LoRaWAN
+     * @param deviceId ID del dispositivo (solo viaja en el anuncio de esquema)
+     * @param stationId ID de la estación (solo viaja en el anuncio de esquema)
+     * @param rtc Referencia al RTC para obtener timestamp
+     * @param sentMask Lecturas que salieron en algún uplink (bit i = readings[i])
+     * @return true si el payload se transmitió
+     */
+    static bool sendBinaryPayload(const ReadingSet& readings,
+                                  LoRaWANNode& node,
+                                  const char* deviceId,
+                                  const char* stationId,
+                                  ESP32Time& rtc,
+                                  uint32_t& sentMask);
+
+    /**
+     * @brief Envía un keyframe o un delta según DeltaEncoder. Antes envía el anuncio de
+     *        esquema si hace falta (el keyframe lo necesita para decodificarse).
+     * @param readings Lecturas de sensores.
+     * @param node Referencia al nodo LoRaWAN
+     * @param deviceId ID del dispositivo (solo viaja en el anuncio de esquema)
+     * @param stationId ID de la estación (solo viaja en el anuncio de esquema)
+     * @param rtc Referencia al RTC para obtener timestamp
+     * @param sentMask Lecturas que salieron en algún uplink (bit i = readings[i])
+     * @return true si el payload se transmitió
+     */
+    static bool sendDeltaPayload(const ReadingSet& readings,
+                                 LoRaWANNode& node,
+                                 const char* deviceId,
+                                 const char* stationId,
+                                 ESP32Time& rtc,
+                                 uint32_t& sentMask);
+
+    /**
+     * @brief Envía el lote acumulado en SampleBatch por LoRa::FPORT_BATCH.
+     *        El lote se vacía solo si la transmisión fue exitosa. Si no cabe en el
+     *        uplink del DR activo pasa a OutageBuffer, que sendBacklog() reparte.
+     * @param readings Lecturas del despertar actual (para el anuncio de esquema)
+     * @param node Referencia al nodo LoRaWAN
+     * @param deviceId ID del dispositivo
+     * @param stationId ID de la estación
+     * @return true si el lote quedó vacío (transmitido o pasado al respaldo)
+     */
+    static bool sendBatch(const ReadingSet& readings,
+                          LoRaWANNode& node,
+                          const char* deviceId,
+                          const char* stationId);
+
+    /**
+     * @brief Envía las lecturas respaldadas en OutageBuffer durante la falta de sesión,
+     *        en hasta LoRa::OUTAGE_FLUSH_FRAMES uplinks de lote por LoRa::FPORT_BATCH.
+     *        Solo se quitan del respaldo los registros transmitidos.
+     * @param readings Lecturas del despertar actual (para el anuncio de esquema)
+     * @return false si un uplink falló (lo que queda se envía en otro despertar)
+     */
+    static bool sendBacklog(const ReadingSet& readings,
+                            LoRaWANNode& node,
+                            const char* deviceId,
+                            const char* stationId);
+
     /**
      * @brief Envía el payload de sensores estándar usando formato delimitado.
-     * @param readings Vector con todas las lecturas de sensores.
+     * @param readings Lecturas de sensores.
      * @param node Referencia al nodo LoRaWAN
      * @param deviceId ID del dispositivo
      * @param stationId ID de la estación
      * @param rtc Referencia al RTC para obtener timestamp
+     * @param sentMask Lecturas que salieron en algún uplink (bit i = readings[i])
+     * @return true si el payload se transmitió
      */
-    static void sendDelimitedPayload(const std::vector<SensorReading>& readings,
+    static bool sendDelimitedPayload(const ReadingSet& readings,
                                    LoRaWANNode& node,
-                                   const String& deviceId,
-                                   const String& stationId,
-                                   ESP32Time& rtc);
+                                   const char* deviceId,
+                                   const char* stationId,
+                                   ESP32Time& rtc,
+                                   uint32_t& sentMask);
 
 
     /**
@@ -95,6 +189,59 @@ public:
     static void setDatarate(LoRaWANNode& node, uint8_t datarate);
 
 private:
+    /**
+     * @brief Pide la hora al servidor si quedan intentos tras el join
+     * @return state, o RADIOLIB_ERR_RTC_SYNC_FAILED si la hora no llegó y quedan intentos
+     */
+    static int16_t syncTimeIfPending(LoRaWANNode& node, int16_t state);
+
+    /**
+     * @brief Un intercambio DeviceTimeReq/Ans; si llega la hora ajusta el RTC y los
+     *        epoch de OutageBuffer
+     */
+    static bool requestDeviceTime(LoRaWANNode& node);
+
+    /**
+     * @brief Carga la copia de la sesión en flash con FCntUp adelantado en
+     *        SessionStore::counterGap() (tras un corte de energía)
+     * @return true si RadioLib aceptó la sesión
+     */
+    static bool restoreSessionFromFlash(LoRaWANNode& node);
+
+    /**
+     * @brief Transmite un buffer por uplink sin esperar downlink
+     * @return Estado de node.uplink
+     */
+    static int16_t transmit(LoRaWANNode& node, uint8_t* data, size_t length, uint8_t fPort);
+
+    /**
+     * @brief Payload máximo de un uplink en el DR activo (ver PayloadPlanner)
+     */
+    static size_t frameBudget(LoRaWANNode& node);
+
+    /**
+     * @brief Reparte las lecturas en frames del DR activo (PayloadPlanner) y los envía
+     *        en formato delimitado o binario según fPort
+     * @param sentMask Lecturas que salieron en algún frame; es la máscara que recibe
+     *        PayloadPlanner::commit()
+     * @return true si todos los frames planificados se transmitieron
+     */
+    static bool sendPlannedFrames(const ReadingSet& readings,
+                                  LoRaWANNode& node,
+                                  const char* deviceId,
+                                  const char* stationId,
+                                  uint32_t timestamp,
+                                  uint8_t fPort,
+                                  uint32_t& sentMask);
+
+    /**
+     * @brief Envía el anuncio de esquema si cambió o si toca reenviarlo
+     */
+    static void announceSchemaIfNeeded(const ReadingSet& readings,
+                                       LoRaWANNode& node,
+                                       const char* deviceId,
+                                       const char* stationId);
+
     static LoRaWANNode* node;
     static SX1262* radioModule;
 
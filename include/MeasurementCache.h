@@ -0,0 +1,59 @@
+/*******************************************************************************************
+ * Archivo: include/MeasurementCache.h
+ * Descripción: Caché de magnitudes físicas adquiridas en el ciclo de lectura.
+ * Los sensores derivados declaran de qué magnitud dependen (ISensor::dependsOn) y
+ * SensorManager los recoge después de la fuente configurada, que publica aquí su valor.
+ * Así la temperatura del agua se mide una sola vez por ciclo y pH y conductividad la
+ * consumen ya adquirida, venga del NTC, de un DS18B20, de un RTD o del MT05.
+ *******************************************************************************************/
+
+#ifndef MEASUREMENT_CACHE_H
+#define MEASUREMENT_CACHE_H
+
+#include <stdint.h>
+#include "sensor_types.h"
+
+/**
+ * @brief Magnitudes que un sensor puede necesitar de otro
+ */
+enum class Quantity : uint8_t {
+    NONE = 0,
+    WATER_TEMPERATURE,
+    COUNT
+};
+
+class MeasurementCache {
+public:
+    /**
+     * @brief Vacía la caché al empezar un ciclo de lectura
+     */
+    static void clear();
+
+    /**
+     * @brief Registra el valor del ciclo. NAN es válido: la fuente existe pero falló,
+     *        y el consumidor debe usar su valor por defecto en lugar de medir otra vez.
+     */
+    static void publish(Quantity quantity, float value);
+
+    /**
+     * @brief Valor adquirido en este ciclo
+     * @return false si ninguna fuente lo publicó (no hay fuente configurada)
+     */
+    static bool get(Quantity quantity, float& value);
+
+    /**
+     * @brief Indica si un tipo de sensor puede servir de fuente de la magnitud
+     */
+    static bool canProvide(SensorType type, Quantity quantity);
+
+    /**
+     * @brief Extrae la magnitud de la lectura de su fuente (valor o subvalor según el tipo)
+     */
+    static float extract(const SensorReading& reading, Quantity quantity);
+
+private:
+    static float _values[(uint8_t)Quantity::COUNT];
+    static bool _present[(uint8_t)Quantity::COUNT];
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*******************************************************************************************
+ * Archivo: include/ModbusLinkStats.h
+ * Descripción: Estadísticas del enlace Modbus por esclavo, en RTC RAM (sobreviven al deep
+ * sleep). ModbusRtu informa la latencia de cada respuesta y cada error, y consulta aquí
+ * el timeout y los intentos de cada petición:
+ *  - El timeout del primer intento es la latencia media + 4 desviaciones + margen (como
+ *    el RTO de TCP), acotado a [MODBUS_MIN_RESPONSE_TIMEOUT, MODBUS_RESPONSE_TIMEOUT];
+ *    los reintentos usan el máximo para que un esclavo más lento pueda volver a medirse.
+ *  - Un esclavo que no respondió en MODBUS_BACKOFF_AFTER_FAILURES ciclos seguidos se
+ *    salta 1, 2, 4... ciclos (hasta MODBUS_BACKOFF_MAX_CYCLES); el ciclo en que se
+ *    vuelve a probar hace un solo intento.
+ * Un ciclo es una adquisición del lote de ModbusSensorManager (beginCycle/endCycle).
+ *******************************************************************************************/
+
+#ifndef MODBUS_LINK_STATS_H
+#define MODBUS_LINK_STATS_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Contadores y estado de un esclavo
+ */
+struct ModbusSlaveStats {
+    uint8_t slave;
+    uint8_t failedCycles;       // Ciclos seguidos sin ninguna respuesta
+    uint8_t backoffCycles;      // Ciclos que todavía se salta
+    uint8_t backoffLevel;       // Exponente del próximo backoff
+    uint32_t latencyUs;         // Latencia media (primer intento respondido)
+    uint32_t deviationUs;       // Desviación media de la latencia
+    uint32_t maxLatencyUs;
+    uint32_t requests;          // Tramas enviadas, reintentos incluidos
+    uint32_t responses;         // Respuestas válidas (datos o excepción)
+    uint32_t timeouts;
+    uint32_t crcErrors;
+    uint32_t otherErrors;       // Respuesta mal formada o de otro esclavo
+    uint32_t exceptions;
+    uint32_t skipped;           // Peticiones no enviadas por backoff
+};
+
+class ModbusLinkStats {
+public:
+    /**
+     * @brief Inicia un ciclo: descuenta el backoff de los esclavos que lo cumplen
+     */
+    static void beginCycle();
+
+    /**
+     * @brief Cierra el ciclo: reinicia el backoff de los esclavos que respondieron y lo
+     *        alarga en los que no respondieron a nada
+     */
+    static void endCycle();
+
+    /**
+     * @brief Indica si las peticiones a este esclavo se saltan en el ciclo actual
+     *        (cuenta la petición en skipped)
+     */
+    static bool skip(uint8_t slave);
+
+    /**
+     * @brief Igual que skip() pero sin contar nada
+     */
+    static bool backedOff(uint8_t slave);
+
+    /**
+     * @brief Timeout de respuesta en ms para el intento indicado (0 = primero)
+     */
+    static uint32_t timeoutMs(uint8_t slave, uint8_t attempt);
+
+    /**
+     * @brief Intentos por petición: uno solo mientras el esclavo está en observación
+     */
+    static uint8_t maxAttempts(uint8_t slave);
+
+    /**
+     * @brief Registra el envío de una trama al esclavo
+     */
+    static void recordSent(uint8_t slave);
+
+    /**
+     * @brief Registra el resultado de un intento (código de ModbusRtu)
+     * @param latencyUs Desde el fin de la petición hasta el fin de la respuesta, menos
+     *        lo que tarda la respuesta en el bus (solo se usa si hubo respuesta)
+     */
+    static void recordResult(uint8_t slave, uint8_t result, uint32_t latencyUs);
+
+    /**
+     * @brief Número de esclavos con estadísticas
+     */
+    static uint8_t count();
+
+    /**
+     * @brief Estadísticas del esclavo en la posición index (nullptr si no existe)
+     */
+    static const ModbusSlaveStats* at(uint8_t index);
+
+    /**
+     * @brief Borra todas las estadísticas
+     */
+    static void reset();
+
+    /**
+     * @brief Imprime los contadores de cada esclavo (diagnóstico)
+     */
+    static void printReport();
+};
+
+#endif
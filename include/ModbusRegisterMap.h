@@ -0,0 +1,89 @@
+/*******************************************************************************************
+ * Archivo: include/ModbusRegisterMap.h
+ * Descripción: Planificación y decodificación de los puntos Modbus descritos en
+ * configuración (ModbusDescriptor). plan() agrupa los puntos de todos los sensores por
+ * esclavo y función y los cubre con el mínimo de lecturas de bloque: ordenados por
+ * registro, cada punto se suma al bloque abierto mientras el hueco no supere
+ * System::MODBUS_COALESCE_GAP y el bloque no pase de MODBUS_MAX_BLOCK_REGISTERS
+ * (recorrer los intervalos ordenados de forma voraz da el mínimo de bloques).
+ * decode() convierte los registros de un punto según su tipo, orden, escala y offset.
+ * No depende de Arduino; el transporte está en ModbusSensorManager.
+ *******************************************************************************************/
+
+#ifndef MODBUS_REGISTER_MAP_H
+#define MODBUS_REGISTER_MAP_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sensor_types.h"
+
+/**
+ * @brief Punto registrado para el ciclo, con su ubicación en el lote una vez planificado
+ */
+struct ModbusPointRef {
+    uint8_t slave;
+    ModbusPoint point;
+    uint8_t block;          // Bloque que lo contiene (NO_BLOCK si no se pudo planificar)
+    uint16_t offset;        // Posición de su primer registro en el búfer del lote
+};
+
+/**
+ * @brief Una transacción: registros [start, start + count) de un esclavo
+ */
+struct ModbusBlock {
+    uint8_t slave;
+    uint8_t function;
+    uint16_t start;
+    uint8_t count;
+    uint16_t offset;        // Posición del bloque en el búfer del lote
+};
+
+class ModbusRegisterMap {
+public:
+    static constexpr uint8_t NO_BLOCK = 0xFF;
+
+    /**
+     * @brief Registros que ocupa un tipo de dato (0 si el tipo no existe)
+     */
+    static uint8_t registerCount(uint8_t dataType);
+
+    /**
+     * @brief Indica si un punto se puede leer (función y tipo soportados)
+     */
+    static bool isValid(const ModbusPoint& point);
+
+    /**
+     * @brief Descriptor de fábrica de un tipo de sensor Modbus conocido
+     * @return false si el tipo no tiene mapa propio (el descriptor queda vacío)
+     */
+    static bool preset(SensorType type, ModbusDescriptor& descriptor);
+
+    /**
+     * @brief Agrupa los puntos en el mínimo de bloques y asigna block/offset a cada uno
+     * @param refs Puntos del ciclo (se reordenan solo sus índices, no el arreglo)
+     * @param blocks Salida, de capacidad maxBlocks
+     * @param maxRegisters Tamaño del búfer del lote; lo que no cabe queda en NO_BLOCK
+     * @return Número de bloques (transacciones)
+     */
+    static uint8_t plan(ModbusPointRef* refs, uint8_t count, ModbusBlock* blocks, uint8_t maxBlocks,
+                        uint16_t maxRegisters);
+
+    /**
+     * @brief Valor del punto a partir de sus registros (registers[0] es point.reg)
+     */
+    static float decode(const uint16_t* registers, const ModbusPoint& point);
+
+    /**
+     * @brief Indica si una lectura de sondeo parece una medición real: valor finito y
+     *        registros que no están todos a 0x0000 ni a 0xFFFF (lo que suelen devolver
+     *        las sondas mientras calientan)
+     */
+    static bool isPlausible(const uint16_t* registers, const ModbusPoint& point);
+
+    /**
+     * @brief Máximo de calentamiento tras encender los 12 V para un tipo de sensor
+     */
+    static uint16_t warmupLimitMs(SensorType type);
+};
+
+#endif
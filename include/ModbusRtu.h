@@ -0,0 +1,123 @@
+/*******************************************************************************************
+ * Archivo: include/ModbusRtu.h
+ * Descripción: Maestro Modbus RTU no bloqueante. Las peticiones (lectura de registros
+ * holding 0x03 o input 0x04) se encolan y se envían una tras otra, respetando el
+ * silencio T3.5 entre tramas, aunque vayan a esclavos distintos. poll() avanza la
+ * máquina de estados sin esperar: recoge los bytes que trajo la UART, da la respuesta
+ * por terminada al alcanzar su longitud esperada o tras T3.5 sin bytes, y aplica el
+ * timeout y los reintentos de cada esclavo (ModbusLinkStats). Entre llamadas el que
+ * llama puede hacer otra cosa o dormir hasta nextEventMs() con HalUart::waitRx
+ * (semáforo del RX timeout del UART en el ESP32).
+ * La respuesta no se arma en un búfer: cada byte que llega actualiza el CRC (por tabla,
+ * util/crc16.h) y los bytes de datos se escriben directamente en los registros del que
+ * llamó, de modo que al terminar la trama solo queda comprobar el CRC acumulado.
+ * Solo depende de la HAL: el mismo código corre en native contra un esclavo simulado o
+ * contra el pty de tools/modbus_slave_sim.py.
+ *******************************************************************************************/
+
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include <stdint.h>
+#include "config.h"
+
+class ModbusRtu {
+public:
+    // Resultado de una petición. Los códigos 0x01..0x04 son excepciones del esclavo.
+    static constexpr uint8_t SUCCESS = 0x00;
+    static constexpr uint8_t ILLEGAL_FUNCTION = 0x01;
+    static constexpr uint8_t ILLEGAL_DATA_ADDRESS = 0x02;
+    static constexpr uint8_t INVALID_SLAVE = 0xE0;      // Respondió otro esclavo
+    static constexpr uint8_t INVALID_FUNCTION = 0xE1;   // Función distinta de la pedida
+    static constexpr uint8_t TIMED_OUT = 0xE2;
+    static constexpr uint8_t INVALID_CRC = 0xE3;
+    static constexpr uint8_t INVALID_RESPONSE = 0xE4;   // Longitud o conteo de bytes incorrectos
+    static constexpr uint8_t BACKED_OFF = 0xE5;         // No se envió: esclavo en backoff
+    static constexpr uint8_t PENDING = 0xFF;
+
+    static constexpr int8_t NO_REQUEST = -1;
+    static constexpr uint8_t REQUEST_SIZE = 8;
+
+    // Opciones de submit(). PROBE: lectura de sondeo durante el calentamiento, un solo
+    // intento con MODBUS_PROBE_TIMEOUT_MS y sin afectar a ModbusLinkStats
+    static constexpr uint8_t PROBE = 0x01;
+
+    /**
+     * @brief Estado de una respuesta en recepción
+     */
+    struct Response {
+        uint16_t length;        // Bytes recibidos
+        uint16_t crc;           // CRC acumulado (0 al final si la trama es válida)
+        uint8_t header[3];      // Esclavo, función y conteo de bytes (o código de excepción)
+    };
+
+    /**
+     * @brief Calcula los tiempos de trama para la velocidad del bus y vacía la cola
+     */
+    static void begin(uint32_t baud);
+
+    /**
+     * @brief Descarta todas las peticiones (las pendientes no se envían)
+     */
+    static void reset();
+
+    /**
+     * @brief Arma la trama de lectura (REQUEST_SIZE bytes, CRC incluido)
+     * @return Longitud de la trama
+     */
+    static uint8_t buildRequest(uint8_t slave, uint8_t function, uint16_t start, uint8_t count,
+                                uint8_t* frame);
+
+    /**
+     * @brief Valida una respuesta completa y decodifica sus registros en out, con el
+     *        mismo procesamiento byte a byte que poll()
+     * @return SUCCESS, la excepción del esclavo o un código de error
+     */
+    static uint8_t decodeResponse(const uint8_t* frame, uint16_t length, uint8_t slave, uint8_t function,
+                                  uint8_t count, uint16_t* out);
+
+    /**
+     * @brief Encola la lectura de count registros desde start
+     * @param out Destino de los registros; debe seguir vivo hasta que la petición termine.
+     *        Se escribe a medida que llegan los bytes: solo es válido si result() es SUCCESS
+     * @param options 0 o PROBE
+     * @return Identificador de la petición, o NO_REQUEST si la cola está llena o la
+     *         petición no es válida
+     */
+    static int8_t submit(uint8_t slave, uint8_t function, uint16_t start, uint8_t count, uint16_t* out,
+                         uint8_t options = 0);
+
+    /**
+     * @brief Resultado de una petición (PENDING mientras no termina)
+     */
+    static uint8_t result(int8_t request);
+
+    /**
+     * @brief Avanza la máquina de estados sin bloquear
+     * @return true mientras queden peticiones sin terminar
+     */
+    static bool poll();
+
+    /**
+     * @brief Milisegundos que pueden pasar antes de que poll() tenga algo que hacer si
+     *        no llegan bytes (fin del silencio entre tramas o timeout de respuesta)
+     */
+    static uint32_t nextEventMs();
+
+    /**
+     * @brief Espera, sin ocupar la CPU, hasta que lleguen bytes o venza nextEventMs()
+     */
+    static void waitForEvent();
+
+    /**
+     * @brief Atiende la cola hasta terminar todas las peticiones
+     */
+    static void runUntilIdle();
+
+    /**
+     * @brief Tramas enviadas desde begin() (reintentos incluidos)
+     */
+    static uint32_t framesSent();
+};
+
+#endif
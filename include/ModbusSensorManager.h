@@ -1,17 +1,29 @@
 #ifndef MODBUS_SENSOR_MANAGER_H
 #define MODBUS_SENSOR_MANAGER_H
 
-#include <Arduino.h>
 #include <vector>
 #include "sensor_types.h"
+#include "ModbusRegisterMap.h"
 
 /**
  * @brief Clase para manejar la lectura de sensores Modbus.
  *        Usa Serial2 con pines configurables para RX/TX.
- *        Utiliza la biblioteca ModbusMaster para comunicación.
+ *        Las transacciones las hace ModbusRtu sin bloquear.
+ *
+ *        Los sensores registran los puntos de su descriptor en begin(); el primer
+ *        startMeasurement() del ciclo planifica (ModbusRegisterMap::plan) y encola todos
+ *        los bloques, poll() los atiende mientras el resto de los sensores convierte, y
+ *        cada sensor toma sus valores del mismo lote.
+ *
+ *        Tras encender los 12 V cada esclavo calienta: antes del lote se le hacen lecturas
+ *        cortas de sondeo cada MODBUS_PROBE_INTERVAL_MS hasta que da un valor plausible o
+ *        vence su máximo, contado desde el encendido del riel (que main adelanta a antes
+ *        de la activación LoRaWAN). El calentamiento dura lo que tarda cada sonda.
  */
 class ModbusSensorManager {
 public:
+    static constexpr int8_t NO_HANDLE = -1;
+
     /**
      * @brief Inicializa el bus RS485/Modbus (configura Serial2 con los pines definidos)
      *        Debe llamarse una sola vez al principio.
@@ -25,23 +37,48 @@ public:
     static void endModbus();
 
     /**
-     * @brief Lee registros Modbus (expuesto para uso de ModbusSensor)
+     * @brief Olvida los puntos registrados (antes de volver a registrar sensores)
      */
-    static bool readRegisters(uint8_t address, uint16_t startReg, uint16_t numRegs, uint16_t* outData) {
-        return readHoldingRegisters(address, startReg, numRegs, outData);
-    }
+    static void clearPoints();
 
-private:
     /**
-     * @brief Envía un frame Modbus (Función 0x03) y recibe la respuesta utilizando ModbusMaster.
-     *        Para simplificar el ejemplo, se hace una lectura consecutiva de registros.
-     * @param address Dirección Modbus del dispositivo
-     * @param startReg Registro inicial
-     * @param numRegs  Cantidad de registros
-     * @param outData  Buffer de salida donde se almacenan los valores de cada registro
-     * @return true si la lectura fue exitosa, false en caso de error
+     * @brief Agrega los puntos de un descriptor al lote del ciclo
+     * @param warmupMs Máximo de calentamiento del esclavo tras encender los 12 V; hasta
+     *        entonces se sondea su primer punto y el lote espera a que dé un valor
+     *        plausible (0 = sin calentamiento)
+     * @return Handle del primer punto (los demás son consecutivos), o NO_HANDLE si no
+     *         caben en System::MODBUS_MAX_POINTS
      */
-    static bool readHoldingRegisters(uint8_t address, uint16_t startReg, uint16_t numRegs, uint16_t* outData);
+    static int8_t addPoints(uint8_t address, const ModbusDescriptor& descriptor, uint16_t warmupMs = 0);
+
+    /**
+     * @brief Marca el lote como obsoleto: la próxima lectura hace las transacciones
+     */
+    static void invalidate();
+
+    /**
+     * @brief Encola las transacciones del lote del ciclo (una vez por ciclo)
+     */
+    static void startAcquisition();
+
+    /**
+     * @brief Atiende las transacciones en curso sin bloquear
+     * @return true cuando el lote está completo
+     */
+    static bool poll();
+
+    /**
+     * @brief Valor de un punto en el lote del ciclo. Si el lote no terminó, espera a que
+     *        termine (con la CPU libre entre bytes).
+     * @return NAN si el bloque del punto no respondió
+     */
+    static float value(int8_t handle);
+
+    /**
+     * @brief Transacciones del último lote (una por bloque)
+     */
+    static uint8_t blockCount();
+
 };
 
-#endif
\ No newline at end of file
+#endif
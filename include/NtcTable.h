@@ -0,0 +1,62 @@
+/*******************************************************************************************
+ * Archivo: include/NtcTable.h
+ * Descripción: Tabla voltaje -> temperatura de un canal NTC, generada al escribir la
+ * calibración a partir de Steinhart-Hart y de la topología del divisor (Vref, resistencia
+ * fija y posición del NTC). Los puntos están equiespaciados en voltaje entre los
+ * voltajes que corresponden a NTC_TEMP_MIN y NTC_TEMP_MAX (con un grado de margen), de
+ * modo que la lectura es un índice y una interpolación lineal con enteros: sin
+ * logaritmos. Fuera de ese tramo el driver descartaría la lectura de todos modos.
+ *
+ * La tabla se indexa por el voltaje ya calibrado (AdcSampler), no por el código crudo
+ * del ADC, para no perder la corrección de esp_adc_cal. No depende de Arduino; la misma
+ * generación está reflejada en tools/ntc_table.py.
+ *******************************************************************************************/
+
+#ifndef NTC_TABLE_H
+#define NTC_TABLE_H
+
+#include <stdint.h>
+#include "config.h"
+#include "CalibrationMath.h"
+
+/**
+ * @brief Divisor del NTC: Vref ---[arriba]--- punto de medida ---[abajo]--- GND
+ */
+struct NtcDivider {
+    uint32_t rFixed;        // Resistencia fija en ohms
+    uint16_t vRefMilliVolts;
+    uint8_t ntcTop;         // 1: NTC arriba (a Vref), 0: NTC abajo (a GND)
+    uint8_t reserved;
+};
+
+/**
+ * @brief Tabla de un canal: temperatura en °C x100 en NTC_LUT_SEGMENTS + 1 puntos
+ */
+struct NtcLut {
+    NtcDivider divider;
+    uint32_t startMicroVolts;   // Voltaje del primer punto
+    uint32_t stepScale;         // Segmentos por µV en Q32 (evita dividir en cada lectura)
+    int16_t c100[Calibration::NTC_LUT_SEGMENTS + 1];
+};
+
+class NtcTable {
+public:
+    // Punto sin temperatura válida (extremos del divisor o fuera del rango de int16)
+    static constexpr int16_t NO_POINT = INT16_MIN;
+    static constexpr int32_t INVALID = INT32_MIN;
+
+    /**
+     * @brief Genera la tabla de un canal con los coeficientes ya resueltos
+     */
+    static void build(const SteinhartHartCoeffs& coeffs, const NtcDivider& divider, NtcLut& lut);
+
+    /**
+     * @brief Temperatura en °C x100 interpolando la tabla
+     * @param microVolts Voltaje calibrado en el punto de medida
+     * @return INVALID si el voltaje está fuera del tramo de la tabla o cae junto a un
+     *         punto sin valor
+     */
+    static int32_t temperatureC100(const NtcLut& lut, int32_t microVolts);
+};
+
+#endif
@@ -0,0 +1,61 @@
+/*******************************************************************************************
+ * Archivo: include/OutageBuffer.h
+ * Descripción: Lecturas guardadas en RTC RAM mientras no hay sesión LoRaWAN (join
+ * diferido por JoinScheduler, join fallido o sin hora del servidor). Cada despertar sin
+ * sesión agrega un registro binario (PayloadFormat::binaryRecord) con su epoch; al volver
+ * la sesión los registros se envían, los más antiguos primero, en uplinks de lote con el
+ * mismo formato que SampleBatch (FPORT_BATCH, desfase u16 desde el primer registro del
+ * uplink). Si se llena se descartan los registros más antiguos, y un cambio de esquema
+ * descarta los anteriores, como en SampleBatch.
+ *******************************************************************************************/
+
+#ifndef OUTAGE_BUFFER_H
+#define OUTAGE_BUFFER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "sensor_types.h"
+
+class OutageBuffer {
+public:
+    /**
+     * @brief Agrega las lecturas del despertar, descartando las más antiguas si no caben
+     * @return false si el registro no cabe ni con el buffer vacío
+     */
+    static bool append(const ReadingSet& readings, uint32_t now);
+
+    /**
+     * @brief Agrega un registro ya codificado (PayloadFormat::binaryRecord), p. ej. uno
+     *        de SampleBatch que no pudo salir en su propio uplink
+     * @param schema schemaId de las lecturas del registro
+     * @param timestamp Epoch de la lectura
+     * @return false si el registro no cabe ni con el buffer vacío
+     */
+    static bool appendRecord(uint16_t schema, uint32_t timestamp, const uint8_t* record, size_t recordSize);
+
+    /**
+     * @brief Arma un uplink de lote con los registros más antiguos que quepan
+     * @param records Registros incluidos (para consume())
+     * @return Tamaño del uplink, o 0 si no hay registros o el primero no cabe
+     */
+    static size_t buildFrame(uint8_t* buffer, size_t bufferSize, uint8_t& records);
+
+    /**
+     * @brief Quita los registros más antiguos (tras enviarlos)
+     */
+    static void consume(uint8_t records);
+
+    /**
+     * @brief Corrige los epoch guardados cuando el RTC se ajusta a la hora del servidor
+     * @param offset Hora nueva menos hora anterior, en segundos
+     */
+    static void shiftTimestamps(int32_t offset);
+
+    static void clear();
+    static uint8_t count();
+    static uint16_t schema();
+    static uint32_t dropped();
+};
+
+#endif
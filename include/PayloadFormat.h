@@ -0,0 +1,205 @@
+/*******************************************************************************************
+ * Archivo: include/PayloadFormat.h
+ * Descripción: Serialización de lecturas al payload de uplink. No depende de Arduino
+ * ni de RadioLib para poder compilarse y medirse en el entorno native.
+ *
+ * Formato binario v1 (enteros big-endian), decodificable con tools/decode_payload.py:
+ *   [0]      versión (BINARY_VERSION)
+ *   [1..2]   schemaId: CRC16 de la lista de sensores (id, tipo, nº de canales)
+ *   [3..6]   timestamp (epoch)
+ *   [7..]    bitmap de presencia, 1 bit por canal (LSB primero); 0 = valor ausente/NAN
+ *   [...]    valores presentes en orden, en punto fijo según channelEncoding()
+ * La correspondencia schemaId -> sensores se envía como anuncio de esquema
+ * ("S|schemaId|st|dev|id,tipo,canales|...") cuando cambia la configuración. Si no
+ * cabe en un uplink sigue en continuaciones "S+|schemaId|índice del primer sensor|...".
+ *
+ * Todas las funciones aceptan una máscara de lecturas (bit i = lectura i) para repartir
+ * un despertar en varios frames (ver PayloadPlanner): en binario las lecturas fuera de
+ * la máscara van como ausentes en el bitmap, de modo que el schemaId no cambia.
+ *
+ * Lote (varios despertares en un uplink, ver SampleBatch):
+ *   [0]      versión (BINARY_VERSION)
+ *   [1..2]   schemaId
+ *   [3..6]   timestamp base (epoch del primer registro)
+ *   [7]      número de registros
+ *   por registro: [desfase en s desde la base, u16][bitmap][valores]
+ *
+ * Keyframe y delta (ver DeltaEncoder):
+ *   keyframe  [0] versión  [1..2] schemaId  [3..6] timestamp  [7] secuencia (0..7)
+ *             [8..] bitmap + valores, igual que el payload binario
+ *   delta     [0] secuencia del keyframe (3 bits altos) | nº de frame desde él (5 bits)
+ *             [1..] varint: segundos desde el keyframe
+ *             [...] por cada canal presente en el keyframe, varint zigzag de
+ *                   (valor en punto fijo - valor del keyframe)
+ *******************************************************************************************/
+
+#ifndef PAYLOAD_FORMAT_H
+#define PAYLOAD_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sensor_types.h"
+
+/**
+ * @brief Representación de un canal en el payload binario.
+ */
+enum class ValueEncoding : uint8_t {
+    I16,   // Entero con signo de 16 bits escalado
+    I32,   // Entero con signo de 32 bits escalado
+    F32    // float IEEE-754 sin escalar (tipos sin tabla)
+};
+
+struct ChannelEncoding {
+    ValueEncoding encoding;
+    float scale;   // valor_codificado = round(valor * scale)
+};
+
+class PayloadFormat {
+public:
+    static const uint8_t BINARY_VERSION = 1;
+    static const uint32_t ALL_READINGS = 0xFFFFFFFFUL;
+    static const size_t BATCH_HEADER_SIZE = 8;     // Versión, schemaId, timestamp base y registros
+
+    static_assert(MAX_READINGS <= 32, "la máscara de lecturas es de 32 bits");
+
+    /**
+     * @brief Crea el payload con formato delimitado "st|dev|bat|ts|id,tipo,v1,v2...|...".
+     * @param readings Lecturas de sensores.
+     * @param deviceId ID del dispositivo.
+     * @param stationId ID de la estación.
+     * @param battery Valor de la batería.
+     * @param timestamp Timestamp del sistema.
+     * @param buffer Buffer donde se almacenará el payload.
+     * @param bufferSize Tamaño del buffer.
+     * @param mask Lecturas a incluir
+     * @return Tamaño del payload generado, o 0 si no cabe completo en el buffer
+     *         (nunca se corta una lectura).
+     */
+    static size_t delimited(
+        const ReadingSet& readings,
+        const char* deviceId,
+        const char* stationId,
+        float battery,
+        uint32_t timestamp,
+        char* buffer,
+        size_t bufferSize,
+        uint32_t mask = ALL_READINGS
+    );
+
+    /**
+     * @brief Bytes de la cabecera "st|dev|bat|ts" del payload delimitado
+     */
+    static size_t delimitedHeaderSize(const char* deviceId, const char* stationId, float battery,
+                                      uint32_t timestamp);
+
+    /**
+     * @brief Bytes que agrega una lectura al payload delimitado ("|id,tipo,v1...")
+     */
+    static size_t delimitedReadingSize(const SensorReading& reading);
+
+    /**
+     * @brief Crea el payload binario compacto (ver formato arriba).
+     * @param readings Lecturas de sensores.
+     * @param timestamp Timestamp del sistema.
+     * @param buffer Buffer de salida.
+     * @param bufferSize Tamaño del buffer.
+     * @param mask Lecturas a incluir (las demás van como ausentes)
+     * @return Tamaño del payload generado, o 0 si no cabe en el buffer.
+     */
+    static size_t binary(
+        const ReadingSet& readings,
+        uint32_t timestamp,
+        uint8_t* buffer,
+        size_t bufferSize,
+        uint32_t mask = ALL_READINGS
+    );
+
+    /**
+     * @brief Codifica solo el cuerpo de un registro binario (bitmap + valores),
+     *        sin cabecera. Es la unidad que se acumula en los lotes.
+     * @return Tamaño escrito, o 0 si no cabe en el buffer.
+     */
+    static size_t binaryRecord(
+        const ReadingSet& readings,
+        uint8_t* buffer,
+        size_t bufferSize,
+        uint32_t mask = ALL_READINGS
+    );
+
+    /**
+     * @brief Bytes del payload binario sin ningún valor: cabecera y bitmap completo
+     */
+    static size_t binaryHeaderSize(const ReadingSet& readings);
+
+    /**
+     * @brief Bytes que agregan los valores presentes de una lectura al payload binario
+     */
+    static size_t binaryReadingSize(const SensorReading& reading);
+
+    /**
+     * @brief Arma un uplink de lote a partir de registros ya codificados.
+     * @param schema schemaId común a todos los registros
+     * @param baseTimestamp Epoch del primer registro
+     * @param count Número de registros
+     * @param records Registros consecutivos ([desfase u16][binaryRecord])
+     * @param recordsLength Bytes de records
+     * @return Tamaño del lote, o 0 si no cabe en el buffer.
+     */
+    static size_t batchFrame(
+        uint16_t schema,
+        uint32_t baseTimestamp,
+        uint8_t count,
+        const uint8_t* records,
+        size_t recordsLength,
+        uint8_t* buffer,
+        size_t bufferSize
+    );
+
+    /**
+     * @brief Calcula el identificador de esquema de un conjunto de lecturas.
+     *        Solo depende de ids, tipos y número de canales, no de los valores.
+     * @return schemaId (nunca 0)
+     */
+    static uint16_t schemaId(const ReadingSet& readings);
+
+    /**
+     * @brief Crea el anuncio de esquema "S|schemaId|st|dev|id,tipo,canales|...", o su
+     *        continuación "S+|schemaId|first|..." si first > 0.
+     * @param first Primer sensor de esta parte
+     * @param next Si no es nullptr, recibe el primer sensor que no cupo (readings.size()
+     *        si el anuncio terminó); sin next, el anuncio debe caber completo
+     * @return Tamaño generado, o 0 si no cabe ni un sensor (o el anuncio completo sin next)
+     */
+    static size_t schemaAnnouncement(
+        const ReadingSet& readings,
+        const char* deviceId,
+        const char* stationId,
+        char* buffer,
+        size_t bufferSize,
+        size_t first = 0,
+        size_t* next = nullptr
+    );
+
+    /**
+     * @brief Codificación en punto fijo de un canal según el tipo de sensor.
+     * @param type Tipo de sensor
+     * @param channel Índice del subvalor (0 para sensores de un solo valor)
+     */
+    static ChannelEncoding channelEncoding(SensorType type, uint8_t channel);
+
+    /**
+     * @brief Valor en punto fijo tal como viaja en el payload binario (los F32 como
+     *        sus bits IEEE-754)
+     * @return false si el canal va como ausente (NAN o fuera de rango)
+     */
+    static bool quantize(float value, ChannelEncoding enc, int32_t& out);
+
+    /**
+     * @brief Número de canales (valores) que aporta una lectura al payload.
+     */
+    static uint8_t channelCount(const SensorReading& reading) {
+        return reading.subValues.empty() ? 1 : (uint8_t)reading.subValues.size();
+    }
+};
+
+#endif
@@ -0,0 +1,92 @@
+/*******************************************************************************************
+ * Archivo: include/PayloadPlanner.h
+ * Descripción: Ajusta los uplinks al payload máximo del data rate activo (US915), de
+ * modo que ningún uplink exceda el MACPayload del DR ni el dwell time de 400 ms. Con el
+ * tamaño de cada lectura en el formato que se envía, reparte las lecturas del
+ * despertar en varios frames y, si no caben todas, rota las de menor prioridad entre
+ * despertares: primero las que llevan REPORT_MAX_WAKES - 1 despertares sin reportarse,
+ * luego por prioridad (según el tipo de sensor) y antigüedad. Las de prioridad ALWAYS
+ * (batería) van en todos los frames. Los despertares sin reportar de cada lectura se
+ * guardan en RTC RAM.
+ *******************************************************************************************/
+
+#ifndef PAYLOAD_PLANNER_H
+#define PAYLOAD_PLANNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "sensor_types.h"
+
+/**
+ * @brief Prioridad de una lectura al repartir el payload
+ */
+enum class ReportPriority : uint8_t {
+    ALWAYS,      // En todos los frames
+    IMPORTANT,
+    NORMAL,
+    OPTIONAL
+};
+
+class PayloadPlanner {
+public:
+    /**
+     * @brief MACPayload máximo (M) de un DR de uplink en US915, 0 si no es de uplink.
+     *        Ya respeta el dwell time de 400 ms.
+     */
+    static constexpr uint8_t maxMacPayload(uint8_t datarate) {
+        return datarate == 0 ? 19 : datarate == 1 ? 61 : datarate == 2 ? 133 :
+               (datarate == 3 || datarate == 4) ? 250 : 0;
+    }
+
+    /**
+     * @brief Payload de aplicación disponible en un DR: M menos FHDR y FPort (8 bytes),
+     *        menos LoRa::FOPTS_RESERVE, y nunca más que LoRa::MAX_PAYLOAD
+     */
+    static constexpr size_t staticBudget(uint8_t datarate) {
+        return maxMacPayload(datarate) < 8 + LoRa::FOPTS_RESERVE ? 0 :
+               (maxMacPayload(datarate) - 8 - LoRa::FOPTS_RESERVE < LoRa::MAX_PAYLOAD
+                    ? maxMacPayload(datarate) - 8 - LoRa::FOPTS_RESERVE : LoRa::MAX_PAYLOAD);
+    }
+
+    /**
+     * @brief Presupuesto de un uplink en el DR activo
+     * @param radioLimit Máximo que informa la pila LoRaWAN con los FOpts pendientes
+     *        (0 si no se conoce)
+     */
+    static size_t frameBudget(uint8_t datarate, size_t radioLimit = 0);
+
+    /**
+     * @brief Prioridad de una lectura según el tipo de sensor
+     */
+    static ReportPriority priority(SensorType type);
+
+    /**
+     * @brief Reparte las lecturas en frames
+     * @param costs Bytes de cada lectura en el formato del uplink
+     * @param headerSize Bytes fijos de cada frame
+     * @param budget Tamaño máximo de un frame
+     * @param masks Salida: lecturas de cada frame (bit i = lectura i)
+     * @return Número de frames (0 si no cabe ni una lectura)
+     */
+    static uint8_t plan(const ReadingSet& readings, const size_t* costs, size_t headerSize, size_t budget,
+                        uint8_t maxFrames, uint32_t* masks);
+
+    /**
+     * @brief Registra las lecturas que se transmitieron en este despertar
+     * @param sentMask Unión de las máscaras de los frames transmitidos
+     */
+    static void commit(const ReadingSet& readings, uint32_t sentMask);
+
+    /**
+     * @brief Despertares seguidos sin reportar la lectura index
+     */
+    static uint8_t wakesSinceReported(size_t index);
+
+    /**
+     * @brief Olvida la antigüedad de las lecturas
+     */
+    static void reset();
+};
+
+#endif
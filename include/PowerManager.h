@@ -1,7 +1,7 @@
 #ifndef POWER_MANAGER_H
 #define POWER_MANAGER_H
 
-#include <Arduino.h>
+#include <stdint.h>
 #include "config.h"
 
 /**
@@ -26,10 +26,22 @@ public:
     static void power3V3Off();
 
     /**
-     * @brief Activa la línea de alimentación de 12V
+     * @brief Activa la línea de alimentación de 12V y espera a que se estabilice (si ya
+     *        estaba encendida, solo lo que falte de POWER_STABILIZE_DELAY_MS)
      */
     static void power12VOn();
 
+    /**
+     * @brief Activa la línea de 12V sin esperar, para que las sondas empiecen a calentar
+     *        mientras se hace otra cosa
+     */
+    static void power12VStart();
+
+    /**
+     * @brief Milisegundos desde que se encendió la línea de 12V (0 si está apagada)
+     */
+    static uint32_t rail12VUptimeMs();
+
     /**
      * @brief Desactiva la línea de alimentación de 12V
      */
@@ -0,0 +1,68 @@
+/*******************************************************************************************
+ * Archivo: include/ReportFilter.h
+ * Descripción: Filtro de report-by-exception. Guarda en RTC RAM el último valor
+ * transmitido de cada canal (en el orden del payload binario) y decide si las lecturas
+ * del despertar merecen un uplink: alguno cruzó su banda muerta (LoRa::ReportDeadband,
+ * según el tipo de sensor y el canal), un canal apareció o desapareció (NaN), cambió la
+ * lista de sensores (schemaId) o toca el latido de LoRa::REPORT_HEARTBEAT_CYCLES.
+ *******************************************************************************************/
+
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sensor_types.h"
+
+/**
+ * @brief Banda muerta de un canal: cambió si |v - último| > max(absolute, relative * |último|)
+ */
+struct Deadband {
+    float absolute;
+    float relative;
+};
+
+class ReportFilter {
+public:
+    /**
+     * @brief Indica si el modo report-by-exception está activo
+     */
+    static bool isEnabled() { return LoRa::REPORT_BY_EXCEPTION; }
+
+    /**
+     * @brief Predice, antes de leer sensores, si este despertar transmite sí o sí
+     *        (latido vencido o sin valores transmitidos)
+     */
+    static bool isHeartbeatDue();
+
+    /**
+     * @brief Indica si las lecturas deben transmitirse
+     */
+    static bool shouldSend(const ReadingSet& readings);
+
+    /**
+     * @brief Guarda como referencia los canales de las lecturas transmitidas y reinicia
+     *        el latido. Las que PayloadPlanner dejó fuera de este despertar conservan su
+     *        último valor enviado (o NaN si cambió el esquema), así se siguen comparando.
+     * @param sentMask Lecturas que salieron (bit i = readings[i]); 0 = no hubo uplink
+     */
+    static void markSent(const ReadingSet& readings, uint32_t sentMask);
+
+    /**
+     * @brief Cuenta un despertar sin uplink para el latido
+     */
+    static void markSkipped();
+
+    /**
+     * @brief Olvida los valores transmitidos (el próximo despertar transmite)
+     */
+    static void reset();
+
+    /**
+     * @brief Banda muerta de un canal según el tipo de sensor
+     * @param channel Índice del subvalor (0 para sensores de un solo valor)
+     */
+    static Deadband deadband(SensorType type, uint8_t channel);
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*******************************************************************************************
+ * Archivo: include/SampleBatch.h
+ * Descripción: Lote de lecturas en RTC RAM para el modo store-and-forward. Cada
+ * despertar agrega un registro binario (desfase de tiempo + bitmap + valores) y el lote
+ * se envía en un solo uplink cuando se llena o vence LoRa::BATCH_MAX_LATENCY_S, de modo
+ * que los despertares intermedios no encienden la radio.
+ *******************************************************************************************/
+
+#ifndef SAMPLE_BATCH_H
+#define SAMPLE_BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "config.h"
+#include "sensor_types.h"
+
+class SampleBatch {
+public:
+    /**
+     * @brief Indica si el modo lote está activo (LoRa::BATCH_SIZE > 1)
+     */
+    static bool isEnabled() { return LoRa::BATCH_SIZE > 1; }
+
+    /**
+     * @brief Predice, antes de leer sensores, si este despertar tendrá que transmitir.
+     *        Permite lanzar la activación LoRaWAN en paralelo solo cuando hace falta.
+     * @param now Epoch actual
+     */
+    static bool willBeDue(uint32_t now);
+
+    /**
+     * @brief Agrega las lecturas del despertar al lote.
+     *        Si la lista de sensores cambió, el lote anterior se descarta.
+     * @param readings Lecturas del despertar
+     * @param now Epoch de la lectura
+     * @return false si el registro no cabe; hay que enviar el lote y volver a agregar
+     */
+    static bool append(const ReadingSet& readings, uint32_t now);
+
+    /**
+     * @brief Indica si el lote debe enviarse (lleno o con latencia vencida)
+     * @param now Epoch actual
+     */
+    static bool isDue(uint32_t now);
+
+    /**
+     * @brief Arma el uplink del lote (ver PayloadFormat::batchFrame)
+     * @return Tamaño del uplink, o 0 si el lote está vacío
+     */
+    static size_t buildFrame(uint8_t* buffer, size_t bufferSize);
+
+    /**
+     * @brief Pasa los registros del lote a OutageBuffer, con su epoch, y vacía el lote.
+     *        Para un lote que no cabe en el uplink del DR activo: el respaldo lo reparte
+     *        en uplinks que sí caben.
+     * @return Registros que aceptó el respaldo
+     */
+    static uint8_t moveToBacklog();
+
+    /**
+     * @brief Vacía el lote (tras un envío exitoso)
+     */
+    static void clear();
+
+    static uint8_t count();
+    static uint16_t schema();
+};
+
+#endif
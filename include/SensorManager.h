@@ -1,32 +1,15 @@
 #ifndef SENSOR_MANAGER_H
 #define SENSOR_MANAGER_H
 
-#include <Arduino.h>
-#include <vector>
-#include <memory>
+#include <cstddef>
+#include <new>
+#include <utility>
 #include "sensors/ISensor.h"
 #include "sensor_types.h"
 #include "config_manager.h"
+#include "SensorPlan.h"
 #include "sensors/ModbusSensor.h"
 #include "ModbusSensorManager.h"
-#include <ESP32Time.h>
-#include <OneWire.h>
-#include <DallasTemperature.h>
-#include "SHT31.h"
-#include <SPI.h>
-#include <Adafruit_MAX31865.h>
-#include <Adafruit_VEML7700.h>
-#include <map>
-#include <string>
-#include <Adafruit_BME680.h>
-#include <Adafruit_BME280.h>
-
-extern ESP32Time rtc;
-extern SPIClass spiLora;
-extern SPISettings spiAdcSettings;
-extern OneWire oneWire;
-extern DallasTemperature dallasTemp;
-extern SHT31 sht30Sensor;
 
 /**
  * @brief Clase que maneja la inicialización y lecturas de todos los sensores
@@ -35,7 +18,8 @@ extern SHT31 sht30Sensor;
 class SensorManager {
   public:
     /**
-     * @brief Carga las configuraciones y crea las instancias de los sensores.
+     * @brief Crea las instancias de los sensores. Usa el plan compilado en RTC RAM si
+     *        sigue vigente; si no, lee ConfigManager y vuelve a compilar el plan.
      */
     void registerSensorsFromConfig();
 
@@ -46,9 +30,14 @@ class SensorManager {
 
     /**
      * @brief Lee todos los sensores y devuelve las mediciones.
-     * @return Vector con todas las lecturas de sensores
+     *        Primero dispara todas las conversiones y luego recoge cada sensor
+     *        en cuanto está listo, de modo que el tiempo total es el de la
+     *        conversión más larga y no la suma de todas. Los sensores derivados
+     *        (dependsOn) se recogen después de su fuente.
+     * @return Lecturas del ciclo (en orden de registro). Viven en un búfer estático
+     *        que la siguiente llamada a readAll() sobrescribe.
      */
-    std::vector<SensorReading> readAll();
+    const ReadingSet& readAll();
 
 
     /**
@@ -61,11 +50,75 @@ class SensorManager {
     /**
      * @brief "Fábrica" para crear el objeto sensor correcto según su tipo.
      * @param config Configuración del sensor
-     * @return Puntero único al sensor creado
+     * @return Sensor construido en la arena, o nullptr si el tipo no existe o no hay espacio
      */
-    std::unique_ptr<ISensor> createSensor(const SensorConfig& config);
+    ISensor* createSensor(const SensorConfig& config);
 
-    std::vector<std::unique_ptr<ISensor>> _sensors;
+    /**
+     * @brief Crea el sensor descrito por una entrada del plan (sin acceder a NVS)
+     */
+    ISensor* createSensor(const SensorPlanEntry& entry);
+
+    /**
+     * @brief Sensor Modbus con el descriptor de su configuración
+     */
+    ISensor* createModbusSensor(const char* sensorId, SensorType type, uint8_t address,
+                                const ModbusDescriptor& descriptor);
+
+    /**
+     * @brief Registra el sensor y lo agrega al plan en compilación
+     * @param descriptor Descriptor de los sensores Modbus (nullptr en el resto)
+     * @return false si el plan no tiene espacio (el plan no se confirmará)
+     */
+    bool registerAndPlan(ISensor* sensor, const char* configKey, uint8_t modbusAddress,
+                         const ModbusDescriptor* descriptor = nullptr);
+
+    /**
+     * @brief Agrega el sensor a la lista de registrados
+     * @return false si se alcanzó MAX_READINGS (el sensor se destruye)
+     */
+    bool registerSensor(ISensor* sensor);
+
+    /**
+     * @brief Construye un sensor en la arena estática (placement new).
+     *        Los objetos se destruyen en bloque en releaseSensors().
+     */
+    template <typename T, typename... Args>
+    static ISensor* emplaceSensor(Args&&... args) {
+        size_t offset = (_arenaUsed + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (offset + sizeof(T) > System::SENSOR_ARENA_SIZE) {
+            return nullptr;
+        }
+        _arenaUsed = offset + sizeof(T);
+        return new (_arena + offset) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Índice del sensor que aporta la magnitud en este ciclo (ver
+     *        SensorPlan::waterTempSource()), o -1 si no hay ninguno registrado
+     */
+    int findSource(Quantity quantity) const;
+
+    /**
+     * @brief Publica en MeasurementCache las magnitudes de las que index es fuente
+     */
+    static void publishIfSource(const int* sources, size_t index, const SensorReading& reading);
+
+    /**
+     * @brief Lectura de error (NAN) para un sensor que no aporta medida en este ciclo
+     */
+    static void setErrorReading(SensorReading& reading, const ISensor* sensor);
+
+    /**
+     * @brief Destruye los sensores registrados y vacía la arena
+     */
+    void releaseSensors();
+
+    FixedVector<ISensor*, MAX_READINGS> _sensors;
+    ReadingSet _readings;
+
+    alignas(std::max_align_t) static uint8_t _arena[System::SENSOR_ARENA_SIZE];
+    static size_t _arenaUsed;
 
 };
 
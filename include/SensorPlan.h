@@ -0,0 +1,79 @@
+/*******************************************************************************************
+ * Archivo: include/SensorPlan.h
+ * Descripción: Plan de sensores compilado en RTC RAM. La primera vez (o cuando cambia la
+ * configuración) SensorManager lo arma a partir de ConfigManager; en los despertares
+ * siguientes instancia los sensores directamente desde el plan, sin abrir NVS.
+ * El plan guarda la generación de ConfigStore con la que se compiló: cualquier escritura
+ * de configuración (BLE) la cambia y el plan se vuelve a compilar. Los descriptores de
+ * los sensores Modbus se copian aparte, uno por sensor Modbus del plan.
+ *******************************************************************************************/
+
+#ifndef SENSOR_PLAN_H
+#define SENSOR_PLAN_H
+
+#include <stdint.h>
+#include "config.h"
+#include "sensor_types.h"
+
+/**
+ * @brief Un sensor del plan: lo necesario para instanciarlo y alimentarlo sin leer NVS
+ */
+struct SensorPlanEntry {
+    char sensorId[20];
+    char configKey[8];      // Selecciona el canal en los sensores ADC (p.ej. NTC100K "0"/"1")
+    uint8_t type;           // SensorType
+    uint8_t bus;            // CommunicationProtocol
+    uint8_t rail;           // PowerRequirement
+    uint8_t modbusAddress;  // Solo sensores Modbus
+    uint8_t modbusDescriptor; // Solo sensores Modbus: índice en modbusDescriptor()
+};
+
+class SensorPlan {
+public:
+    /**
+     * @brief Indica si el plan en RTC es íntegro y corresponde a la configuración actual
+     * @param generation ConfigStore::generation()
+     */
+    static bool isValid(uint32_t generation);
+
+    /**
+     * @brief Vacía el plan para compilarlo de nuevo
+     */
+    static void reset();
+
+    /**
+     * @brief Agrega un sensor al plan en compilación
+     * @param descriptor Registros del sensor Modbus (nullptr en el resto)
+     * @return false si el plan está lleno
+     */
+    static bool add(const char* sensorId, const char* configKey, SensorType type,
+                    uint8_t bus, uint8_t rail, uint8_t modbusAddress,
+                    const ModbusDescriptor* descriptor = nullptr);
+
+    /**
+     * @brief Fija el sensorId de la temperatura de compensación del plan en compilación
+     *        (ConfigManager::getWaterTempSourceId, "" = el N10K)
+     */
+    static void setWaterTempSource(const char* sensorId);
+
+    /**
+     * @brief sensorId de la temperatura de compensación ("" = el N10K)
+     */
+    static const char* waterTempSource();
+
+    /**
+     * @brief Cierra el plan (CRC) y lo marca válido para la generación indicada
+     */
+    static void commit(uint32_t generation);
+
+    /**
+     * @brief Indica si algún sensor del plan usa el riel indicado (PowerRequirement)
+     */
+    static bool usesRail(uint8_t rail);
+
+    static uint8_t count();
+    static const SensorPlanEntry& entry(uint8_t index);
+    static const ModbusDescriptor& modbusDescriptor(const SensorPlanEntry& entry);
+};
+
+#endif
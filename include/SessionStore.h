@@ -0,0 +1,90 @@
+/*******************************************************************************************
+ * Archivo: include/SessionStore.h
+ * Descripción: Copia en flash de la sesión LoRaWAN para sobrevivir a un corte de energía.
+ * La sesión de RadioLib vive en RTC RAM (se pierde sin alimentación) y los nonces ya se
+ * guardan en NVS; sin esta copia, un reinicio en frío obliga a un nuevo join.
+ *
+ * Las copias rotan entre LoRa::SESSION_SLOTS claves de JsonKeys::NS_LORA_SESSION, cada
+ * una con número de secuencia, FCntUp y CRC16; al restaurar gana la de mayor secuencia
+ * cuyo CRC es válido, de modo que una escritura cortada a la mitad solo invalida su
+ * propia ranura. Solo se escribe cada LoRa::SESSION_SAVE_INTERVAL incrementos de FCntUp
+ * (o al iniciar una sesión nueva), lo que acota el desgaste de la flash.
+ *
+ * Como la copia puede ir atrasada respecto de la sesión real, al restaurarla se adelanta
+ * FCntUp en counterGap(): el servidor descarta los uplinks con contadores ya usados.
+ * Solo depende de la HAL: la rotación y la restauración se prueban en native.
+ *******************************************************************************************/
+
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * @brief Cabecera de cada ranura; la sigue la sesión (length bytes)
+ */
+struct SessionSlotHeader {
+    uint8_t version;        // SessionStore::VERSION
+    uint8_t reserved;
+    uint16_t crc;           // CRC16 desde 'sequence' hasta el final de la sesión
+    uint32_t sequence;      // Crece en cada escritura: la mayor es la más reciente
+    uint32_t fcntUp;        // FCntUp de la sesión guardada
+    uint16_t length;        // Bytes de sesión
+    uint16_t reserved2;
+};
+
+class SessionStore {
+public:
+    static constexpr uint8_t VERSION = 1;
+
+    /**
+     * @brief Indica si toca guardar: nunca se guardó en este arranque, FCntUp avanzó
+     *        LoRa::SESSION_SAVE_INTERVAL desde la última copia o volvió atrás (sesión nueva)
+     */
+    static bool isDue(uint32_t fcntUp);
+
+    /**
+     * @brief Escribe la sesión en la ranura siguiente a la más reciente
+     * @return false si no cabe en LoRa::SESSION_MAX_SIZE o falló la escritura
+     */
+    static bool save(const uint8_t* session, uint16_t length, uint32_t fcntUp);
+
+    /**
+     * @brief Lee la copia válida más reciente
+     * @param length Bytes de sesión leídos
+     * @param fcntUp FCntUp con el que se guardó
+     * @return false si no hay ninguna ranura válida que quepa en maxLength
+     */
+    static bool load(uint8_t* session, uint16_t maxLength, uint16_t& length, uint32_t& fcntUp);
+
+    /**
+     * @brief Adelanta en gap el FCntUp (uint32) que el búfer de sesión guarda en offset y
+     *        corrige la firma de RadioLib (XOR de palabras de 16 bits en los dos últimos
+     *        bytes). El orden de bytes del contador y de la firma se deduce del propio
+     *        búfer, comparando con fcntUp y con la firma recalculada.
+     * @return false si el búfer no coincide con lo esperado (no se modifica)
+     */
+    static bool advanceFCntUp(uint8_t* session, uint16_t length, uint16_t offset, uint32_t fcntUp,
+                              uint32_t gap);
+
+    /**
+     * @brief Incrementos de FCntUp que pudo haber tras la copia restaurada: hasta un
+     *        intervalo sin guardar, otro si la última escritura se cortó, y los uplinks
+     *        del despertar en que se cortó la energía
+     */
+    static uint32_t counterGap();
+
+    /**
+     * @brief Borra todas las ranuras
+     */
+    static void clear();
+
+    /**
+     * @brief Escrituras hechas desde el arranque en frío
+     */
+    static uint32_t writes();
+};
+
+#endif
@@ -25,12 +25,15 @@ public:
      * @param node Referencia al nodo LoRaWAN para guardar sesión
      * @param LWsession Buffer para almacenar la sesión LoRaWAN
      * @param spiLora Referencia al objeto SPI para LoRa
+     * @param saveSession false si la radio no se activó en este despertar; se conserva
+     *                    la sesión que ya está en RTC en lugar de sobrescribirla
      */
     static void goToDeepSleep(uint32_t timeToSleep,
                              SX1262* radio,
                              LoRaWANNode& node,
                              uint8_t* LWsession,
-                             SPIClass& spiLora);
+                             SPIClass& spiLora,
+                             bool saveSession = true);
 
     /**
      * @brief Configura los pines no utilizados en alta impedancia para reducir el consumo durante deep sleep.
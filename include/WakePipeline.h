@@ -0,0 +1,127 @@
+/*******************************************************************************************
+ * Archivo: include/WakePipeline.h
+ * Descripción: Ciclo de despertar en paralelo sobre los dos núcleos del ESP32-S3.
+ * Una tarea activa la radio y restaura la sesión LoRaWAN mientras otra inicializa
+ * y lee los sensores; las lecturas se entregan por una cola al envío.
+ *******************************************************************************************/
+
+#ifndef WAKE_PIPELINE_H
+#define WAKE_PIPELINE_H
+
+#include <Arduino.h>
+#include <RadioLib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/event_groups.h"
+#include "sensor_types.h"
+#include "SensorManager.h"
+
+/**
+ * @brief Marcas de tiempo (micros()) de cada fase del ciclo en paralelo.
+ *        Un valor 0 indica que la fase no llegó a ejecutarse.
+ */
+struct WakeTimeline {
+    uint32_t pipelineStartUs;
+    uint32_t loraStartUs;
+    uint32_t radioReadyUs;
+    uint32_t loraEndUs;
+    uint32_t sensorsStartUs;
+    uint32_t sensorsBeginEndUs;
+    uint32_t sensorsEndUs;
+    uint32_t handoffUs;
+};
+
+class WakePipeline {
+public:
+    /**
+     * @brief Lanza las tareas de activación LoRaWAN y de adquisición de sensores.
+     * @param radio Módulo de radio SX1262
+     * @param node Nodo LoRaWAN a activar
+     * @param sensors Gestor de sensores a inicializar y leer
+     * @param withLoRa false para no encender la radio en este despertar (modo lote);
+     *                 puede lanzarse después con startLoRa()
+     * @return true si las tareas se crearon correctamente
+     */
+    static bool start(SX1262& radio, LoRaWANNode& node, SensorManager& sensors, bool withLoRa = true);
+
+    /**
+     * @brief Lanza la activación LoRaWAN si no se lanzó en start()
+     * @return true si la tarea está en marcha o ya terminó
+     */
+    static bool startLoRa();
+
+    /**
+     * @brief Indica si en este despertar se encendió la radio
+     */
+    static bool isLoRaStarted() { return loraStarted; }
+
+    /**
+     * @brief Indica si la tarea LoRa terminó con una sesión activa (nueva o restaurada),
+     *        único caso en que el búfer de sesión del nodo vale la pena guardarlo
+     */
+    static bool hasSession();
+
+    /**
+     * @brief Indica si el pipeline ya fue lanzado en este despertar.
+     */
+    static bool isStarted() { return started; }
+
+    /**
+     * @brief Espera a que la tarea de sensores entregue sus lecturas por la cola.
+     * @param timeoutMs Tiempo máximo de espera
+     * @return Puntero a las lecturas, o nullptr si se agotó el tiempo
+     */
+    static const ReadingSet* waitForReadings(uint32_t timeoutMs);
+
+    /**
+     * @brief Espera a que termine la activación LoRaWAN.
+     * @param timeoutMs Tiempo máximo de espera
+     * @return Estado devuelto por LoRaManager::lwActivate (o error de radio/timeout)
+     */
+    static int16_t waitForLoRa(uint32_t timeoutMs);
+
+    /**
+     * @brief Espera a que la tarea de sensores salga. Si no sale a tiempo se suspende,
+     *        para que no siga usando el bus cuando se apague su alimentación.
+     * @param timeoutMs Tiempo máximo de espera
+     * @return true si la tarea terminó por sí sola (o no se lanzó)
+     */
+    static bool stopSensors(uint32_t timeoutMs);
+
+    /**
+     * @brief Espera a que salgan las dos tareas antes de dormir; las que no salen a
+     *        tiempo se suspenden para que no usen la radio ni el bus durante el apagado.
+     * @param timeoutMs Tiempo máximo de espera
+     * @return true si todas las tareas lanzadas terminaron por sí solas
+     */
+    static bool stop(uint32_t timeoutMs);
+
+    /**
+     * @brief Imprime la duración de cada fase y cuánto se solaparon.
+     */
+    static void printTimeline();
+
+    static const WakeTimeline& getTimeline() { return timeline; }
+
+private:
+    static void loraTask(void* param);
+    static void sensorTask(void* param);
+    static bool stopTask(TaskHandle_t task, EventBits_t doneBit, uint32_t timeoutMs);
+
+    static bool started;
+    static bool loraStarted;
+    static SX1262* radioModule;
+    static LoRaWANNode* loraNode;
+    static SensorManager* sensorManager;
+
+    static TaskHandle_t loraTaskHandle;
+    static TaskHandle_t sensorTaskHandle;
+    static QueueHandle_t readingsQueue;
+    static EventGroupHandle_t events;
+    static volatile int16_t loraState;
+    static const ReadingSet* readings;
+    static WakeTimeline timeline;
+};
+
+#endif
@@ -0,0 +1,105 @@
+/*******************************************************************************************
+ * Archivo: include/WakeProfiler.h
+ * Descripción: Perfilador ligero de las fases del ciclo de despertar.
+ * Registra spans en microsegundos en un buffer circular en RTC RAM (sobrevive al
+ * deep sleep) y agrega min/media/max/p95 por fase a lo largo de los despertares.
+ *******************************************************************************************/
+
+#ifndef WAKE_PROFILER_H
+#define WAKE_PROFILER_H
+
+#include <stdint.h>
+#include "config.h"
+#include "hal/Hal.h"
+
+/**
+ * @brief Fases medidas en cada ciclo de despertar.
+ */
+enum WakePhase : uint8_t {
+    PHASE_WAKEUP_CAUSE = 0,   // SleepManager::handleWakeupCause
+    PHASE_CONFIG_LOAD,        // Configuración desde RTC o NVS
+    PHASE_HARDWARE_INIT,      // HardwareManager::initHardware
+    PHASE_SENSORS_BEGIN,      // beginAll (total) / begin() de cada sensor
+    PHASE_SENSORS_READ,       // readAll (total) / lectura de cada sensor
+    PHASE_RADIO_BEGIN,        // radio.begin
+    PHASE_LORA_ACTIVATE,      // LoRaManager::lwActivate
+    PHASE_PAYLOAD_BUILD,      // createDelimitedPayload
+    PHASE_UPLINK,             // node.uplink
+    PHASE_SLEEP_ENTRY,        // goToDeepSleep hasta esp_deep_sleep_start
+    PHASE_WAKE_TOTAL,         // Desde el arranque hasta entrar en deep sleep
+    PHASE_COUNT
+};
+
+/**
+ * @brief Span individual guardado en el buffer circular.
+ *        tag identifica el sensor (índice de registro) o PROFILER_NO_TAG.
+ */
+struct ProfileSpan {
+    uint16_t wake;
+    uint8_t phase;
+    uint8_t tag;
+    uint32_t durationUs;
+};
+
+/**
+ * @brief Estadísticas agregadas de una fase.
+ */
+struct PhaseStats {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t meanUs;
+    uint32_t maxUs;
+    uint32_t p95Us;
+};
+
+static const uint8_t PROFILER_NO_TAG = 0xFF;
+
+class WakeProfiler {
+public:
+    /**
+     * @brief Inicia el perfilado de un nuevo despertar.
+     * @param wakeupCount Contador de despertares (se guarda en cada span)
+     */
+    static void beginWake(uint32_t wakeupCount);
+
+    /**
+     * @brief Marca de tiempo actual en microsegundos desde el arranque.
+     */
+    static uint32_t now() { return HalClock::micros(); }
+
+    /**
+     * @brief Registra un span que empezó en startUs y termina ahora.
+     * @param phase Fase medida
+     * @param startUs Marca obtenida con now() al inicio de la fase
+     * @param tag Índice del sensor para spans por-sensor; PROFILER_NO_TAG para el total de la fase.
+     *            Solo los spans sin tag alimentan las estadísticas por fase.
+     */
+    static void record(WakePhase phase, uint32_t startUs, uint8_t tag = PROFILER_NO_TAG);
+
+    /**
+     * @brief Incorpora las fases del despertar actual a las estadísticas.
+     *        Se llama justo antes de entrar en deep sleep.
+     */
+    static void commitWake();
+
+    /**
+     * @brief Obtiene min/media/max/p95 de una fase a lo largo de los despertares.
+     *        min/media/max cubren todos los despertares desde el último reset;
+     *        el p95 se calcula sobre los últimos PROFILER_STATS_WINDOW.
+     */
+    static PhaseStats getStats(WakePhase phase);
+
+    /**
+     * @brief Imprime las fases del despertar actual y las estadísticas acumuladas.
+     */
+    static void printReport();
+
+    /**
+     * @brief Borra spans y estadísticas.
+     */
+    static void reset();
+
+    static const char* phaseName(WakePhase phase);
+};
+
+#endif
@@ -2,6 +2,10 @@
 #define CONFIG_H
 
 #include <stdint.h>
+#include <stddef.h>
+#ifdef ARDUINO
+#include <Arduino.h>  // SERIAL_8N1
+#endif
 #include "sensor_types.h"
 
 // =========================================================================
@@ -19,9 +23,58 @@ namespace System {
     constexpr uint16_t JSON_DOC_SIZE_LARGE = 2048;
 
     constexpr uint32_t MODBUS_BAUD_RATE = 9600;
+#ifdef ARDUINO
     constexpr uint32_t MODBUS_SERIAL_CONFIG = SERIAL_8N1;
-    constexpr uint16_t MODBUS_RESPONSE_TIMEOUT = 300;
+#endif
+    constexpr uint16_t MODBUS_RESPONSE_TIMEOUT = 300;     // Máximo; se adapta por esclavo (ver ModbusLinkStats)
     constexpr uint8_t MODBUS_MAX_RETRY = 3;
+    constexpr uint16_t MODBUS_MIN_RESPONSE_TIMEOUT = 30;
+    constexpr uint16_t MODBUS_TIMEOUT_MARGIN_MS = 20;     // Sobre latencia media + 4 desviaciones
+    constexpr uint8_t MODBUS_BACKOFF_AFTER_FAILURES = 2;  // Ciclos seguidos sin respuesta
+    constexpr uint8_t MODBUS_BACKOFF_MAX_CYCLES = 32;     // Tope del backoff exponencial
+    constexpr uint8_t MODBUS_MAX_SLAVES = 8;              // Esclavos con estadísticas en RTC
+    // Calentamiento de las sondas tras encender los 12 V: lecturas cortas de sondeo hasta
+    // que cada esclavo da un valor plausible (ver ModbusSensorManager)
+    constexpr uint16_t MODBUS_PROBE_TIMEOUT_MS = 50;
+    constexpr uint16_t MODBUS_PROBE_INTERVAL_MS = 200;
+    constexpr uint16_t MODBUS_WARMUP_MAX_MS = 5000;       // Tipos sin tiempo propio
+    constexpr uint8_t MODBUS_RX_IDLE_SYMBOLS = 4;       // Fin de trama: >= T3.5 caracteres sin bytes
+    constexpr uint8_t MODBUS_QUEUE_SIZE = 64;           // Peticiones encoladas por ciclo (ver ModbusRtu)
+
+    // Agrupación de lecturas Modbus (ver ModbusRegisterMap). A 9600 baudios cada
+    // transacción cuesta ~10 caracteres de trama más el retardo de respuesta del esclavo,
+    // y cada registro de hueco solo 2 bytes: se leen huecos de hasta MODBUS_COALESCE_GAP
+    // registros para ahorrar idas y vueltas. 0 = solo registros contiguos.
+    constexpr uint8_t MODBUS_COALESCE_GAP = 8;
+    constexpr uint8_t MODBUS_MAX_BLOCK_REGISTERS = 125;   // Límite de la función 0x03/0x04
+    constexpr uint8_t MODBUS_MAX_POINTS = 32;             // Puntos registrados por ciclo
+    constexpr uint16_t MODBUS_BATCH_REGISTERS = 256;      // Registros leídos por ciclo
+
+    // Pipeline de despertar en doble núcleo (ver WakePipeline)
+    constexpr uint32_t PIPELINE_TASK_STACK_SIZE = 8192;
+    constexpr uint8_t PIPELINE_TASK_PRIORITY = 2;
+    constexpr uint8_t LORA_TASK_CORE = 0;
+    constexpr uint8_t SENSOR_TASK_CORE = 1;
+    constexpr uint32_t PIPELINE_SENSORS_TIMEOUT_MS = 20000;
+    constexpr uint32_t PIPELINE_LORA_TIMEOUT_MS = 60000;
+    constexpr uint32_t PIPELINE_STOP_TIMEOUT_MS = 5000;   // Margen para que las tareas salgan
+
+    // Perfilador de fases del ciclo de despertar (ver WakeProfiler, vive en RTC RAM)
+    constexpr uint8_t PROFILER_SPAN_RING_SIZE = 48;   // Spans individuales (incluye por-sensor)
+    constexpr uint8_t PROFILER_STATS_WINDOW = 20;     // Despertares usados para el p95
+
+    // Imagen binaria de configuración (ver ConfigStore). Cambiar la versión al modificar
+    // ConfigImage fuerza la migración desde los namespaces JSON anteriores.
+    constexpr uint8_t CONFIG_IMAGE_VERSION = 3;
+    constexpr uint8_t CONFIG_MAX_SENSORS = 16;
+    constexpr uint8_t CONFIG_MAX_MODBUS_SENSORS = 8;
+    constexpr uint8_t CONFIG_MAX_ADC_SENSORS = 8;
+
+    // Plan de sensores compilado en RTC RAM (ver SensorPlan), incluye la batería
+    constexpr uint8_t SENSOR_PLAN_MAX_ENTRIES = 16;
+
+    // Arena estática donde SensorManager construye los sensores (sin heap por despertar)
+    constexpr size_t SENSOR_ARENA_SIZE = 4096;
 }
 
 // =========================================================================
@@ -93,6 +146,47 @@ namespace LoRa {
     constexpr uint32_t SPI_CLOCK = 1000000;
     constexpr uint16_t MAX_PAYLOAD = 200;
 
+    // Formato del payload de uplink (ver PayloadFormat.h)
+    enum class PayloadType : uint8_t {
+        DELIMITED,  // Texto "st|dev|bat|ts|id,tipo,v..." (formato original)
+        BINARY,     // Binario compacto con schemaId y bitmap de ausentes
+        DELTA       // Keyframe binario periódico y luego diferencias varint (DeltaEncoder)
+    };
+    constexpr PayloadType PAYLOAD_TYPE = PayloadType::BINARY;
+    constexpr uint8_t FPORT_DELIMITED = 1;
+    constexpr uint8_t FPORT_BINARY = 2;
+    constexpr uint8_t FPORT_SCHEMA = 3;
+    constexpr uint16_t SCHEMA_ANNOUNCE_INTERVAL = 96;  // Reenviar el esquema cada N uplinks binarios
+    constexpr uint8_t FPORT_KEYFRAME = 5;
+    constexpr uint8_t FPORT_DELTA = 6;
+    constexpr uint8_t DELTA_KEYFRAME_INTERVAL = 16;    // Un keyframe cada N uplinks (máx. 32)
+
+    // Modo lote (store-and-forward, ver SampleBatch): las lecturas de varios despertares
+    // se acumulan en RTC RAM y se envían en un solo uplink binario por FPORT_BATCH.
+    // BATCH_SIZE = 1 desactiva el modo lote (un uplink por despertar).
+    constexpr uint8_t BATCH_SIZE = 1;
+    constexpr uint32_t BATCH_MAX_LATENCY_S = 3600;     // Enviar aunque el lote no esté lleno
+    constexpr uint8_t FPORT_BATCH = 4;
+
+    // Report-by-exception (ver ReportFilter, solo sin modo lote): si ningún canal se movió
+    // más que su banda muerta desde el último uplink no se transmite y la radio no se
+    // enciende, salvo un latido cada REPORT_HEARTBEAT_CYCLES despertares.
+    constexpr bool REPORT_BY_EXCEPTION = false;
+    constexpr uint16_t REPORT_HEARTBEAT_CYCLES = 12;
+
+    // Bandas muertas: un canal cambió si |v - último| > max(absoluta, relativa * |último|)
+    namespace ReportDeadband {
+        constexpr float TEMPERATURE_ABS = 0.2f;     // °C
+        constexpr float PERCENT_ABS = 1.0f;         // % (humedad relativa y de suelo)
+        constexpr float PH_ABS = 0.05f;
+        constexpr float BATTERY_ABS = 0.05f;        // V
+        constexpr float CONDUCTIVITY_REL = 0.02f;
+        constexpr float LIGHT_REL = 0.10f;
+        constexpr float CO2_ABS = 20.0f;            // ppm
+        constexpr float PRESSURE_REL = 0.001f;
+        constexpr float DEFAULT_REL = 0.01f;        // Canales sin banda propia
+    }
+
     // Usar pines definidos en ::Pins::LoRaSPI
     constexpr uint8_t NSS_PIN = ::Pins::LoRaSPI::NSS;
     constexpr uint8_t BUSY_PIN = ::Pins::LoRaSPI::BUSY;
@@ -138,7 +232,9 @@ namespace LoRa {
      * - DR0 a DR3 se usan para uplink en los 64 canales de 125kHz.
      * - DR4 se usa para uplink en los 8 canales de 500kHz.
      * - DR8 a DR13 se usan para downlink en los 8 canales de 500kHz.
-     * - El payload máximo puede verse afectado por la opción FOpt en el MAC layer.
+     * - El payload máximo es el del MACPayload: la aplicación dispone de 8 bytes menos
+     *   (FHDR y FPort) y además de los comandos MAC que viajen en FOpts. PayloadPlanner
+     *   ajusta los uplinks a ese presupuesto.
      *
      * Uso recomendado:
      *   LoRaManager::setDatarate(node, 3);  // DR3 = SF7BW125, buen balance velocidad/alcance
@@ -146,6 +242,46 @@ namespace LoRa {
 
     // Data Rate por defecto (DR3 = SF7BW125)
     constexpr uint8_t DEFAULT_DATARATE = 3;
+
+    // Presupuesto de payload (ver PayloadPlanner): las lecturas que no caben en el máximo
+    // del DR activo se reparten en hasta MAX_FRAMES_PER_WAKE uplinks y, si aun así no
+    // caben, las de menor prioridad rotan entre despertares; ninguna pasa más de
+    // REPORT_MAX_WAKES despertares sin reportarse mientras el total quepa en ese número
+    // de frames. FOPTS_RESERVE deja lugar a los comandos MAC que encola la aplicación
+    // (DeviceTimeReq, LinkCheckReq: 1 byte cada uno).
+    constexpr uint8_t MAX_FRAMES_PER_WAKE = 2;
+    constexpr uint8_t REPORT_MAX_WAKES = 4;
+    constexpr uint8_t FOPTS_RESERVE = 2;
+
+    // Copia de la sesión LoRaWAN en flash (ver SessionStore): la sesión vive en RTC RAM y
+    // se guarda en NVS cada SESSION_SAVE_INTERVAL incrementos de FCntUp, rotando entre
+    // SESSION_SLOTS claves. Tras un corte de energía se restaura la copia más reciente
+    // adelantando FCntUp en SessionStore::counterGap() para no repetir contadores.
+    constexpr uint8_t SESSION_SLOTS = 4;
+    constexpr uint16_t SESSION_SAVE_INTERVAL = 16;
+    constexpr uint16_t SESSION_FCNT_MARGIN = 8;         // Uplinks de un despertar antes de guardar
+    constexpr uint16_t SESSION_MAX_SIZE = 512;
+
+    // Join OTAA (ver JoinScheduler): tras un join fallido los despertares siguientes no
+    // transmiten hasta que vence un backoff exponencial con jitter (de JOIN_BACKOFF_BASE_S
+    // a JOIN_BACKOFF_MAX_S). Cada intento baja un DR, de JOIN_DR_MAX a JOIN_DR_MIN, y
+    // vuelve a empezar. Los Join-Request de 24 h no pueden sumar más de
+    // JOIN_DAILY_AIRTIME_MS de tiempo en el aire.
+    constexpr uint8_t JOIN_DR_MAX = 3;
+    constexpr uint8_t JOIN_DR_MIN = 0;
+    constexpr uint32_t JOIN_BACKOFF_BASE_S = 60;
+    constexpr uint32_t JOIN_BACKOFF_MAX_S = 6 * 3600;
+    constexpr uint32_t JOIN_DAILY_AIRTIME_MS = 10000;
+
+    // Tras el join, DeviceTimeReq se intenta una vez por despertar en los próximos
+    // TIME_SYNC_ATTEMPTS despertares; mientras falte la hora las lecturas se guardan.
+    constexpr uint8_t TIME_SYNC_ATTEMPTS = 3;
+
+    // Lecturas guardadas en RTC RAM mientras no hay sesión (ver OutageBuffer). Al volver
+    // la sesión se envían en uplinks de lote por FPORT_BATCH, hasta OUTAGE_FLUSH_FRAMES
+    // por despertar; si se llena se descartan las más antiguas.
+    constexpr uint16_t OUTAGE_BUFFER_SIZE = 1024;
+    constexpr uint8_t OUTAGE_FLUSH_FRAMES = 2;
 }
 
 // =========================================================================
@@ -160,6 +296,7 @@ namespace BLE {
     constexpr const char* CHAR_NTC10K_UUID = "2A39";
     constexpr const char* CHAR_CONDUCTIVITY_UUID = "2A3C";
     constexpr const char* CHAR_PH_UUID = "2A3B";
+    constexpr const char* CHAR_MODBUS_UUID = "2A42";
     constexpr const char* DEVICE_PREFIX = "AGRICOS-";
 
     constexpr uint32_t CONFIG_TRIGGER_TIME_MS = 5000;
@@ -183,6 +320,9 @@ namespace JsonKeys {
     constexpr const char* NS_NTC10K = "ntc_10k";
     constexpr const char* NS_COND = "cond";
     constexpr const char* NS_PH = "ph";
+    constexpr const char* NS_CALIBRATION = "calib";     // Coeficientes resueltos (blob binario)
+    constexpr const char* NS_CONFIG = "config";         // Imagen binaria de configuración
+    constexpr const char* KEY_CONFIG_IMAGE = "image";
 
     // Claves generales
     constexpr const char* KEY_INITIALIZED = "initialized";
@@ -192,7 +332,7 @@ namespace JsonKeys {
     constexpr const char* KEY_VOLT = "volt";
     constexpr const char* KEY_SENSOR = "k";
     constexpr const char* KEY_SENSOR_ID = "id";
-    constexpr const char* KEY_SENSOR_ID_TEMPERATURE = "ts";
+    constexpr const char* KEY_SENSOR_ID_TEMPERATURE = "ts";   // Fuente de temperatura del agua
     constexpr const char* KEY_SENSOR_TYPE = "t";
     constexpr const char* KEY_SENSOR_ENABLE = "e";
 
@@ -208,6 +348,13 @@ namespace JsonKeys {
     constexpr const char* KEY_MODBUS_SENSOR_TYPE = "t";
     constexpr const char* KEY_MODBUS_SENSOR_ADDR = "a";
     constexpr const char* KEY_MODBUS_SENSOR_ENABLE = "e";
+    constexpr const char* KEY_MODBUS_POINTS = "p";          // Descriptor: lista de puntos
+    constexpr const char* KEY_MODBUS_POINT_REG = "r";
+    constexpr const char* KEY_MODBUS_POINT_FUNCTION = "f";  // 3 holding, 4 input
+    constexpr const char* KEY_MODBUS_POINT_TYPE = "d";      // ModbusDataType
+    constexpr const char* KEY_MODBUS_POINT_ORDER = "o";     // MODBUS_ORDER_*
+    constexpr const char* KEY_MODBUS_POINT_SCALE = "s";
+    constexpr const char* KEY_MODBUS_POINT_OFFSET = "of";
 
     // Claves ADC
     constexpr const char* KEY_ADC_SENSOR = "k";
@@ -222,6 +369,9 @@ namespace JsonKeys {
     constexpr const char* KEY_NTC100K_R2 = "n100k_r2";
     constexpr const char* KEY_NTC100K_T3 = "n100k_t3";
     constexpr const char* KEY_NTC100K_R3 = "n100k_r3";
+    constexpr const char* KEY_NTC100K_VREF = "n100k_vr";    // Divisor: Vref en mV
+    constexpr const char* KEY_NTC100K_RFIXED = "n100k_rf";  // Divisor: resistencia fija
+    constexpr const char* KEY_NTC100K_TOP = "n100k_top";    // Divisor: NTC a Vref
 
     // Claves NTC10K
     constexpr const char* KEY_NTC10K_T1 = "n10k_t1";
@@ -230,6 +380,9 @@ namespace JsonKeys {
     constexpr const char* KEY_NTC10K_R2 = "n10k_r2";
     constexpr const char* KEY_NTC10K_T3 = "n10k_t3";
     constexpr const char* KEY_NTC10K_R3 = "n10k_r3";
+    constexpr const char* KEY_NTC10K_VREF = "n10k_vr";
+    constexpr const char* KEY_NTC10K_RFIXED = "n10k_rf";
+    constexpr const char* KEY_NTC10K_TOP = "n10k_top";
 
     // Claves Conductividad
     constexpr const char* KEY_CONDUCT_CT = "c_ct";
@@ -264,18 +417,54 @@ namespace Sensors {
     constexpr float RNOMINAL = 100.0f;
     constexpr uint32_t SPI_RTD_CLOCK = 1000000;
 
+    // DS18B20 en bus 1-Wire multipunto (ver DS18B20Bus). La configKey del sensor elige
+    // la sonda y, opcionalmente, su resolución: "D" = sonda 0, "D3" = sonda 3, "D3:10"
+    constexpr uint8_t DS18B20_MAX_PROBES = 12;
+    constexpr uint8_t DS18B20_DEFAULT_RESOLUTION = 12;
+
+    // Fuente de temperatura para compensar pH y conductividad (ver MeasurementCache) por
+    // defecto; se configura por BLE (JsonKeys::KEY_SENSOR_ID_TEMPERATURE) y queda en
+    // ConfigImage. sensorId del sensor elegido (NTC, DS18B20, RTD, MT05...); vacío = el
+    // sensor N10K si está registrado. Sin fuente registrada se lee el NTC10K directamente.
+    constexpr const char* DEFAULT_WATER_TEMP_SOURCE_ID = "";
+
+    // Adquisición ADC sobremuestreada (ver AdcSampler): muestras por canal y cuántas se
+    // descartan en cada extremo antes de promediar (media recortada)
+    constexpr uint8_t ADC_OVERSAMPLE_COUNT = 16;
+    constexpr uint8_t ADC_TRIM_COUNT = 2;
+    constexpr uint8_t ADC_MAX_CHANNELS = 8;
+    // Ráfaga por DMA del controlador digital del ADC (ver HalAdc::readBurst): frecuencia
+    // de conversión y espera máxima por la ráfaga completa
+    constexpr uint32_t ADC_BURST_SAMPLE_RATE_HZ = 20000;
+    constexpr uint32_t ADC_BURST_TIMEOUT_MS = 50;
+
     // Límites NTC
     constexpr float NTC_TEMP_MIN = -20.0f;
     constexpr float NTC_TEMP_MAX = 100.0f;
 
     // Tiempos
     constexpr uint16_t POWER_STABILIZE_DELAY_MS = 20; 
+    constexpr uint32_t MEASUREMENT_TIMEOUT_MS = 12000; // Máximo de espera por conversiones en readAll()
 }
 
 // =========================================================================
 // 7. CALIBRACIÓN DE SENSORES
 // =========================================================================
 namespace Calibration {
+    // Versión del blob de coeficientes en NVS (CalibrationStore); cambiarla al
+    // modificar CalibrationCoeffs fuerza a resolverlos de nuevo desde el JSON
+    constexpr uint8_t COEFFS_VERSION = 3;
+    constexpr const char* KEY_COEFFS = "coeffs";
+
+    // Kernels de pH y conductividad: float (FPU de precisión simple del S3) o punto fijo
+    // en enteros (CalibrationFixed). Ambos quedan dentro de la precisión de los sensores;
+    // ver el barrido de error en test/test_calibration y el tiempo por llamada en el
+    // programa native. Los NTC se leen siempre por tabla (NTC_LUT_SEGMENTS).
+    constexpr bool FIXED_POINT_KERNELS = false;
+
+    // Tabla voltaje -> temperatura de los NTC (NtcTable): segmentos entre 0 y Vref
+    constexpr uint16_t NTC_LUT_SEGMENTS = 128;
+
     // Batería
     constexpr float BATTERY_R1 = 100000.0f;
     constexpr float BATTERY_R2 = 390000.0f;
@@ -289,6 +478,10 @@ namespace Calibration {
         constexpr float DEFAULT_R2 = 64770.0f;
         constexpr float DEFAULT_T3 = 45.0f;
         constexpr float DEFAULT_R3 = 42530.0f;
+        // Divisor: 3V --- NTC100K --- [medida] --- 100K --- GND
+        constexpr uint16_t DEFAULT_VREF_MV = 3000;
+        constexpr uint32_t DEFAULT_R_FIXED = 100000;
+        constexpr bool DEFAULT_NTC_TOP = true;
     }
 
     // NTC 10K
@@ -299,6 +492,10 @@ namespace Calibration {
         constexpr float DEFAULT_R2 = 6477.0f;
         constexpr float DEFAULT_T3 = 45.0f;
         constexpr float DEFAULT_R3 = 4253.0f;
+        // Divisor: 3V --- NTC10K --- [medida] --- 10K --- GND
+        constexpr uint16_t DEFAULT_VREF_MV = 3000;
+        constexpr uint32_t DEFAULT_R_FIXED = 10000;
+        constexpr bool DEFAULT_NTC_TOP = true;
     }
 
     // Conductividad
@@ -341,8 +538,16 @@ namespace DEFAULT_CONFIGS {
         {"MT05", "MT05_2", MT05S, true} \
     }
 
+    // ENV4: humedad, temperatura, presión e iluminación en float big-endian desde el 500
+    #define DEFAULT_ENV4_DESCRIPTOR {4, { \
+        {500, MODBUS_FUNCTION_HOLDING, (uint8_t)ModbusDataType::F32, 0, 1.0f, 0.0f}, \
+        {502, MODBUS_FUNCTION_HOLDING, (uint8_t)ModbusDataType::F32, 0, 1.0f, 0.0f}, \
+        {504, MODBUS_FUNCTION_HOLDING, (uint8_t)ModbusDataType::F32, 0, 1.0f, 0.0f}, \
+        {506, MODBUS_FUNCTION_HOLDING, (uint8_t)ModbusDataType::F32, 0, 1.0f, 0.0f} \
+    }}
+
     #define DEFAULT_MODBUS_SENSOR_CONFIGS { \
-        {"ModbusEnv1", ENV4, 1, false} \
+        {"ModbusEnv1", ENV4, 1, false, DEFAULT_ENV4_DESCRIPTOR} \
     }
 
     #define DEFAULT_ADC_SENSOR_CONFIGS { \
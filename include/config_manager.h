@@ -1,11 +1,13 @@
 #pragma once
-#include <Preferences.h>
 #include <vector>
-#include <Arduino.h>
+#include <ArduinoJson.h>
 #include "sensor_types.h"
-#include <RadioLib.h>
 
 #include "config.h"
+#include "NtcTable.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
 
 struct LoRaConfig {
     String joinEUI;
@@ -13,6 +15,7 @@ struct LoRaConfig {
     String nwkKey;
     String appKey;
 };
+#endif
 
 class ConfigManager {
 public:
@@ -20,13 +23,22 @@ public:
        INICIALIZACIÓN Y CONFIGURACIÓN DEL SISTEMA
        ========================================================================= */
     // Verificación e inicialización
+    // Carga la imagen binaria de configuración (una apertura de NVS por arranque);
+    // si aún no existe la migra desde los namespaces JSON anteriores
+    static void loadConfig();
     static bool checkInitialized();
     static void initializeDefaultConfig();
     static void clearAllPreferences();
 
+#ifdef ARDUINO
     // Configuración del sistema
     static void getSystemConfig(bool &initialized, uint32_t &sleepTime, String &deviceId, String &stationId);
     static void setSystemConfig(bool initialized, uint32_t sleepTime, const String &deviceId, const String &stationId);
+#endif
+
+    // Sensor que aporta la temperatura del agua para compensar pH y conductividad
+    static const char* getWaterTempSourceId();
+    static void setWaterTempSourceId(const char* sensorId);
 
     /* =========================================================================
        CONFIGURACIÓN DE SENSORES NO-MODBUS
@@ -43,6 +55,11 @@ public:
     static std::vector<ModbusSensorConfig> getAllModbusSensorConfigs();
     static std::vector<ModbusSensorConfig> getEnabledModbusSensorConfigs();
 
+    // Formato JSON de un sensor Modbus con su descriptor (BLE y migración):
+    // {"id","t","a","e","p":[{"r","f","d","o","s","of"}, ...]}
+    static void modbusSensorFromJson(JsonObjectConst obj, ModbusSensorConfig& config);
+    static void modbusSensorToJson(const ModbusSensorConfig& config, JsonObject obj);
+
     /* =========================================================================
        CONFIGURACIÓN DE SENSORES ADC
        ========================================================================= */
@@ -53,23 +70,38 @@ public:
     /* =========================================================================
        CONFIGURACIÓN DE LORA
        ========================================================================= */
+#ifdef ARDUINO
     static LoRaConfig getLoRaConfig();
+#endif
+
+    /**
+     * @brief Credenciales OTAA ya convertidas a binario, leídas directamente de la
+     *        imagen de configuración (sin String). nwkKey y appKey deben tener 16 bytes.
+     * @return false si algún EUI no es válido
+     */
+    static bool getLoRaKeys(uint64_t& joinEUI, uint64_t& devEUI, uint8_t* nwkKey, uint8_t* appKey);
+#ifdef ARDUINO
     static void setLoRaConfig(
         const String &joinEUI,
         const String &devEUI,
         const String &nwkKey,
         const String &appKey);
+#endif
 
     /* =========================================================================
        CONFIGURACIÓN DE SENSORES ANALÓGICOS
        ========================================================================= */
-    // NTC 100K
-    static void getNTC100KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3);
-    static void setNTC100KConfig(double t1, double r1, double t2, double r2, double t3, double r3);
+    // NTC 100K (puntos de calibración y topología del divisor)
+    static void getNTC100KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3,
+                                 NtcDivider& divider);
+    static void setNTC100KConfig(double t1, double r1, double t2, double r2, double t3, double r3,
+                                 const NtcDivider& divider);
 
     // NTC 10K
-    static void getNTC10KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3);
-    static void setNTC10KConfig(double t1, double r1, double t2, double r2, double t3, double r3);
+    static void getNTC10KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3,
+                                NtcDivider& divider);
+    static void setNTC10KConfig(double t1, double r1, double t2, double r2, double t3, double r3,
+                                const NtcDivider& divider);
 
     // Conductividad
     static void getConductivityConfig(float& calTemp, float& coefComp,
@@ -81,6 +113,14 @@ public:
     static void getPHConfig(float& v1, float& t1, float& v2, float& t2, float& v3, float& t3, float& defaultTemp);
     static void setPHConfig(float v1, float t1, float v2, float t2, float v3, float t3, float defaultTemp);
 
+    /* =========================================================================
+       COEFICIENTES DE CALIBRACIÓN (ver CalibrationStore)
+       ========================================================================= */
+    // Carga los coeficientes resueltos; si no hay blob válido los resuelve desde el JSON
+    static void loadCalibration();
+    // Resuelve y guarda los coeficientes de todos los sensores analógicos
+    static void rebuildCalibration();
+
 private:
     static const SensorConfig defaultConfigs[];
     static const ModbusSensorConfig defaultModbusSensors[];
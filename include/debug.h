@@ -6,11 +6,19 @@
 #ifndef DEBUG_H
 #define DEBUG_H
 
-#include <Arduino.h>
 #include "config.h"
 
-
-#ifdef DEBUG_ENABLED
+#ifndef ARDUINO
+    // Entorno native: los mensajes van a stdout
+    #include <stdio.h>
+    #define DEBUG_BEGIN(baud)     ((void)(baud))
+    #define DEBUG_PRINT(...)      printf("%s", __VA_ARGS__)
+    #define DEBUG_PRINTLN(...)    printf("%s\n", __VA_ARGS__)
+    #define DEBUG_PRINTF(...)     printf(__VA_ARGS__)
+    #define DEBUG_FLUSH()         fflush(stdout)
+    #define DEBUG_END()           {}
+#elif defined(DEBUG_ENABLED)
+    #include <Arduino.h>
     #define DEBUG_BEGIN(baud)     Serial.begin(baud)
     #define DEBUG_PRINT(...)      Serial.print(__VA_ARGS__)
     #define DEBUG_PRINTLN(...)    Serial.println(__VA_ARGS__)
@@ -18,6 +26,7 @@
     #define DEBUG_FLUSH()         Serial.flush()
     #define DEBUG_END()           Serial.end()
 #else
+    #include <Arduino.h>
     #define DEBUG_BEGIN(baud)     Serial.begin(baud)
     #define DEBUG_PRINT(...)      {}
     #define DEBUG_PRINTLN(...)    {}
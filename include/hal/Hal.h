@@ -0,0 +1,182 @@
+/*******************************************************************************************
+ * Archivo: include/hal/Hal.h
+ * Descripción: Capa de abstracción de hardware (HAL) mínima para ADC, GPIO, I2C, UART, NVS
+ * y reloj. En el ESP32 se implementa sobre Arduino (src/hal/HalEsp32.cpp)
+ * y en el entorno native con periféricos simulados (src/hal/HalSim.cpp), de modo que la
+ * lógica que solo depende de esta interfaz puede compilarse y medirse en un PC.
+ *******************************************************************************************/
+
+#ifndef HAL_H
+#define HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+class HalClock {
+public:
+    /**
+     * @brief Milisegundos desde el arranque
+     */
+    static uint32_t millis();
+
+    /**
+     * @brief Microsegundos desde el arranque
+     */
+    static uint32_t micros();
+
+    /**
+     * @brief Espera bloqueante en milisegundos
+     */
+    static void delayMs(uint32_t ms);
+};
+
+class HalAdc {
+public:
+    /**
+     * @brief Bits de la conversión nativa: la que entrega readBurst() y la que espera
+     *        rawToMilliVolts(), independiente de setResolution()
+     */
+    static constexpr uint8_t NATIVE_BITS = 12;
+
+    /**
+     * @brief Configura la resolución del ADC en bits
+     */
+    static void setResolution(uint8_t bits);
+
+    /**
+     * @brief Resolución configurada del ADC en bits
+     */
+    static uint8_t getResolution();
+
+    /**
+     * @brief Atenuación de 11 dB en todos los canales (rango completo, ~0-3.1 V), la que
+     *        suponen las curvas de calibración de rawToMilliVolts()
+     */
+    static void setFullScaleAttenuation();
+
+    /**
+     * @brief Lectura cruda del ADC (0 .. 2^resolución - 1)
+     * @param pin Pin analógico
+     */
+    static uint16_t readRaw(uint8_t pin);
+
+    /**
+     * @brief Lectura calibrada en milivoltios
+     * @param pin Pin analógico
+     */
+    static uint32_t readMilliVolts(uint8_t pin);
+
+    /**
+     * @brief Ráfaga de conversiones de varios canales. En el ESP32 la hace el controlador
+     *        digital del ADC por DMA, recorriendo los canales en patrón sin intervención
+     *        de la CPU; en native se simula con lecturas canal a canal.
+     * @param pins Pines analógicos
+     * @param count Número de pines
+     * @param samples Conversiones por canal
+     * @param out Conversiones nativas (NATIVE_BITS), out[canal * samples + muestra]
+     * @return false si el controlador no pudo completar la ráfaga
+     */
+    static bool readBurst(const uint8_t* pins, uint8_t count, uint8_t samples, uint16_t* out);
+
+    /**
+     * @brief Convierte una conversión nativa (NATIVE_BITS) a milivoltios con la
+     *        calibración de fábrica del ADC, sin volver a muestrear
+     * @param pin Pin analógico (elige la unidad ADC y su calibración)
+     */
+    static uint32_t rawToMilliVolts(uint8_t pin, uint16_t raw);
+};
+
+class HalGpio {
+public:
+    /**
+     * @brief Configura el pin como salida digital
+     */
+    static void setOutput(uint8_t pin);
+
+    /**
+     * @brief Fija el nivel de un pin de salida (true = alto)
+     */
+    static void write(uint8_t pin, bool level);
+};
+
+class HalI2c {
+public:
+    /**
+     * @brief Inicializa el bus I2C
+     * @param sda Pin SDA
+     * @param scl Pin SCL
+     */
+    static bool begin(uint8_t sda, uint8_t scl);
+};
+
+class HalUart {
+public:
+    /**
+     * @brief Abre el puerto serie usado por el bus RS485
+     */
+    static void begin(uint32_t baud, uint8_t rxPin, uint8_t txPin);
+    static void end();
+    static size_t write(const uint8_t* data, size_t length);
+    static int available();
+
+    /**
+     * @brief Lee un byte
+     * @return Byte leído, o -1 si no hay datos
+     */
+    static int read();
+
+    /**
+     * @brief Espera a que haya bytes para leer sin ocupar la CPU. En el ESP32 la tarea
+     *        queda bloqueada en un semáforo que libera el evento de RX timeout del UART
+     *        (System::MODBUS_RX_IDLE_SYMBOLS sin bytes, fin de trama RTU); mientras tanto
+     *        el núcleo atiende otras tareas o entra en light sleep automático.
+     * @param timeoutMs Espera máxima
+     * @return true si hay bytes disponibles
+     */
+    static bool waitRx(uint32_t timeoutMs);
+};
+
+class HalNvs {
+public:
+    /**
+     * @brief Lee un blob de NVS
+     * @param ns Namespace
+     * @param key Clave
+     * @param out Buffer de salida
+     * @param maxLength Tamaño del buffer
+     * @return Bytes leídos (0 si la clave no existe)
+     */
+    static size_t getBytes(const char* ns, const char* key, void* out, size_t maxLength);
+
+    /**
+     * @brief Escribe un blob en NVS
+     * @return Bytes escritos (0 en caso de error)
+     */
+    static size_t putBytes(const char* ns, const char* key, const void* data, size_t length);
+
+    /**
+     * @brief Lee una cadena de NVS (tipo string, no blob)
+     * @param out Cadena leída; queda vacía si la clave no existe
+     * @return false si la clave no existe
+     */
+    static bool getString(const char* ns, const char* key, std::string& out);
+
+    /**
+     * @brief Escribe una cadena en NVS (tipo string, no blob)
+     * @return false en caso de error
+     */
+    static bool putString(const char* ns, const char* key, const char* value);
+
+    /**
+     * @brief Borra una clave de NVS
+     */
+    static bool remove(const char* ns, const char* key);
+
+    /**
+     * @brief Borra todas las claves de un namespace
+     */
+    static bool clear(const char* ns);
+};
+
+#endif
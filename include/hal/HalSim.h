@@ -0,0 +1,82 @@
+/*******************************************************************************************
+ * Archivo: include/hal/HalSim.h
+ * Descripción: Control de los periféricos simulados de la HAL en el entorno native.
+ * Permite fijar tensiones de ADC y respuestas de la UART e inspeccionar lo que
+ * el firmware escribió, sin placa.
+ *******************************************************************************************/
+
+#ifndef HAL_SIM_H
+#define HAL_SIM_H
+
+#ifndef ARDUINO
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+class HalSim {
+public:
+    /**
+     * @brief Restablece todos los periféricos simulados (NVS incluida)
+     */
+    static void reset();
+
+    /**
+     * @brief Fija la tensión que verá el ADC en un pin
+     * @param pin Pin analógico
+     * @param milliVolts Tensión en mV (la lectura cruda se deriva con fondo de escala de 3300 mV)
+     */
+    static void setAdcMilliVolts(uint8_t pin, uint32_t milliVolts);
+
+    /**
+     * @brief Último nivel escrito en un pin de salida (false si nunca se escribió)
+     */
+    static bool gpioLevel(uint8_t pin);
+
+    /**
+     * @brief Encola bytes que llegarán por la UART (respuesta de un esclavo Modbus). La
+     *        cola es de 1 KB; lo que no cabe se pierde, como en un desborde de la FIFO.
+     */
+    static void queueUartRx(const uint8_t* data, size_t length);
+
+    /**
+     * @brief Bytes transmitidos por la UART desde el último reset (los primeros 4 KB)
+     */
+    static const std::vector<uint8_t>& uartTx();
+
+    /**
+     * @brief Esclavo simulado en el propio proceso: recibe cada escritura de la UART y
+     *        devuelve la respuesta que se encola en RX (0 bytes = no responde)
+     */
+    typedef size_t (*UartResponder)(const uint8_t* request, size_t length, uint8_t* response, size_t maxLength);
+    static void setUartResponder(UartResponder responder);
+
+    // Esclavos de modbusSlave(), igual que tools/modbus_slave_sim.py --dead 3 --exception 4
+    static constexpr uint8_t MODBUS_DEAD_SLAVE = 3;
+    static constexpr uint8_t MODBUS_EXCEPTION_SLAVE = 4;
+    static constexpr uint16_t MODBUS_EXCEPTION_FROM = 100;
+
+    /**
+     * @brief Esclavos Modbus RTU en proceso para setUartResponder(): el registro r del
+     *        esclavo s vale (s << 12) + r, MODBUS_DEAD_SLAVE no responde y
+     *        MODBUS_EXCEPTION_SLAVE devuelve la excepción 02 desde MODBUS_EXCEPTION_FROM
+     */
+    static size_t modbusSlave(const uint8_t* request, size_t length, uint8_t* response, size_t maxLength);
+
+    /**
+     * @brief Conecta la UART a un dispositivo del host (p.ej. el pty que abre
+     *        tools/modbus_slave_sim.py) en lugar de las colas simuladas. Las esperas de
+     *        HalUart::waitRx pasan a ser reales.
+     * @return false si no se pudo abrir
+     */
+    static bool openUartDevice(const char* path);
+
+    /**
+     * @brief Tiempo simulado acumulado por las esperas de HalClock::delayMs
+     */
+    static uint64_t simulatedDelayUs();
+};
+
+#endif // !ARDUINO
+
+#endif
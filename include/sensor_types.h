@@ -6,9 +6,12 @@
 #include <map>
 
 #include "config.h"
+#include "FixedVector.h"
 
 /************************************************************************
  * TIEMPOS DE ESTABILIZACIÓN PARA SENSORES MODBUS (en ms)
+ * Máximo de calentamiento: el sondeo termina antes si la sonda ya responde
+ * (ver ModbusRegisterMap::warmupLimitMs)
  ************************************************************************/
 
 #define MODBUS_ENV4_STABILIZATION_TIME 5000
@@ -21,6 +24,15 @@ struct SubValue {
     float value;
 };
 
+/**
+ * @brief Capacidades fijas de la ruta de lectura (sin heap).
+ *        MAX_SUB_VALUES cubre el sensor con más variables (BME680, ENV4: 4).
+ */
+constexpr size_t MAX_SUB_VALUES = 4;
+constexpr size_t MAX_READINGS = 24;
+
+typedef FixedVector<SubValue, MAX_SUB_VALUES> SubValueArray;
+
 /************************************************************************
  * SECCIÓN PARA SENSORES ESTÁNDAR (NO MODBUS)
  ************************************************************************/
@@ -48,6 +60,7 @@ enum SensorType {
     MT05S = 105,  // Sensor MT05S: [0]=Temperatura(°C), [1]=Humedad Suelo(%), [2]=Conductividad(μS/cm)
 
     ENV4 = 110,   // Sensor ambiental 4 en 1: [0]=Humedad(%), [1]=Temperatura(°C), [2]=Presión(kPa), [3]=Iluminación(lux)
+    MODBUS_GENERIC = 111, // Sensor Modbus descrito en configuración: [i]=punto i del descriptor
 };
 
 /**
@@ -58,7 +71,14 @@ struct SensorReading {
     char sensorId[20];         // Identificador del sensor (ej. "SHT30_1")
     SensorType type;           // Tipo de sensor
     float value;               // Valor único (si aplica)
-    std::vector<SubValue> subValues;};
+    SubValueArray subValues;   // Variables múltiples, almacenadas en línea
+};
+
+/**
+ * @brief Lecturas de un ciclo, en orden de registro. Capacidad fija: se llena en una
+ *        arena estática por ciclo en lugar de crear un vector nuevo en cada despertar.
+ */
+typedef FixedVector<SensorReading, MAX_READINGS> ReadingSet;
 
 /**
  * @brief Estructura de configuración para sensores "normales" (no Modbus).
@@ -74,6 +94,46 @@ struct SensorConfig {
  * SECCIÓN PARA SENSORES MODBUS
  ************************************************************************/
 
+/**
+ * @brief Tipo de dato de un punto Modbus (1 registro los de 16 bits, 2 los de 32)
+ */
+enum class ModbusDataType : uint8_t {
+    U16 = 0,
+    I16 = 1,
+    U32 = 2,
+    I32 = 3,
+    F32 = 4
+};
+
+/**
+ * @brief Orden de bytes/palabras de un punto. 0 = big-endian (ABCD), el de la norma.
+ */
+constexpr uint8_t MODBUS_ORDER_SWAP_BYTES = 0x01;  // Bytes invertidos en cada registro (BADC)
+constexpr uint8_t MODBUS_ORDER_SWAP_WORDS = 0x02;  // Palabra baja primero (CDAB)
+
+constexpr uint8_t MODBUS_FUNCTION_HOLDING = 0x03;
+constexpr uint8_t MODBUS_FUNCTION_INPUT = 0x04;
+
+/**
+ * @brief Un valor leído del esclavo: valor = crudo * scale + offset
+ */
+struct ModbusPoint {
+    uint16_t reg;              // Dirección del (primer) registro
+    uint8_t function;          // MODBUS_FUNCTION_HOLDING o MODBUS_FUNCTION_INPUT
+    uint8_t dataType;          // ModbusDataType
+    uint8_t order;             // MODBUS_ORDER_*
+    float scale;
+    float offset;
+};
+
+/**
+ * @brief Descriptor de un dispositivo Modbus: un punto por cada subValue de la lectura
+ */
+struct ModbusDescriptor {
+    uint8_t count;
+    ModbusPoint points[MAX_SUB_VALUES];
+};
+
 /**
  * @brief Estructura de configuración para sensores Modbus.
  */
@@ -82,6 +142,7 @@ struct ModbusSensorConfig {
     SensorType type;           // Tipo de sensor Modbus
     uint8_t address;           // Dirección Modbus del dispositivo
     bool enable;               // Si está habilitado o no
+    ModbusDescriptor descriptor; // Registros a leer; vacío en ENV4 usa su mapa de fábrica
 };
 
 /**
@@ -90,6 +151,7 @@ struct ModbusSensorConfig {
 struct ModbusSensorReading {
     char sensorId[20];         // Identificador del sensor
     SensorType type;           // Tipo de sensor Modbus
-    std::vector<SubValue> subValues;};
+    SubValueArray subValues;
+};
 
 #endif
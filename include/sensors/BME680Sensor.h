@@ -6,14 +6,22 @@
 
 class BME680Sensor : public ISensor {
 public:
-    explicit BME680Sensor(const std::string& id);
+    explicit BME680Sensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::I2C; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
+
+    void startMeasurement() override;
+    bool isReady() override;
+    SensorReading collect() override;
+
+private:
+    // Instante (millis) en que termina la medición iniciada; 0 si no hay medición en curso
+    uint32_t _readingEndMs = 0;
 };
 
 #endif
\ No newline at end of file
@@ -1,17 +1,16 @@
 #ifndef BATTERY_SENSOR_H
 #define BATTERY_SENSOR_H
 
-#include <Arduino.h>
 #include "sensors/ISensor.h"
 #include "config.h"
 #include "debug.h"
 
 class BatterySensor : public ISensor {
-public:    explicit BatterySensor(const std::string& id);
+public:    explicit BatterySensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::ANALOG_ADC; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_NONE; }
@@ -9,14 +9,28 @@
 
 
 class CO2Sensor : public ISensor {
-public:    explicit CO2Sensor(const std::string& id);
+public:    explicit CO2Sensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::I2C; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_MAIN; }
+
+    void startMeasurement() override;
+    bool isReady() override;
+    SensorReading collect() override;
+
+private:
+    // Intervalo de sondeo y número máximo de sondeos del resultado single-shot
+    static constexpr uint32_t POLL_INTERVAL_MS = 50;
+    static constexpr uint32_t MAX_POLL_ATTEMPTS = 200;
+
+    bool _measurementStarted = false;
+    bool _dataReady = false;
+    uint32_t _startMs = 0;
+    uint32_t _lastPollMs = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,69 @@
+/*******************************************************************************************
+ * Archivo: include/sensors/DS18B20Bus.h
+ * Descripción: Bus 1-Wire compartido por todas las sondas DS18B20.
+ * Los códigos ROM se descubren una sola vez (búsqueda completa del bus) y se guardan en
+ * RTC RAM junto con la resolución de cada sonda; en los despertares siguientes no se
+ * recorre el bus. Cada ciclo emite un único Convert T por difusión (Skip ROM) sin
+ * esperar, y luego cada sonda lee su scratchpad direccionándola por su ROM: N sondas
+ * cuestan una ventana de conversión, no N.
+ *******************************************************************************************/
+
+#ifndef DS18B20_BUS_H
+#define DS18B20_BUS_H
+
+#include <Arduino.h>
+#include "config.h"
+
+class DS18B20Bus {
+public:
+    /**
+     * @brief Deja disponibles los códigos ROM: usa la copia en RTC si es íntegra y, si
+     *        no, recorre el bus y la guarda. Se puede llamar desde cada sonda.
+     * @return true si hay al menos una sonda
+     */
+    static bool begin();
+
+    /**
+     * @brief Número de sondas descubiertas (en orden de búsqueda del bus)
+     */
+    static uint8_t probeCount();
+
+    /**
+     * @brief Fija la resolución de una sonda (9-12 bits). Solo escribe en la sonda (y en
+     *        su EEPROM) si difiere de la guardada en RTC, es decir, una vez.
+     * @return false si la sonda no existe o no respondió
+     */
+    static bool setResolution(uint8_t probe, uint8_t bits);
+
+    /**
+     * @brief Pide una conversión para el ciclo. Solo la primera petición emite el
+     *        Convert T por difusión; las demás se suman a la conversión en curso.
+     */
+    static void requestConversion();
+
+    /**
+     * @brief Indica si pasó el tiempo de conversión de la sonda con mayor resolución
+     */
+    static bool isConversionDone();
+
+    /**
+     * @brief Lee el scratchpad de una sonda (con CRC) y libera su petición de conversión
+     * @return Temperatura en °C, o NAN si la sonda no respondió
+     */
+    static float readProbe(uint8_t probe);
+
+    /**
+     * @brief Descarta la copia en RTC: el próximo begin() vuelve a recorrer el bus
+     *        (sonda desconectada o reemplazada)
+     */
+    static void invalidate();
+
+private:
+    static bool discover();
+
+    static uint8_t _pendingRequests;
+    static uint32_t _conversionStartMs;
+    static uint16_t _conversionTimeMs;
+};
+
+#endif
@@ -6,15 +6,34 @@
 #include "config.h"
 #include "debug.h"
 
+/**
+ * @brief Una sonda DS18B20 del bus 1-Wire compartido (ver DS18B20Bus).
+ *        Se pueden registrar varias; todas convierten con un único Convert T.
+ */
 class DS18B20Sensor : public ISensor {
-public:    explicit DS18B20Sensor(const std::string& id);
+public:
+    /**
+     * @param id Identificador del sensor
+     * @param configKey "D<sonda>[:<bits>]": índice de la sonda en el bus y resolución
+     *        opcional (por defecto sonda 0 a Sensors::DS18B20_DEFAULT_RESOLUTION)
+     */
+    explicit DS18B20Sensor(const char* id, const char* configKey = nullptr);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::ONE_WIRE; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
+
+    void startMeasurement() override;
+    bool isReady() override;
+    SensorReading collect() override;
+
+private:
+    uint8_t _probe = 0;
+    uint8_t _resolution = Sensors::DS18B20_DEFAULT_RESOLUTION;
+    bool _conversionStarted = false;
 };
 
-#endif
\ No newline at end of file
+#endif
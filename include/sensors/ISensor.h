@@ -2,7 +2,9 @@
 #define ISENSOR_H
 
 #include "sensor_types.h"
-#include <string>
+#include "MeasurementCache.h"
+#include "hal/Hal.h"
+#include <stdio.h>
 
 enum class CommunicationProtocol {
     NONE,
@@ -26,19 +28,63 @@ public:
 
     virtual bool begin() = 0;
     virtual SensorReading read() = 0;
-    virtual const std::string& getId() const = 0;
+    virtual const char* getId() const = 0;
     virtual SensorType getType() const = 0;
     virtual CommunicationProtocol getProtocol() const = 0;
     virtual PowerRequirement getPowerRequirement() const = 0;
-    
+
+    /**
+     * @brief Dispara la conversión sin bloquear.
+     *        Los sensores sin tiempo de conversión propio no necesitan sobrescribirlo.
+     */
+    virtual void startMeasurement() {}
+
+    /**
+     * @brief Indica si la conversión iniciada con startMeasurement() ya terminó
+     *        (o expiró su timeout) y collect() puede llamarse sin esperar.
+     */
+    virtual bool isReady() { return true; }
+
+    /**
+     * @brief Recoge el resultado de la conversión en curso.
+     *        Por defecto hace una lectura bloqueante completa con read().
+     */
+    virtual SensorReading collect() { return read(); }
+
+    /**
+     * @brief Magnitud de otro sensor que necesita este (p.ej. temperatura para compensar).
+     *        SensorManager lo recoge después de la fuente y la deja en MeasurementCache.
+     */
+    virtual Quantity dependsOn() const { return Quantity::NONE; }
+
     bool isInitialized() const {
         return _initialized;
     }
 
 protected:
-    std::string _id;
+    /**
+     * @brief Lectura bloqueante para drivers que implementan el ciclo
+     *        startMeasurement()/isReady()/collect(). Útil para implementar read().
+     */
+    SensorReading readBlocking() {
+        startMeasurement();
+        while (!isReady()) {
+            HalClock::delayMs(1);
+        }
+        return collect();
+    }
+
+    /**
+     * @brief Copia el identificador al búfer propio del sensor. Un std::string pasaría
+     *        al heap con ids de más de 15 caracteres (sensorId admite 19).
+     */
+    void setId(const char* id) {
+        snprintf(_id, sizeof(_id), "%s", id);
+    }
+
+    char _id[sizeof(SensorConfig::sensorId)];
     SensorType _type;
     bool _initialized = false;
 };
 
-#endif
\ No newline at end of file
+#endif
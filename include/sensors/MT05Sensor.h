@@ -24,7 +24,7 @@ public:
      * @brief Constructor
      * @param id Identificador único del sensor
      */
-    explicit MT05Sensor(const std::string& id);
+    explicit MT05Sensor(const char* id);
 
     /**
      * @brief Inicializa el sensor
@@ -33,15 +33,31 @@ public:
     bool begin() override;
 
     /**
-     * @brief Lee las mediciones del sensor
+     * @brief Lee las mediciones del sensor (bloqueante)
      * @return SensorReading con temperatura, humedad y conductividad
      */
     SensorReading read() override;
 
+    /**
+     * @brief Configura el sensor y dispara la conversión (Convert T) sin esperar
+     */
+    void startMeasurement() override;
+
+    /**
+     * @brief true cuando transcurrió el tiempo de conversión del MT05S
+     */
+    bool isReady() override;
+
+    /**
+     * @brief Lee el scratchpad con el resultado de la conversión
+     * @return SensorReading con temperatura, humedad y conductividad
+     */
+    SensorReading collect() override;
+
     /**
      * @brief Obtiene el ID del sensor
      */
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
 
     /**
      * @brief Obtiene el tipo de sensor
@@ -59,6 +75,11 @@ public:
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
 
 private:
+    // Tiempo de conversión (100ms típico según datasheet + margen)
+    static constexpr uint32_t CONVERSION_TIME_MS = 110;
+
+    bool _conversionStarted = false;
+    uint32_t _conversionStartMs = 0;
 };
 
 #endif
\ No newline at end of file
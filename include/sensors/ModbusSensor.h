@@ -1,42 +1,36 @@
 #ifndef MODBUS_SENSOR_H
 #define MODBUS_SENSOR_H
 
-#include <Arduino.h>
 #include "sensors/ISensor.h"
 #include "ModbusSensorManager.h"
 #include "config.h"
 
 /**
- * @brief Clase base para sensores Modbus
+ * @brief Sensor Modbus descrito por configuración: cada punto del descriptor (registro,
+ *        función, tipo, orden, escala y offset) es un subValue de la lectura. Los
+ *        registros se leen en el lote agrupado de ModbusSensorManager.
+ *        ENV4 usa el mismo driver con su descriptor de fábrica.
  */
 class ModbusSensor : public ISensor {
 public:
-    ModbusSensor(const std::string& id, SensorType type, uint8_t slaveId, uint16_t startReg, uint8_t numRegs);
+    ModbusSensor(const char* id, SensorType type, uint8_t slaveId, const ModbusDescriptor& descriptor);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+
+    // Las transacciones de todos los sensores Modbus se encolan juntas y avanzan
+    // mientras el resto de los sensores convierte
+    void startMeasurement() override { ModbusSensorManager::startAcquisition(); }
+    bool isReady() override { return ModbusSensorManager::poll(); }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::MODBUS; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_12V; }
 
-protected:
+private:
     uint8_t _slaveId;
-    uint16_t _startRegister;
-    uint8_t _numRegisters;
-
-    virtual SensorReading processModbusData(uint16_t* data, uint8_t numRegs) = 0;
-};
-
-/**
- * @brief Sensor Modbus ENV4 - Lee 4 valores: Humedad, Temperatura, Presión, Iluminación
- */
-class ENV4ModbusSensor : public ModbusSensor {
-public:
-    ENV4ModbusSensor(const std::string& id, uint8_t slaveId);
-
-protected:
-    SensorReading processModbusData(uint16_t* data, uint8_t numRegs) override;
+    ModbusDescriptor _descriptor;
+    int8_t _firstPoint = ModbusSensorManager::NO_HANDLE;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,22 +1,21 @@
 #ifndef PH_SENSOR_H
 #define PH_SENSOR_H
 
-#include <Arduino.h>
 #include "sensors/ISensor.h"
 #include "config.h"
 #include "debug.h"
-#include "config_manager.h"
 
 class PHSensor : public ISensor {
 public:
-    explicit PHSensor(const std::string& id);
+    explicit PHSensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::ANALOG_ADC; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
+    Quantity dependsOn() const override { return Quantity::WATER_TEMPERATURE; }
 
 private:
     /**
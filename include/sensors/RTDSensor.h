@@ -9,11 +9,11 @@
 
 class RTDSensor : public ISensor {
 public:
-    explicit RTDSensor(const std::string& id);
+    explicit RTDSensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::SPI; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
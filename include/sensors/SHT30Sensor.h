@@ -7,11 +7,11 @@
 #include "debug.h"
 
 class SHT30Sensor : public ISensor {
-public:    explicit SHT30Sensor(const std::string& id);
+public:    explicit SHT30Sensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::I2C; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_MAIN; }
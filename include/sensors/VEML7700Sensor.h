@@ -8,11 +8,11 @@
 
 class VEML7700Sensor : public ISensor {
 public:
-    explicit VEML7700Sensor(const std::string& id);
+    explicit VEML7700Sensor(const char* id);
 
     bool begin() override;
     SensorReading read() override;
-    const std::string& getId() const override { return _id; }
+    const char* getId() const override { return _id; }
     SensorType getType() const override { return _type; }
     CommunicationProtocol getProtocol() const override { return CommunicationProtocol::I2C; }
     PowerRequirement getPowerRequirement() const override { return PowerRequirement::POWER_3V3_SWITCHED; }
@@ -0,0 +1,42 @@
+/*******************************************************************************************
+ * Archivo: include/util/varint.h
+ * Descripción: Enteros de longitud variable (LEB128 sin signo, 7 bits por byte, LSB
+ * primero) y codificación zigzag para que las diferencias pequeñas de cualquier signo
+ * ocupen un byte. Usado por los frames delta (DeltaEncoder).
+ *******************************************************************************************/
+
+#ifndef UTIL_VARINT_H
+#define UTIL_VARINT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief Mapea 0, -1, 1, -2... a 0, 1, 2, 3...
+ */
+static inline uint32_t zigzag_encode(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static inline int32_t zigzag_decode(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+/**
+ * @brief Escribe value como varint
+ * @return Bytes escritos (1 a 5), o 0 si no cabe en size
+ */
+static inline size_t varint_put(uint32_t value, uint8_t* out, size_t size) {
+    size_t length = 0;
+    do {
+        if (length >= size) {
+            return 0;
+        }
+        uint8_t byte = (uint8_t)(value & 0x7F);
+        value >>= 7;
+        out[length++] = value ? (uint8_t)(byte | 0x80) : byte;
+    } while (value);
+    return length;
+}
+
+#endif
@@ -1,9 +1,19 @@
 #ifndef UTILITIES_H
 #define UTILITIES_H
 
-#include <Arduino.h>
+#include <stdint.h>
+#include <stddef.h>
 
+#ifdef ARDUINO
+#include <Arduino.h>
 void parseKeyString(const String &keyStr, uint8_t *outArray, size_t expectedSize);
+#endif
+
+/**
+ * @brief Convierte una clave "EE,F1,30,..." en expectedSize bytes, sin usar el heap
+ */
+void parseKeyString(const char* keyStr, uint8_t* outArray, size_t expectedSize);
+
 bool parseEUIString(const char* euiStr, uint64_t* eui);
 
 /**
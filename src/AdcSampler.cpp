@@ -0,0 +1,105 @@
+#include "AdcSampler.h"
+#include "hal/Hal.h"
+#include <math.h>
+
+static_assert(Sensors::ADC_OVERSAMPLE_COUNT <= 64, "Demasiadas muestras por canal");
+static_assert(Sensors::ADC_OVERSAMPLE_COUNT > 2 * Sensors::ADC_TRIM_COUNT,
+              "La media recortada necesita al menos una muestra");
+
+static uint8_t channels[Sensors::ADC_MAX_CHANNELS];
+static float channelMilliVolts[Sensors::ADC_MAX_CHANNELS];
+static uint8_t channelCount = 0;
+static bool batchValid = false;
+
+// Muestras de la ráfaga, agrupadas por canal
+static uint16_t samples[Sensors::ADC_MAX_CHANNELS][Sensors::ADC_OVERSAMPLE_COUNT];
+
+void AdcSampler::clearChannels() {
+    channelCount = 0;
+    batchValid = false;
+}
+
+bool AdcSampler::addChannel(uint8_t pin) {
+    for (uint8_t i = 0; i < channelCount; i++) {
+        if (channels[i] == pin) {
+            return true;
+        }
+    }
+    if (channelCount >= Sensors::ADC_MAX_CHANNELS) {
+        return false;
+    }
+    channels[channelCount++] = pin;
+    batchValid = false;
+    return true;
+}
+
+void AdcSampler::invalidate() {
+    batchValid = false;
+}
+
+float AdcSampler::trimmedMilliVolts(uint8_t pin, uint16_t* values) {
+    const uint8_t n = Sensors::ADC_OVERSAMPLE_COUNT;
+
+    // Inserción: con 16-64 muestras es más barato que cualquier otro orden
+    for (uint8_t i = 1; i < n; i++) {
+        uint16_t value = values[i];
+        int8_t j = i - 1;
+        while (j >= 0 && values[j] > value) {
+            values[j + 1] = values[j];
+            j--;
+        }
+        values[j + 1] = value;
+    }
+
+    uint32_t sum = 0;
+    for (uint8_t i = Sensors::ADC_TRIM_COUNT; i < n - Sensors::ADC_TRIM_COUNT; i++) {
+        sum += values[i];
+    }
+    float meanRaw = (float)sum / (n - 2 * Sensors::ADC_TRIM_COUNT);
+
+    // La calibración es por código nativo entero: interpolar entre los dos códigos
+    // vecinos conserva la resolución que aporta el promedio
+    uint16_t low = (uint16_t)meanRaw;
+    float fraction = meanRaw - low;
+    float mvLow = (float)HalAdc::rawToMilliVolts(pin, low);
+    if (fraction <= 0.0f) {
+        return mvLow;
+    }
+    float mvHigh = (float)HalAdc::rawToMilliVolts(pin, low + 1);
+    return mvLow + fraction * (mvHigh - mvLow);
+}
+
+void AdcSampler::acquire() {
+    // Una sola ráfaga con todos los canales; samples[c] queda contiguo por canal
+    if (!HalAdc::readBurst(channels, channelCount, Sensors::ADC_OVERSAMPLE_COUNT, &samples[0][0])) {
+        for (uint8_t c = 0; c < channelCount; c++) {
+            channelMilliVolts[c] = NAN;
+        }
+        batchValid = true;
+        return;
+    }
+    for (uint8_t c = 0; c < channelCount; c++) {
+        channelMilliVolts[c] = trimmedMilliVolts(channels[c], samples[c]);
+    }
+    batchValid = true;
+}
+
+float AdcSampler::milliVolts(uint8_t pin) {
+    for (uint8_t c = 0; c < channelCount; c++) {
+        if (channels[c] == pin) {
+            if (!batchValid) {
+                acquire();
+            }
+            return channelMilliVolts[c];
+        }
+    }
+    return sampleNow(pin);
+}
+
+float AdcSampler::sampleNow(uint8_t pin) {
+    uint16_t values[Sensors::ADC_OVERSAMPLE_COUNT];
+    if (!HalAdc::readBurst(&pin, 1, Sensors::ADC_OVERSAMPLE_COUNT, values)) {
+        return NAN;
+    }
+    return trimmedMilliVolts(pin, values);
+}
@@ -156,6 +156,12 @@ BLEService* BLEHandler::setupService(BLEServer* pServer) {
     );
     pSensorsChar->setCallbacks(new SensorsConfigCallback());
 
+    BLECharacteristic* pModbusChar = pService->createCharacteristic(
+        BLEUUID(BLE::CHAR_MODBUS_UUID),
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
+    );
+    pModbusChar->setCallbacks(new ModbusConfigCallback());
+
     BLECharacteristic* pLoRaConfigChar = pService->createCharacteristic(
         BLEUUID(BLE::CHAR_LORA_CONFIG_UUID),
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE
@@ -193,6 +199,11 @@ void BLEHandler::SystemConfigCallback::onWrite(BLECharacteristic *pCharacteristi
     DEBUG_PRINTLN(stationId);
 
     ConfigManager::setSystemConfig(initialized, sleepTime, deviceId, stationId);
+
+    // Opcional: las apps que no conocen la clave no borran la fuente configurada
+    if (obj.containsKey(JsonKeys::KEY_SENSOR_ID_TEMPERATURE)) {
+        ConfigManager::setWaterTempSourceId(obj[JsonKeys::KEY_SENSOR_ID_TEMPERATURE] | "");
+    }
 }
 
 void BLEHandler::SystemConfigCallback::onRead(BLECharacteristic *pCharacteristic) {
@@ -208,6 +219,7 @@ void BLEHandler::SystemConfigCallback::onRead(BLECharacteristic *pCharacteristic
     obj[JsonKeys::KEY_SLEEP_TIME] = sleepTime;
     obj[JsonKeys::KEY_DEVICE_ID] = deviceId;
     obj[JsonKeys::KEY_STATION_ID] = stationId;
+    obj[JsonKeys::KEY_SENSOR_ID_TEMPERATURE] = ConfigManager::getWaterTempSourceId();
 
     String jsonString;
     serializeJson(doc, jsonString);
@@ -241,19 +253,28 @@ void BLEHandler::NTC100KConfigCallback::onWrite(BLECharacteristic *pCharacterist
     DEBUG_PRINT(F(", R3: "));
     DEBUG_PRINTLN(doc[JsonKeys::KEY_NTC100K_R3] | 0.0);
 
+    // Topología del divisor: opcional, por defecto la de la placa
+    NtcDivider divider;
+    divider.vRefMilliVolts = doc[JsonKeys::KEY_NTC100K_VREF] | Calibration::NTC100K::DEFAULT_VREF_MV;
+    divider.rFixed = doc[JsonKeys::KEY_NTC100K_RFIXED] | Calibration::NTC100K::DEFAULT_R_FIXED;
+    divider.ntcTop = (doc[JsonKeys::KEY_NTC100K_TOP] | Calibration::NTC100K::DEFAULT_NTC_TOP) ? 1 : 0;
+    divider.reserved = 0;
+
     ConfigManager::setNTC100KConfig(
         doc[JsonKeys::KEY_NTC100K_T1] | 0.0,
         doc[JsonKeys::KEY_NTC100K_R1] | 0.0,
         doc[JsonKeys::KEY_NTC100K_T2] | 0.0,
         doc[JsonKeys::KEY_NTC100K_R2] | 0.0,
         doc[JsonKeys::KEY_NTC100K_T3] | 0.0,
-        doc[JsonKeys::KEY_NTC100K_R3] | 0.0
+        doc[JsonKeys::KEY_NTC100K_R3] | 0.0,
+        divider
     );
 }
 
 void BLEHandler::NTC100KConfigCallback::onRead(BLECharacteristic *pCharacteristic) {
     double t1, r1, t2, r2, t3, r3;
-    ConfigManager::getNTC100KConfig(t1, r1, t2, r2, t3, r3);
+    NtcDivider divider;
+    ConfigManager::getNTC100KConfig(t1, r1, t2, r2, t3, r3, divider);
 
     DEBUG_PRINT(F("DEBUG: NTC100KConfigCallback onRead - Config: T1="));
     DEBUG_PRINT(t1);
@@ -276,6 +297,9 @@ void BLEHandler::NTC100KConfigCallback::onRead(BLECharacteristic *pCharacteristi
     doc[JsonKeys::KEY_NTC100K_R2] = r2;
     doc[JsonKeys::KEY_NTC100K_T3] = t3;
     doc[JsonKeys::KEY_NTC100K_R3] = r3;
+    doc[JsonKeys::KEY_NTC100K_VREF] = divider.vRefMilliVolts;
+    doc[JsonKeys::KEY_NTC100K_RFIXED] = divider.rFixed;
+    doc[JsonKeys::KEY_NTC100K_TOP] = divider.ntcTop != 0;
 
     String jsonString;
     serializeJson(fullDoc, jsonString);
@@ -309,19 +333,28 @@ void BLEHandler::NTC10KConfigCallback::onWrite(BLECharacteristic *pCharacteristi
     DEBUG_PRINT(F(", R3: "));
     DEBUG_PRINTLN(doc[JsonKeys::KEY_NTC10K_R3] | 0.0);
 
+    // Topología del divisor: opcional, por defecto la de la placa
+    NtcDivider divider;
+    divider.vRefMilliVolts = doc[JsonKeys::KEY_NTC10K_VREF] | Calibration::NTC10K::DEFAULT_VREF_MV;
+    divider.rFixed = doc[JsonKeys::KEY_NTC10K_RFIXED] | Calibration::NTC10K::DEFAULT_R_FIXED;
+    divider.ntcTop = (doc[JsonKeys::KEY_NTC10K_TOP] | Calibration::NTC10K::DEFAULT_NTC_TOP) ? 1 : 0;
+    divider.reserved = 0;
+
     ConfigManager::setNTC10KConfig(
         doc[JsonKeys::KEY_NTC10K_T1] | 0.0,
         doc[JsonKeys::KEY_NTC10K_R1] | 0.0,
         doc[JsonKeys::KEY_NTC10K_T2] | 0.0,
         doc[JsonKeys::KEY_NTC10K_R2] | 0.0,
         doc[JsonKeys::KEY_NTC10K_T3] | 0.0,
-        doc[JsonKeys::KEY_NTC10K_R3] | 0.0
+        doc[JsonKeys::KEY_NTC10K_R3] | 0.0,
+        divider
     );
 }
 
 void BLEHandler::NTC10KConfigCallback::onRead(BLECharacteristic *pCharacteristic) {
     double t1, r1, t2, r2, t3, r3;
-    ConfigManager::getNTC10KConfig(t1, r1, t2, r2, t3, r3);
+    NtcDivider divider;
+    ConfigManager::getNTC10KConfig(t1, r1, t2, r2, t3, r3, divider);
 
     DEBUG_PRINT(F("DEBUG: NTC10KConfigCallback onRead - Config: T1="));
     DEBUG_PRINT(t1);
@@ -344,6 +377,9 @@ void BLEHandler::NTC10KConfigCallback::onRead(BLECharacteristic *pCharacteristic
     doc[JsonKeys::KEY_NTC10K_R2] = r2;
     doc[JsonKeys::KEY_NTC10K_T3] = t3;
     doc[JsonKeys::KEY_NTC10K_R3] = r3;
+    doc[JsonKeys::KEY_NTC10K_VREF] = divider.vRefMilliVolts;
+    doc[JsonKeys::KEY_NTC10K_RFIXED] = divider.rFixed;
+    doc[JsonKeys::KEY_NTC10K_TOP] = divider.ntcTop != 0;
 
     String jsonString;
     serializeJson(fullDoc, jsonString);
@@ -579,6 +615,61 @@ void BLEHandler::SensorsConfigCallback::onRead(BLECharacteristic *pCharacteristi
     pCharacteristic->setValue(jsonString.c_str());
 }
 
+// Implementación de ModbusConfigCallback
+void BLEHandler::ModbusConfigCallback::onWrite(BLECharacteristic *pCharacteristic) {
+    DEBUG_PRINTLN(F("DEBUG: ModbusConfigCallback onWrite - JSON recibido:"));
+    DEBUG_PRINTLN(pCharacteristic->getValue().c_str());
+
+    // Se espera un JSON: { "sensors_modbus": [ {"id","t","a","e","p":[{"r","f","d","o","s","of"}]}, ... ] }
+    // Sin "p" un ENV4 usa su descriptor de fábrica
+    DynamicJsonDocument doc(System::JSON_DOC_SIZE_LARGE);
+    DeserializationError error = deserializeJson(doc, pCharacteristic->getValue());
+    if (error) {
+        DEBUG_PRINT(F("Error deserializando Modbus config: "));
+        DEBUG_PRINTLN(error.c_str());
+        return;
+    }
+
+    std::vector<ModbusSensorConfig> configs;
+    JsonArray sensorArray = doc[JsonKeys::NS_SENSORS_MODBUS];
+
+    for (JsonObject sensor : sensorArray) {
+        ModbusSensorConfig config;
+        ConfigManager::modbusSensorFromJson(sensor, config);
+
+        DEBUG_PRINT(F("DEBUG: Modbus config parsed - sensorId: "));
+        DEBUG_PRINT(config.sensorId);
+        DEBUG_PRINT(F(", type: "));
+        DEBUG_PRINT(static_cast<int>(config.type));
+        DEBUG_PRINT(F(", address: "));
+        DEBUG_PRINT(config.address);
+        DEBUG_PRINT(F(", points: "));
+        DEBUG_PRINT(config.descriptor.count);
+        DEBUG_PRINT(F(", enable: "));
+        DEBUG_PRINTLN(config.enable ? "true" : "false");
+
+        configs.push_back(config);
+    }
+
+    ConfigManager::setModbusSensorsConfigs(configs);
+}
+
+void BLEHandler::ModbusConfigCallback::onRead(BLECharacteristic *pCharacteristic) {
+    DynamicJsonDocument doc(System::JSON_DOC_SIZE_LARGE);
+    JsonArray sensorArray = doc.createNestedArray(JsonKeys::NS_SENSORS_MODBUS);
+
+    std::vector<ModbusSensorConfig> configs = ConfigManager::getAllModbusSensorConfigs();
+    for (const auto& sensor : configs) {
+        ConfigManager::modbusSensorToJson(sensor, sensorArray.createNestedObject());
+    }
+
+    String jsonString;
+    serializeJson(doc, jsonString);
+    DEBUG_PRINT(F("DEBUG: ModbusConfigCallback onRead - JSON enviado: "));
+    DEBUG_PRINTLN(jsonString);
+    pCharacteristic->setValue(jsonString.c_str());
+}
+
 // Implementación de LoRaConfigCallback
 void BLEHandler::LoRaConfigCallback::onWrite(BLECharacteristic* pCharacteristic) {
     DEBUG_PRINTLN(F("DEBUG: LoRaConfigCallback onWrite - JSON recibido:"));
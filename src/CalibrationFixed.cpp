@@ -0,0 +1,164 @@
+#include "CalibrationFixed.h"
+#include <cmath>
+
+namespace {
+    // round(log2(1 + i/32) * 2^30), i = 0..32
+    const uint32_t LOG2_TABLE_Q30[33] = {
+        0, 47667823, 93912511, 138816582, 182455581, 224898839, 266210141, 306448299,
+        345667660, 383918542, 421247625, 457698295, 493310944, 528123241, 562170370, 595485245,
+        628098702, 660039669, 691335320, 722011213, 752091421, 781598637, 810554283, 838978604,
+        866890747, 894308843, 921250079, 947730758, 973766362, 999371606, 1024560487, 1049346328,
+        1073741824
+    };
+    const uint64_t LN2_Q30 = 744261118;     // round(ln(2) * 2^30)
+    const int32_t KELVIN_OFFSET_C100 = 27315;
+
+    /**
+     * @brief División entera redondeando al más cercano (con signo)
+     */
+    int64_t divRound(int64_t numerator, int64_t denominator) {
+        return ((numerator < 0) != (denominator < 0)) ? (numerator - denominator / 2) / denominator
+                                                       : (numerator + denominator / 2) / denominator;
+    }
+
+    /**
+     * @brief Desplazamiento que deja |value| * 2^shift justo por debajo de 2^bits
+     */
+    uint8_t scaleShift(double value, int bits) {
+        if (value == 0.0) {
+            return 0;
+        }
+        int exponent;
+        frexp(value, &exponent);
+        int shift = bits - exponent;
+        return (uint8_t)(shift < 0 ? 0 : (shift > 62 ? 62 : shift));
+    }
+}
+
+SteinhartHartFixed CalibrationFixed::fromFloat(const SteinhartHartCoeffs& coeffs) {
+    SteinhartHartFixed fixed{0, 0, 0, 0};
+    if (std::isnan(coeffs.A) || std::isnan(coeffs.B) || std::isnan(coeffs.C)) {
+        return fixed;
+    }
+    fixed.a = llround(ldexp((double)coeffs.A, 48));
+    fixed.b = llround(ldexp((double)coeffs.B, 48));
+    fixed.c = llround(ldexp((double)coeffs.C, 48));
+    fixed.valid = 1;
+    return fixed;
+}
+
+PhFixed CalibrationFixed::fromFloat(const PhCoeffs& coeffs) {
+    PhFixed fixed{0, 0, 0, 0, 0};
+    // Una pendiente de 2 V/pH o más ya no cabe en nV sobre 32 bits (y no es un electrodo)
+    if (std::isnan(coeffs.e0) || std::isnan(coeffs.slope) || fabs(coeffs.slope) >= 2.0f ||
+        coeffs.slope == 0.0f) {
+        return fixed;
+    }
+    fixed.e0Uv = (int32_t)lround(coeffs.e0 * 1e6);
+    fixed.slopeNv = (int32_t)lround(coeffs.slope * 1e9);
+    fixed.calTempK100 = (int32_t)lround(coeffs.calTempK * 100.0);
+    fixed.calTempC100 = (int32_t)lround(coeffs.calTempC * 100.0);
+    fixed.valid = 1;
+    return fixed;
+}
+
+ConductivityFixed CalibrationFixed::fromFloat(const ConductivityCoeffs& coeffs) {
+    ConductivityFixed fixed{0, 0, 0, 0, 0, 0, 0, 0};
+    if (std::isnan(coeffs.a) || std::isnan(coeffs.b) || std::isnan(coeffs.c)) {
+        return fixed;
+    }
+    // ppm x100 con Vc en µV: a * 100 / 1e12 por cada µV^2 (Vc^2 llega dividido por 2^16)
+    const double a = coeffs.a * 100.0 * 1e-12 * 65536.0;
+    const double b = coeffs.b * 100.0 * 1e-6;
+    fixed.aShift = scaleShift(a, 30);
+    fixed.bShift = scaleShift(b, 30);
+    fixed.a = llround(ldexp(a, fixed.aShift));
+    fixed.b = llround(ldexp(b, fixed.bShift));
+    fixed.c = (int32_t)lround(coeffs.c * 100.0);
+    fixed.calTempC100 = (int32_t)lround(coeffs.calTempC * 100.0);
+    fixed.coefCompPpm = (int32_t)lround(coeffs.coefComp * 1e6);
+    fixed.valid = 1;
+    return fixed;
+}
+
+int32_t CalibrationFixed::lnQ20(uint64_t x) {
+    // log2(x) = n + log2(1 + f), con n la posición del bit más alto y f la mantisa
+    const int n = 63 - __builtin_clzll(x);
+    const uint32_t fraction = (uint32_t)(((x << (63 - n)) << 1) >> 32);
+    const uint32_t index = fraction >> 27;
+    const uint32_t remainder = (fraction >> 11) & 0xFFFF;
+    const uint32_t low = LOG2_TABLE_Q30[index];
+    const uint32_t high = LOG2_TABLE_Q30[index + 1];
+    const uint64_t mantissaQ30 = low + (((uint64_t)(high - low) * remainder) >> 16);
+
+    const uint64_t lnQ30 = (uint64_t)n * LN2_Q30 + ((mantissaQ30 * LN2_Q30) >> 30);
+    return (int32_t)((lnQ30 + (1u << 9)) >> 10);
+}
+
+int32_t CalibrationFixed::ntcTemperatureC100(int32_t microVolts, int32_t vRefMicroVolts, uint32_t rFixed,
+                                             bool ntcTop, const SteinhartHartFixed& coeffs) {
+    if (!coeffs.valid || microVolts <= 0 || microVolts >= vRefMicroVolts) {
+        return INVALID;
+    }
+    // R = rFixed * num / den; ln(R) como diferencia de logaritmos enteros
+    const uint64_t across = (uint64_t)(vRefMicroVolts - microVolts);
+    const uint64_t numerator = (uint64_t)rFixed * (ntcTop ? across : (uint64_t)microVolts);
+    const uint64_t denominator = ntcTop ? (uint64_t)microVolts : across;
+    const int64_t lnR = (int64_t)lnQ20(numerator) - lnQ20(denominator);
+
+    // 1/T = A + lnR * (B + C * lnR^2), en Q48
+    const int64_t lnR2 = (lnR * lnR) >> 20;
+    const int64_t inner = coeffs.b + ((coeffs.c * lnR2) >> 20);
+    const int64_t invT = coeffs.a + ((inner * lnR) >> 20);
+    if (invT <= 0) {
+        return INVALID;
+    }
+    const int64_t tempK100 = divRound((int64_t)100 << 48, invT);
+    return (int32_t)(tempK100 - KELVIN_OFFSET_C100);
+}
+
+int32_t CalibrationFixed::phMilli(int32_t electrodeMicroVolts, int32_t tempC100, const PhFixed& coeffs) {
+    if (!coeffs.valid) {
+        return INVALID;
+    }
+    if (tempC100 == NO_TEMPERATURE) {
+        tempC100 = coeffs.calTempC100;
+    }
+    // pH = (E0 + V) / (S * T / Tcal); x1000 con V en µV y S en nV/pH
+    const int64_t numerator = ((int64_t)coeffs.e0Uv + electrodeMicroVolts) * 1000000LL * coeffs.calTempK100;
+    const int64_t denominator = (int64_t)coeffs.slopeNv * (tempC100 + KELVIN_OFFSET_C100);
+    if (denominator == 0) {
+        return INVALID;
+    }
+    int64_t ph = divRound(numerator, denominator);
+    if (ph < 0) {
+        ph = 0;
+    } else if (ph > 14000) {
+        ph = 14000;
+    }
+    return (int32_t)ph;
+}
+
+int32_t CalibrationFixed::conductivityPpm100(int32_t microVolts, int32_t tempC100,
+                                             const ConductivityFixed& coeffs) {
+    if (!coeffs.valid) {
+        return INVALID;
+    }
+    if (tempC100 == NO_TEMPERATURE) {
+        tempC100 = coeffs.calTempC100;
+    }
+    // Vc = V / (1 + k * (T - Tcal)), con la compensación escalada por 1e8
+    const int64_t compensation = 100000000LL + (int64_t)coeffs.coefCompPpm * (tempC100 - coeffs.calTempC100);
+    if (compensation <= 0) {
+        return INVALID;
+    }
+    const int64_t vc = divRound((int64_t)microVolts * 100000000LL, compensation);
+    const int64_t vc2 = (vc * vc) >> 16;
+    int64_t ppm100 = ((coeffs.a * vc2) >> coeffs.aShift) + ((coeffs.b * vc) >> coeffs.bShift) + coeffs.c;
+    if (ppm100 < 0) {
+        ppm100 = 0;
+    } else if (ppm100 > INT32_MAX) {
+        ppm100 = INT32_MAX;
+    }
+    return (int32_t)ppm100;
+}
@@ -0,0 +1,211 @@
+#include "CalibrationMath.h"
+#include <cmath>
+
+void CalibrationMath::steinhartHartCoeffs(double T1, double R1,
+                                          double T2, double R2,
+                                          double T3, double R3,
+                                          double &A, double &B, double &C) {
+    // 1/T = A + B*ln(R) + C*(ln(R))^3
+    double L1 = log(R1);
+    double L2 = log(R2);
+    double L3 = log(R3);
+    double Y1 = 1.0 / T1;
+    double Y2 = 1.0 / T2;
+    double Y3 = 1.0 / T3;
+    double L1_3 = L1 * L1 * L1;
+    double L2_3 = L2 * L2 * L2;
+    double L3_3 = L3 * L3 * L3;
+    double denominator = (L2 - L1) * (L3 - L1) * (L3 - L2);
+
+    if (fabs(denominator) < 1e-10) {
+        A = NAN;
+        B = NAN;
+        C = NAN;
+        return;
+    }
+
+    C = ((Y2 - Y1) * (L3 - L1) - (Y3 - Y1) * (L2 - L1)) /
+        ((L2_3 - L1_3) * (L3 - L1) - (L3_3 - L1_3) * (L2 - L1));
+    B = ((Y2 - Y1) - C * (L2_3 - L1_3)) / (L2 - L1);
+    A = Y1 - B * L1 - C * L1_3;
+}
+
+double CalibrationMath::steinhartHartTemperature(double resistance, double A, double B, double C) {
+    if (resistance <= 0.0) {
+        return NAN;
+    }
+    double lnR = log(resistance);
+    double invT = A + B * lnR + C * lnR*lnR*lnR;  // 1/T en Kelvin^-1
+    double tempK = 1.0 / invT;                     // Kelvin
+    double tempC = tempK - 273.15;                 // °C
+    return tempC;
+}
+
+double CalibrationMath::ntcResistanceFromDivider(double voltage, double vRef, double rFixed, bool ntcTop) {
+    // Validación de rangos
+    if (voltage <= 0.0 || voltage >= vRef) {
+        return -1.0;  // Indica valor inválido
+    }
+
+    double Rntc;
+    if (ntcTop) {
+        // NTC conectado a Vref (arriba) y resistencia fija a GND (abajo)
+        // Fórmula: Rntc = rFixed * (vRef - voltage) / voltage
+        Rntc = rFixed * ((vRef - voltage) / voltage);
+    } else {
+        // NTC conectado a GND (abajo) y resistencia fija a Vref (arriba)
+        // Fórmula: Rntc = rFixed * voltage / (vRef - voltage)
+        Rntc = rFixed * (voltage / (vRef - voltage));
+    }
+    return Rntc;
+}
+
+float CalibrationMath::phFromVoltage(float voltage, float tempC,
+                                     float V1, float T1, float V2, float T2, float V3, float T3,
+                                     float tempCal) {
+    // Si tempC es NAN, usar la temperatura de calibración como valor por defecto
+    if (std::isnan(tempC)) {
+        tempC = tempCal;
+    }
+    const double pH_calib[] = {T1, T2, T3};
+    const double V_calib[] = {V1, V2, V3};
+    const int n = 3;
+    double sum_pH = 0.0;
+    double sum_V = 0.0;
+    double sum_pHV = 0.0;
+    double sum_pH2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum_pH += pH_calib[i];
+        sum_V += V_calib[i];
+        sum_pHV += pH_calib[i] * V_calib[i];
+        sum_pH2 += pH_calib[i] * pH_calib[i];
+    }
+    double S_CAL = ((n * sum_pHV) - (sum_pH * sum_V)) / ((n * sum_pH2) - (sum_pH * sum_pH));
+    double E0 = ((sum_V) + (S_CAL * sum_pH)) / n;
+    const double tempK = (tempC + 273.15);
+    const double tempCalK = (tempCal + 273.15);
+    const double S_T = S_CAL * (tempK / tempCalK);
+    double pH = ((E0 + voltage) / S_T);
+    if (pH < 0.0) {
+        pH = 0.0;
+    } else if (pH > 14.0) {
+        pH = 14.0;
+    }
+    return pH;
+}
+
+float CalibrationMath::conductivityFromVoltage(float voltage, float tempC, float calTemp, float coefComp,
+                                               float V1, float T1, float V2, float T2, float V3, float T3) {
+    // Si tempC es NAN, usar la temperatura de calibración como valor por defecto
+    if (std::isnan(tempC)) {
+        tempC = calTemp;
+    }
+
+    // Matriz para resolver el sistema de ecuaciones
+    // Basado en 3 puntos de calibración
+    const double det = V1*V1*(V2 - V3) - V1*(V2*V2 - V3*V3) + (V2*V2*V3 - V2*V3*V3);
+    if (fabs(det) <= 1e-6) {
+        return NAN;
+    }
+    const double a = (T1*(V2 - V3) - T2*(V1 - V3) + T3*(V1 - V2)) / det;
+    const double b = (T1*(V3*V3 - V2*V2) + T2*(V1*V1 - V3*V3) + T3*(V2*V2 - V1*V1)) / det;
+    const double c = (T1*(V2*V2*V3 - V2*V3*V3) - T2*(V1*V1*V3 - V1*V3*V3) + T3*(V1*V1*V2 - V1*V2*V2)) / det;
+
+    // Aplicar compensación de temperatura
+    const double compensation = 1.0 + coefComp * (tempC - calTemp);
+    double compensatedVoltage = voltage / compensation;
+    double conductivity = a * (compensatedVoltage * compensatedVoltage)
+        + b * compensatedVoltage
+        + c;
+    return fmax(conductivity, 0.0);
+}
+
+float CalibrationMath::batteryVoltage(float adcVoltage, float r1, float r2) {
+    // VBAT = VADC / (R1 / (R1 + R2))
+    return adcVoltage / (r1 / (r1 + r2));
+}
+
+SteinhartHartCoeffs CalibrationMath::solveSteinhartHart(double t1C, double r1,
+                                                        double t2C, double r2,
+                                                        double t3C, double r3) {
+    double A, B, C;
+    steinhartHartCoeffs(t1C + 273.15, r1, t2C + 273.15, r2, t3C + 273.15, r3, A, B, C);
+    return SteinhartHartCoeffs{(float)A, (float)B, (float)C};
+}
+
+PhCoeffs CalibrationMath::solvePh(float V1, float T1, float V2, float T2, float V3, float T3,
+                                  float tempCal) {
+    const double pH_calib[] = {T1, T2, T3};
+    const double V_calib[] = {V1, V2, V3};
+    const int n = 3;
+    double sum_pH = 0.0;
+    double sum_V = 0.0;
+    double sum_pHV = 0.0;
+    double sum_pH2 = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum_pH += pH_calib[i];
+        sum_V += V_calib[i];
+        sum_pHV += pH_calib[i] * V_calib[i];
+        sum_pH2 += pH_calib[i] * pH_calib[i];
+    }
+    double S_CAL = ((n * sum_pHV) - (sum_pH * sum_V)) / ((n * sum_pH2) - (sum_pH * sum_pH));
+    double E0 = ((sum_V) + (S_CAL * sum_pH)) / n;
+    return PhCoeffs{(float)E0, (float)S_CAL, (float)(tempCal + 273.15), tempCal};
+}
+
+ConductivityCoeffs CalibrationMath::solveConductivity(float calTemp, float coefComp,
+                                                      float V1, float T1, float V2, float T2,
+                                                      float V3, float T3) {
+    ConductivityCoeffs coeffs{NAN, NAN, NAN, calTemp, coefComp};
+    const double det = V1*V1*(V2 - V3) - V1*(V2*V2 - V3*V3) + (V2*V2*V3 - V2*V3*V3);
+    if (fabs(det) <= 1e-6) {
+        return coeffs;
+    }
+    coeffs.a = (float)((T1*(V2 - V3) - T2*(V1 - V3) + T3*(V1 - V2)) / det);
+    coeffs.b = (float)((T1*(V3*V3 - V2*V2) + T2*(V1*V1 - V3*V3) + T3*(V2*V2 - V1*V1)) / det);
+    coeffs.c = (float)((T1*(V2*V2*V3 - V2*V3*V3) - T2*(V1*V1*V3 - V1*V3*V3) + T3*(V1*V1*V2 - V1*V2*V2)) / det);
+    return coeffs;
+}
+
+float CalibrationMath::evaluateSteinhartHart(float resistance, const SteinhartHartCoeffs& coeffs) {
+    if (resistance <= 0.0f) {
+        return NAN;
+    }
+    float lnR = logf(resistance);
+    float invT = coeffs.A + lnR * (coeffs.B + coeffs.C * lnR * lnR);
+    return 1.0f / invT - 273.15f;
+}
+
+float CalibrationMath::ntcResistanceFromDividerF(float voltage, float vRef, float rFixed, bool ntcTop) {
+    if (voltage <= 0.0f || voltage >= vRef) {
+        return -1.0f;
+    }
+    return ntcTop ? rFixed * ((vRef - voltage) / voltage)
+                  : rFixed * (voltage / (vRef - voltage));
+}
+
+float CalibrationMath::evaluatePh(float voltage, float tempC, const PhCoeffs& coeffs) {
+    if (std::isnan(tempC)) {
+        tempC = coeffs.calTempC;
+    }
+    const float S_T = coeffs.slope * ((tempC + 273.15f) / coeffs.calTempK);
+    float pH = (coeffs.e0 + voltage) / S_T;
+    if (pH < 0.0f) {
+        pH = 0.0f;
+    } else if (pH > 14.0f) {
+        pH = 14.0f;
+    }
+    return pH;
+}
+
+float CalibrationMath::evaluateConductivity(float voltage, float tempC, const ConductivityCoeffs& coeffs) {
+    if (std::isnan(coeffs.a)) {
+        return NAN;
+    }
+    if (std::isnan(tempC)) {
+        tempC = coeffs.calTempC;
+    }
+    const float compensatedVoltage = voltage / (1.0f + coeffs.coefComp * (tempC - coeffs.calTempC));
+    const float conductivity = (coeffs.a * compensatedVoltage + coeffs.b) * compensatedVoltage + coeffs.c;
+    return fmaxf(conductivity, 0.0f);
+}
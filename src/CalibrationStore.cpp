@@ -0,0 +1,190 @@
+#include "CalibrationStore.h"
+#include <stddef.h>
+#include <string.h>
+#include "config.h"
+#include "debug.h"
+#include "hal/Hal.h"
+#include "util/crc16.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// Copia en RTC RAM: sobrevive al deep sleep, se pone a cero en un arranque en frío
+RTC_DATA_ATTR static CalibrationCoeffs rtcCoeffs;
+
+static bool loaded = false;
+
+static uint16_t coeffsCrc(const CalibrationCoeffs& coeffs) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&coeffs);
+    const size_t start = offsetof(CalibrationCoeffs, ntc100k);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = start; i < sizeof(CalibrationCoeffs); i++) {
+        crc = crc16_update(crc, bytes[i]);
+    }
+    return crc;
+}
+
+static bool isValid(const CalibrationCoeffs& coeffs) {
+    return coeffs.version == Calibration::COEFFS_VERSION && coeffs.crc == coeffsCrc(coeffs);
+}
+
+/**
+ * @brief Deriva las versiones en punto fijo de los coeficientes float
+ */
+static void deriveFixed(CalibrationCoeffs& coeffs) {
+    coeffs.ntc100kFixed = CalibrationFixed::fromFloat(coeffs.ntc100k);
+    coeffs.ntc10kFixed = CalibrationFixed::fromFloat(coeffs.ntc10k);
+    coeffs.phFixed = CalibrationFixed::fromFloat(coeffs.ph);
+    coeffs.conductivityFixed = CalibrationFixed::fromFloat(coeffs.conductivity);
+}
+
+/**
+ * @brief Coeficientes de Calibration:: para cuando no hay blob (primer arranque sin migrar)
+ */
+static void fillDefaults(CalibrationCoeffs& coeffs) {
+    memset(&coeffs, 0, sizeof(coeffs));
+    coeffs.version = Calibration::COEFFS_VERSION;
+    {
+        using namespace Calibration::NTC100K;
+        coeffs.ntc100k = CalibrationMath::solveSteinhartHart(DEFAULT_T1, DEFAULT_R1, DEFAULT_T2,
+                                                             DEFAULT_R2, DEFAULT_T3, DEFAULT_R3);
+        NtcTable::build(coeffs.ntc100k, NtcDivider{DEFAULT_R_FIXED, DEFAULT_VREF_MV, DEFAULT_NTC_TOP, 0},
+                        coeffs.ntc100kLut);
+    }
+    {
+        using namespace Calibration::NTC10K;
+        coeffs.ntc10k = CalibrationMath::solveSteinhartHart(DEFAULT_T1, DEFAULT_R1, DEFAULT_T2,
+                                                            DEFAULT_R2, DEFAULT_T3, DEFAULT_R3);
+        NtcTable::build(coeffs.ntc10k, NtcDivider{DEFAULT_R_FIXED, DEFAULT_VREF_MV, DEFAULT_NTC_TOP, 0},
+                        coeffs.ntc10kLut);
+    }
+    {
+        using namespace Calibration::PH;
+        coeffs.ph = CalibrationMath::solvePh(DEFAULT_V1, DEFAULT_T1, DEFAULT_V2, DEFAULT_T2,
+                                             DEFAULT_V3, DEFAULT_T3, DEFAULT_TEMP);
+    }
+    {
+        using namespace Calibration::Conductivity;
+        coeffs.conductivity = CalibrationMath::solveConductivity(DEFAULT_TEMP, TEMP_COEF_COMPENSATION,
+                                                                 DEFAULT_V1, DEFAULT_T1, DEFAULT_V2,
+                                                                 DEFAULT_T2, DEFAULT_V3, DEFAULT_T3);
+    }
+    deriveFixed(coeffs);
+    coeffs.crc = coeffsCrc(coeffs);
+}
+
+bool CalibrationStore::load() {
+    if (isValid(rtcCoeffs)) {
+        loaded = true;
+        return true;
+    }
+
+    CalibrationCoeffs stored;
+    size_t length = HalNvs::getBytes(JsonKeys::NS_CALIBRATION, Calibration::KEY_COEFFS,
+                                     &stored, sizeof(stored));
+    if (length != sizeof(stored) || !isValid(stored)) {
+        DEBUG_PRINTLN("Calibración: no hay coeficientes válidos en NVS");
+        return false;
+    }
+    rtcCoeffs = stored;
+    loaded = true;
+    return true;
+}
+
+const CalibrationCoeffs& CalibrationStore::current() {
+    if (!loaded && !load()) {
+        fillDefaults(rtcCoeffs);
+        loaded = true;
+    }
+    return rtcCoeffs;
+}
+
+void CalibrationStore::commit() {
+    rtcCoeffs.version = Calibration::COEFFS_VERSION;
+    deriveFixed(rtcCoeffs);
+    rtcCoeffs.crc = coeffsCrc(rtcCoeffs);
+    loaded = true;
+    if (HalNvs::putBytes(JsonKeys::NS_CALIBRATION, Calibration::KEY_COEFFS,
+                         &rtcCoeffs, sizeof(rtcCoeffs)) != sizeof(rtcCoeffs)) {
+        DEBUG_PRINTLN("Calibración: error al guardar los coeficientes en NVS");
+    }
+}
+
+void CalibrationStore::setNtc100k(double t1, double r1, double t2, double r2, double t3, double r3,
+                                  const NtcDivider& divider) {
+    current();
+    rtcCoeffs.ntc100k = CalibrationMath::solveSteinhartHart(t1, r1, t2, r2, t3, r3);
+    NtcTable::build(rtcCoeffs.ntc100k, divider, rtcCoeffs.ntc100kLut);
+    commit();
+}
+
+void CalibrationStore::setNtc10k(double t1, double r1, double t2, double r2, double t3, double r3,
+                                 const NtcDivider& divider) {
+    current();
+    rtcCoeffs.ntc10k = CalibrationMath::solveSteinhartHart(t1, r1, t2, r2, t3, r3);
+    NtcTable::build(rtcCoeffs.ntc10k, divider, rtcCoeffs.ntc10kLut);
+    commit();
+}
+
+void CalibrationStore::setPh(float v1, float t1, float v2, float t2, float v3, float t3, float tempCal) {
+    current();
+    rtcCoeffs.ph = CalibrationMath::solvePh(v1, t1, v2, t2, v3, t3, tempCal);
+    commit();
+}
+
+void CalibrationStore::setConductivity(float calTemp, float coefComp,
+                                       float v1, float t1, float v2, float t2, float v3, float t3) {
+    current();
+    rtcCoeffs.conductivity = CalibrationMath::solveConductivity(calTemp, coefComp,
+                                                                v1, t1, v2, t2, v3, t3);
+    commit();
+}
+
+void CalibrationStore::clear() {
+    HalNvs::remove(JsonKeys::NS_CALIBRATION, Calibration::KEY_COEFFS);
+    memset(&rtcCoeffs, 0, sizeof(rtcCoeffs));
+    loaded = false;
+}
+
+const SteinhartHartCoeffs& CalibrationStore::ntc100k() {
+    return current().ntc100k;
+}
+
+const SteinhartHartCoeffs& CalibrationStore::ntc10k() {
+    return current().ntc10k;
+}
+
+const PhCoeffs& CalibrationStore::ph() {
+    return current().ph;
+}
+
+const ConductivityCoeffs& CalibrationStore::conductivity() {
+    return current().conductivity;
+}
+
+const SteinhartHartFixed& CalibrationStore::ntc100kFixed() {
+    return current().ntc100kFixed;
+}
+
+const SteinhartHartFixed& CalibrationStore::ntc10kFixed() {
+    return current().ntc10kFixed;
+}
+
+const PhFixed& CalibrationStore::phFixed() {
+    return current().phFixed;
+}
+
+const ConductivityFixed& CalibrationStore::conductivityFixed() {
+    return current().conductivityFixed;
+}
+
+const NtcLut& CalibrationStore::ntc100kLut() {
+    return current().ntc100kLut;
+}
+
+const NtcLut& CalibrationStore::ntc10kLut() {
+    return current().ntc10kLut;
+}
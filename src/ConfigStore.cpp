@@ -0,0 +1,75 @@
+#include "ConfigStore.h"
+#include <stddef.h>
+#include <string.h>
+#include "debug.h"
+#include "hal/Hal.h"
+#include "util/crc16.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+RTC_DATA_ATTR static uint32_t configGeneration = 0;
+
+static ConfigImage configImage;
+static bool configLoaded = false;
+
+static uint16_t imageCrc(const ConfigImage& image) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&image);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = offsetof(ConfigImage, size); i < sizeof(ConfigImage); i++) {
+        crc = crc16_update(crc, bytes[i]);
+    }
+    return crc;
+}
+
+bool ConfigStore::load() {
+    size_t length = HalNvs::getBytes(JsonKeys::NS_CONFIG, JsonKeys::KEY_CONFIG_IMAGE,
+                                     &configImage, sizeof(configImage));
+    configLoaded = length == sizeof(ConfigImage) &&
+                   configImage.version == System::CONFIG_IMAGE_VERSION &&
+                   configImage.size == sizeof(ConfigImage) &&
+                   configImage.crc == imageCrc(configImage);
+    if (!configLoaded) {
+        DEBUG_PRINTLN("ConfigStore: no hay imagen de configuración válida en NVS");
+        memset(&configImage, 0, sizeof(configImage));
+    }
+    return configLoaded;
+}
+
+bool ConfigStore::save() {
+    configImage.version = System::CONFIG_IMAGE_VERSION;
+    configImage.reserved = 0;
+    configImage.size = sizeof(ConfigImage);
+    configImage.crc = imageCrc(configImage);
+    configLoaded = true;
+    configGeneration++;
+
+    if (HalNvs::putBytes(JsonKeys::NS_CONFIG, JsonKeys::KEY_CONFIG_IMAGE,
+                         &configImage, sizeof(configImage)) != sizeof(configImage)) {
+        DEBUG_PRINTLN("ConfigStore: error al guardar la imagen de configuración");
+        return false;
+    }
+    return true;
+}
+
+void ConfigStore::clear() {
+    HalNvs::remove(JsonKeys::NS_CONFIG, JsonKeys::KEY_CONFIG_IMAGE);
+    memset(&configImage, 0, sizeof(configImage));
+    configLoaded = false;
+    configGeneration++;
+}
+
+bool ConfigStore::isLoaded() {
+    return configLoaded;
+}
+
+ConfigImage& ConfigStore::image() {
+    return configImage;
+}
+
+uint32_t ConfigStore::generation() {
+    return configGeneration;
+}
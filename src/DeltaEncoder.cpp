@@ -0,0 +1,151 @@
+#include "DeltaEncoder.h"
+#include <string.h>
+#include "PayloadFormat.h"
+#include "util/varint.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+static const size_t MAX_CHANNELS = MAX_READINGS * MAX_SUB_VALUES;
+static const size_t KEYFRAME_HEADER_SIZE = 8;
+static const uint8_t SEQUENCE_MASK = 0x07;
+
+/**
+ * @brief Canales de un despertar en punto fijo, en el orden del payload binario
+ */
+struct QuantizedFrame {
+    uint16_t schema;
+    uint16_t channels;
+    uint32_t timestamp;
+    uint8_t present[(MAX_CHANNELS + 7) / 8];
+    int32_t values[MAX_CHANNELS];
+};
+
+// Keyframe de referencia
+RTC_DATA_ATTR static bool referenceValid = false;
+RTC_DATA_ATTR static uint8_t referenceSequence = 0;
+RTC_DATA_ATTR static uint8_t referenceFrames = 0;
+RTC_DATA_ATTR static QuantizedFrame reference;
+
+// Último build(), a la espera de commit()
+static QuantizedFrame pending;
+static bool pendingKeyframe = false;
+static bool pendingValid = false;
+
+static void quantizeReadings(const ReadingSet& readings, uint32_t timestamp, QuantizedFrame& frame) {
+    frame.schema = PayloadFormat::schemaId(readings);
+    frame.timestamp = timestamp;
+    memset(frame.present, 0, sizeof(frame.present));
+    size_t index = 0;
+    for (const auto& reading : readings) {
+        const uint8_t channels = PayloadFormat::channelCount(reading);
+        for (uint8_t c = 0; c < channels && index < MAX_CHANNELS; c++, index++) {
+            const float value = reading.subValues.empty() ? reading.value : reading.subValues[c].value;
+            if (PayloadFormat::quantize(value, PayloadFormat::channelEncoding(reading.type, c),
+                                        frame.values[index])) {
+                frame.present[index / 8] |= (uint8_t)(1u << (index % 8));
+            }
+        }
+    }
+    frame.channels = (uint16_t)index;
+}
+
+/**
+ * @brief Indica si el delta puede ir contra la referencia: mismo esquema y mismos
+ *        canales presentes, dentro del intervalo de keyframes
+ */
+static bool fitsReference(const QuantizedFrame& frame) {
+    return referenceValid && referenceFrames + 1 < LoRa::DELTA_KEYFRAME_INTERVAL &&
+           frame.schema == reference.schema && frame.channels == reference.channels &&
+           (int32_t)(frame.timestamp - reference.timestamp) >= 0 &&
+           memcmp(frame.present, reference.present, (frame.channels + 7) / 8) == 0;
+}
+
+static size_t buildDelta(uint8_t* buffer, size_t bufferSize) {
+    if (bufferSize < 1) {
+        return 0;
+    }
+    const uint8_t frameNumber = (uint8_t)(referenceFrames + 1);
+    buffer[0] = (uint8_t)((referenceSequence << 5) | frameNumber);
+    size_t offset = 1;
+
+    size_t written = varint_put(pending.timestamp - reference.timestamp, buffer + offset, bufferSize - offset);
+    if (written == 0) {
+        return 0;
+    }
+    offset += written;
+
+    for (size_t i = 0; i < pending.channels; i++) {
+        if (!(pending.present[i / 8] & (1u << (i % 8)))) {
+            continue;
+        }
+        // Resta modular: los bits de un F32 también se recuperan exactos
+        const int32_t delta = (int32_t)((uint32_t)pending.values[i] - (uint32_t)reference.values[i]);
+        written = varint_put(zigzag_encode(delta), buffer + offset, bufferSize - offset);
+        if (written == 0) {
+            return 0;
+        }
+        offset += written;
+    }
+    return offset;
+}
+
+size_t DeltaEncoder::build(const ReadingSet& readings, uint32_t timestamp, uint8_t* buffer, size_t bufferSize,
+                           uint8_t& fPort) {
+    pendingValid = false;
+    quantizeReadings(readings, timestamp, pending);
+
+    if (fitsReference(pending)) {
+        size_t size = buildDelta(buffer, bufferSize);
+        if (size > 0) {
+            pendingKeyframe = false;
+            pendingValid = true;
+            fPort = LoRa::FPORT_DELTA;
+            return size;
+        }
+    }
+
+    if (bufferSize < KEYFRAME_HEADER_SIZE) {
+        return 0;
+    }
+    size_t size = PayloadFormat::binary(readings, timestamp, buffer, bufferSize);
+    if (size == 0 || size + 1 > bufferSize) {
+        return 0;
+    }
+    // Mismo payload binario con la secuencia del keyframe tras la cabecera
+    memmove(buffer + KEYFRAME_HEADER_SIZE, buffer + KEYFRAME_HEADER_SIZE - 1, size - (KEYFRAME_HEADER_SIZE - 1));
+    buffer[KEYFRAME_HEADER_SIZE - 1] = referenceValid ? (uint8_t)((referenceSequence + 1) & SEQUENCE_MASK) : 0;
+    pendingKeyframe = true;
+    pendingValid = true;
+    fPort = LoRa::FPORT_KEYFRAME;
+    return size + 1;
+}
+
+void DeltaEncoder::commit() {
+    if (!pendingValid) {
+        return;
+    }
+    if (pendingKeyframe) {
+        referenceSequence = referenceValid ? (uint8_t)((referenceSequence + 1) & SEQUENCE_MASK) : 0;
+        reference = pending;
+        referenceFrames = 0;
+        referenceValid = true;
+    } else {
+        referenceFrames++;
+    }
+    pendingValid = false;
+}
+
+void DeltaEncoder::reset() {
+    referenceValid = false;
+    referenceSequence = 0;
+    referenceFrames = 0;
+    pendingValid = false;
+}
+
+uint8_t DeltaEncoder::framesSinceKeyframe() {
+    return referenceFrames;
+}
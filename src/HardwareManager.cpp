@@ -6,8 +6,11 @@
 #include "HardwareManager.h"
 #include "debug.h"
 #include "ModbusSensorManager.h"
-#include "SensorManager.h"
-#include "driver/gpio.h"
+#include "hal/Hal.h"
+
+#ifdef ARDUINO
+#include <SPI.h>
+#endif
 
 bool HardwareManager::i2cInitialized = false;
 bool HardwareManager::oneWireInitialized = false;
@@ -17,10 +20,10 @@ bool HardwareManager::spiInitialized = false;
 
 void HardwareManager::initialize() {
 
-    pinMode(Pins::BATTERY_CONTROL, OUTPUT);
-    digitalWrite(Pins::BATTERY_CONTROL, HIGH);
-    pinMode(Pins::CONFIG_LED, OUTPUT);
-    digitalWrite(Pins::CONFIG_LED, LOW);
+    HalGpio::setOutput(Pins::BATTERY_CONTROL);
+    HalGpio::write(Pins::BATTERY_CONTROL, true);
+    HalGpio::setOutput(Pins::CONFIG_LED);
+    HalGpio::write(Pins::CONFIG_LED, false);
 
     PowerManager::begin();
 }
@@ -29,7 +32,7 @@ void HardwareManager::initializeBus(CommunicationProtocol protocol) {
     switch (protocol) {
         case CommunicationProtocol::I2C:
             if (!i2cInitialized) {
-                Wire.begin(Pins::I2C_SDA, Pins::I2C_SCL);
+                HalI2c::begin(Pins::I2C_SDA, Pins::I2C_SCL);
                 i2cInitialized = true;
             }
             break;
@@ -46,8 +49,8 @@ void HardwareManager::initializeBus(CommunicationProtocol protocol) {
             break;
         case CommunicationProtocol::ANALOG_ADC:
             if (!analogInitialized) {
-                analogReadResolution(13);
-                analogSetAttenuation(ADC_11db);
+                HalAdc::setResolution(13);
+                HalAdc::setFullScaleAttenuation();
                 analogInitialized = true;
             }
             break;
@@ -64,7 +67,11 @@ void HardwareManager::initializeBus(CommunicationProtocol protocol) {
 bool HardwareManager::initHardware(SPIClass& spiLora) {
     initialize();
 
+#ifdef ARDUINO
     spiLora.begin(Pins::LoRaSPI::SCK, Pins::LoRaSPI::MISO, Pins::LoRaSPI::MOSI);
+#else
+    (void)spiLora;
+#endif
 
     initializeSPISSPins();
 
@@ -74,9 +81,9 @@ bool HardwareManager::initHardware(SPIClass& spiLora) {
 }
 
 void HardwareManager::initializeSPISSPins() {
-    pinMode(Pins::LoRaSPI::NSS, OUTPUT);
-    digitalWrite(Pins::LoRaSPI::NSS, HIGH);
+    HalGpio::setOutput(Pins::LoRaSPI::NSS);
+    HalGpio::write(Pins::LoRaSPI::NSS, true);
 
-    pinMode(Pins::RtdSPI::PT100_CS, OUTPUT);
-    digitalWrite(Pins::RtdSPI::PT100_CS, HIGH);
+    HalGpio::setOutput(Pins::RtdSPI::PT100_CS);
+    HalGpio::write(Pins::RtdSPI::PT100_CS, true);
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "HeapCounter.h"
+
+#ifdef HEAP_COUNTER
+
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+// Atómicos: en el S3 las tareas del pipeline asignan desde los dos núcleos
+static std::atomic<uint32_t> allocationCount(0);
+static std::atomic<uint32_t> allocationBytes(0);
+
+static void* countedAlloc(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add((uint32_t)size, std::memory_order_relaxed);
+    void* ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        abort();
+    }
+    return ptr;
+}
+
+void* operator new(size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size) {
+    return countedAlloc(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocationBytes.fetch_add((uint32_t)size, std::memory_order_relaxed);
+    return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept {
+    free(ptr);
+}
+
+bool HeapCounter::isEnabled() {
+    return true;
+}
+
+uint32_t HeapCounter::allocations() {
+    return allocationCount.load(std::memory_order_relaxed);
+}
+
+uint32_t HeapCounter::bytes() {
+    return allocationBytes.load(std::memory_order_relaxed);
+}
+
+void HeapCounter::reset() {
+    allocationCount.store(0, std::memory_order_relaxed);
+    allocationBytes.store(0, std::memory_order_relaxed);
+}
+
+#else
+
+bool HeapCounter::isEnabled() {
+    return false;
+}
+
+uint32_t HeapCounter::allocations() {
+    return 0;
+}
+
+uint32_t HeapCounter::bytes() {
+    return 0;
+}
+
+void HeapCounter::reset() {
+}
+
+#endif // HEAP_COUNTER
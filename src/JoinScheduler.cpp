@@ -0,0 +1,103 @@
+#include "JoinScheduler.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+static_assert(LoRa::JOIN_DR_MIN <= LoRa::JOIN_DR_MAX && LoRa::JOIN_DR_MAX <= 4,
+              "JOIN_DR_MIN..JOIN_DR_MAX deben ser DR de uplink de US915");
+static_assert(LoRa::JOIN_DAILY_AIRTIME_MS >= JoinScheduler::joinAirtimeMs(LoRa::JOIN_DR_MIN),
+              "el presupuesto diario no alcanza para un Join-Request en JOIN_DR_MIN");
+
+RTC_DATA_ATTR static uint8_t failureCount = 0;
+RTC_DATA_ATTR static uint32_t nextAttempt = 0;
+RTC_DATA_ATTR static uint32_t windowStart = 0;
+RTC_DATA_ATTR static uint32_t windowAirtimeMs = 0;
+
+/**
+ * @brief Abre una ventana de presupuesto nueva si la actual venció o el reloj volvió
+ *        atrás (sincronización de la hora)
+ */
+static void refreshWindow(uint32_t now) {
+    if (windowAirtimeMs == 0 || now < windowStart || now - windowStart >= JoinScheduler::BUDGET_WINDOW_S) {
+        windowStart = now;
+        windowAirtimeMs = 0;
+    }
+}
+
+static bool withinBudget(uint32_t now) {
+    refreshWindow(now);
+    return windowAirtimeMs + JoinScheduler::joinAirtimeMs(JoinScheduler::datarate()) <=
+           LoRa::JOIN_DAILY_AIRTIME_MS;
+}
+
+bool JoinScheduler::isDue(uint32_t now) {
+    return secondsUntilDue(now) == 0;
+}
+
+uint32_t JoinScheduler::secondsUntilDue(uint32_t now) {
+    uint32_t wait = 0;
+    // Un reloj que volvió atrás no debe dejar el join bloqueado hasta alcanzar nextAttempt
+    if (failureCount > 0 && (int32_t)(nextAttempt - now) > 0 &&
+        nextAttempt - now <= LoRa::JOIN_BACKOFF_MAX_S) {
+        wait = nextAttempt - now;
+    }
+    if (!withinBudget(now)) {
+        uint32_t windowEnd = BUDGET_WINDOW_S - (now - windowStart);
+        wait = windowEnd > wait ? windowEnd : wait;
+    }
+    return wait;
+}
+
+uint8_t JoinScheduler::datarate() {
+    const uint8_t steps = LoRa::JOIN_DR_MAX - LoRa::JOIN_DR_MIN + 1;
+    return (uint8_t)(LoRa::JOIN_DR_MAX - failureCount % steps);
+}
+
+void JoinScheduler::recordAttempt(uint32_t now, uint8_t datarate, bool joined, uint32_t random) {
+    refreshWindow(now);
+    windowAirtimeMs += joinAirtimeMs(datarate);
+
+    if (joined) {
+        failureCount = 0;
+        nextAttempt = now;
+        return;
+    }
+    if (failureCount < UINT8_MAX) {
+        failureCount++;
+    }
+    nextAttempt = now + backoffSeconds(failureCount, random);
+}
+
+uint32_t JoinScheduler::backoffSeconds(uint8_t failures, uint32_t random) {
+    if (failures == 0) {
+        return 0;
+    }
+    uint32_t backoff = LoRa::JOIN_BACKOFF_BASE_S;
+    for (uint8_t i = 1; i < failures && backoff < LoRa::JOIN_BACKOFF_MAX_S; i++) {
+        backoff *= 2;
+    }
+    if (backoff > LoRa::JOIN_BACKOFF_MAX_S) {
+        backoff = LoRa::JOIN_BACKOFF_MAX_S;
+    }
+    const uint32_t half = backoff / 2;
+    return half + random % (backoff - half + 1);
+}
+
+uint8_t JoinScheduler::failures() {
+    return failureCount;
+}
+
+uint32_t JoinScheduler::airtimeUsedMs(uint32_t now) {
+    refreshWindow(now);
+    return windowAirtimeMs;
+}
+
+void JoinScheduler::reset() {
+    failureCount = 0;
+    nextAttempt = 0;
+    windowStart = 0;
+    windowAirtimeMs = 0;
+}
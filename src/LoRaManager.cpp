@@ -14,6 +14,14 @@
 #include "config.h"  // Incluido para acceder a todas las constantes de configuración
 #include "sensor_types.h"  // Incluido para acceder a ModbusSensorReading
 #include "config_manager.h"
+#include "WakeProfiler.h"
+#include "PayloadFormat.h"
+#include "SampleBatch.h"
+#include "DeltaEncoder.h"
+#include "PayloadPlanner.h"
+#include "SessionStore.h"
+#include "JoinScheduler.h"
+#include "OutageBuffer.h"
 
 LoRaWANNode* LoRaManager::node = nullptr;
 SX1262* LoRaManager::radioModule = nullptr;
@@ -21,6 +29,19 @@ SX1262* LoRaManager::radioModule = nullptr;
 extern RTC_DATA_ATTR uint8_t LWsession[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
 extern ESP32Time rtc;
 
+// Último esquema anunciado al servidor y uplinks binarios desde entonces
+RTC_DATA_ATTR static uint16_t announcedSchemaId = 0;
+RTC_DATA_ATTR static uint16_t uplinksSinceAnnounce = 0;
+
+// La sesión de este despertar está activa (restaurada o recién unida)
+static bool sessionActive = false;
+
+// Despertares en que aún se pedirá la hora al servidor tras el join
+RTC_DATA_ATTR static uint8_t timeSyncAttemptsLeft = 0;
+
+static_assert(RADIOLIB_LORAWAN_SESSION_BUF_SIZE <= LoRa::SESSION_MAX_SIZE,
+              "La sesión de RadioLib no cabe en una ranura de SessionStore");
+
 int16_t LoRaManager::begin(SX1262* radio, const LoRaWANBand_t* region, uint8_t subBand) {
     radioModule = radio;
     int16_t state = radioModule->begin();
@@ -36,18 +57,12 @@ int16_t LoRaManager::lwActivate(LoRaWANNode& node) {
     int16_t state = RADIOLIB_ERR_UNKNOWN;
     Preferences store;
 
-    LoRaConfig loraConfig = ConfigManager::getLoRaConfig();
-
     uint64_t joinEUI = 0, devEUI = 0;
-    if (!parseEUIString(loraConfig.joinEUI.c_str(), &joinEUI) ||
-        !parseEUIString(loraConfig.devEUI.c_str(), &devEUI)) {
+    uint8_t nwkKey[16], appKey[16];
+    if (!ConfigManager::getLoRaKeys(joinEUI, devEUI, nwkKey, appKey)) {
         return state;
     }
 
-    uint8_t nwkKey[16], appKey[16];
-    parseKeyString(loraConfig.nwkKey, nwkKey, 16);
-    parseKeyString(loraConfig.appKey, appKey, 16);
-
     node.beginOTAA(joinEUI, devEUI, nwkKey, appKey);
 
     store.begin("radiolib");
@@ -62,132 +77,170 @@ int16_t LoRaManager::lwActivate(LoRaWANNode& node) {
 
             if (state == RADIOLIB_ERR_NONE) {
                 state = node.activateOTAA();
+            }
+
+            // Sin sesión en RTC (corte de energía): probar con la copia en flash
+            bool fromFlash = false;
+            if (state != RADIOLIB_LORAWAN_SESSION_RESTORED && restoreSessionFromFlash(node)) {
+                state = node.activateOTAA();
+                fromFlash = true;
+            }
 
-                if (state == RADIOLIB_LORAWAN_SESSION_RESTORED) {
-                    store.end();
-                    DEBUG_PRINTLN("Sesión LoRaWAN restaurada");
+            if (state == RADIOLIB_LORAWAN_SESSION_RESTORED) {
+                store.end();
+                sessionActive = true;
+                DEBUG_PRINTF("Sesión LoRaWAN restaurada%s\n", fromFlash ? " desde flash" : "");
 
-                    // IMPORTANTE: Deshabilitar ADR para evitar que el servidor cambie el DR
-                    node.setADR(false);
-                    DEBUG_PRINTLN("ADR deshabilitado - manteniendo DR fijo");
+                // IMPORTANTE: Deshabilitar ADR para evitar que el servidor cambie el DR
+                node.setADR(false);
+                DEBUG_PRINTLN("ADR deshabilitado - manteniendo DR fijo");
 
-                    // Forzar DR3 después de restaurar sesión
-                    node.setDatarate(LoRa::DEFAULT_DATARATE);
-                    DEBUG_PRINTF("Data Rate forzado a DR%d (SF7BW125)\n", LoRa::DEFAULT_DATARATE);
+                // Forzar DR3 después de restaurar sesión
+                node.setDatarate(LoRa::DEFAULT_DATARATE);
+                DEBUG_PRINTF("Data Rate forzado a DR%d (SF7BW125)\n", LoRa::DEFAULT_DATARATE);
 
-                    // Configurar dwell time para US915 (400ms límite)
-                    node.setDwellTime(true, 400);
+                // Configurar dwell time para US915 (400ms límite)
+                node.setDwellTime(true, 400);
 
-                    return state;
+                // La copia en flash ya no sirve: sus contadores se saltaron
+                if (fromFlash) {
+                    checkpointSession(node, true);
                 }
+
+                return syncTimeIfPending(node, state);
             }
         }
     } else {
         DEBUG_PRINTLN("No hay nonces guardados - iniciando nuevo join");
     }
 
-    state = RADIOLIB_ERR_NETWORK_NOT_JOINED;
-    while (state != RADIOLIB_LORAWAN_NEW_SESSION) {
-        state = node.activateOTAA();
-
-        if (state == RADIOLIB_LORAWAN_NEW_SESSION) {
-            uint8_t buffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
-            uint8_t *persist = node.getBufferNonces();
-            memcpy(buffer, persist, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
-            store.putBytes("nonces", buffer, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
-
-            // Solicitar DeviceTime después de un join exitoso
-            delay(1000); // Pausa para estabilización
-            node.setADR(false);
-            node.setDatarate(LoRa::DEFAULT_DATARATE);
-
-            int rtcAttempts = 0;
-            bool rtcUpdated = false;
-            const int maxAttempts = 3; // Máximo número de intentos para actualizar RTC
-            
-            while (!rtcUpdated && rtcAttempts < maxAttempts) {
-                rtcAttempts++;
-
-                bool macCommandSuccess = node.sendMacCommandReq(RADIOLIB_LORAWAN_MAC_DEVICE_TIME);
-                if (macCommandSuccess) {
-                    uint8_t fPort = 1;
-                    uint8_t downlinkPayload[255];
-                    size_t downlinkSize = 0;
-
-                    int16_t rxState = node.sendReceive(nullptr, 0, fPort, downlinkPayload, &downlinkSize, true);
-                    if (rxState == RADIOLIB_ERR_NONE) {
-                        uint32_t unixEpoch;
-                        uint8_t fraction;
-                        int16_t dtState = node.getMacDeviceTimeAns(&unixEpoch, &fraction, true);
-                        if (dtState == RADIOLIB_ERR_NONE) {
-                            DEBUG_PRINTF("DeviceTime recibido: epoch = %lu s, fraction = %u\n", unixEpoch, fraction);
-
-                            rtc.setTime(unixEpoch);
-                            
-                            if (abs((int32_t)rtc.getEpoch() - (int32_t)unixEpoch) < 10) {
-                                DEBUG_PRINTLN("RTC actualizado exitosamente con tiempo del servidor");
-                                rtcUpdated = true; // Marca como actualizado para salir del bucle
-                            } else {
-                                DEBUG_PRINTLN("Error al actualizar RTC con tiempo del servidor");
-                                // Si estamos en el último intento, continuamos de todas formas
-                                if (rtcAttempts >= maxAttempts) {
-                                    DEBUG_PRINTLN("Agotados los intentos de actualización de RTC");
-                                } else {
-                                    delay(1000); // Esperar un segundo antes del siguiente intento
-                                }
-                            }
-                        } else {
-                            DEBUG_PRINTF("Error al obtener DeviceTime: %d\n", dtState);
-                            // Si estamos en el último intento, continuamos de todas formas
-                            if (rtcAttempts >= maxAttempts) {
-                                DEBUG_PRINTLN("Agotados los intentos de actualización de RTC");
-                            } else {
-                                delay(1000); // Esperar un segundo antes del siguiente intento
-                            }
-                        }
-                    } else {
-                        DEBUG_PRINTF("Error al recibir respuesta DeviceTime: %d\n", rxState);
-                        // Si estamos en el último intento, continuamos de todas formas
-                        if (rtcAttempts >= maxAttempts) {
-                            DEBUG_PRINTLN("Agotados los intentos de actualización de RTC");
-                        } else {
-                            delay(1000); // Esperar un segundo antes del siguiente intento
-                        }
-                    }
-                } else {
-                    DEBUG_PRINTLN("Error al solicitar DeviceTime: comando no pudo ser encolado");
-                    // Si estamos en el último intento, continuamos de todas formas
-                    if (rtcAttempts >= maxAttempts) {
-                        DEBUG_PRINTLN("Agotados los intentos de actualización de RTC");
-                    } else {
-                        delay(1000); // Esperar un segundo antes del siguiente intento
-                    }
-                }
-            }
+    // Sin sesión: el join solo se intenta cuando JoinScheduler lo permite
+    uint32_t now = rtc.getEpoch();
+    if (!JoinScheduler::isDue(now)) {
+        DEBUG_PRINTF("Join diferido %lu s (%u fallos, %lu ms de aire hoy)\n",
+                     (unsigned long)JoinScheduler::secondsUntilDue(now), JoinScheduler::failures(),
+                     (unsigned long)JoinScheduler::airtimeUsedMs(now));
+        store.end();
+        return RADIOLIB_ERR_NETWORK_NOT_JOINED;
+    }
 
-            // Si no se pudo actualizar el RTC después de los intentos máximos, retornar error
-            if (!rtcUpdated) {
-                DEBUG_PRINTLN("No se pudo actualizar el RTC después de los intentos máximos, entrando en deep sleep");
-                store.end();
-                return RADIOLIB_ERR_RTC_SYNC_FAILED; // Error personalizado para indicar fallo en sincronización RTC
-            }
+    const uint8_t joinDatarate = JoinScheduler::datarate();
+    state = node.activateOTAA(joinDatarate);
+    JoinScheduler::recordAttempt(now, joinDatarate, state == RADIOLIB_LORAWAN_NEW_SESSION, esp_random());
 
-            store.end();
-            return RADIOLIB_LORAWAN_NEW_SESSION;
-        } else {
-            DEBUG_PRINTF("Join falló: %d\n", state);
-            store.end();
-            return state;
-        }
-    }
-    
+    // DevNonce avanza con cada Join-Request, aunque el join falle: no debe repetirse
+    uint8_t buffer[RADIOLIB_LORAWAN_NONCES_BUF_SIZE];
+    uint8_t *persist = node.getBufferNonces();
+    memcpy(buffer, persist, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
+    store.putBytes("nonces", buffer, RADIOLIB_LORAWAN_NONCES_BUF_SIZE);
     store.end();
-    return state;
+
+    if (state != RADIOLIB_LORAWAN_NEW_SESSION) {
+        DEBUG_PRINTF("Join en DR%u falló: %d, próximo intento en %lu s\n", joinDatarate, state,
+                     (unsigned long)JoinScheduler::secondsUntilDue(rtc.getEpoch()));
+        return state;
+    }
+
+    // Las copias de la sesión anterior quedan obsoletas: guardar la nueva
+    sessionActive = true;
+    checkpointSession(node, true);
+
+    node.setADR(false);
+    node.setDatarate(LoRa::DEFAULT_DATARATE);
+
+    // La hora del servidor se pide ahora y, si no llega, en los próximos despertares
+    timeSyncAttemptsLeft = LoRa::TIME_SYNC_ATTEMPTS;
+    return syncTimeIfPending(node, state);
+}
+
+int16_t LoRaManager::syncTimeIfPending(LoRaWANNode& node, int16_t state) {
+    if (timeSyncAttemptsLeft == 0) {
+        return state;
+    }
+    if (requestDeviceTime(node)) {
+        timeSyncAttemptsLeft = 0;
+        return state;
+    }
+    if (--timeSyncAttemptsLeft == 0) {
+        DEBUG_PRINTLN("Agotados los intentos de actualización de RTC - se continúa con la hora local");
+        return state;
+    }
+    return RADIOLIB_ERR_RTC_SYNC_FAILED;
+}
+
+bool LoRaManager::requestDeviceTime(LoRaWANNode& node) {
+    if (!node.sendMacCommandReq(RADIOLIB_LORAWAN_MAC_DEVICE_TIME)) {
+        DEBUG_PRINTLN("Error al solicitar DeviceTime: comando no pudo ser encolado");
+        return false;
+    }
+
+    uint8_t fPort = 1;
+    uint8_t downlinkPayload[255];
+    size_t downlinkSize = 0;
+    int16_t rxState = node.sendReceive(nullptr, 0, fPort, downlinkPayload, &downlinkSize, true);
+    if (rxState != RADIOLIB_ERR_NONE) {
+        DEBUG_PRINTF("Error al recibir respuesta DeviceTime: %d\n", rxState);
+        return false;
+    }
+
+    uint32_t unixEpoch;
+    uint8_t fraction;
+    int16_t dtState = node.getMacDeviceTimeAns(&unixEpoch, &fraction, true);
+    if (dtState != RADIOLIB_ERR_NONE) {
+        DEBUG_PRINTF("Error al obtener DeviceTime: %d\n", dtState);
+        return false;
+    }
+    DEBUG_PRINTF("DeviceTime recibido: epoch = %lu s, fraction = %u\n", unixEpoch, fraction);
+
+    // Las lecturas respaldadas con la hora local pasan a la hora del servidor
+    const uint32_t localEpoch = rtc.getEpoch();
+    rtc.setTime(unixEpoch);
+    if (abs((int32_t)rtc.getEpoch() - (int32_t)unixEpoch) >= 10) {
+        DEBUG_PRINTLN("Error al actualizar RTC con tiempo del servidor");
+        return false;
+    }
+    OutageBuffer::shiftTimestamps((int32_t)(unixEpoch - localEpoch));
+    DEBUG_PRINTLN("RTC actualizado exitosamente con tiempo del servidor");
+    return true;
+}
+
+bool LoRaManager::restoreSessionFromFlash(LoRaWANNode& node) {
+#if defined(RADIOLIB_LORAWAN_SESSION_FCNT_UP)
+    uint8_t session[RADIOLIB_LORAWAN_SESSION_BUF_SIZE];
+    uint16_t length = 0;
+    uint32_t fcntUp = 0;
+    if (!SessionStore::load(session, sizeof(session), length, fcntUp) || length != sizeof(session)) {
+        return false;
+    }
+    if (!SessionStore::advanceFCntUp(session, length, RADIOLIB_LORAWAN_SESSION_FCNT_UP, fcntUp,
+                                     SessionStore::counterGap())) {
+        DEBUG_PRINTLN("Copia de sesión en flash con formato inesperado - se descarta");
+        return false;
+    }
+    DEBUG_PRINTF("Sesión en flash: FCntUp %lu -> %lu\n", (unsigned long)fcntUp,
+                 (unsigned long)(fcntUp + SessionStore::counterGap()));
+    memcpy(LWsession, session, sizeof(session));
+    return node.setBufferSession(LWsession) == RADIOLIB_ERR_NONE;
+#else
+    // Sin la posición de FCntUp en el búfer no se puede evitar repetir contadores
+    (void)node;
+    return false;
+#endif
+}
+
+void LoRaManager::checkpointSession(LoRaWANNode& node, bool force) {
+    if (!sessionActive) {
+        return;
+    }
+    uint32_t fcntUp = node.getFCntUp();
+    if (force || SessionStore::isDue(fcntUp)) {
+        SessionStore::save(node.getBufferSession(), RADIOLIB_LORAWAN_SESSION_BUF_SIZE, fcntUp);
+    }
 }
 
 /**
  * @brief Crea un payload optimizado con formato delimitado por | y , en lugar de JSON.
- * @param readings Vector con lecturas de sensores.
+ * @param readings Lecturas de sensores.
  * @param deviceId ID del dispositivo.
  * @param stationId ID de la estación.
  * @param battery Valor de la batería.
@@ -197,73 +250,50 @@ int16_t LoRaManager::lwActivate(LoRaWANNode& node) {
  * @return Tamaño del payload generado.
  */
 size_t LoRaManager::createDelimitedPayload(
-    const std::vector<SensorReading>& readings,
-    const String& deviceId,
-    const String& stationId,
+    const ReadingSet& readings,
+    const char* deviceId,
+    const char* stationId,
     float battery,
     uint32_t timestamp,
     char* buffer,
     size_t bufferSize
 ) {
-    buffer[0] = '\0';
-    size_t offset = 0;
-
-    char batteryStr[16];
-    formatFloatTo3Decimals(battery, batteryStr, sizeof(batteryStr));
-
-
-    offset += snprintf(buffer + offset, bufferSize - offset,
-                      "%s|%s|%s|%lu",
-                      stationId.c_str(),
-                      deviceId.c_str(),
-                      batteryStr,
-                      timestamp);
-
-    for (const auto& reading : readings) {
-        if (offset >= bufferSize - 1) break; // Evitar desbordamiento
-
-        buffer[offset++] = '|';
-        buffer[offset] = '\0';
-
-        offset += snprintf(buffer + offset, bufferSize - offset,
-                          "%s,%d",
-                          reading.sensorId,
-                          reading.type);
-
-        if (reading.subValues.empty()) {
-            char valStr[16];
-            formatFloatTo3Decimals(reading.value, valStr, sizeof(valStr));
-            offset += snprintf(buffer + offset, bufferSize - offset, ",%s", valStr);
-        } else {
-            for (const auto& sv : reading.subValues) {
-                char valStr[16];
-                formatFloatTo3Decimals(sv.value, valStr, sizeof(valStr));
-                offset += snprintf(buffer + offset, bufferSize - offset, ",%s", valStr);
-            }
-        }
-    }
-
-    return offset;
+    return PayloadFormat::delimited(readings, deviceId, stationId,
+                                    battery, timestamp, buffer, bufferSize);
 }
 
 
 /**
  * @brief Envía el payload de sensores estándar usando formato delimitado.
- * @param readings Vector con todas las lecturas de sensores.
+ * @param readings Lecturas de sensores.
  * @param node Referencia al nodo LoRaWAN
  * @param deviceId ID del dispositivo
  * @param stationId ID de la estación
  * @param rtc Referencia al RTC para obtener timestamp
+ * @return true si el payload se transmitió
  */
-void LoRaManager::sendDelimitedPayload(
-    const std::vector<SensorReading>& readings,
+bool LoRaManager::sendDelimitedPayload(
+    const ReadingSet& readings,
     LoRaWANNode& node,
-    const String& deviceId,
-    const String& stationId,
-    ESP32Time& rtc)
+    const char* deviceId,
+    const char* stationId,
+    ESP32Time& rtc,
+    uint32_t& sentMask)
 {
-    char payloadBuffer[LoRa::MAX_PAYLOAD + 1];
+    return sendPlannedFrames(readings, node, deviceId, stationId, rtc.getEpoch(), LoRa::FPORT_DELIMITED, sentMask);
+}
 
+bool LoRaManager::sendPlannedFrames(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId,
+    uint32_t timestamp,
+    uint8_t fPort,
+    uint32_t& sentMask)
+{
+    const bool delimited = fPort == LoRa::FPORT_DELIMITED;
+    sentMask = 0;
     float battery = NAN;
     for (const auto& reading : readings) {
         if (reading.type == BATTERY) {
@@ -272,42 +302,286 @@ void LoRaManager::sendDelimitedPayload(
         }
     }
 
-    uint32_t timestamp = rtc.getEpoch();
+    // Tamaño de cada lectura en el formato del uplink y reparto en frames del DR activo
+    uint32_t phaseStart = WakeProfiler::now();
+    const size_t budget = frameBudget(node);
+    size_t costs[MAX_READINGS];
+    for (size_t i = 0; i < readings.size(); i++) {
+        costs[i] = delimited ? PayloadFormat::delimitedReadingSize(readings[i])
+                             : PayloadFormat::binaryReadingSize(readings[i]);
+    }
+    const size_t headerSize = delimited
+        ? PayloadFormat::delimitedHeaderSize(deviceId, stationId, battery, timestamp)
+        : PayloadFormat::binaryHeaderSize(readings);
+    uint32_t masks[LoRa::MAX_FRAMES_PER_WAKE];
+    const uint8_t frames = PayloadPlanner::plan(readings, costs, headerSize, budget,
+                                                LoRa::MAX_FRAMES_PER_WAKE, masks);
+    WakeProfiler::record(PHASE_PAYLOAD_BUILD, phaseStart);
+
+    if (frames == 0) {
+        DEBUG_PRINTF("Error: ninguna lectura cabe en %u bytes (DR%u)\n", budget, LoRa::DEFAULT_DATARATE);
+        return false;
+    }
 
-    size_t payloadSize = createDelimitedPayload(
-        readings,
-        deviceId,
-        stationId,
-        battery,
-        timestamp,
-        payloadBuffer,
-        sizeof(payloadBuffer)
-    );
+    uint32_t sent = 0;
+    bool ok = true;
+    for (uint8_t f = 0; f < frames && ok; f++) {
+        uint8_t payloadBuffer[LoRa::MAX_PAYLOAD + 1];
+        size_t payloadSize = delimited
+            ? PayloadFormat::delimited(readings, deviceId, stationId, battery, timestamp,
+                                       (char*)payloadBuffer, budget + 1, masks[f])
+            : PayloadFormat::binary(readings, timestamp, payloadBuffer, budget, masks[f]);
+        if (payloadSize == 0) {
+            DEBUG_PRINTLN("Error: el frame planificado no cabe en el presupuesto");
+            ok = false;
+            break;
+        }
 
-    DEBUG_PRINTF("Enviando payload delimitado con tamaño %d bytes\n", payloadSize);
-    DEBUG_PRINTLN(payloadBuffer);
+        DEBUG_PRINTF("Enviando payload %s %u/%u con tamaño %d bytes (máx. %u)\n",
+                     delimited ? "delimitado" : "binario", f + 1, frames, payloadSize, budget);
+        if (delimited) {
+            DEBUG_PRINTLN((const char*)payloadBuffer);
+        }
+        ok = transmit(node, payloadBuffer, payloadSize, fPort) == RADIOLIB_ERR_NONE;
+        if (ok) {
+            sent |= masks[f];
+        }
+    }
 
-    uint8_t fPort = 1;
-    uint8_t downlinkPayload[255];
-    size_t downlinkSize = 0;
+    for (size_t i = 0; i < readings.size(); i++) {
+        if (!(sent & (1UL << i)) && PayloadPlanner::wakesSinceReported(i) + 1 >= LoRa::REPORT_MAX_WAKES) {
+            DEBUG_PRINTF("Aviso: %s lleva %u despertares sin reportarse\n", readings[i].sensorId,
+                         PayloadPlanner::wakesSinceReported(i) + 1);
+        }
+    }
+    PayloadPlanner::commit(readings, sent);
+    sentMask = sent;
+    return ok;
+}
+
+size_t LoRaManager::frameBudget(LoRaWANNode& node) {
+    // El límite de la pila depende del DR, que transmit() fija antes de cada uplink
+    node.setDatarate(LoRa::DEFAULT_DATARATE);
+    return PayloadPlanner::frameBudget(LoRa::DEFAULT_DATARATE, node.getMaxPayloadLen());
+}
+
+bool LoRaManager::sendPayload(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId,
+    ESP32Time& rtc,
+    uint32_t& sentMask)
+{
+    if (LoRa::PAYLOAD_TYPE == LoRa::PayloadType::BINARY) {
+        return sendBinaryPayload(readings, node, deviceId, stationId, rtc, sentMask);
+    }
+    if (LoRa::PAYLOAD_TYPE == LoRa::PayloadType::DELTA) {
+        return sendDeltaPayload(readings, node, deviceId, stationId, rtc, sentMask);
+    }
+    return sendDelimitedPayload(readings, node, deviceId, stationId, rtc, sentMask);
+}
+
+bool LoRaManager::sendBinaryPayload(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId,
+    ESP32Time& rtc,
+    uint32_t& sentMask)
+{
+    announceSchemaIfNeeded(readings, node, deviceId, stationId);
+    DEBUG_PRINTF("Esquema %04X\n", PayloadFormat::schemaId(readings));
+    if (!sendPlannedFrames(readings, node, deviceId, stationId, rtc.getEpoch(), LoRa::FPORT_BINARY, sentMask)) {
+        return false;
+    }
+    uplinksSinceAnnounce++;
+    return true;
+}
+
+bool LoRaManager::sendDeltaPayload(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId,
+    ESP32Time& rtc,
+    uint32_t& sentMask)
+{
+    sentMask = 0;
+    uint16_t schema = PayloadFormat::schemaId(readings);
+    announceSchemaIfNeeded(readings, node, deviceId, stationId);
+
+    uint8_t payloadBuffer[LoRa::MAX_PAYLOAD];
+    uint8_t fPort = LoRa::FPORT_KEYFRAME;
+    const size_t budget = frameBudget(node);
+    uint32_t phaseStart = WakeProfiler::now();
+    size_t payloadSize = DeltaEncoder::build(readings, rtc.getEpoch(), payloadBuffer,
+                                             budget < sizeof(payloadBuffer) ? budget : sizeof(payloadBuffer), fPort);
+    WakeProfiler::record(PHASE_PAYLOAD_BUILD, phaseStart);
+
+    if (payloadSize == 0) {
+        // El keyframe no cabe en el DR activo: este despertar va repartido en binario
+        DEBUG_PRINTF("Payload delta no cabe en %u bytes, se envía repartido en binario\n", budget);
+        if (!sendPlannedFrames(readings, node, deviceId, stationId, rtc.getEpoch(), LoRa::FPORT_BINARY, sentMask)) {
+            return false;
+        }
+        uplinksSinceAnnounce++;
+        return true;
+    }
+
+    DEBUG_PRINTF("Enviando %s con tamaño %d bytes (esquema %04X)\n",
+                 fPort == LoRa::FPORT_DELTA ? "delta" : "keyframe", payloadSize, schema);
+    if (transmit(node, payloadBuffer, payloadSize, fPort) != RADIOLIB_ERR_NONE) {
+        return false;
+    }
+    // El keyframe o delta lleva todos los canales
+    sentMask = PayloadFormat::ALL_READINGS;
+    DeltaEncoder::commit();
+    uplinksSinceAnnounce++;
+    return true;
+}
+
+bool LoRaManager::sendBatch(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId)
+{
+    if (SampleBatch::count() == 0) {
+        return true;
+    }
+    if (PayloadFormat::schemaId(readings) == SampleBatch::schema()) {
+        announceSchemaIfNeeded(readings, node, deviceId, stationId);
+    }
+
+    uint8_t payloadBuffer[LoRa::MAX_PAYLOAD];
+    const size_t budget = frameBudget(node);
+    uint32_t phaseStart = WakeProfiler::now();
+    size_t payloadSize = SampleBatch::buildFrame(payloadBuffer,
+                                                 budget < sizeof(payloadBuffer) ? budget : sizeof(payloadBuffer));
+    WakeProfiler::record(PHASE_PAYLOAD_BUILD, phaseStart);
+
+    if (payloadSize == 0) {
+        // El DR activo admite menos que el estático con que se dimensionó el lote: si se
+        // quedara aquí fallaría igual en cada despertar, así que sale por el respaldo
+        DEBUG_PRINTF("Lote no cabe en %u bytes, se envía repartido desde el respaldo\n", budget);
+        SampleBatch::moveToBacklog();
+        return true;
+    }
+
+    DEBUG_PRINTF("Enviando lote de %u registros con tamaño %d bytes (esquema %04X)\n",
+                 SampleBatch::count(), payloadSize, SampleBatch::schema());
+    if (transmit(node, payloadBuffer, payloadSize, LoRa::FPORT_BATCH) != RADIOLIB_ERR_NONE) {
+        return false;
+    }
+    uplinksSinceAnnounce++;
+    SampleBatch::clear();
+    return true;
+}
 
+bool LoRaManager::sendBacklog(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId)
+{
+    if (OutageBuffer::count() == 0) {
+        return true;
+    }
+    if (PayloadFormat::schemaId(readings) == OutageBuffer::schema()) {
+        announceSchemaIfNeeded(readings, node, deviceId, stationId);
+    }
+
+    uint8_t payloadBuffer[LoRa::MAX_PAYLOAD];
+    const size_t budget = frameBudget(node);
+    for (uint8_t frame = 0; frame < LoRa::OUTAGE_FLUSH_FRAMES && OutageBuffer::count() > 0; frame++) {
+        uint8_t records = 0;
+        size_t payloadSize = OutageBuffer::buildFrame(payloadBuffer,
+                                                      budget < sizeof(payloadBuffer) ? budget : sizeof(payloadBuffer),
+                                                      records);
+        if (payloadSize == 0) {
+            DEBUG_PRINTF("Error: registro respaldado no cabe en %u bytes, se descarta\n", budget);
+            OutageBuffer::consume(1);
+            continue;
+        }
+
+        DEBUG_PRINTF("Enviando respaldo: %u registros en %d bytes (quedan %u)\n",
+                     records, payloadSize, OutageBuffer::count() - records);
+        if (transmit(node, payloadBuffer, payloadSize, LoRa::FPORT_BATCH) != RADIOLIB_ERR_NONE) {
+            return false;
+        }
+        uplinksSinceAnnounce++;
+        OutageBuffer::consume(records);
+    }
+    return true;
+}
+
+void LoRaManager::announceSchemaIfNeeded(
+    const ReadingSet& readings,
+    LoRaWANNode& node,
+    const char* deviceId,
+    const char* stationId)
+{
+    uint16_t schema = PayloadFormat::schemaId(readings);
+
+    // El servidor necesita el esquema para interpretar el payload binario
+    if (schema == announcedSchemaId && uplinksSinceAnnounce < LoRa::SCHEMA_ANNOUNCE_INTERVAL) {
+        return;
+    }
+
+    // En los DR bajos el anuncio se parte en continuaciones que caben en un uplink
+    const size_t budget = frameBudget(node);
+    size_t first = 0;
+    while (first < readings.size() || first == 0) {
+        char announcement[LoRa::MAX_PAYLOAD + 1];
+        size_t next = first;
+        size_t announcementSize = PayloadFormat::schemaAnnouncement(
+            readings, deviceId, stationId, announcement,
+            budget + 1 < sizeof(announcement) ? budget + 1 : sizeof(announcement), first, &next);
+        if (announcementSize == 0) {
+            DEBUG_PRINTF("Error: el anuncio de esquema %04X no cabe en %u bytes\n", schema, budget);
+            return;
+        }
+        DEBUG_PRINTF("Anunciando esquema %04X (%d bytes)\n", schema, announcementSize);
+        DEBUG_PRINTLN(announcement);
+        if (transmit(node, (uint8_t*)announcement, announcementSize, LoRa::FPORT_SCHEMA) != RADIOLIB_ERR_NONE) {
+            return;
+        }
+        if (next == first) {
+            break;
+        }
+        first = next;
+    }
+    announcedSchemaId = schema;
+    uplinksSinceAnnounce = 0;
+}
+
+int16_t LoRaManager::transmit(LoRaWANNode& node, uint8_t* data, size_t length, uint8_t fPort) {
     // Log del tiempo transcurrido antes del envío LoRa
     extern unsigned long setupStartTime;
     unsigned long elapsedTime = millis() - setupStartTime;
     DEBUG_PRINTF("Tiempo transcurrido antes del envío LoRa: %lu ms\n", elapsedTime);
 
     // VERIFICACIÓN CRÍTICA: Asegurar DR3 antes de cada transmisión
-    // Esto previene el error -1114 si el servidor intentó cambiar el DR
-    node.setDatarate(LoRa::DEFAULT_DATARATE);
+    // Esto previene el error -1114 si el servidor intentó cambiar el DR.
+    // Nada que supere el presupuesto del DR llega a la radio (ni al dwell time)
+    const size_t budget = frameBudget(node);
+    if (length > budget) {
+        DEBUG_PRINTF("Error: uplink de %u bytes supera el máximo de %u en DR%u\n",
+                     length, budget, LoRa::DEFAULT_DATARATE);
+        return RADIOLIB_ERR_PACKET_TOO_LONG;
+    }
 
     // Usar uplink() en lugar de sendReceive() para NO esperar ventanas RX
     // Esto reduce significativamente el tiempo de transmisión
+    uint32_t phaseStart = WakeProfiler::now();
     int16_t state = node.uplink(
-        (uint8_t*)payloadBuffer,
-        payloadSize,
+        data,
+        length,
         fPort,
         false  // unconfirmed message
     );
+    WakeProfiler::record(PHASE_UPLINK, phaseStart);
 
     if (state == RADIOLIB_ERR_NONE) {
         DEBUG_PRINTLN("Transmisión exitosa (sin esperar downlink)");
@@ -335,6 +609,7 @@ void LoRaManager::sendDelimitedPayload(
             DEBUG_PRINTLN("Error de frecuencia detectado - reinicialización requerida");
         }
     }
+    return state;
 }
 
 
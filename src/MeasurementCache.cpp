@@ -0,0 +1,52 @@
+#include "MeasurementCache.h"
+#include <math.h>
+
+float MeasurementCache::_values[(uint8_t)Quantity::COUNT] = {};
+bool MeasurementCache::_present[(uint8_t)Quantity::COUNT] = {};
+
+void MeasurementCache::clear() {
+    for (uint8_t i = 0; i < (uint8_t)Quantity::COUNT; i++) {
+        _present[i] = false;
+        _values[i] = NAN;
+    }
+}
+
+void MeasurementCache::publish(Quantity quantity, float value) {
+    _values[(uint8_t)quantity] = value;
+    _present[(uint8_t)quantity] = true;
+}
+
+bool MeasurementCache::get(Quantity quantity, float& value) {
+    if (!_present[(uint8_t)quantity]) {
+        return false;
+    }
+    value = _values[(uint8_t)quantity];
+    return true;
+}
+
+bool MeasurementCache::canProvide(SensorType type, Quantity quantity) {
+    if (quantity != Quantity::WATER_TEMPERATURE) {
+        return false;
+    }
+    switch (type) {
+        case N100K:
+        case N10K:
+        case RTD:
+        case DS18B20:
+        case MT05S:
+            return true;
+        default:
+            return false;
+    }
+}
+
+float MeasurementCache::extract(const SensorReading& reading, Quantity quantity) {
+    if (!canProvide(reading.type, quantity)) {
+        return NAN;
+    }
+    // El MT05 entrega la temperatura como primer subvalor
+    if (reading.type == MT05S) {
+        return reading.subValues.empty() ? NAN : reading.subValues[0].value;
+    }
+    return reading.value;
+}
@@ -0,0 +1,218 @@
+#include "ModbusLinkStats.h"
+#include <stddef.h>
+#include <string.h>
+#include "ModbusRtu.h"
+#include "debug.h"
+#include "util/crc16.h"
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// Distinto de cero para que una RTC recién puesta a cero nunca pase por una tabla válida
+static const uint16_t STATS_MAGIC = 0x4D53;
+
+/**
+ * @brief Tabla de esclavos en RTC RAM. El CRC se sella al cerrar cada ciclo; si el
+ *        equipo se reinicia a mitad de un ciclo la tabla se descarta.
+ */
+struct LinkStatsTable {
+    uint16_t magic;
+    uint16_t crc;
+    uint8_t count;
+    ModbusSlaveStats slaves[System::MODBUS_MAX_SLAVES];
+};
+
+RTC_DATA_ATTR static LinkStatsTable table;
+
+// Estado del ciclo en curso (no necesita sobrevivir al deep sleep)
+static bool loaded = false;
+static bool tried[System::MODBUS_MAX_SLAVES];
+static bool responded[System::MODBUS_MAX_SLAVES];
+
+static uint16_t computeCrc() {
+    return crc16_block(0xFFFF, (const uint8_t*)&table.count,
+                       (uint16_t)(sizeof(table) - offsetof(LinkStatsTable, count)));
+}
+
+static void seal() {
+    table.magic = STATS_MAGIC;
+    table.crc = computeCrc();
+}
+
+static void ensureLoaded() {
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+    if (table.magic != STATS_MAGIC || table.count > System::MODBUS_MAX_SLAVES || table.crc != computeCrc()) {
+        ModbusLinkStats::reset();
+    }
+}
+
+/**
+ * @brief Índice del esclavo en la tabla; lo agrega si hay lugar (-1 si no)
+ */
+static int8_t indexOf(uint8_t slave, bool add) {
+    ensureLoaded();
+    for (uint8_t i = 0; i < table.count; i++) {
+        if (table.slaves[i].slave == slave) {
+            return (int8_t)i;
+        }
+    }
+    if (!add || table.count >= System::MODBUS_MAX_SLAVES) {
+        return -1;
+    }
+    ModbusSlaveStats& stats = table.slaves[table.count];
+    memset(&stats, 0, sizeof(stats));
+    stats.slave = slave;
+    tried[table.count] = false;
+    responded[table.count] = false;
+    return (int8_t)table.count++;
+}
+
+void ModbusLinkStats::beginCycle() {
+    ensureLoaded();
+    memset(tried, 0, sizeof(tried));
+    memset(responded, 0, sizeof(responded));
+}
+
+void ModbusLinkStats::endCycle() {
+    ensureLoaded();
+    for (uint8_t i = 0; i < table.count; i++) {
+        ModbusSlaveStats& stats = table.slaves[i];
+        if (stats.backoffCycles > 0) {
+            stats.backoffCycles--;
+        } else if (responded[i]) {
+            stats.failedCycles = 0;
+            stats.backoffLevel = 0;
+        } else if (tried[i]) {
+            if (stats.failedCycles < 0xFF) {
+                stats.failedCycles++;
+            }
+            if (stats.failedCycles >= System::MODBUS_BACKOFF_AFTER_FAILURES) {
+                uint32_t cycles = 1UL << stats.backoffLevel;
+                stats.backoffCycles = (uint8_t)(cycles < System::MODBUS_BACKOFF_MAX_CYCLES
+                                                    ? cycles : System::MODBUS_BACKOFF_MAX_CYCLES);
+                if (cycles < System::MODBUS_BACKOFF_MAX_CYCLES) {
+                    stats.backoffLevel++;
+                }
+            }
+        }
+    }
+    seal();
+}
+
+bool ModbusLinkStats::skip(uint8_t slave) {
+    if (!backedOff(slave)) {
+        return false;
+    }
+    table.slaves[indexOf(slave, false)].skipped++;
+    return true;
+}
+
+bool ModbusLinkStats::backedOff(uint8_t slave) {
+    int8_t i = indexOf(slave, false);
+    return i >= 0 && table.slaves[i].backoffCycles > 0;
+}
+
+uint32_t ModbusLinkStats::timeoutMs(uint8_t slave, uint8_t attempt) {
+    int8_t i = indexOf(slave, false);
+    if (i < 0 || attempt > 0 || table.slaves[i].responses == 0) {
+        return System::MODBUS_RESPONSE_TIMEOUT;
+    }
+    const ModbusSlaveStats& stats = table.slaves[i];
+    uint32_t timeout = (stats.latencyUs + 4 * stats.deviationUs + 999) / 1000 + System::MODBUS_TIMEOUT_MARGIN_MS;
+    if (timeout < System::MODBUS_MIN_RESPONSE_TIMEOUT) {
+        return System::MODBUS_MIN_RESPONSE_TIMEOUT;
+    }
+    return timeout > System::MODBUS_RESPONSE_TIMEOUT ? System::MODBUS_RESPONSE_TIMEOUT : timeout;
+}
+
+uint8_t ModbusLinkStats::maxAttempts(uint8_t slave) {
+    int8_t i = indexOf(slave, false);
+    return (i >= 0 && table.slaves[i].failedCycles > 0) ? 1 : System::MODBUS_MAX_RETRY;
+}
+
+void ModbusLinkStats::recordSent(uint8_t slave) {
+    int8_t i = indexOf(slave, true);
+    if (i < 0) {
+        return;
+    }
+    table.slaves[i].requests++;
+    tried[i] = true;
+}
+
+void ModbusLinkStats::recordResult(uint8_t slave, uint8_t result, uint32_t latencyUs) {
+    int8_t i = indexOf(slave, true);
+    if (i < 0) {
+        return;
+    }
+    ModbusSlaveStats& stats = table.slaves[i];
+    switch (result) {
+        case ModbusRtu::TIMED_OUT:
+            stats.timeouts++;
+            return;
+        case ModbusRtu::INVALID_CRC:
+            stats.crcErrors++;
+            return;
+        case ModbusRtu::INVALID_SLAVE:
+        case ModbusRtu::INVALID_FUNCTION:
+        case ModbusRtu::INVALID_RESPONSE:
+            stats.otherErrors++;
+            return;
+        case ModbusRtu::SUCCESS:
+            break;
+        default:
+            stats.exceptions++;
+            break;
+    }
+
+    // Respondió: media y desviación con los pesos del RTO de TCP (1/8 y 1/4)
+    if (stats.responses == 0) {
+        stats.latencyUs = latencyUs;
+        stats.deviationUs = latencyUs / 2;
+    } else {
+        uint32_t error = latencyUs > stats.latencyUs ? latencyUs - stats.latencyUs : stats.latencyUs - latencyUs;
+        stats.deviationUs = stats.deviationUs - stats.deviationUs / 4 + error / 4;
+        stats.latencyUs = stats.latencyUs - stats.latencyUs / 8 + latencyUs / 8;
+    }
+    if (latencyUs > stats.maxLatencyUs) {
+        stats.maxLatencyUs = latencyUs;
+    }
+    stats.responses++;
+    responded[i] = true;
+}
+
+uint8_t ModbusLinkStats::count() {
+    ensureLoaded();
+    return table.count;
+}
+
+const ModbusSlaveStats* ModbusLinkStats::at(uint8_t index) {
+    ensureLoaded();
+    return index < table.count ? &table.slaves[index] : nullptr;
+}
+
+void ModbusLinkStats::reset() {
+    memset(&table, 0, sizeof(table));
+    memset(tried, 0, sizeof(tried));
+    memset(responded, 0, sizeof(responded));
+    loaded = true;
+    seal();
+}
+
+void ModbusLinkStats::printReport() {
+    ensureLoaded();
+    for (uint8_t i = 0; i < table.count; i++) {
+        const ModbusSlaveStats& s = table.slaves[i];
+        DEBUG_PRINTF("  Modbus %3u: tx=%lu ok=%lu exc=%lu timeout=%lu crc=%lu otros=%lu saltadas=%lu "
+                     "latencia=%lu/%lu us timeout=%lu ms fallos=%u backoff=%u\n",
+                     s.slave, (unsigned long)s.requests, (unsigned long)s.responses,
+                     (unsigned long)s.exceptions, (unsigned long)s.timeouts, (unsigned long)s.crcErrors,
+                     (unsigned long)s.otherErrors, (unsigned long)s.skipped, (unsigned long)s.latencyUs,
+                     (unsigned long)s.maxLatencyUs, (unsigned long)timeoutMs(s.slave, 0),
+                     s.failedCycles, s.backoffCycles);
+    }
+}
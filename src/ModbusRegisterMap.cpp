@@ -0,0 +1,168 @@
+#include "ModbusRegisterMap.h"
+#include <math.h>
+#include <string.h>
+
+namespace {
+    const ModbusDescriptor ENV4_DESCRIPTOR = DEFAULT_ENV4_DESCRIPTOR;
+
+    /**
+     * @brief Orden de planificación: esclavo, función y registro
+     */
+    bool comesBefore(const ModbusPointRef& a, const ModbusPointRef& b) {
+        if (a.slave != b.slave) {
+            return a.slave < b.slave;
+        }
+        if (a.point.function != b.point.function) {
+            return a.point.function < b.point.function;
+        }
+        return a.point.reg < b.point.reg;
+    }
+
+    uint16_t readWord(const uint16_t* registers, uint8_t index, uint8_t order) {
+        uint16_t value = registers[index];
+        if (order & MODBUS_ORDER_SWAP_BYTES) {
+            value = (uint16_t)((value >> 8) | (value << 8));
+        }
+        return value;
+    }
+}
+
+uint8_t ModbusRegisterMap::registerCount(uint8_t dataType) {
+    switch (static_cast<ModbusDataType>(dataType)) {
+        case ModbusDataType::U16:
+        case ModbusDataType::I16:
+            return 1;
+        case ModbusDataType::U32:
+        case ModbusDataType::I32:
+        case ModbusDataType::F32:
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+bool ModbusRegisterMap::isValid(const ModbusPoint& point) {
+    return (point.function == MODBUS_FUNCTION_HOLDING || point.function == MODBUS_FUNCTION_INPUT) &&
+           registerCount(point.dataType) > 0 &&
+           (uint32_t)point.reg + registerCount(point.dataType) <= 0x10000;
+}
+
+bool ModbusRegisterMap::preset(SensorType type, ModbusDescriptor& descriptor) {
+    if (type == ENV4) {
+        descriptor = ENV4_DESCRIPTOR;
+        return true;
+    }
+    memset(&descriptor, 0, sizeof(descriptor));
+    return false;
+}
+
+uint8_t ModbusRegisterMap::plan(ModbusPointRef* refs, uint8_t count, ModbusBlock* blocks, uint8_t maxBlocks,
+                                uint16_t maxRegisters) {
+    if (count > System::MODBUS_MAX_POINTS) {
+        count = System::MODBUS_MAX_POINTS;
+    }
+
+    // Índices de los puntos válidos, ordenados por inserción (son pocos)
+    uint8_t order[System::MODBUS_MAX_POINTS];
+    uint8_t valid = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        refs[i].block = NO_BLOCK;
+        refs[i].offset = 0;
+        if (!isValid(refs[i].point)) {
+            continue;
+        }
+        uint8_t j = valid++;
+        while (j > 0 && comesBefore(refs[i], refs[order[j - 1]])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+    }
+
+    uint8_t blockCount = 0;
+    uint16_t used = 0;
+    for (uint8_t k = 0; k < valid; k++) {
+        ModbusPointRef& ref = refs[order[k]];
+        const uint32_t first = ref.point.reg;
+        const uint32_t last = first + registerCount(ref.point.dataType);
+
+        ModbusBlock* block = blockCount > 0 ? &blocks[blockCount - 1] : nullptr;
+        bool joins = false;
+        if (block && block->slave == ref.slave && block->function == ref.point.function) {
+            const uint32_t end = (uint32_t)block->start + block->count;
+            const uint32_t growth = last > end ? last - end : 0;
+            joins = first <= end + System::MODBUS_COALESCE_GAP &&
+                    last - block->start <= System::MODBUS_MAX_BLOCK_REGISTERS &&
+                    used + growth <= maxRegisters;
+            if (joins) {
+                block->count = (uint8_t)(block->count + growth);
+                used += growth;
+            }
+        }
+        if (!joins) {
+            if (blockCount >= maxBlocks || used + (last - first) > maxRegisters) {
+                continue;
+            }
+            block = &blocks[blockCount++];
+            block->slave = ref.slave;
+            block->function = ref.point.function;
+            block->start = ref.point.reg;
+            block->count = (uint8_t)(last - first);
+            block->offset = used;
+            used += block->count;
+        }
+        ref.block = (uint8_t)(block - blocks);
+        ref.offset = (uint16_t)(block->offset + (first - block->start));
+    }
+    return blockCount;
+}
+
+bool ModbusRegisterMap::isPlausible(const uint16_t* registers, const ModbusPoint& point) {
+    const uint8_t count = registerCount(point.dataType);
+    bool allZero = true;
+    bool allOnes = true;
+    for (uint8_t i = 0; i < count; i++) {
+        allZero &= registers[i] == 0x0000;
+        allOnes &= registers[i] == 0xFFFF;
+    }
+    return count > 0 && !allZero && !allOnes && isfinite(decode(registers, point));
+}
+
+uint16_t ModbusRegisterMap::warmupLimitMs(SensorType type) {
+    return type == ENV4 ? MODBUS_ENV4_STABILIZATION_TIME : System::MODBUS_WARMUP_MAX_MS;
+}
+
+float ModbusRegisterMap::decode(const uint16_t* registers, const ModbusPoint& point) {
+    float raw;
+    switch (static_cast<ModbusDataType>(point.dataType)) {
+        case ModbusDataType::U16:
+            raw = (float)readWord(registers, 0, point.order);
+            break;
+        case ModbusDataType::I16:
+            raw = (float)(int16_t)readWord(registers, 0, point.order);
+            break;
+        case ModbusDataType::U32:
+        case ModbusDataType::I32:
+        case ModbusDataType::F32: {
+            uint16_t high = readWord(registers, 0, point.order);
+            uint16_t low = readWord(registers, 1, point.order);
+            if (point.order & MODBUS_ORDER_SWAP_WORDS) {
+                uint16_t swap = high;
+                high = low;
+                low = swap;
+            }
+            const uint32_t combined = ((uint32_t)high << 16) | low;
+            if (point.dataType == (uint8_t)ModbusDataType::F32) {
+                memcpy(&raw, &combined, sizeof(raw));
+            } else if (point.dataType == (uint8_t)ModbusDataType::I32) {
+                raw = (float)(int32_t)combined;
+            } else {
+                raw = (float)combined;
+            }
+            break;
+        }
+        default:
+            return NAN;
+    }
+    return raw * point.scale + point.offset;
+}
@@ -0,0 +1,307 @@
+#include "ModbusRtu.h"
+#include <string.h>
+#include "hal/Hal.h"
+#include "ModbusLinkStats.h"
+#include "util/crc16.h"
+
+namespace {
+    // Trama RTU más larga: dirección + función + conteo + 250 bytes de datos + CRC
+    const uint16_t MAX_ADU_SIZE = 256;
+    const uint8_t REQUEST_SIZE = ModbusRtu::REQUEST_SIZE;
+
+    struct Request {
+        uint8_t slave;
+        uint8_t function;
+        uint16_t start;
+        uint8_t count;
+        uint8_t options;
+        uint8_t result;
+        uint16_t* out;
+    };
+
+    enum class State : uint8_t {
+        IDLE,           // Esperando el silencio entre tramas para enviar la siguiente
+        WAIT_RESPONSE   // Petición enviada, recogiendo la respuesta
+    };
+
+    Request requests[System::MODBUS_QUEUE_SIZE];
+    uint8_t requestCount = 0;
+    uint8_t nextRequest = 0;        // Siguiente a enviar (o la que está en curso)
+    uint8_t attempts = 0;
+    State state = State::IDLE;
+
+    uint32_t charUs = 1146;         // Un carácter de 11 bits a 9600 baudios
+    uint32_t silenceUs = 4010;      // T3.5
+    uint32_t deadlineUs = 0;        // Timeout de la respuesta en curso
+    uint32_t requestEndUs = 0;      // Fin de la petición en curso en el bus
+    uint32_t lastBusUs = 0;         // Último byte enviado o recibido
+    uint32_t sentFrames = 0;
+
+    // Respuesta en curso: solo la cabecera se guarda; los datos van directo a out
+    ModbusRtu::Response rx;
+
+    /**
+     * @brief Indica si ya pasó el instante (con aritmética modular de micros())
+     */
+    bool reached(uint32_t now, uint32_t when) {
+        return (int32_t)(now - when) >= 0;
+    }
+
+    uint32_t remainingMs(uint32_t now, uint32_t when) {
+        return reached(now, when) ? 0 : ((when - now) + 999) / 1000;
+    }
+
+    /**
+     * @brief Longitud total de la respuesta según lo recibido (0 si aún no se sabe)
+     */
+    uint16_t expectedLength(const ModbusRtu::Response& response) {
+        if (response.length >= 2 && (response.header[1] & 0x80)) {
+            return 5;
+        }
+        return response.length >= 3 ? 5 + response.header[2] : 0;
+    }
+
+    /**
+     * @brief Procesa un byte de la respuesta: CRC acumulado y, si la cabecera es la
+     *        esperada, el byte de datos en su registro de destino
+     */
+    inline void acceptByte(ModbusRtu::Response& response, uint8_t slave, uint8_t function, uint8_t count,
+                           uint16_t* out, uint8_t value) {
+        const uint16_t index = response.length++;
+        response.crc = (response.crc >> 8) ^ crc16_table[(uint8_t)(response.crc ^ value)];
+        if (index < 3) {
+            response.header[index] = value;
+            return;
+        }
+        const uint16_t data = index - 3;
+        if (data >= (uint16_t)count * 2 || response.header[0] != slave || response.header[1] != function ||
+            response.header[2] != count * 2) {
+            return;
+        }
+        if (data & 1) {
+            out[data >> 1] |= value;
+        } else {
+            out[data >> 1] = (uint16_t)(value << 8);
+        }
+    }
+
+    /**
+     * @brief Resultado de una respuesta completa. El CRC sobre la trama entera, incluidos
+     *        sus dos bytes de CRC, da 0 si la trama es válida.
+     */
+    uint8_t checkResponse(const ModbusRtu::Response& response, uint8_t slave, uint8_t function, uint8_t count) {
+        if (response.length < 5 || response.length > MAX_ADU_SIZE) {
+            return ModbusRtu::INVALID_RESPONSE;
+        }
+        if (response.crc != 0) {
+            return ModbusRtu::INVALID_CRC;
+        }
+        if (response.header[0] != slave) {
+            return ModbusRtu::INVALID_SLAVE;
+        }
+        if (response.header[1] == (function | 0x80)) {
+            return response.header[2];
+        }
+        if (response.header[1] != function) {
+            return ModbusRtu::INVALID_FUNCTION;
+        }
+        if (response.header[2] != count * 2 || response.length != 5 + response.header[2]) {
+            return ModbusRtu::INVALID_RESPONSE;
+        }
+        return ModbusRtu::SUCCESS;
+    }
+
+    void beginResponse() {
+        rx.length = 0;
+        rx.crc = 0xFFFF;
+    }
+
+    void send(uint32_t now) {
+        const Request& request = requests[nextRequest];
+        // Bytes tardíos de una respuesta anterior no deben mezclarse con la nueva
+        while (HalUart::available() > 0) {
+            HalUart::read();
+        }
+
+        uint8_t frame[REQUEST_SIZE];
+        ModbusRtu::buildRequest(request.slave, request.function, request.start, request.count, frame);
+        HalUart::write(frame, sizeof(frame));
+        sentFrames++;
+
+        const bool probe = request.options & ModbusRtu::PROBE;
+        if (!probe) {
+            ModbusLinkStats::recordSent(request.slave);
+        }
+
+        // El timeout cuenta desde que el último byte sale del UART. En el ESP32 los bytes
+        // se ven al terminar la trama (RX timeout), así que se suma lo que tarda la
+        // respuesta completa en el bus.
+        lastBusUs = now + REQUEST_SIZE * charUs;
+        requestEndUs = lastBusUs;
+        const uint32_t responseChars = 5 + 2 * (uint32_t)request.count + System::MODBUS_RX_IDLE_SYMBOLS;
+        const uint32_t timeoutMs = probe ? System::MODBUS_PROBE_TIMEOUT_MS
+                                         : ModbusLinkStats::timeoutMs(request.slave, attempts);
+        deadlineUs = lastBusUs + responseChars * charUs + timeoutMs * 1000;
+        beginResponse();
+        state = State::WAIT_RESPONSE;
+    }
+
+    uint8_t parseResponse() {
+        const Request& request = requests[nextRequest];
+        return checkResponse(rx, request.slave, request.function, request.count);
+    }
+
+    /**
+     * @brief Cierra el intento en curso: reintenta los errores de línea y pasa a la
+     *        siguiente petición con el resto
+     */
+    void finish(uint8_t result) {
+        state = State::IDLE;
+        const uint8_t slave = requests[nextRequest].slave;
+        const bool probe = requests[nextRequest].options & ModbusRtu::PROBE;
+        if (!probe) {
+            // Latencia del esclavo: sin el tiempo que la propia respuesta ocupa en el bus
+            int32_t busUs = (int32_t)(rx.length * charUs);
+            int32_t elapsedUs = (int32_t)(lastBusUs - requestEndUs);
+            ModbusLinkStats::recordResult(slave, result, elapsedUs > busUs ? (uint32_t)(elapsedUs - busUs) : 0);
+        }
+
+        bool lineError = result == ModbusRtu::TIMED_OUT || result == ModbusRtu::INVALID_CRC ||
+                         result == ModbusRtu::INVALID_RESPONSE;
+        if (lineError && !probe && ++attempts < ModbusLinkStats::maxAttempts(slave)) {
+            return;
+        }
+        requests[nextRequest].result = result;
+        nextRequest++;
+        attempts = 0;
+    }
+}
+
+void ModbusRtu::begin(uint32_t baud) {
+    // Caracter de 11 bits; por encima de 19200 baudios la norma fija T3.5 en 1750 us
+    charUs = (11000000UL + baud - 1) / baud;
+    silenceUs = baud > 19200 ? 1750 : (charUs * 7 + 1) / 2;
+    lastBusUs = HalClock::micros();
+    sentFrames = 0;
+    reset();
+}
+
+void ModbusRtu::reset() {
+    requestCount = 0;
+    nextRequest = 0;
+    attempts = 0;
+    beginResponse();
+    state = State::IDLE;
+}
+
+uint8_t ModbusRtu::buildRequest(uint8_t slave, uint8_t function, uint16_t start, uint8_t count,
+                                uint8_t* frame) {
+    frame[0] = slave;
+    frame[1] = function;
+    frame[2] = (uint8_t)(start >> 8);
+    frame[3] = (uint8_t)start;
+    frame[4] = 0;
+    frame[5] = count;
+    uint16_t crc = crc16_block(0xFFFF, frame, 6);
+    frame[6] = (uint8_t)crc;
+    frame[7] = (uint8_t)(crc >> 8);
+    return REQUEST_SIZE;
+}
+
+uint8_t ModbusRtu::decodeResponse(const uint8_t* frame, uint16_t length, uint8_t slave, uint8_t function,
+                                  uint8_t count, uint16_t* out) {
+    Response response = {0, 0xFFFF, {0, 0, 0}};
+    for (uint16_t i = 0; i < length; i++) {
+        acceptByte(response, slave, function, count, out, frame[i]);
+    }
+    return checkResponse(response, slave, function, count);
+}
+
+int8_t ModbusRtu::submit(uint8_t slave, uint8_t function, uint16_t start, uint8_t count, uint16_t* out,
+                         uint8_t options) {
+    if (requestCount >= System::MODBUS_QUEUE_SIZE || out == nullptr || count == 0 ||
+        count > System::MODBUS_MAX_BLOCK_REGISTERS ||
+        (function != MODBUS_FUNCTION_HOLDING && function != MODBUS_FUNCTION_INPUT)) {
+        return NO_REQUEST;
+    }
+    Request& request = requests[requestCount];
+    request.slave = slave;
+    request.function = function;
+    request.start = start;
+    request.count = count;
+    request.options = options;
+    request.result = (!(options & PROBE) && ModbusLinkStats::skip(slave)) ? BACKED_OFF : PENDING;
+    request.out = out;
+    return (int8_t)requestCount++;
+}
+
+uint8_t ModbusRtu::result(int8_t request) {
+    if (request < 0 || request >= (int8_t)requestCount) {
+        return INVALID_RESPONSE;
+    }
+    return requests[request].result;
+}
+
+bool ModbusRtu::poll() {
+    uint32_t now = HalClock::micros();
+
+    if (state == State::WAIT_RESPONSE) {
+        const Request& request = requests[nextRequest];
+        while (HalUart::available() > 0) {
+            acceptByte(rx, request.slave, request.function, request.count, request.out,
+                       (uint8_t)HalUart::read());
+            lastBusUs = now;
+        }
+
+        uint16_t expected = expectedLength(rx);
+        if (expected > 0 && rx.length >= expected) {
+            finish(parseResponse());
+        } else if (rx.length > 0 && reached(now, lastBusUs + silenceUs)) {
+            // T3.5 sin bytes antes de completar la trama
+            finish(parseResponse());
+        } else if (rx.length == 0 && reached(now, deadlineUs)) {
+            finish(TIMED_OUT);
+        }
+        return nextRequest < requestCount;
+    }
+
+    // Las peticiones a esclavos en backoff ya nacen terminadas
+    while (nextRequest < requestCount && requests[nextRequest].result != PENDING) {
+        nextRequest++;
+    }
+    if (nextRequest >= requestCount) {
+        return false;
+    }
+    if (reached(now, lastBusUs + silenceUs)) {
+        send(now);
+    }
+    return true;
+}
+
+uint32_t ModbusRtu::nextEventMs() {
+    uint32_t now = HalClock::micros();
+    if (nextRequest >= requestCount) {
+        return 0;
+    }
+    if (state == State::IDLE || rx.length > 0) {
+        return remainingMs(now, lastBusUs + silenceUs);
+    }
+    return remainingMs(now, deadlineUs);
+}
+
+void ModbusRtu::waitForEvent() {
+    uint32_t waitMs = nextEventMs();
+    if (waitMs > 0) {
+        HalUart::waitRx(waitMs);
+    }
+}
+
+void ModbusRtu::runUntilIdle() {
+    while (poll()) {
+        waitForEvent();
+    }
+}
+
+uint32_t ModbusRtu::framesSent() {
+    return sentFrames;
+}
@@ -1,66 +1,284 @@
 #include "ModbusSensorManager.h"
+#include <math.h>
 #include "config.h"  // Para todas las constantes de configuración
 
-#include "ModbusMaster.h"
+#include "ModbusRtu.h"
+#include "ModbusLinkStats.h"
+#include "PowerManager.h"
+#include "hal/Hal.h"
 #include "debug.h"     // Para DEBUG_END
 #include "sensor_types.h" // Para todos los tipos y constantes de sensores
 #include "utilities.h"
 #include <string.h>
 
-// Crear una instancia global de ModbusMaster
-ModbusMaster modbus;
-
-// Definir Serial2 para la comunicación Modbus
-HardwareSerial modbusSerial(2); // Usar Serial2 para comunicación Modbus
-
 /**
  * @note
- *  - Se usa la biblioteca ModbusMaster para la comunicación Modbus
+ *  - Las transacciones las hace ModbusRtu (no bloqueante) sobre HalUart (Serial2)
  *  - Se asume que el pin DE/RE del transceiver RS485 está atado de forma que cuando
  *    se escribe en Serial, se habilita la transmisión, y al terminar, pasa a recepción.
  */
 
 void ModbusSensorManager::beginModbus() {
     // Configurar Serial2 usando los parámetros definidos en config.h
-    modbusSerial.begin(System::MODBUS_BAUD_RATE, System::MODBUS_SERIAL_CONFIG, Pins::MODBUS_RX, Pins::MODBUS_TX);
-
-    // Inicializar ModbusMaster con Serial2
-    modbus.begin(0, modbusSerial); // El slave ID se configurará en cada petición
+    HalUart::begin(System::MODBUS_BAUD_RATE, Pins::MODBUS_RX, Pins::MODBUS_TX);
+    ModbusRtu::begin(System::MODBUS_BAUD_RATE);
 }
 
 void ModbusSensorManager::endModbus() {
     // Finalizar la comunicación Serial2 de Modbus
-    modbusSerial.end();
+    ModbusRtu::reset();
+    HalUart::end();
 }
 
-bool ModbusSensorManager::readHoldingRegisters(uint8_t address, uint16_t startReg, uint16_t numRegs, uint16_t* outData) {
-    // Guardar los bytes recibidos para depuración posterior
-    uint8_t result;
+// Lote de puntos del ciclo (ver ModbusRegisterMap::plan)
+static ModbusPointRef points[System::MODBUS_MAX_POINTS];
+static uint8_t pointCount = 0;
+static bool pointOk[System::MODBUS_MAX_POINTS];
+static ModbusBlock blocks[System::MODBUS_MAX_POINTS];
+static uint8_t plannedBlocks = 0;
+static uint16_t batchRegisters[System::MODBUS_BATCH_REGISTERS];
+static bool planned = false;
+static bool started = false;
+static bool acquired = false;
 
-    // Establecer el slave ID
-    modbus.begin(address, modbusSerial);
+// Peticiones de ModbusRtu del lote en curso: una por bloque y, si un bloque agrupado
+// fue rechazado por dirección ilegal, una por cada uno de sus puntos
+static int8_t blockRequests[System::MODBUS_MAX_POINTS];
+static int8_t pointRequests[System::MODBUS_MAX_POINTS];
 
-    // Implementar reintentos de lectura
-    for (uint8_t retry = 0; retry < System::MODBUS_MAX_RETRY; retry++) {
-        // Registrar el tiempo de inicio para implementar timeout manual
-        uint32_t startTime = millis();
+/**
+ * @brief Calentamiento de un esclavo: se sondea su primer punto hasta que da un valor
+ *        plausible o se cumple su máximo desde que se encendieron los 12 V
+ */
+struct SlaveWarmup {
+    uint8_t slave;
+    bool ready;
+    uint8_t probePoint;         // Índice en points[]
+    uint16_t limitMs;
+    int8_t request;             // Sondeo en curso (NO_REQUEST si no hay)
+    uint16_t registers[2];
+};
 
-        // Realizar la petición Modbus para leer registros holding
-        result = modbus.readHoldingRegisters(startReg, numRegs);        if (result == modbus.ku8MBSuccess) {
-            // Extraer datos de los registros
-            for (uint8_t i = 0; i < numRegs; i++) {
-                outData[i] = modbus.getResponseBuffer(i);
-            }
+static SlaveWarmup warmups[System::MODBUS_MAX_SLAVES];
+static uint8_t warmupCount = 0;
+static bool warming = false;
+static uint32_t nextProbeMs = 0;
+
+static void submitBatch() {
+    ModbusRtu::reset();
+    for (uint8_t b = 0; b < plannedBlocks; b++) {
+        const ModbusBlock& block = blocks[b];
+        blockRequests[b] = ModbusRtu::submit(block.slave, block.function, block.start, block.count,
+                                             &batchRegisters[block.offset]);
+    }
+    for (uint8_t i = 0; i < pointCount; i++) {
+        pointRequests[i] = ModbusRtu::NO_REQUEST;
+    }
+}
+
+/**
+ * @brief Encola un sondeo por cada esclavo que todavía calienta
+ */
+static void submitProbes() {
+    ModbusRtu::reset();
+    for (uint8_t w = 0; w < warmupCount; w++) {
+        SlaveWarmup& warmup = warmups[w];
+        warmup.request = ModbusRtu::NO_REQUEST;
+        if (warmup.ready) {
+            continue;
+        }
+        const ModbusPoint& point = points[warmup.probePoint].point;
+        warmup.request = ModbusRtu::submit(warmup.slave, point.function, point.reg,
+                                           ModbusRegisterMap::registerCount(point.dataType),
+                                           warmup.registers, ModbusRtu::PROBE);
+    }
+    nextProbeMs = HalClock::millis() + System::MODBUS_PROBE_INTERVAL_MS;
+}
+
+/**
+ * @brief Avanza el calentamiento con la cola de ModbusRtu vacía
+ * @return true cuando todos los esclavos están listos (o agotaron su máximo)
+ */
+static bool warmupDone() {
+    const uint32_t railMs = PowerManager::rail12VUptimeMs();
+    bool done = true;
+    for (uint8_t w = 0; w < warmupCount; w++) {
+        SlaveWarmup& warmup = warmups[w];
+        if (warmup.ready) {
+            continue;
+        }
+        if (warmup.request != ModbusRtu::NO_REQUEST &&
+            ModbusRtu::result(warmup.request) == ModbusRtu::SUCCESS &&
+            ModbusRegisterMap::isPlausible(warmup.registers, points[warmup.probePoint].point)) {
+            warmup.ready = true;
+            DEBUG_PRINTF("Modbus: esclavo %u listo a los %lu ms de encender 12V\n", warmup.slave,
+                         (unsigned long)railMs);
+        } else if (railMs >= warmup.limitMs) {
+            warmup.ready = true;
+            DEBUG_PRINTF("Modbus: esclavo %u sin valor plausible tras %u ms\n", warmup.slave, warmup.limitMs);
+        } else {
+            done = false;
+        }
+        warmup.request = ModbusRtu::NO_REQUEST;
+    }
+    return done;
+}
+
+void ModbusSensorManager::clearPoints() {
+    warmupCount = 0;
+    warming = false;
+    pointCount = 0;
+    plannedBlocks = 0;
+    planned = false;
+    started = false;
+    acquired = false;
+}
 
-            return true;
-        }        if ((millis() - startTime) >= System::MODBUS_RESPONSE_TIMEOUT) {
-            DEBUG_PRINTLN("Timeout en comunicación Modbus");
-            break; // Salir del bucle de reintentos si se agota el tiempo
+int8_t ModbusSensorManager::addPoints(uint8_t address, const ModbusDescriptor& descriptor, uint16_t warmupMs) {
+    if (descriptor.count == 0 || descriptor.count > MAX_SUB_VALUES ||
+        pointCount + descriptor.count > System::MODBUS_MAX_POINTS) {
+        return NO_HANDLE;
+    }
+    int8_t handle = (int8_t)pointCount;
+
+    // Un calentamiento por esclavo, con el máximo más largo de sus sensores
+    if (warmupMs > 0 && ModbusRegisterMap::isValid(descriptor.points[0])) {
+        uint8_t w = 0;
+        while (w < warmupCount && warmups[w].slave != address) {
+            w++;
+        }
+        if (w == warmupCount && warmupCount < System::MODBUS_MAX_SLAVES) {
+            warmups[warmupCount++] = SlaveWarmup{address, false, (uint8_t)handle, warmupMs,
+                                                 ModbusRtu::NO_REQUEST, {0, 0}};
+        } else if (w < warmupCount && warmupMs > warmups[w].limitMs) {
+            warmups[w].limitMs = warmupMs;
+        }
+    }
+
+    for (uint8_t i = 0; i < descriptor.count; i++) {
+        ModbusPointRef& ref = points[pointCount++];
+        ref.slave = address;
+        ref.point = descriptor.points[i];
+    }
+    planned = false;
+    started = false;
+    acquired = false;
+    return handle;
+}
+
+void ModbusSensorManager::invalidate() {
+    started = false;
+    acquired = false;
+}
+
+uint8_t ModbusSensorManager::blockCount() {
+    return plannedBlocks;
+}
+
+void ModbusSensorManager::startAcquisition() {
+    if (started) {
+        return;
+    }
+    if (!planned) {
+        plannedBlocks = ModbusRegisterMap::plan(points, pointCount, blocks, System::MODBUS_MAX_POINTS,
+                                                System::MODBUS_BATCH_REGISTERS);
+        planned = true;
+        DEBUG_PRINTF("Modbus: %u puntos en %u transacciones\n", pointCount, plannedBlocks);
+    }
+
+    // Esclavos recién alimentados: primero se sondean hasta que responden algo plausible.
+    // Los que están en backoff no se esperan.
+    ModbusLinkStats::beginCycle();
+    warming = false;
+    for (uint8_t w = 0; w < warmupCount; w++) {
+        if (!warmups[w].ready && ModbusLinkStats::backedOff(warmups[w].slave)) {
+            warmups[w].ready = true;
         }
+        warming |= !warmups[w].ready;
+    }
 
-        // Si no es el último intento, continuar con el siguiente intento
-        DEBUG_PRINTF("Intento %d fallido, código: %d\n", retry + 1, result);
-    }    DEBUG_PRINTF("Error Modbus después de %d intentos\n", System::MODBUS_MAX_RETRY);
-    return false;
+    // Todos los bloques se encolan de una vez; ModbusRtu los envía uno tras otro
+    if (warming) {
+        submitProbes();
+    } else {
+        submitBatch();
+    }
+    started = true;
+    acquired = false;
 }
 
+bool ModbusSensorManager::poll() {
+    if (acquired) {
+        return true;
+    }
+    startAcquisition();
+    if (ModbusRtu::poll()) {
+        return false;
+    }
+    if (warming) {
+        if (warmupDone()) {
+            warming = false;
+            submitBatch();
+        } else if ((int32_t)(HalClock::millis() - nextProbeMs) >= 0) {
+            submitProbes();
+        }
+        return false;
+    }
+
+    // Cola vacía: los bloques rechazados por registros no implementados (huecos
+    // agrupados) se recuperan punto a punto antes de dar el lote por terminado
+    bool retried = false;
+    for (uint8_t i = 0; i < pointCount; i++) {
+        const ModbusPointRef& ref = points[i];
+        if (ref.block == ModbusRegisterMap::NO_BLOCK || pointRequests[i] != ModbusRtu::NO_REQUEST ||
+            ModbusRtu::result(blockRequests[ref.block]) != ModbusRtu::ILLEGAL_DATA_ADDRESS) {
+            continue;
+        }
+        pointRequests[i] = ModbusRtu::submit(ref.slave, ref.point.function, ref.point.reg,
+                                             ModbusRegisterMap::registerCount(ref.point.dataType),
+                                             &batchRegisters[ref.offset]);
+        retried |= (pointRequests[i] != ModbusRtu::NO_REQUEST);
+    }
+    if (retried) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < pointCount; i++) {
+        const ModbusPointRef& ref = points[i];
+        if (ref.block == ModbusRegisterMap::NO_BLOCK) {
+            pointOk[i] = false;
+        } else if (pointRequests[i] != ModbusRtu::NO_REQUEST) {
+            pointOk[i] = ModbusRtu::result(pointRequests[i]) == ModbusRtu::SUCCESS;
+        } else {
+            uint8_t result = ModbusRtu::result(blockRequests[ref.block]);
+            pointOk[i] = (result == ModbusRtu::SUCCESS);
+            if (!pointOk[i]) {
+                DEBUG_PRINTF("Error Modbus esclavo %u registro %u: código 0x%02X\n",
+                             ref.slave, ref.point.reg, result);
+            }
+        }
+    }
+    ModbusLinkStats::endCycle();
+    ModbusLinkStats::printReport();
+    acquired = true;
+    return true;
+}
+
+float ModbusSensorManager::value(int8_t handle) {
+    if (handle < 0 || handle >= (int8_t)pointCount) {
+        return NAN;
+    }
+    // Sin startMeasurement() previo (read() directo) se completa el lote aquí
+    while (!poll()) {
+        if (ModbusRtu::nextEventMs() > 0) {
+            ModbusRtu::waitForEvent();
+        } else {
+            HalClock::delayMs(1);   // Entre sondeos del calentamiento
+        }
+    }
+    const ModbusPointRef& ref = points[handle];
+    if (!pointOk[handle]) {
+        return NAN;
+    }
+    return ModbusRegisterMap::decode(&batchRegisters[ref.offset], ref.point);
+}
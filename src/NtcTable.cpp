@@ -0,0 +1,86 @@
+#include "NtcTable.h"
+#include <cmath>
+#include <string.h>
+
+namespace {
+    // Grados de margen más allá de NTC_TEMP_MIN/NTC_TEMP_MAX cubiertos por la tabla
+    const double TABLE_MARGIN_C = 1.0;
+
+    double temperatureAt(double voltage, double vRef, const SteinhartHartCoeffs& coeffs,
+                         const NtcDivider& divider) {
+        double resistance = CalibrationMath::ntcResistanceFromDivider(voltage, vRef, divider.rFixed,
+                                                                      divider.ntcTop != 0);
+        return resistance > 0.0
+            ? CalibrationMath::steinhartHartTemperature(resistance, coeffs.A, coeffs.B, coeffs.C)
+            : NAN;
+    }
+
+    /**
+     * @brief Voltaje del divisor a una temperatura, por bisección (la curva es monótona).
+     *        Si la temperatura no se alcanza dentro de (0, Vref) devuelve el extremo.
+     */
+    double voltageAt(double tempC, double vRef, const SteinhartHartCoeffs& coeffs,
+                     const NtcDivider& divider) {
+        double low = vRef * 1e-6;
+        double high = vRef * (1.0 - 1e-6);
+        const bool rising = temperatureAt(high, vRef, coeffs, divider) > temperatureAt(low, vRef, coeffs, divider);
+        for (int i = 0; i < 60; i++) {
+            double mid = (low + high) / 2.0;
+            if ((temperatureAt(mid, vRef, coeffs, divider) < tempC) == rising) {
+                low = mid;
+            } else {
+                high = mid;
+            }
+        }
+        return (low + high) / 2.0;
+    }
+}
+
+void NtcTable::build(const SteinhartHartCoeffs& coeffs, const NtcDivider& divider, NtcLut& lut) {
+    memset(&lut, 0, sizeof(lut));
+    lut.divider = divider;
+    const uint32_t segments = Calibration::NTC_LUT_SEGMENTS;
+    const double vRef = divider.vRefMilliVolts / 1000.0;
+    if (divider.vRefMilliVolts == 0 || divider.rFixed == 0 || std::isnan(coeffs.A)) {
+        for (uint32_t i = 0; i <= segments; i++) {
+            lut.c100[i] = NO_POINT;
+        }
+        return;
+    }
+
+    double start = voltageAt(Sensors::NTC_TEMP_MIN - TABLE_MARGIN_C, vRef, coeffs, divider);
+    double end = voltageAt(Sensors::NTC_TEMP_MAX + TABLE_MARGIN_C, vRef, coeffs, divider);
+    if (start > end) {
+        double swap = start;
+        start = end;
+        end = swap;
+    }
+    lut.startMicroVolts = (uint32_t)llround(start * 1e6);
+    const uint32_t spanMicroVolts = (uint32_t)llround(end * 1e6) - lut.startMicroVolts;
+    lut.stepScale = spanMicroVolts > 0 ? (uint32_t)llround(ldexp((double)segments, 32) / spanMicroVolts) : 0;
+
+    for (uint32_t i = 0; i <= segments; i++) {
+        double voltage = (lut.startMicroVolts + (double)spanMicroVolts * i / segments) / 1e6;
+        double c100 = round(temperatureAt(voltage, vRef, coeffs, divider) * 100.0);
+        lut.c100[i] = (std::isnan(c100) || c100 <= INT16_MIN || c100 > INT16_MAX) ? NO_POINT : (int16_t)c100;
+    }
+}
+
+int32_t NtcTable::temperatureC100(const NtcLut& lut, int32_t microVolts) {
+    if (microVolts < (int32_t)lut.startMicroVolts) {
+        return INVALID;
+    }
+    // Posición en la tabla en Q32: parte entera = segmento, 16 bits siguientes = fracción
+    const uint64_t position = (uint64_t)(microVolts - (int32_t)lut.startMicroVolts) * lut.stepScale;
+    const uint32_t index = (uint32_t)(position >> 32);
+    if (index >= Calibration::NTC_LUT_SEGMENTS) {
+        return INVALID;
+    }
+    const int32_t low = lut.c100[index];
+    const int32_t high = lut.c100[index + 1];
+    if (low == NO_POINT || high == NO_POINT) {
+        return INVALID;
+    }
+    const int32_t fraction = (int32_t)((position >> 16) & 0xFFFF);
+    return low + (int32_t)(((int64_t)(high - low) * fraction) >> 16);
+}
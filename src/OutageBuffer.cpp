@@ -0,0 +1,153 @@
+#include "OutageBuffer.h"
+#include <string.h>
+#include "PayloadFormat.h"
+#include "debug.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// Cada entrada: [epoch u32][longitud u8][binaryRecord]
+static const size_t ENTRY_HEADER_SIZE = 5;
+
+RTC_DATA_ATTR static uint8_t outageData[LoRa::OUTAGE_BUFFER_SIZE];
+RTC_DATA_ATTR static uint16_t outageLength = 0;
+RTC_DATA_ATTR static uint8_t outageCount = 0;
+RTC_DATA_ATTR static uint16_t outageSchema = 0;
+RTC_DATA_ATTR static uint32_t outageDropped = 0;
+RTC_DATA_ATTR static bool overflowReported = false;     // Ya se avisó del desborde en esta caída
+
+static uint32_t entryTimestamp(size_t offset) {
+    uint32_t timestamp;
+    memcpy(&timestamp, outageData + offset, sizeof(timestamp));
+    return timestamp;
+}
+
+static size_t entrySize(size_t offset) {
+    return ENTRY_HEADER_SIZE + outageData[offset + 4];
+}
+
+bool OutageBuffer::append(const ReadingSet& readings, uint32_t now) {
+    uint8_t record[LoRa::MAX_PAYLOAD];
+    size_t recordSize = PayloadFormat::binaryRecord(readings, record, sizeof(record));
+    if (recordSize == 0) {
+        return false;
+    }
+    return appendRecord(PayloadFormat::schemaId(readings), now, record, recordSize);
+}
+
+bool OutageBuffer::appendRecord(uint16_t schema, uint32_t timestamp, const uint8_t* record, size_t recordSize) {
+    if (outageCount > 0 && schema != outageSchema) {
+        DEBUG_PRINTF("Respaldo: cambio de esquema %04X -> %04X, se descartan %u registros\n",
+                     outageSchema, schema, outageCount);
+        outageDropped += outageCount;
+        clear();
+    }
+
+    if (recordSize == 0 || recordSize > UINT8_MAX || ENTRY_HEADER_SIZE + recordSize > sizeof(outageData)) {
+        return false;
+    }
+
+    // Lleno: se descartan los registros más antiguos
+    uint8_t discard = 0;
+    size_t freed = 0;
+    while (outageLength - freed + ENTRY_HEADER_SIZE + recordSize > sizeof(outageData) ||
+           (discard == 0 && outageCount == UINT8_MAX)) {
+        freed += entrySize(freed);
+        discard++;
+    }
+    if (discard > 0) {
+        consume(discard);
+        outageDropped += discard;
+        if (!overflowReported) {
+            DEBUG_PRINTF("Respaldo lleno (%u registros): se descartan los más antiguos\n", outageCount);
+            overflowReported = true;
+        }
+    }
+
+    memcpy(outageData + outageLength, &timestamp, sizeof(timestamp));
+    outageData[outageLength + 4] = (uint8_t)recordSize;
+    memcpy(outageData + outageLength + ENTRY_HEADER_SIZE, record, recordSize);
+    outageLength += ENTRY_HEADER_SIZE + recordSize;
+    outageCount++;
+    outageSchema = schema;
+    return true;
+}
+
+size_t OutageBuffer::buildFrame(uint8_t* buffer, size_t bufferSize, uint8_t& records) {
+    records = 0;
+    if (outageCount == 0 || bufferSize <= PayloadFormat::BATCH_HEADER_SIZE) {
+        return 0;
+    }
+
+    uint8_t body[LoRa::MAX_PAYLOAD];
+    size_t room = bufferSize - PayloadFormat::BATCH_HEADER_SIZE;
+    if (room > sizeof(body)) {
+        room = sizeof(body);
+    }
+    const uint32_t base = entryTimestamp(0);
+    size_t used = 0;
+    size_t offset = 0;
+    while (records < outageCount) {
+        const uint32_t delta = entryTimestamp(offset) - base;
+        const uint8_t recordSize = outageData[offset + 4];
+        // El desfase es u16: un registro a más de ~18 h del primero va en otro uplink
+        if (delta > UINT16_MAX || used + 2 + recordSize > room) {
+            break;
+        }
+        body[used] = (uint8_t)(delta >> 8);
+        body[used + 1] = (uint8_t)delta;
+        memcpy(body + used + 2, outageData + offset + ENTRY_HEADER_SIZE, recordSize);
+        used += 2 + recordSize;
+        offset += entrySize(offset);
+        records++;
+    }
+    if (records == 0) {
+        return 0;
+    }
+    return PayloadFormat::batchFrame(outageSchema, base, records, body, used, buffer, bufferSize);
+}
+
+void OutageBuffer::consume(uint8_t records) {
+    size_t offset = 0;
+    uint8_t removed = 0;
+    while (removed < records && removed < outageCount) {
+        offset += entrySize(offset);
+        removed++;
+    }
+    memmove(outageData, outageData + offset, outageLength - offset);
+    outageLength = (uint16_t)(outageLength - offset);
+    outageCount = (uint8_t)(outageCount - removed);
+    if (outageCount == 0) {
+        overflowReported = false;
+    }
+}
+
+void OutageBuffer::shiftTimestamps(int32_t offset) {
+    size_t position = 0;
+    for (uint8_t i = 0; i < outageCount; i++) {
+        uint32_t timestamp = entryTimestamp(position) + (uint32_t)offset;
+        memcpy(outageData + position, &timestamp, sizeof(timestamp));
+        position += entrySize(position);
+    }
+}
+
+void OutageBuffer::clear() {
+    outageLength = 0;
+    outageCount = 0;
+    overflowReported = false;
+}
+
+uint8_t OutageBuffer::count() {
+    return outageCount;
+}
+
+uint16_t OutageBuffer::schema() {
+    return outageSchema;
+}
+
+uint32_t OutageBuffer::dropped() {
+    return outageDropped;
+}
@@ -0,0 +1,358 @@
+#include "PayloadFormat.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <cmath>
+#include "utilities.h"
+#include "util/crc16.h"
+
+namespace {
+    void putU16(uint8_t* out, uint16_t value) {
+        out[0] = (uint8_t)(value >> 8);
+        out[1] = (uint8_t)value;
+    }
+
+    void putU32(uint8_t* out, uint32_t value) {
+        out[0] = (uint8_t)(value >> 24);
+        out[1] = (uint8_t)(value >> 16);
+        out[2] = (uint8_t)(value >> 8);
+        out[3] = (uint8_t)value;
+    }
+
+    /**
+     * @brief Agrega texto con formato en buffer + offset
+     * @return false si no cabe completo (offset no cambia)
+     */
+    bool appendf(char* buffer, size_t bufferSize, size_t& offset, const char* format, ...) {
+        if (offset >= bufferSize) {
+            return false;
+        }
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(buffer + offset, bufferSize - offset, format, args);
+        va_end(args);
+        if (written < 0 || offset + (size_t)written >= bufferSize) {
+            buffer[offset] = '\0';
+            return false;
+        }
+        offset += (size_t)written;
+        return true;
+    }
+
+    /**
+     * @brief Agrega "|id,tipo,v1,v2..." de una lectura completa o nada
+     */
+    bool appendDelimitedReading(const SensorReading& reading, char* buffer, size_t bufferSize, size_t& offset) {
+        const size_t start = offset;
+        bool fits = appendf(buffer, bufferSize, offset, "|%s,%d", reading.sensorId, reading.type);
+        for (uint8_t ch = 0; fits && ch < PayloadFormat::channelCount(reading); ch++) {
+            char valStr[16];
+            formatFloatTo3Decimals(reading.subValues.empty() ? reading.value : reading.subValues[ch].value,
+                                   valStr, sizeof(valStr));
+            fits = appendf(buffer, bufferSize, offset, ",%s", valStr);
+        }
+        if (!fits) {
+            offset = start;
+            buffer[offset] = '\0';
+        }
+        return fits;
+    }
+
+    bool selected(uint32_t mask, size_t index) {
+        return index < 32 && (mask & (1UL << index));
+    }
+
+    size_t encodingSize(ValueEncoding encoding) {
+        return encoding == ValueEncoding::I16 ? 2 : 4;
+    }
+
+    float channelValue(const SensorReading& reading, uint8_t channel) {
+        return reading.subValues.empty() ? reading.value : reading.subValues[channel].value;
+    }
+
+    /**
+     * @brief Escala un valor a punto fijo y lo escribe big-endian.
+     * @return false si es NAN o no cabe en el rango (se marca como ausente)
+     */
+    bool encodeValue(float value, ChannelEncoding enc, uint8_t* out) {
+        int32_t quantized;
+        if (!PayloadFormat::quantize(value, enc, quantized)) {
+            return false;
+        }
+        if (enc.encoding == ValueEncoding::I16) {
+            putU16(out, (uint16_t)(int16_t)quantized);
+        } else {
+            putU32(out, (uint32_t)quantized);
+        }
+        return true;
+    }
+}
+
+bool PayloadFormat::quantize(float value, ChannelEncoding enc, int32_t& out) {
+    if (std::isnan(value) || std::isinf(value)) {
+        return false;
+    }
+    if (enc.encoding == ValueEncoding::F32) {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        out = (int32_t)bits;
+        return true;
+    }
+    double scaled = std::round((double)value * enc.scale);
+    const double min = enc.encoding == ValueEncoding::I16 ? INT16_MIN : INT32_MIN;
+    const double max = enc.encoding == ValueEncoding::I16 ? INT16_MAX : INT32_MAX;
+    if (scaled < min || scaled > max) {
+        return false;
+    }
+    out = (int32_t)scaled;
+    return true;
+}
+
+size_t PayloadFormat::delimited(
+    const ReadingSet& readings,
+    const char* deviceId,
+    const char* stationId,
+    float battery,
+    uint32_t timestamp,
+    char* buffer,
+    size_t bufferSize,
+    uint32_t mask
+) {
+    if (bufferSize == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    size_t offset = 0;
+
+    char batteryStr[16];
+    formatFloatTo3Decimals(battery, batteryStr, sizeof(batteryStr));
+
+    if (!appendf(buffer, bufferSize, offset, "%s|%s|%s|%lu",
+                 stationId, deviceId, batteryStr, (unsigned long)timestamp)) {
+        return 0;
+    }
+
+    // Sin cortar lecturas a la mitad: si alguna no cabe el payload no es válido
+    for (size_t i = 0; i < readings.size(); i++) {
+        if (selected(mask, i) && !appendDelimitedReading(readings[i], buffer, bufferSize, offset)) {
+            return 0;
+        }
+    }
+
+    return offset;
+}
+
+size_t PayloadFormat::delimitedHeaderSize(
+    const char* deviceId,
+    const char* stationId,
+    float battery,
+    uint32_t timestamp
+) {
+    char batteryStr[16];
+    formatFloatTo3Decimals(battery, batteryStr, sizeof(batteryStr));
+    return (size_t)snprintf(nullptr, 0, "%s|%s|%s|%lu", stationId, deviceId, batteryStr,
+                            (unsigned long)timestamp);
+}
+
+size_t PayloadFormat::delimitedReadingSize(const SensorReading& reading) {
+    char piece[LoRa::MAX_PAYLOAD + 1];
+    size_t offset = 0;
+    return appendDelimitedReading(reading, piece, sizeof(piece), offset) ? offset : SIZE_MAX;
+}
+
+size_t PayloadFormat::binaryHeaderSize(const ReadingSet& readings) {
+    size_t channels = 0;
+    for (const auto& reading : readings) {
+        channels += channelCount(reading);
+    }
+    return 7 + (channels + 7) / 8;
+}
+
+size_t PayloadFormat::binaryReadingSize(const SensorReading& reading) {
+    size_t size = 0;
+    for (uint8_t ch = 0; ch < channelCount(reading); ch++) {
+        ChannelEncoding enc = channelEncoding(reading.type, ch);
+        int32_t quantized;
+        if (quantize(channelValue(reading, ch), enc, quantized)) {
+            size += encodingSize(enc.encoding);
+        }
+    }
+    return size;
+}
+
+ChannelEncoding PayloadFormat::channelEncoding(SensorType type, uint8_t channel) {
+    const ChannelEncoding temp = {ValueEncoding::I16, 100.0f};      // 0.01 °C
+    const ChannelEncoding percent = {ValueEncoding::I16, 100.0f};   // 0.01 %
+    const ChannelEncoding wide = {ValueEncoding::I32, 100.0f};      // 0.01 unidades
+    const ChannelEncoding counts = {ValueEncoding::I32, 1.0f};      // enteros (ppm, lux, µS/cm)
+
+    switch (type) {
+        case N100K:
+        case N10K:
+        case RTD:
+        case DS18B20:
+            return temp;
+        case HDS10:
+        case SOILH:
+            return percent;
+        case PH:
+            return {ValueEncoding::I16, 1000.0f};                   // 0.001 pH
+        case BATTERY:
+            return {ValueEncoding::I16, 1000.0f};                   // mV
+        case COND:
+        case VEML7700:
+            return wide;
+        case SHT30:
+        case SHT40:
+            return channel == 0 ? temp : percent;
+        case BME280:
+            return channel == 2 ? wide : (channel == 0 ? temp : percent);
+        case BME680:
+            return channel >= 2 ? wide : (channel == 0 ? temp : percent);
+        case CO2:
+            return channel == 0 ? counts : (channel == 1 ? temp : percent);
+        case MT05S:
+            return channel == 2 ? counts : (channel == 0 ? temp : percent);
+        case ENV4:
+            if (channel == 0) return percent;
+            if (channel == 1) return temp;
+            if (channel == 2) return wide;
+            return counts;
+        default:
+            return {ValueEncoding::F32, 1.0f};
+    }
+}
+
+uint16_t PayloadFormat::schemaId(const ReadingSet& readings) {
+    uint16_t crc = 0xFFFF;
+    crc = crc16_update(crc, BINARY_VERSION);
+    for (const auto& reading : readings) {
+        for (const char* c = reading.sensorId; *c; c++) {
+            crc = crc16_update(crc, (uint8_t)*c);
+        }
+        crc = crc16_update(crc, 0);
+        crc = crc16_update(crc, (uint8_t)reading.type);
+        crc = crc16_update(crc, channelCount(reading));
+    }
+    return crc == 0 ? 1 : crc;
+}
+
+size_t PayloadFormat::binary(
+    const ReadingSet& readings,
+    uint32_t timestamp,
+    uint8_t* buffer,
+    size_t bufferSize,
+    uint32_t mask
+) {
+    const size_t headerSize = 7;
+    if (bufferSize < headerSize) {
+        return 0;
+    }
+
+    buffer[0] = BINARY_VERSION;
+    putU16(buffer + 1, schemaId(readings));
+    putU32(buffer + 3, timestamp);
+
+    size_t recordSize = binaryRecord(readings, buffer + headerSize, bufferSize - headerSize, mask);
+    return recordSize == 0 ? 0 : headerSize + recordSize;
+}
+
+size_t PayloadFormat::binaryRecord(
+    const ReadingSet& readings,
+    uint8_t* buffer,
+    size_t bufferSize,
+    uint32_t mask
+) {
+    size_t channels = 0;
+    for (const auto& reading : readings) {
+        channels += channelCount(reading);
+    }
+    const size_t bitmapSize = (channels + 7) / 8;
+    if (bufferSize < bitmapSize) {
+        return 0;
+    }
+
+    uint8_t* bitmap = buffer;
+    memset(bitmap, 0, bitmapSize);
+    size_t offset = bitmapSize;
+
+    size_t bit = 0;
+    for (size_t i = 0; i < readings.size(); i++) {
+        const SensorReading& reading = readings[i];
+        uint8_t count = channelCount(reading);
+        if (!selected(mask, i)) {
+            // Las lecturas fuera de este frame viajan como ausentes
+            bit += count;
+            continue;
+        }
+        for (uint8_t ch = 0; ch < count; ch++, bit++) {
+            ChannelEncoding enc = channelEncoding(reading.type, ch);
+            size_t size = encodingSize(enc.encoding);
+            if (offset + size > bufferSize) {
+                return 0;
+            }
+            if (encodeValue(channelValue(reading, ch), enc, buffer + offset)) {
+                bitmap[bit / 8] |= (uint8_t)(1u << (bit % 8));
+                offset += size;
+            }
+        }
+    }
+    return offset;
+}
+
+size_t PayloadFormat::batchFrame(
+    uint16_t schema,
+    uint32_t baseTimestamp,
+    uint8_t count,
+    const uint8_t* records,
+    size_t recordsLength,
+    uint8_t* buffer,
+    size_t bufferSize
+) {
+    const size_t headerSize = BATCH_HEADER_SIZE;
+    if (bufferSize < headerSize + recordsLength) {
+        return 0;
+    }
+    buffer[0] = BINARY_VERSION;
+    putU16(buffer + 1, schema);
+    putU32(buffer + 3, baseTimestamp);
+    buffer[7] = count;
+    memcpy(buffer + headerSize, records, recordsLength);
+    return headerSize + recordsLength;
+}
+
+size_t PayloadFormat::schemaAnnouncement(
+    const ReadingSet& readings,
+    const char* deviceId,
+    const char* stationId,
+    char* buffer,
+    size_t bufferSize,
+    size_t first,
+    size_t* next
+) {
+    if (bufferSize == 0) {
+        return 0;
+    }
+    buffer[0] = '\0';
+    size_t offset = 0;
+    bool fits = first == 0
+        ? appendf(buffer, bufferSize, offset, "S|%04X|%s|%s", schemaId(readings), stationId, deviceId)
+        : appendf(buffer, bufferSize, offset, "S+|%04X|%u", schemaId(readings), (unsigned)first);
+    if (!fits) {
+        return 0;
+    }
+
+    size_t index = first;
+    while (index < readings.size() &&
+           appendf(buffer, bufferSize, offset, "|%s,%d,%u", readings[index].sensorId,
+                   readings[index].type, channelCount(readings[index]))) {
+        index++;
+    }
+    if (next != nullptr) {
+        *next = index;
+    } else if (index < readings.size()) {
+        return 0;
+    }
+    // Una parte sin sensores no avanza
+    return (index == first && first < readings.size()) ? 0 : offset;
+}
@@ -0,0 +1,141 @@
+#include "PayloadPlanner.h"
+#include "PayloadFormat.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+RTC_DATA_ATTR static uint16_t agesSchema = 0;
+RTC_DATA_ATTR static uint8_t ages[MAX_READINGS];
+
+/**
+ * @brief Orden de reparto: vencidas, prioridad, antigüedad y orden de registro
+ */
+static bool comesBefore(const ReadingSet& readings, const uint8_t* age, size_t a, size_t b) {
+    const bool overdueA = age[a] + 1 >= LoRa::REPORT_MAX_WAKES;
+    const bool overdueB = age[b] + 1 >= LoRa::REPORT_MAX_WAKES;
+    if (overdueA != overdueB) {
+        return overdueA;
+    }
+    const ReportPriority priorityA = PayloadPlanner::priority(readings[a].type);
+    const ReportPriority priorityB = PayloadPlanner::priority(readings[b].type);
+    if (priorityA != priorityB) {
+        return priorityA < priorityB;
+    }
+    if (age[a] != age[b]) {
+        return age[a] > age[b];
+    }
+    return a < b;
+}
+
+size_t PayloadPlanner::frameBudget(uint8_t datarate, size_t radioLimit) {
+    size_t budget = staticBudget(datarate);
+    return (radioLimit > 0 && radioLimit < budget) ? radioLimit : budget;
+}
+
+ReportPriority PayloadPlanner::priority(SensorType type) {
+    switch (type) {
+        case BATTERY:
+            return ReportPriority::ALWAYS;
+        case N100K:
+        case N10K:
+        case RTD:
+        case DS18B20:
+        case PH:
+        case COND:
+        case SOILH:
+        case HDS10:
+            return ReportPriority::IMPORTANT;
+        case VEML7700:
+        case MODBUS_GENERIC:
+            return ReportPriority::OPTIONAL;
+        default:
+            return ReportPriority::NORMAL;
+    }
+}
+
+uint8_t PayloadPlanner::plan(const ReadingSet& readings, const size_t* costs, size_t headerSize, size_t budget,
+                             uint8_t maxFrames, uint32_t* masks) {
+    if (maxFrames == 0 || headerSize >= budget) {
+        return 0;
+    }
+    const bool known = agesSchema == PayloadFormat::schemaId(readings);
+    uint8_t age[MAX_READINGS];
+    for (size_t i = 0; i < readings.size(); i++) {
+        age[i] = known ? ages[i] : 0;
+    }
+
+    // Las ALWAYS que caben van en todos los frames; el resto se reparte por orden
+    uint32_t always = 0;
+    size_t alwaysCost = 0;
+    uint8_t order[MAX_READINGS];
+    size_t candidates = 0;
+    for (size_t i = 0; i < readings.size(); i++) {
+        if (priority(readings[i].type) == ReportPriority::ALWAYS &&
+            headerSize + alwaysCost + costs[i] <= budget) {
+            always |= 1UL << i;
+            alwaysCost += costs[i];
+            continue;
+        }
+        size_t j = candidates++;
+        while (j > 0 && comesBefore(readings, age, i, order[j - 1])) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = (uint8_t)i;
+    }
+
+    uint32_t assigned = 0;
+    uint8_t frames = 0;
+    size_t placed = 0;
+    while (frames < maxFrames && (frames == 0 || placed < candidates)) {
+        uint32_t mask = always;
+        size_t room = budget - headerSize - alwaysCost;
+        size_t added = 0;
+        for (size_t k = 0; k < candidates; k++) {
+            const uint8_t i = order[k];
+            if (!(assigned & (1UL << i)) && costs[i] <= room) {
+                mask |= 1UL << i;
+                assigned |= 1UL << i;
+                room -= costs[i];
+                added++;
+            }
+        }
+        if (mask == 0 || (frames > 0 && added == 0)) {
+            break;
+        }
+        masks[frames++] = mask;
+        placed += added;
+    }
+    return frames;
+}
+
+void PayloadPlanner::commit(const ReadingSet& readings, uint32_t sentMask) {
+    const uint16_t schema = PayloadFormat::schemaId(readings);
+    if (schema != agesSchema) {
+        agesSchema = schema;
+        for (size_t i = 0; i < MAX_READINGS; i++) {
+            ages[i] = 0;
+        }
+    }
+    for (size_t i = 0; i < readings.size(); i++) {
+        if (sentMask & (1UL << i)) {
+            ages[i] = 0;
+        } else if (ages[i] < UINT8_MAX) {
+            ages[i]++;
+        }
+    }
+}
+
+uint8_t PayloadPlanner::wakesSinceReported(size_t index) {
+    return index < MAX_READINGS ? ages[index] : 0;
+}
+
+void PayloadPlanner::reset() {
+    agesSchema = 0;
+    for (size_t i = 0; i < MAX_READINGS; i++) {
+        ages[i] = 0;
+    }
+}
@@ -1,30 +1,53 @@
 #include "PowerManager.h"
 #include "config.h"
 #include "debug.h"
+#include "hal/Hal.h"
+
+// Momento de encendido de la línea de 12V (para el calentamiento de las sondas Modbus)
+static bool rail12VOn = false;
+static uint32_t rail12VOnMs = 0;
 
 void PowerManager::begin() {
-    pinMode(Pins::POWER_3V3, OUTPUT);
-    pinMode(Pins::POWER_12V, OUTPUT);
+    HalGpio::setOutput(Pins::POWER_3V3);
+    HalGpio::setOutput(Pins::POWER_12V);
 
     allPowerOff();
 }
 
 void PowerManager::power3V3On() {
-    digitalWrite(Pins::POWER_3V3, LOW);
-    delay(Sensors::POWER_STABILIZE_DELAY_MS);
+    // La línea de 3.3V se activa en bajo
+    HalGpio::write(Pins::POWER_3V3, false);
+    HalClock::delayMs(Sensors::POWER_STABILIZE_DELAY_MS);
 }
 
 void PowerManager::power3V3Off() {
-    digitalWrite(Pins::POWER_3V3, HIGH);
+    HalGpio::write(Pins::POWER_3V3, true);
 }
 
 void PowerManager::power12VOn() {
-    digitalWrite(Pins::POWER_12V, HIGH);
-    delay(Sensors::POWER_STABILIZE_DELAY_MS);
+    power12VStart();
+    uint32_t uptime = rail12VUptimeMs();
+    if (uptime < Sensors::POWER_STABILIZE_DELAY_MS) {
+        HalClock::delayMs(Sensors::POWER_STABILIZE_DELAY_MS - uptime);
+    }
+}
+
+void PowerManager::power12VStart() {
+    if (rail12VOn) {
+        return;
+    }
+    HalGpio::write(Pins::POWER_12V, true);
+    rail12VOnMs = HalClock::millis();
+    rail12VOn = true;
+}
+
+uint32_t PowerManager::rail12VUptimeMs() {
+    return rail12VOn ? HalClock::millis() - rail12VOnMs : 0;
 }
 
 void PowerManager::power12VOff() {
-    digitalWrite(Pins::POWER_12V, LOW);
+    HalGpio::write(Pins::POWER_12V, false);
+    rail12VOn = false;
 }
 
 void PowerManager::allPowerOff() {
@@ -0,0 +1,143 @@
+#include "ReportFilter.h"
+#include <math.h>
+#include "PayloadFormat.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+static const size_t MAX_CHANNELS = MAX_READINGS * MAX_SUB_VALUES;
+
+RTC_DATA_ATTR static bool sentValid = false;
+RTC_DATA_ATTR static uint16_t sentSchema = 0;
+RTC_DATA_ATTR static uint16_t sentChannels = 0;
+RTC_DATA_ATTR static float sentValues[MAX_CHANNELS];
+RTC_DATA_ATTR static uint16_t cyclesSinceSent = 0;
+
+/**
+ * @brief Llama a visit(índice, lectura, tipo, canal, valor) por cada canal en el orden
+ *        del payload; lectura es la posición en readings
+ * @return false si hay más canales que MAX_CHANNELS
+ */
+template <typename F>
+static bool forEachChannel(const ReadingSet& readings, F visit) {
+    size_t index = 0;
+    for (size_t r = 0; r < readings.size(); r++) {
+        const SensorReading& reading = readings[r];
+        uint8_t channels = PayloadFormat::channelCount(reading);
+        for (uint8_t c = 0; c < channels; c++) {
+            if (index >= MAX_CHANNELS) {
+                return false;
+            }
+            float value = reading.subValues.empty() ? reading.value : reading.subValues[c].value;
+            visit(index++, r, reading.type, c, value);
+        }
+    }
+    return true;
+}
+
+bool ReportFilter::isHeartbeatDue() {
+    return !sentValid || cyclesSinceSent + 1 >= LoRa::REPORT_HEARTBEAT_CYCLES;
+}
+
+bool ReportFilter::shouldSend(const ReadingSet& readings) {
+    if (isHeartbeatDue() || PayloadFormat::schemaId(readings) != sentSchema) {
+        return true;
+    }
+    bool changed = false;
+    size_t channels = 0;
+    bool fits = forEachChannel(readings, [&](size_t index, size_t, SensorType type, uint8_t channel, float value) {
+        channels = index + 1;
+        const float last = sentValues[index];
+        if (isnan(value) || isnan(last)) {
+            changed |= isnan(value) != isnan(last);
+            return;
+        }
+        const Deadband band = deadband(type, channel);
+        const float threshold = fmaxf(band.absolute, band.relative * fabsf(last));
+        changed |= fabsf(value - last) > threshold;
+    });
+    return changed || !fits || channels != sentChannels;
+}
+
+void ReportFilter::markSent(const ReadingSet& readings, uint32_t sentMask) {
+    if (sentMask == 0) {
+        return;
+    }
+    // Con otro esquema los valores guardados no corresponden a estos canales
+    const uint16_t schema = PayloadFormat::schemaId(readings);
+    const bool sameSchema = sentValid && schema == sentSchema;
+    size_t channels = 0;
+    sentValid = forEachChannel(readings, [&](size_t index, size_t reading, SensorType, uint8_t, float value) {
+        if (sentMask & (1UL << reading)) {
+            sentValues[index] = value;
+        } else if (!sameSchema) {
+            sentValues[index] = NAN;
+        }
+        channels = index + 1;
+    });
+    sentSchema = schema;
+    sentChannels = (uint16_t)channels;
+    cyclesSinceSent = 0;
+}
+
+void ReportFilter::markSkipped() {
+    if (cyclesSinceSent < UINT16_MAX) {
+        cyclesSinceSent++;
+    }
+}
+
+void ReportFilter::reset() {
+    sentValid = false;
+    sentSchema = 0;
+    sentChannels = 0;
+    cyclesSinceSent = 0;
+}
+
+Deadband ReportFilter::deadband(SensorType type, uint8_t channel) {
+    using namespace LoRa::ReportDeadband;
+    const Deadband temperature = {TEMPERATURE_ABS, 0.0f};
+    const Deadband percent = {PERCENT_ABS, 0.0f};
+    const Deadband pressure = {0.0f, PRESSURE_REL};
+    const Deadband relative = {0.0f, DEFAULT_REL};
+
+    switch (type) {
+        case N100K:
+        case N10K:
+        case RTD:
+        case DS18B20:
+            return temperature;
+        case HDS10:
+        case SOILH:
+            return percent;
+        case PH:
+            return {PH_ABS, 0.0f};
+        case BATTERY:
+            return {BATTERY_ABS, 0.0f};
+        case COND:
+            return {0.0f, CONDUCTIVITY_REL};
+        case VEML7700:
+            return {0.0f, LIGHT_REL};
+        case SHT30:
+        case SHT40:
+            return channel == 0 ? temperature : percent;
+        case BME280:
+            return channel == 2 ? pressure : (channel == 0 ? temperature : percent);
+        case BME680:
+            if (channel == 2) return pressure;
+            return channel == 3 ? relative : (channel == 0 ? temperature : percent);
+        case CO2:
+            return channel == 0 ? Deadband{CO2_ABS, 0.0f} : (channel == 1 ? temperature : percent);
+        case MT05S:
+            return channel == 2 ? Deadband{0.0f, CONDUCTIVITY_REL} : (channel == 0 ? temperature : percent);
+        case ENV4:
+            if (channel == 0) return percent;
+            if (channel == 1) return temperature;
+            if (channel == 2) return pressure;
+            return relative;
+        default:
+            return relative;
+    }
+}
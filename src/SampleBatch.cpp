@@ -0,0 +1,120 @@
+#include "SampleBatch.h"
+#include <string.h>
+#include "OutageBuffer.h"
+#include "PayloadFormat.h"
+#include "PayloadPlanner.h"
+#include "debug.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// El lote completo, con su cabecera, debe caber en un uplink del DR configurado
+static const size_t BATCH_HEADER_SIZE = PayloadFormat::BATCH_HEADER_SIZE;
+static_assert(PayloadPlanner::staticBudget(LoRa::DEFAULT_DATARATE) > BATCH_HEADER_SIZE,
+              "el DR configurado no admite el uplink de lote");
+static const size_t BATCH_RECORDS_CAPACITY = PayloadPlanner::staticBudget(LoRa::DEFAULT_DATARATE) - BATCH_HEADER_SIZE;
+
+static_assert(BATCH_RECORDS_CAPACITY - 2 <= UINT8_MAX, "el tamaño de cada registro se guarda en un u8");
+
+RTC_DATA_ATTR static uint8_t batchRecords[BATCH_RECORDS_CAPACITY];
+RTC_DATA_ATTR static uint8_t batchRecordSizes[LoRa::BATCH_SIZE];   // Sin el desfase u16
+RTC_DATA_ATTR static uint16_t batchLength = 0;
+RTC_DATA_ATTR static uint8_t batchCount = 0;
+RTC_DATA_ATTR static uint16_t batchSchema = 0;
+RTC_DATA_ATTR static uint32_t batchBaseTimestamp = 0;
+
+bool SampleBatch::willBeDue(uint32_t now) {
+    if (batchCount + 1 >= LoRa::BATCH_SIZE) {
+        return true;
+    }
+    return batchCount > 0 && (now - batchBaseTimestamp) >= LoRa::BATCH_MAX_LATENCY_S;
+}
+
+bool SampleBatch::append(const ReadingSet& readings, uint32_t now) {
+    uint16_t schema = PayloadFormat::schemaId(readings);
+    if (batchCount > 0 && schema != batchSchema) {
+        // Sin el anuncio del esquema anterior el servidor no podría decodificarlo
+        DEBUG_PRINTF("Lote: cambio de esquema %04X -> %04X, se descartan %u registros\n",
+                     batchSchema, schema, batchCount);
+        clear();
+    }
+    if (batchCount >= LoRa::BATCH_SIZE) {
+        return false;
+    }
+
+    // El desfase es u16: un registro a más de ~18 h de la base no puede entrar en el lote
+    if (batchCount > 0 && (now - batchBaseTimestamp) > UINT16_MAX) {
+        return false;
+    }
+
+    size_t offset = batchLength;
+    if (offset + 2 > BATCH_RECORDS_CAPACITY) {
+        return false;
+    }
+    size_t recordSize = PayloadFormat::binaryRecord(readings, batchRecords + offset + 2,
+                                                    BATCH_RECORDS_CAPACITY - offset - 2);
+    if (recordSize == 0) {
+        return false;
+    }
+
+    if (batchCount == 0) {
+        batchBaseTimestamp = now;
+        batchSchema = schema;
+    }
+    uint16_t delta = (uint16_t)(now - batchBaseTimestamp);
+    batchRecords[offset] = (uint8_t)(delta >> 8);
+    batchRecords[offset + 1] = (uint8_t)delta;
+    batchLength = offset + 2 + recordSize;
+    batchRecordSizes[batchCount] = (uint8_t)recordSize;
+    batchCount++;
+
+    DEBUG_PRINTF("Lote: registro %u/%u (%u bytes)\n", batchCount, LoRa::BATCH_SIZE, batchLength);
+    return true;
+}
+
+bool SampleBatch::isDue(uint32_t now) {
+    if (batchCount == 0) {
+        return false;
+    }
+    return batchCount >= LoRa::BATCH_SIZE || (now - batchBaseTimestamp) >= LoRa::BATCH_MAX_LATENCY_S;
+}
+
+size_t SampleBatch::buildFrame(uint8_t* buffer, size_t bufferSize) {
+    if (batchCount == 0) {
+        return 0;
+    }
+    return PayloadFormat::batchFrame(batchSchema, batchBaseTimestamp, batchCount,
+                                     batchRecords, batchLength, buffer, bufferSize);
+}
+
+uint8_t SampleBatch::moveToBacklog() {
+    uint8_t moved = 0;
+    size_t offset = 0;
+    for (uint8_t i = 0; i < batchCount; i++) {
+        uint16_t delta = (uint16_t)((batchRecords[offset] << 8) | batchRecords[offset + 1]);
+        if (OutageBuffer::appendRecord(batchSchema, batchBaseTimestamp + delta,
+                                       batchRecords + offset + 2, batchRecordSizes[i])) {
+            moved++;
+        }
+        offset += 2 + batchRecordSizes[i];
+    }
+    DEBUG_PRINTF("Lote: %u de %u registros pasan al respaldo\n", moved, batchCount);
+    clear();
+    return moved;
+}
+
+void SampleBatch::clear() {
+    batchLength = 0;
+    batchCount = 0;
+}
+
+uint8_t SampleBatch::count() {
+    return batchCount;
+}
+
+uint16_t SampleBatch::schema() {
+    return batchSchema;
+}
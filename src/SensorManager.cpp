@@ -1,53 +1,89 @@
 #include "SensorManager.h"
 #include "HardwareManager.h"
 #include "PowerManager.h"
-#include <Wire.h>
-#include <SPI.h>
 #include <cmath>
-#include <DallasTemperature.h>
+#include <stdio.h>
+#include <string.h>
 #include "sensor_types.h"
 #include "config.h"
-#include <Preferences.h>
 #include "config_manager.h"
+#include "ConfigStore.h"
+#include "SensorPlan.h"
 #include "debug.h"
 #include "utilities.h"
-#include <map>
-#include <string>
+#include "WakeProfiler.h"
+#include "MeasurementCache.h"
+#include "AdcSampler.h"
+#include "hal/Hal.h"
 
+#include "sensors/BatterySensor.h"
+#include "sensors/NtcSensor.h"
+#include "sensors/PHSensor.h"
+#include "sensors/ConductivitySensor.h"
+#include "sensors/HDS10Sensor.h"
+#include "sensors/SoilHumiditySensor.h"
+#include "sensors/ModbusSensor.h"
+
+// Los sensores de bus dependen de librerías de Arduino: en native no se compilan
+#ifdef ARDUINO
 #include "sensors/SHT30Sensor.h"
 #include "sensors/DS18B20Sensor.h"
 #include "sensors/CO2Sensor.h"
 #include "sensors/VEML7700Sensor.h"
 #include "sensors/SHT40Sensor.h"
-#include "sensors/BatterySensor.h"
 #include "sensors/BME680Sensor.h"
 #include "sensors/BME280Sensor.h"
-#include "sensors/NtcSensor.h"
-#include "sensors/PHSensor.h"
-#include "sensors/ConductivitySensor.h"
-#include "sensors/HDS10Sensor.h"
-#include "sensors/SoilHumiditySensor.h"
 #include "sensors/RTDSensor.h"
 #include "sensors/MT05Sensor.h"
-#include "sensors/ModbusSensor.h"
-#include <Adafruit_BME680.h>
-#include <Adafruit_BME280.h>
-#include <Adafruit_VEML7700.h>
+#endif
 
-extern Adafruit_BME680 bme680Sensor;
+alignas(std::max_align_t) uint8_t SensorManager::_arena[System::SENSOR_ARENA_SIZE];
+size_t SensorManager::_arenaUsed = 0;
 
-void SensorManager::registerSensorsFromConfig() {
+void SensorManager::releaseSensors() {
+    for (ISensor* sensor : _sensors) {
+        sensor->~ISensor();
+    }
     _sensors.clear();
+    _arenaUsed = 0;
+}
 
-    auto batterySensor = std::make_unique<BatterySensor>("BATT");
-    _sensors.push_back(std::move(batterySensor));
+bool SensorManager::registerSensor(ISensor* sensor) {
+    if (_sensors.push_back(sensor)) {
+        return true;
+    }
+    DEBUG_PRINTF("Límite de %u sensores alcanzado; se descarta %s\n",
+                 (unsigned)MAX_READINGS, sensor->getId());
+    sensor->~ISensor();
+    return false;
+}
+
+void SensorManager::registerSensorsFromConfig() {
+    releaseSensors();
+
+    uint32_t generation = ConfigStore::generation();
+    if (SensorPlan::isValid(generation)) {
+        // Despertar normal: el plan en RTC basta, sin NVS ni JSON
+        for (uint8_t i = 0; i < SensorPlan::count(); i++) {
+            ISensor* sensor = createSensor(SensorPlan::entry(i));
+            if (sensor) {
+                registerSensor(sensor);
+            }
+        }
+        DEBUG_PRINTF("Sensores registrados desde el plan en RTC: %u\n", (unsigned)_sensors.size());
+        return;
+    }
+
+    SensorPlan::reset();
+    SensorPlan::setWaterTempSource(ConfigManager::getWaterTempSourceId());
+    bool planComplete = registerAndPlan(emplaceSensor<BatterySensor>("BATT"), "", 0);
 
     auto normalConfigs = ConfigManager::getEnabledSensorConfigs();
     for (const auto& config : normalConfigs) {
         if (config.enable) {
-            auto sensor = createSensor(config);
+            ISensor* sensor = createSensor(config);
             if (sensor) {
-                _sensors.push_back(std::move(sensor));
+                planComplete &= registerAndPlan(sensor, config.configKey, 0);
                 DEBUG_PRINTF("Sensor registrado: %s\n", config.sensorId);
             }
         }
@@ -56,12 +92,10 @@ void SensorManager::registerSensorsFromConfig() {
     auto modbusConfigs = ConfigManager::getEnabledModbusSensorConfigs();
     for (const auto& config : modbusConfigs) {
         if (config.enable) {
-            if (config.type == ENV4) {
-                auto sensor = std::make_unique<ENV4ModbusSensor>(config.sensorId, config.address);
-                if (sensor) {
-                    _sensors.push_back(std::move(sensor));
-                    DEBUG_PRINTF("Sensor Modbus registrado: %s\n", config.sensorId);
-                }
+            ISensor* sensor = createModbusSensor(config.sensorId, config.type, config.address, config.descriptor);
+            if (sensor) {
+                planComplete &= registerAndPlan(sensor, "", config.address, &config.descriptor);
+                DEBUG_PRINTF("Sensor Modbus registrado: %s\n", config.sensorId);
             }
         }
     }
@@ -69,60 +103,139 @@ void SensorManager::registerSensorsFromConfig() {
     auto adcConfigs = ConfigManager::getEnabledAdcSensorConfigs();
     for (const auto& config : adcConfigs) {
         if (config.enable) {
-            auto sensor = createSensor(config);
+            ISensor* sensor = createSensor(config);
             if (sensor) {
-                _sensors.push_back(std::move(sensor));
+                planComplete &= registerAndPlan(sensor, config.configKey, 0);
                 DEBUG_PRINTF("Sensor ADC registrado: %s\n", config.sensorId);
             }
         }
     }
+
+    if (planComplete) {
+        SensorPlan::commit(generation);
+        DEBUG_PRINTF("Plan de sensores compilado en RTC (%u sensores)\n", SensorPlan::count());
+    } else {
+        // Sin plan completo el próximo despertar vuelve a leer la configuración
+        DEBUG_PRINTLN("Plan de sensores lleno; no se guarda en RTC");
+    }
 }
 
-std::unique_ptr<ISensor> SensorManager::createSensor(const SensorConfig& config) {
+bool SensorManager::registerAndPlan(ISensor* sensor, const char* configKey, uint8_t modbusAddress,
+                                    const ModbusDescriptor* descriptor) {
+    if (sensor == nullptr) {
+        return false;
+    }
+    bool planned = SensorPlan::add(sensor->getId(), configKey, sensor->getType(),
+                                   (uint8_t)sensor->getProtocol(),
+                                   (uint8_t)sensor->getPowerRequirement(), modbusAddress, descriptor);
+    // Un sensor que no cabe no puede figurar en el plan: el plan queda incompleto
+    return registerSensor(sensor) && planned;
+}
+
+ISensor* SensorManager::createSensor(const SensorPlanEntry& entry) {
+    SensorType type = static_cast<SensorType>(entry.type);
+    if (static_cast<CommunicationProtocol>(entry.bus) == CommunicationProtocol::MODBUS) {
+        return createModbusSensor(entry.sensorId, type, entry.modbusAddress,
+                                  SensorPlan::modbusDescriptor(entry));
+    }
+
+    SensorConfig config = {};
+    snprintf(config.configKey, sizeof(config.configKey), "%s", entry.configKey);
+    snprintf(config.sensorId, sizeof(config.sensorId), "%s", entry.sensorId);
+    config.type = type;
+    config.enable = true;
+    return createSensor(config);
+}
+
+ISensor* SensorManager::createModbusSensor(const char* sensorId, SensorType type, uint8_t address,
+                                          const ModbusDescriptor& descriptor) {
+    // ENV4 sin descriptor toma el de fábrica; un genérico sin puntos no tiene qué leer
+    if (type != ENV4 && !(type == MODBUS_GENERIC && descriptor.count > 0)) {
+        return nullptr;
+    }
+    return emplaceSensor<ModbusSensor>(sensorId, type, address, descriptor);
+}
+
+ISensor* SensorManager::createSensor(const SensorConfig& config) {
+    ISensor* sensor = nullptr;
     switch (config.type) {
+#ifdef ARDUINO
         case SHT40:
-            return std::make_unique<SHT40Sensor>(config.sensorId);
+            sensor = emplaceSensor<SHT40Sensor>(config.sensorId);
+            break;
         case SHT30:
-            return std::make_unique<SHT30Sensor>(config.sensorId);
+            sensor = emplaceSensor<SHT30Sensor>(config.sensorId);
+            break;
         case DS18B20:
-            return std::make_unique<DS18B20Sensor>(config.sensorId);
+            sensor = emplaceSensor<DS18B20Sensor>(config.sensorId, config.configKey);
+            break;
         case CO2:
-            return std::make_unique<CO2Sensor>(config.sensorId);
-        case BATTERY:
-            return std::make_unique<BatterySensor>(config.sensorId);
+            sensor = emplaceSensor<CO2Sensor>(config.sensorId);
+            break;
         case BME680:
-            return std::make_unique<BME680Sensor>(config.sensorId);
+            sensor = emplaceSensor<BME680Sensor>(config.sensorId);
+            break;
         case BME280:
-            return std::make_unique<BME280Sensor>(config.sensorId);
+            sensor = emplaceSensor<BME280Sensor>(config.sensorId);
+            break;
         case VEML7700:
-            return std::make_unique<VEML7700Sensor>(config.sensorId);
+            sensor = emplaceSensor<VEML7700Sensor>(config.sensorId);
+            break;
+        case RTD:
+            sensor = emplaceSensor<RTDSensor>(config.sensorId);
+            break;
+        case MT05S:
+            sensor = emplaceSensor<MT05Sensor>(config.sensorId);
+            break;
+#else
+        case SHT40:
+        case SHT30:
+        case DS18B20:
+        case CO2:
+        case BME680:
+        case BME280:
+        case VEML7700:
+        case RTD:
+        case MT05S:
+            DEBUG_PRINTF("Sensor %s sin driver en native\n", config.sensorId);
+            return nullptr;
+#endif
+        case BATTERY:
+            sensor = emplaceSensor<BatterySensor>(config.sensorId);
+            break;
         case N100K:
-            return std::make_unique<NtcSensor>(config.sensorId, N100K, config.configKey);
+            sensor = emplaceSensor<NtcSensor>(config.sensorId, N100K, config.configKey);
+            break;
         case N10K:
-            return std::make_unique<NtcSensor>(config.sensorId, N10K);
+            sensor = emplaceSensor<NtcSensor>(config.sensorId, N10K);
+            break;
         case HDS10:
-            return std::make_unique<HDS10Sensor>(config.sensorId);
+            sensor = emplaceSensor<HDS10Sensor>(config.sensorId);
+            break;
         case PH:
-            return std::make_unique<PHSensor>(config.sensorId);
+            sensor = emplaceSensor<PHSensor>(config.sensorId);
+            break;
         case COND:
-            return std::make_unique<ConductivitySensor>(config.sensorId);
+            sensor = emplaceSensor<ConductivitySensor>(config.sensorId);
+            break;
         case SOILH:
-            return std::make_unique<SoilHumiditySensor>(config.sensorId);
-        case RTD:
-            return std::make_unique<RTDSensor>(config.sensorId);
-        case MT05S:
-            return std::make_unique<MT05Sensor>(config.sensorId);
+            sensor = emplaceSensor<SoilHumiditySensor>(config.sensorId);
+            break;
         default:
             DEBUG_PRINTF("Tipo de sensor no reconocido: %d\n", config.type);
             return nullptr;
     }
+    if (sensor == nullptr) {
+        DEBUG_PRINTF("Arena de sensores llena; no se crea %s\n", config.sensorId);
+    }
+    return sensor;
 }
 
 void SensorManager::beginAll() {
     bool needs3V3Switched = false;
     bool needs12V = false;
 
-    for (const auto& sensor : _sensors) {
+    for (ISensor* sensor : _sensors) {
         PowerRequirement powerReq = sensor->getPowerRequirement();
 
         switch (powerReq) {
@@ -138,6 +251,12 @@ void SensorManager::beginAll() {
         }
     }
 
+    uint32_t phaseStart = WakeProfiler::now();
+
+    // Los sensores analógicos y Modbus vuelven a registrar sus canales/puntos en begin()
+    AdcSampler::clearChannels();
+    ModbusSensorManager::clearPoints();
+
     if (needs3V3Switched) {
         PowerManager::power3V3On();
     }
@@ -147,41 +266,137 @@ void SensorManager::beginAll() {
         ModbusSensorManager::beginModbus();
     }
 
-    for (const auto& sensor : _sensors) {
+    for (size_t i = 0; i < _sensors.size(); i++) {
+        ISensor* sensor = _sensors[i];
+        uint32_t sensorStart = WakeProfiler::now();
         HardwareManager::initializeBus(sensor->getProtocol());
 
         bool success = sensor->begin();
         if (!success) {
-            DEBUG_PRINTF("ERROR: Sensor %s falló al inicializar\n", sensor->getId().c_str());
+            DEBUG_PRINTF("ERROR: Sensor %s falló al inicializar\n", sensor->getId());
         }
+        WakeProfiler::record(PHASE_SENSORS_BEGIN, sensorStart, (uint8_t)i);
     }
+
+    WakeProfiler::record(PHASE_SENSORS_BEGIN, phaseStart);
 }
 
-std::vector<SensorReading> SensorManager::readAll() {
-    std::vector<SensorReading> readings;
+const ReadingSet& SensorManager::readAll() {
+    const size_t count = _sensors.size();
+    ReadingSet& readings = _readings;
+    readings.clear();
+    readings.resize(count);
+    bool pending[MAX_READINGS] = {};
+    uint32_t sensorStart[MAX_READINGS] = {};
+    size_t remaining = 0;
+    uint32_t phaseStart = WakeProfiler::now();
+
+    // Lotes ADC y Modbus nuevos: la primera lectura de cada uno los adquiere
+    AdcSampler::invalidate();
+    ModbusSensorManager::invalidate();
+
+    // Fuente de cada magnitud del ciclo (-1 = sin fuente: el consumidor mide por su cuenta)
+    MeasurementCache::clear();
+    int sources[(uint8_t)Quantity::COUNT];
+    for (uint8_t q = 0; q < (uint8_t)Quantity::COUNT; q++) {
+        sources[q] = findSource((Quantity)q);
+    }
 
-    for (const auto& sensor : _sensors) {
+    // Fase 1: disparar todas las conversiones para que sus esperas se solapen
+    for (size_t i = 0; i < count; i++) {
+        ISensor* sensor = _sensors[i];
         if (sensor->isInitialized()) {
-            readings.push_back(sensor->read());
+            sensorStart[i] = WakeProfiler::now();
+            sensor->startMeasurement();
+            pending[i] = true;
+            remaining++;
         } else {
-            SensorReading errorReading;
-            strncpy(errorReading.sensorId, sensor->getId().c_str(), sizeof(errorReading.sensorId) - 1);
-            errorReading.sensorId[sizeof(errorReading.sensorId) - 1] = '\0';
-            errorReading.type = sensor->getType();
-            errorReading.value = NAN;
-            readings.push_back(errorReading);
+            setErrorReading(readings[i], sensor);
+            publishIfSource(sources, i, readings[i]);
         }
     }
 
+    // Fase 2: recoger cada sensor en cuanto está listo. Las lecturas se guardan
+    // en el índice de registro para que el orden del payload no cambie.
+    uint32_t startMs = HalClock::millis();
+    while (remaining > 0) {
+        bool timedOut = (HalClock::millis() - startMs) >= Sensors::MEASUREMENT_TIMEOUT_MS;
+        bool collected = false;
+
+        for (size_t i = 0; i < count; i++) {
+            if (!pending[i]) {
+                continue;
+            }
+            // Un sensor derivado espera a que su fuente publique la magnitud
+            int source = sources[(uint8_t)_sensors[i]->dependsOn()];
+            if (!timedOut && source >= 0 && pending[source]) {
+                continue;
+            }
+            if (timedOut || _sensors[i]->isReady()) {
+                // Al expirar, un sensor que no terminó tiene en sus registros un
+                // valor a medias (p. ej. el scratchpad del DS18B20): se publica NAN
+                if (_sensors[i]->isReady()) {
+                    readings[i] = _sensors[i]->collect();
+                } else {
+                    DEBUG_PRINTF("Sensor %s sin terminar al expirar el timeout\n", _sensors[i]->getId());
+                    setErrorReading(readings[i], _sensors[i]);
+                }
+                publishIfSource(sources, i, readings[i]);
+                WakeProfiler::record(PHASE_SENSORS_READ, sensorStart[i], (uint8_t)i);
+                pending[i] = false;
+                remaining--;
+                collected = true;
+            }
+        }
+
+        if (!collected && remaining > 0) {
+            HalClock::delayMs(1);
+        }
+    }
+
+    WakeProfiler::record(PHASE_SENSORS_READ, phaseStart);
     return readings;
 }
 
 
+int SensorManager::findSource(Quantity quantity) const {
+    if (quantity != Quantity::WATER_TEMPERATURE) {
+        return -1;
+    }
+    // Fuente configurada por sensorId; sin configurar, el NTC10K como antes
+    const char* sourceId = SensorPlan::waterTempSource();
+    for (size_t i = 0; i < _sensors.size(); i++) {
+        const ISensor* sensor = _sensors[i];
+        bool selected = (sourceId[0] != '\0') ? (strcmp(sensor->getId(), sourceId) == 0)
+                                               : (sensor->getType() == N10K);
+        if (selected && MeasurementCache::canProvide(sensor->getType(), quantity)) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+void SensorManager::setErrorReading(SensorReading& reading, const ISensor* sensor) {
+    strncpy(reading.sensorId, sensor->getId(), sizeof(reading.sensorId) - 1);
+    reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
+    reading.type = sensor->getType();
+    reading.value = NAN;
+    reading.subValues.clear();
+}
+
+void SensorManager::publishIfSource(const int* sources, size_t index, const SensorReading& reading) {
+    for (uint8_t q = 1; q < (uint8_t)Quantity::COUNT; q++) {
+        if (sources[q] == (int)index) {
+            MeasurementCache::publish((Quantity)q, MeasurementCache::extract(reading, (Quantity)q));
+        }
+    }
+}
+
 void SensorManager::powerDown() {
     bool has3V3Switched = false;
     bool has12V = false;
 
-    for (const auto& sensor : _sensors) {
+    for (ISensor* sensor : _sensors) {
         PowerRequirement powerReq = sensor->getPowerRequirement();
 
         switch (powerReq) {
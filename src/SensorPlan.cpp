@@ -0,0 +1,113 @@
+#include "SensorPlan.h"
+#include <stddef.h>
+#include <string.h>
+#include "util/crc16.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+// Distinto de cero para que una RTC recién puesta a cero nunca pase por un plan válido
+static const uint16_t PLAN_MAGIC = 0x5350;
+
+RTC_DATA_ATTR static SensorPlanEntry planEntries[System::SENSOR_PLAN_MAX_ENTRIES];
+RTC_DATA_ATTR static uint8_t planCount = 0;
+RTC_DATA_ATTR static ModbusDescriptor planDescriptors[System::CONFIG_MAX_MODBUS_SENSORS];
+RTC_DATA_ATTR static uint8_t planDescriptorCount = 0;
+RTC_DATA_ATTR static char planWaterTempSource[sizeof(SensorPlanEntry::sensorId)];
+RTC_DATA_ATTR static uint16_t planMagic = 0;
+RTC_DATA_ATTR static uint16_t planCrc = 0;
+RTC_DATA_ATTR static uint32_t planGeneration = 0;
+
+static uint16_t computeCrc() {
+    uint16_t crc = 0xFFFF;
+    crc = crc16_update(crc, planCount);
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(planEntries);
+    for (size_t i = 0; i < planCount * sizeof(SensorPlanEntry); i++) {
+        crc = crc16_update(crc, bytes[i]);
+    }
+    crc = crc16_update(crc, planDescriptorCount);
+    bytes = reinterpret_cast<const uint8_t*>(planDescriptors);
+    for (size_t i = 0; i < planDescriptorCount * sizeof(ModbusDescriptor); i++) {
+        crc = crc16_update(crc, bytes[i]);
+    }
+    for (size_t i = 0; i < sizeof(planWaterTempSource); i++) {
+        crc = crc16_update(crc, (uint8_t)planWaterTempSource[i]);
+    }
+    return crc;
+}
+
+bool SensorPlan::isValid(uint32_t generation) {
+    return planMagic == PLAN_MAGIC &&
+           planGeneration == generation &&
+           planCount <= System::SENSOR_PLAN_MAX_ENTRIES &&
+           planDescriptorCount <= System::CONFIG_MAX_MODBUS_SENSORS &&
+           planCrc == computeCrc();
+}
+
+void SensorPlan::reset() {
+    planMagic = 0;
+    planCount = 0;
+    planDescriptorCount = 0;
+    memset(planEntries, 0, sizeof(planEntries));
+    memset(planDescriptors, 0, sizeof(planDescriptors));
+    memset(planWaterTempSource, 0, sizeof(planWaterTempSource));
+}
+
+bool SensorPlan::add(const char* sensorId, const char* configKey, SensorType type,
+                     uint8_t bus, uint8_t rail, uint8_t modbusAddress,
+                     const ModbusDescriptor* descriptor) {
+    if (planCount >= System::SENSOR_PLAN_MAX_ENTRIES ||
+        (descriptor && planDescriptorCount >= System::CONFIG_MAX_MODBUS_SENSORS)) {
+        return false;
+    }
+    SensorPlanEntry& entry = planEntries[planCount++];
+    strncpy(entry.sensorId, sensorId, sizeof(entry.sensorId) - 1);
+    strncpy(entry.configKey, configKey, sizeof(entry.configKey) - 1);
+    entry.type = (uint8_t)type;
+    entry.bus = bus;
+    entry.rail = rail;
+    entry.modbusAddress = modbusAddress;
+    if (descriptor) {
+        entry.modbusDescriptor = planDescriptorCount;
+        planDescriptors[planDescriptorCount++] = *descriptor;
+    }
+    return true;
+}
+
+bool SensorPlan::usesRail(uint8_t rail) {
+    for (uint8_t i = 0; i < planCount; i++) {
+        if (planEntries[i].rail == rail) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void SensorPlan::setWaterTempSource(const char* sensorId) {
+    strncpy(planWaterTempSource, sensorId, sizeof(planWaterTempSource) - 1);
+}
+
+const char* SensorPlan::waterTempSource() {
+    return planWaterTempSource;
+}
+
+void SensorPlan::commit(uint32_t generation) {
+    planGeneration = generation;
+    planCrc = computeCrc();
+    planMagic = PLAN_MAGIC;
+}
+
+uint8_t SensorPlan::count() {
+    return planCount;
+}
+
+const SensorPlanEntry& SensorPlan::entry(uint8_t index) {
+    return planEntries[index];
+}
+
+const ModbusDescriptor& SensorPlan::modbusDescriptor(const SensorPlanEntry& entry) {
+    return planDescriptors[entry.modbusDescriptor < planDescriptorCount ? entry.modbusDescriptor : 0];
+}
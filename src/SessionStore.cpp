@@ -0,0 +1,218 @@
+#include "SessionStore.h"
+#include <stdio.h>
+#include <string.h>
+#include "debug.h"
+#include "hal/Hal.h"
+#include "util/crc16.h"
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#else
+#define RTC_DATA_ATTR
+#endif
+
+static_assert(LoRa::SESSION_SLOTS >= 2 && LoRa::SESSION_SLOTS <= 10,
+              "SESSION_SLOTS: entre 2 y 10 ranuras (claves slot0..slot9)");
+
+namespace {
+    struct SlotImage {
+        SessionSlotHeader header;
+        uint8_t session[LoRa::SESSION_MAX_SIZE];
+    };
+
+    // Estado del anillo, válido mientras haya alimentación
+    RTC_DATA_ATTR bool ringKnown = false;
+    RTC_DATA_ATTR bool hasCopy = false;         // Hay una ranura válida
+    RTC_DATA_ATTR uint8_t newestSlot = 0;
+    RTC_DATA_ATTR uint32_t newestSequence = 0;
+    RTC_DATA_ATTR uint32_t savedFCntUp = 0;
+    RTC_DATA_ATTR uint32_t writeCount = 0;
+
+    // Se usa una sola ranura a la vez: fuera de la pila de la tarea que guarda
+    SlotImage slot;
+
+    void slotKey(uint8_t index, char* key) {
+        snprintf(key, 8, "slot%u", (unsigned)index);
+    }
+
+    uint16_t slotCrc(const SlotImage& image) {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&image.header.sequence);
+        const uint16_t length = (uint16_t)(sizeof(SessionSlotHeader) - offsetof(SessionSlotHeader, sequence) +
+                                           image.header.length);
+        return crc16_block(0xFFFF, bytes, length);
+    }
+
+    /**
+     * @brief Lee una ranura en 'slot' y valida versión, longitud y CRC
+     */
+    bool readSlot(uint8_t index) {
+        char key[8];
+        slotKey(index, key);
+        size_t length = HalNvs::getBytes(JsonKeys::NS_LORA_SESSION, key, &slot, sizeof(slot));
+        return length >= sizeof(SessionSlotHeader) &&
+               slot.header.version == SessionStore::VERSION &&
+               slot.header.length <= LoRa::SESSION_MAX_SIZE &&
+               length == sizeof(SessionSlotHeader) + slot.header.length &&
+               slot.header.crc == slotCrc(slot);
+    }
+
+    /**
+     * @brief Recorre las ranuras y deja en RTC la más reciente
+     * @return Índice de la ranura más reciente, o -1 si no hay ninguna válida
+     */
+    int8_t scan() {
+        int8_t newest = -1;
+        for (uint8_t i = 0; i < LoRa::SESSION_SLOTS; i++) {
+            if (!readSlot(i)) {
+                continue;
+            }
+            if (newest < 0 || (int32_t)(slot.header.sequence - newestSequence) > 0) {
+                newest = (int8_t)i;
+                newestSequence = slot.header.sequence;
+                savedFCntUp = slot.header.fcntUp;
+            }
+        }
+        hasCopy = newest >= 0;
+        newestSlot = hasCopy ? (uint8_t)newest : LoRa::SESSION_SLOTS - 1;
+        if (!hasCopy) {
+            newestSequence = 0;
+        }
+        ringKnown = true;
+        return newest;
+    }
+
+    uint32_t readU32(const uint8_t* bytes, bool bigEndian) {
+        return bigEndian ? ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | bytes[3]
+                         : ((uint32_t)bytes[3] << 24) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[1] << 8) | bytes[0];
+    }
+
+    void writeU32(uint8_t* bytes, uint32_t value, bool bigEndian) {
+        for (uint8_t i = 0; i < 4; i++) {
+            bytes[bigEndian ? 3 - i : i] = (uint8_t)(value >> (8 * i));
+        }
+    }
+
+    /**
+     * @brief XOR de los bytes pares e impares antes de la firma. La firma de RadioLib es
+     *        el XOR de las palabras de 16 bits, así que sus dos bytes son estos dos XOR.
+     */
+    void signatureBytes(const uint8_t* session, uint16_t length, uint8_t& even, uint8_t& odd) {
+        even = 0;
+        odd = 0;
+        for (uint16_t i = 0; i + 1 < length - 2; i += 2) {
+            even ^= session[i];
+            odd ^= session[i + 1];
+        }
+    }
+}
+
+bool SessionStore::isDue(uint32_t fcntUp) {
+    if (!ringKnown) {
+        scan();
+    }
+    return !hasCopy || fcntUp < savedFCntUp ||
+           fcntUp - savedFCntUp >= LoRa::SESSION_SAVE_INTERVAL;
+}
+
+bool SessionStore::save(const uint8_t* session, uint16_t length, uint32_t fcntUp) {
+    if (length > LoRa::SESSION_MAX_SIZE) {
+        DEBUG_PRINTF("SessionStore: sesión de %u bytes no cabe\n", length);
+        return false;
+    }
+    if (!ringKnown) {
+        scan();
+    }
+
+    const uint8_t index = (uint8_t)((newestSlot + 1) % LoRa::SESSION_SLOTS);
+    memset(&slot.header, 0, sizeof(slot.header));
+    slot.header.version = VERSION;
+    slot.header.sequence = newestSequence + 1;
+    slot.header.fcntUp = fcntUp;
+    slot.header.length = length;
+    memcpy(slot.session, session, length);
+    slot.header.crc = slotCrc(slot);
+
+    char key[8];
+    slotKey(index, key);
+    const size_t size = sizeof(SessionSlotHeader) + length;
+    if (HalNvs::putBytes(JsonKeys::NS_LORA_SESSION, key, &slot, size) != size) {
+        DEBUG_PRINTLN("SessionStore: error al guardar la sesión");
+        // La ranura pudo quedar a medias: la siguiente escritura usa otra, con secuencia mayor
+        newestSlot = index;
+        newestSequence = slot.header.sequence;
+        return false;
+    }
+
+    hasCopy = true;
+    newestSlot = index;
+    newestSequence = slot.header.sequence;
+    savedFCntUp = fcntUp;
+    writeCount++;
+    DEBUG_PRINTF("SessionStore: sesión guardada en %s (FCntUp %lu)\n", key, (unsigned long)fcntUp);
+    return true;
+}
+
+bool SessionStore::load(uint8_t* session, uint16_t maxLength, uint16_t& length, uint32_t& fcntUp) {
+    int8_t newest = scan();
+    if (newest < 0 || !readSlot((uint8_t)newest) || slot.header.length > maxLength) {
+        return false;
+    }
+    memcpy(session, slot.session, slot.header.length);
+    length = slot.header.length;
+    fcntUp = slot.header.fcntUp;
+    return true;
+}
+
+bool SessionStore::advanceFCntUp(uint8_t* session, uint16_t length, uint16_t offset, uint32_t fcntUp,
+                                 uint32_t gap) {
+    if (length < 6 || (length & 1) || offset + 4 > length - 2) {
+        return false;
+    }
+
+    uint8_t even, odd;
+    signatureBytes(session, length, even, odd);
+    uint8_t* signature = session + length - 2;
+    // Palabras big-endian guardadas en little-endian, o al revés
+    bool oddFirst = signature[0] == odd && signature[1] == even;
+    bool evenFirst = signature[0] == even && signature[1] == odd;
+    if (!oddFirst && !evenFirst) {
+        return false;
+    }
+
+    uint8_t* counter = session + offset;
+    bool bigEndian;
+    if (readU32(counter, false) == fcntUp) {
+        bigEndian = false;
+    } else if (readU32(counter, true) == fcntUp) {
+        bigEndian = true;
+    } else {
+        return false;
+    }
+
+    writeU32(counter, fcntUp + gap, bigEndian);
+    signatureBytes(session, length, even, odd);
+    signature[0] = oddFirst ? odd : even;
+    signature[1] = oddFirst ? even : odd;
+    return true;
+}
+
+uint32_t SessionStore::counterGap() {
+    return 2 * (uint32_t)LoRa::SESSION_SAVE_INTERVAL + LoRa::SESSION_FCNT_MARGIN;
+}
+
+void SessionStore::clear() {
+    char key[8];
+    for (uint8_t i = 0; i < LoRa::SESSION_SLOTS; i++) {
+        slotKey(i, key);
+        HalNvs::remove(JsonKeys::NS_LORA_SESSION, key);
+    }
+    ringKnown = true;
+    hasCopy = false;
+    newestSlot = LoRa::SESSION_SLOTS - 1;
+    newestSequence = 0;
+    savedFCntUp = 0;
+}
+
+uint32_t SessionStore::writes() {
+    return writeCount;
+}
@@ -2,6 +2,7 @@
 #include "config.h"
 #include "debug.h"
 #include "LoRaManager.h"
+#include "WakeProfiler.h"
 #include "esp_sleep.h"
 #include "driver/rtc_io.h"
 
@@ -9,10 +10,16 @@ void SleepManager::goToDeepSleep(uint32_t timeToSleep,
                                SX1262* radio,
                                LoRaWANNode& node,
                                uint8_t* LWsession,
-                               SPIClass& spiLora) {
-    // Guardar sesión en RTC y otras rutinas de apagado
-    uint8_t *persist = node.getBufferSession();
-    memcpy(LWsession, persist, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+                               SPIClass& spiLora,
+                               bool saveSession) {
+    uint32_t sleepEntryStart = WakeProfiler::now();
+
+    // Guardar sesión en RTC (y en flash cada SESSION_SAVE_INTERVAL uplinks) y otras rutinas de apagado
+    if (saveSession) {
+        uint8_t *persist = node.getBufferSession();
+        memcpy(LWsession, persist, RADIOLIB_LORAWAN_SESSION_BUF_SIZE);
+        LoRaManager::checkpointSession(node);
+    }
 
     // Flush Serial antes de dormir
     DEBUG_FLUSH();
@@ -55,6 +62,11 @@ void SleepManager::goToDeepSleep(uint32_t timeToSleep,
     esp_sleep_enable_timer_wakeup(timeToSleep * 1000000ULL);
     esp_sleep_enable_ext0_wakeup(wakePin, 0); // 0 para nivel bajo
 
+    // Cerrar el perfil del despertar; queda en RTC RAM para los siguientes ciclos
+    WakeProfiler::record(PHASE_SLEEP_ENTRY, sleepEntryStart);
+    WakeProfiler::record(PHASE_WAKE_TOTAL, 0);
+    WakeProfiler::commitWake();
+
     esp_deep_sleep_start();
 }
 
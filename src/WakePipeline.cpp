@@ -0,0 +1,221 @@
+/*******************************************************************************************
+ * Archivo: src/WakePipeline.cpp
+ * Descripción: Implementación del ciclo de despertar en paralelo. La restauración de la
+ * sesión LoRaWAN (radio.begin + lwActivate) corre en el núcleo 0 mientras la
+ * inicialización y lectura de sensores corre en el núcleo 1.
+ *******************************************************************************************/
+
+#include "WakePipeline.h"
+#include "LoRaManager.h"
+#include "config.h"
+#include "debug.h"
+#include "WakeProfiler.h"
+
+// Bits del event group que señalan la salida de cada tarea. Las tareas no se borran a
+// sí mismas: se quedan suspendidas tras marcar su bit, así su handle sigue siendo válido
+// para suspenderlas desde fuera si no terminan a tiempo.
+static const EventBits_t LORA_DONE_BIT = BIT0;
+static const EventBits_t SENSORS_DONE_BIT = BIT1;
+
+// Estado usado cuando la espera de la tarea LoRa expira
+static const int16_t LORA_STATE_TIMEOUT = RADIOLIB_ERR_RX_TIMEOUT;
+
+bool WakePipeline::started = false;
+bool WakePipeline::loraStarted = false;
+SX1262* WakePipeline::radioModule = nullptr;
+LoRaWANNode* WakePipeline::loraNode = nullptr;
+SensorManager* WakePipeline::sensorManager = nullptr;
+TaskHandle_t WakePipeline::loraTaskHandle = nullptr;
+TaskHandle_t WakePipeline::sensorTaskHandle = nullptr;
+QueueHandle_t WakePipeline::readingsQueue = nullptr;
+EventGroupHandle_t WakePipeline::events = nullptr;
+volatile int16_t WakePipeline::loraState = RADIOLIB_ERR_UNKNOWN;
+const ReadingSet* WakePipeline::readings = nullptr;
+WakeTimeline WakePipeline::timeline = {};
+
+bool WakePipeline::start(SX1262& radio, LoRaWANNode& node, SensorManager& sensors, bool withLoRa) {
+    if (started) {
+        return true;
+    }
+
+    radioModule = &radio;
+    loraNode = &node;
+    sensorManager = &sensors;
+    loraState = RADIOLIB_ERR_UNKNOWN;
+    timeline = {};
+    timeline.pipelineStartUs = micros();
+
+    readingsQueue = xQueueCreate(1, sizeof(const ReadingSet*));
+    events = xEventGroupCreate();
+    if (readingsQueue == nullptr || events == nullptr) {
+        DEBUG_PRINTLN("WakePipeline: no se pudo crear la cola/event group");
+        return false;
+    }
+
+    started = true;
+
+    BaseType_t sensorsOk = xTaskCreatePinnedToCore(
+        sensorTask, "sensors", System::PIPELINE_TASK_STACK_SIZE, nullptr,
+        System::PIPELINE_TASK_PRIORITY, &sensorTaskHandle, System::SENSOR_TASK_CORE);
+
+    if (sensorsOk != pdPASS || (withLoRa && !startLoRa())) {
+        DEBUG_PRINTLN("WakePipeline: error al crear las tareas");
+        // Si la tarea de sensores sí arrancó, stop() debe seguir esperándola antes de dormir
+        started = (sensorsOk == pdPASS);
+        return false;
+    }
+    return true;
+}
+
+bool WakePipeline::startLoRa() {
+    if (!started) {
+        return false;
+    }
+    if (loraStarted) {
+        return true;
+    }
+
+    BaseType_t loraOk = xTaskCreatePinnedToCore(
+        loraTask, "lora", System::PIPELINE_TASK_STACK_SIZE, nullptr,
+        System::PIPELINE_TASK_PRIORITY, &loraTaskHandle, System::LORA_TASK_CORE);
+    loraStarted = (loraOk == pdPASS);
+    return loraStarted;
+}
+
+void WakePipeline::loraTask(void* param) {
+    (void)param;
+    timeline.loraStartUs = micros();
+
+    uint32_t phaseStart = WakeProfiler::now();
+    int16_t state = radioModule->begin();
+    timeline.radioReadyUs = micros();
+    WakeProfiler::record(PHASE_RADIO_BEGIN, phaseStart);
+
+    if (state == RADIOLIB_ERR_NONE) {
+        phaseStart = WakeProfiler::now();
+        state = LoRaManager::lwActivate(*loraNode);
+        WakeProfiler::record(PHASE_LORA_ACTIVATE, phaseStart);
+    } else {
+        DEBUG_PRINTF("WakePipeline: radio.begin falló (%d)\n", state);
+    }
+
+    loraState = state;
+    timeline.loraEndUs = micros();
+    xEventGroupSetBits(events, LORA_DONE_BIT);
+    vTaskSuspend(nullptr);
+}
+
+void WakePipeline::sensorTask(void* param) {
+    (void)param;
+    timeline.sensorsStartUs = micros();
+
+    sensorManager->registerSensorsFromConfig();
+    sensorManager->beginAll();
+    timeline.sensorsBeginEndUs = micros();
+
+    // Sin copia: las lecturas quedan en el búfer estático de SensorManager
+    readings = &sensorManager->readAll();
+    timeline.sensorsEndUs = micros();
+
+    const ReadingSet* handoff = readings;
+    xQueueSend(readingsQueue, &handoff, portMAX_DELAY);
+    xEventGroupSetBits(events, SENSORS_DONE_BIT);
+    vTaskSuspend(nullptr);
+}
+
+const ReadingSet* WakePipeline::waitForReadings(uint32_t timeoutMs) {
+    if (!started) {
+        return nullptr;
+    }
+
+    const ReadingSet* handoff = nullptr;
+    if (xQueueReceive(readingsQueue, &handoff, pdMS_TO_TICKS(timeoutMs)) != pdTRUE) {
+        DEBUG_PRINTLN("WakePipeline: timeout esperando lecturas de sensores");
+        return nullptr;
+    }
+    timeline.handoffUs = micros();
+    return handoff;
+}
+
+int16_t WakePipeline::waitForLoRa(uint32_t timeoutMs) {
+    if (!loraStarted) {
+        return RADIOLIB_ERR_UNKNOWN;
+    }
+
+    EventBits_t bits = xEventGroupWaitBits(events, LORA_DONE_BIT, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    if ((bits & LORA_DONE_BIT) == 0) {
+        DEBUG_PRINTLN("WakePipeline: timeout esperando activación LoRaWAN");
+        return LORA_STATE_TIMEOUT;
+    }
+    return loraState;
+}
+
+bool WakePipeline::hasSession() {
+    if (!loraStarted || (xEventGroupGetBits(events) & LORA_DONE_BIT) == 0) {
+        return false;
+    }
+    return loraState == RADIOLIB_LORAWAN_NEW_SESSION ||
+           loraState == RADIOLIB_LORAWAN_SESSION_RESTORED;
+}
+
+bool WakePipeline::stopTask(TaskHandle_t task, EventBits_t doneBit, uint32_t timeoutMs) {
+    EventBits_t bits = xEventGroupWaitBits(events, doneBit, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeoutMs));
+    if ((bits & doneBit) != 0) {
+        return true;
+    }
+    // Si marca su bit justo ahora ya está suspendiéndose: suspenderla otra vez no hace nada
+    vTaskSuspend(task);
+    return false;
+}
+
+bool WakePipeline::stopSensors(uint32_t timeoutMs) {
+    if (!started) {
+        return true;
+    }
+    if (!stopTask(sensorTaskHandle, SENSORS_DONE_BIT, timeoutMs)) {
+        DEBUG_PRINTLN("WakePipeline: la tarea de sensores no terminó; se suspende");
+        return false;
+    }
+    return true;
+}
+
+bool WakePipeline::stop(uint32_t timeoutMs) {
+    if (!started) {
+        return true;
+    }
+    // Ambas esperas corren contra el mismo plazo
+    uint32_t startMs = millis();
+    bool sensorsDone = stopSensors(timeoutMs);
+    if (!loraStarted) {
+        return sensorsDone;
+    }
+    uint32_t elapsedMs = millis() - startMs;
+    uint32_t leftMs = elapsedMs < timeoutMs ? timeoutMs - elapsedMs : 0;
+    if (!stopTask(loraTaskHandle, LORA_DONE_BIT, leftMs)) {
+        DEBUG_PRINTLN("WakePipeline: la activación LoRaWAN no terminó; se suspende");
+        return false;
+    }
+    return sensorsDone;
+}
+
+void WakePipeline::printTimeline() {
+    const WakeTimeline& t = timeline;
+    uint32_t loraUs = t.loraEndUs ? t.loraEndUs - t.loraStartUs : 0;
+    uint32_t radioUs = t.radioReadyUs ? t.radioReadyUs - t.loraStartUs : 0;
+    uint32_t beginUs = t.sensorsBeginEndUs ? t.sensorsBeginEndUs - t.sensorsStartUs : 0;
+    uint32_t readUs = t.sensorsEndUs ? t.sensorsEndUs - t.sensorsBeginEndUs : 0;
+    uint32_t sensorsUs = beginUs + readUs;
+
+    uint32_t endUs = max(t.loraEndUs, t.sensorsEndUs);
+    uint32_t wallUs = endUs ? endUs - t.pipelineStartUs : 0;
+    uint32_t savedUs = (loraUs + sensorsUs > wallUs) ? (loraUs + sensorsUs - wallUs) : 0;
+
+    DEBUG_PRINTF("Pipeline LoRa:    radio.begin %lu us, lwActivate %lu us, total %lu us\n",
+                 (unsigned long)radioUs, (unsigned long)(loraUs - radioUs), (unsigned long)loraUs);
+    DEBUG_PRINTF("Pipeline sensores: beginAll %lu us, readAll %lu us, total %lu us\n",
+                 (unsigned long)beginUs, (unsigned long)readUs, (unsigned long)sensorsUs);
+    DEBUG_PRINTF("Pipeline: duración %lu us, solapamiento %lu us\n",
+                 (unsigned long)wallUs, (unsigned long)savedUs);
+}
@@ -0,0 +1,186 @@
+/*******************************************************************************************
+ * Archivo: src/WakeProfiler.cpp
+ * Descripción: Implementación del perfilador de fases del ciclo de despertar.
+ *******************************************************************************************/
+
+#include "WakeProfiler.h"
+#include "debug.h"
+#include <algorithm>
+#include <string.h>
+
+#ifdef ARDUINO
+#include "esp_attr.h"
+#include "freertos/FreeRTOS.h"
+// Los spans llegan desde las dos tareas del WakePipeline (núcleos 0 y 1)
+static portMUX_TYPE profilerMux = portMUX_INITIALIZER_UNLOCKED;
+#define PROFILER_LOCK()   portENTER_CRITICAL(&profilerMux)
+#define PROFILER_UNLOCK() portEXIT_CRITICAL(&profilerMux)
+#else
+#define RTC_DATA_ATTR
+// En native no hay tareas concurrentes
+#define PROFILER_LOCK()
+#define PROFILER_UNLOCK()
+#endif
+
+/**
+ * @brief Acumulador por fase que persiste en RTC RAM entre despertares.
+ */
+struct PhaseAccumulator {
+    uint32_t count;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint64_t sumUs;
+    uint32_t window[System::PROFILER_STATS_WINDOW];
+    uint8_t windowHead;
+    uint8_t windowFill;
+};
+
+RTC_DATA_ATTR static ProfileSpan spanRing[System::PROFILER_SPAN_RING_SIZE];
+RTC_DATA_ATTR static uint8_t spanHead = 0;
+RTC_DATA_ATTR static uint8_t spanFill = 0;
+RTC_DATA_ATTR static PhaseAccumulator accumulators[PHASE_COUNT];
+
+// Estado del despertar en curso (no necesita sobrevivir al deep sleep)
+static uint32_t currentUs[PHASE_COUNT];
+static uint16_t currentMask = 0;
+static uint16_t currentWake = 0;
+
+void WakeProfiler::beginWake(uint32_t wakeupCount) {
+    PROFILER_LOCK();
+    currentWake = (uint16_t)wakeupCount;
+    currentMask = 0;
+    memset(currentUs, 0, sizeof(currentUs));
+    PROFILER_UNLOCK();
+}
+
+void WakeProfiler::record(WakePhase phase, uint32_t startUs, uint8_t tag) {
+    if (phase >= PHASE_COUNT) {
+        return;
+    }
+    uint32_t durationUs = now() - startUs;
+
+    PROFILER_LOCK();
+    ProfileSpan& span = spanRing[spanHead];
+    span.wake = currentWake;
+    span.phase = phase;
+    span.tag = tag;
+    span.durationUs = durationUs;
+    spanHead = (spanHead + 1) % System::PROFILER_SPAN_RING_SIZE;
+    if (spanFill < System::PROFILER_SPAN_RING_SIZE) {
+        spanFill++;
+    }
+
+    if (tag == PROFILER_NO_TAG) {
+        currentUs[phase] += durationUs;
+        currentMask |= (1u << phase);
+    }
+    PROFILER_UNLOCK();
+}
+
+void WakeProfiler::commitWake() {
+    PROFILER_LOCK();
+    for (uint8_t p = 0; p < PHASE_COUNT; p++) {
+        // Las fases que no se ejecutaron en este despertar no cuentan como 0 us
+        if ((currentMask & (1u << p)) == 0) {
+            continue;
+        }
+        PhaseAccumulator& acc = accumulators[p];
+        uint32_t us = currentUs[p];
+
+        if (acc.count == 0 || us < acc.minUs) {
+            acc.minUs = us;
+        }
+        if (us > acc.maxUs) {
+            acc.maxUs = us;
+        }
+        acc.sumUs += us;
+        acc.count++;
+
+        acc.window[acc.windowHead] = us;
+        acc.windowHead = (acc.windowHead + 1) % System::PROFILER_STATS_WINDOW;
+        if (acc.windowFill < System::PROFILER_STATS_WINDOW) {
+            acc.windowFill++;
+        }
+    }
+    currentMask = 0;
+    PROFILER_UNLOCK();
+}
+
+PhaseStats WakeProfiler::getStats(WakePhase phase) {
+    PhaseStats stats = {};
+    if (phase >= PHASE_COUNT) {
+        return stats;
+    }
+
+    uint32_t sorted[System::PROFILER_STATS_WINDOW];
+    PROFILER_LOCK();
+    const PhaseAccumulator& acc = accumulators[phase];
+    stats.count = acc.count;
+    stats.minUs = acc.minUs;
+    stats.maxUs = acc.maxUs;
+    stats.meanUs = acc.count ? (uint32_t)(acc.sumUs / acc.count) : 0;
+    uint8_t fill = acc.windowFill;
+    memcpy(sorted, acc.window, sizeof(uint32_t) * fill);
+    PROFILER_UNLOCK();
+
+    if (fill > 0) {
+        // Percentil por rango más cercano sobre la ventana de despertares recientes
+        std::sort(sorted, sorted + fill);
+        uint8_t rank = (uint8_t)((95u * fill + 99u) / 100u);
+        stats.p95Us = sorted[rank - 1];
+    }
+    return stats;
+}
+
+void WakeProfiler::printReport() {
+    DEBUG_PRINTF("Perfil despertar #%u (us)\n", currentWake);
+    for (uint8_t p = 0; p < PHASE_COUNT; p++) {
+        PhaseStats s = getStats((WakePhase)p);
+        if ((currentMask & (1u << p)) == 0 && s.count == 0) {
+            continue;
+        }
+        DEBUG_PRINTF("  %-14s actual=%lu n=%lu min=%lu media=%lu max=%lu p95=%lu\n",
+                     phaseName((WakePhase)p),
+                     (unsigned long)currentUs[p], (unsigned long)s.count,
+                     (unsigned long)s.minUs, (unsigned long)s.meanUs,
+                     (unsigned long)s.maxUs, (unsigned long)s.p95Us);
+    }
+
+    // Spans por sensor del despertar actual
+    for (uint8_t i = 0; i < spanFill; i++) {
+        uint8_t idx = (spanHead + System::PROFILER_SPAN_RING_SIZE - spanFill + i) % System::PROFILER_SPAN_RING_SIZE;
+        const ProfileSpan& span = spanRing[idx];
+        if (span.wake == currentWake && span.tag != PROFILER_NO_TAG) {
+            DEBUG_PRINTF("  %-14s sensor[%u]=%lu\n", phaseName((WakePhase)span.phase),
+                         span.tag, (unsigned long)span.durationUs);
+        }
+    }
+}
+
+void WakeProfiler::reset() {
+    PROFILER_LOCK();
+    memset(spanRing, 0, sizeof(spanRing));
+    memset(accumulators, 0, sizeof(accumulators));
+    spanHead = 0;
+    spanFill = 0;
+    currentMask = 0;
+    memset(currentUs, 0, sizeof(currentUs));
+    PROFILER_UNLOCK();
+}
+
+const char* WakeProfiler::phaseName(WakePhase phase) {
+    switch (phase) {
+        case PHASE_WAKEUP_CAUSE:  return "wakeup_cause";
+        case PHASE_CONFIG_LOAD:   return "config_load";
+        case PHASE_HARDWARE_INIT: return "hw_init";
+        case PHASE_SENSORS_BEGIN: return "sensors_begin";
+        case PHASE_SENSORS_READ:  return "sensors_read";
+        case PHASE_RADIO_BEGIN:   return "radio_begin";
+        case PHASE_LORA_ACTIVATE: return "lw_activate";
+        case PHASE_PAYLOAD_BUILD: return "payload_build";
+        case PHASE_UPLINK:        return "uplink";
+        case PHASE_SLEEP_ENTRY:   return "sleep_entry";
+        case PHASE_WAKE_TOTAL:    return "wake_total";
+        default:                  return "?";
+    }
+}
@@ -1,33 +1,129 @@
 #include "config_manager.h"
 #include <ArduinoJson.h>
 #include <vector>
+#include <string>
+#include <stdio.h>
+#include <string.h>
 #include "sensor_types.h"
-#include <Preferences.h>
-#include <Arduino.h> // Incluido para usar Serial
+#include "hal/Hal.h"
+#include "debug.h"
 #include "config.h" // Incluido para acceder a las constantes de configuración
+#include "CalibrationStore.h"
+#include "ConfigStore.h"
+#include "ModbusRegisterMap.h"
+#include "utilities.h"
 
 /* =========================================================================
    FUNCIONES AUXILIARES
    ========================================================================= */
 // Funciones auxiliares para leer y escribir el JSON completo en cada namespace.
 static void writeNamespace(const char* ns, const StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM>& doc) {
-    Preferences prefs;
-    prefs.begin(ns, false);
-    String jsonString;
+    std::string jsonString;
     serializeJson(doc, jsonString);
     // Se usa el mismo nombre del namespace como clave interna
-    prefs.putString(ns, jsonString.c_str());
-    prefs.end();
+    HalNvs::putString(ns, ns, jsonString.c_str());
 }
 
 static void readNamespace(const char* ns, StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM>& doc) {
-    Preferences prefs;
-    prefs.begin(ns, true);
-    String jsonString = prefs.getString(ns, "{}");
-    prefs.end();
+    std::string jsonString;
+    if (!HalNvs::getString(ns, ns, jsonString)) {
+        jsonString = "{}";
+    }
     deserializeJson(doc, jsonString);
 }
 
+/* =========================================================================
+   MIGRACIÓN DESDE LOS NAMESPACES JSON
+   ========================================================================= */
+// Firmwares anteriores guardaban sistema, LoRaWAN y listas de sensores como JSON, un
+// namespace por sección. Solo se leen una vez, para construir la imagen binaria.
+static void migrateSensorArray(const char* ns, const char* keyConfig, const char* keyId,
+                               const char* keyType, const char* keyEnable,
+                               SensorConfig* out, uint8_t& count, uint8_t maxCount) {
+    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+    readNamespace(ns, doc);
+    count = 0;
+    if (!doc.is<JsonArray>()) {
+        return;
+    }
+    for (JsonObject sensorObj : doc.as<JsonArray>()) {
+        if (count >= maxCount) {
+            break;
+        }
+        SensorConfig& config = out[count++];
+        snprintf(config.configKey, sizeof(config.configKey), "%s", sensorObj[keyConfig] | "");
+        snprintf(config.sensorId, sizeof(config.sensorId), "%s", sensorObj[keyId] | "");
+        config.type = static_cast<SensorType>(sensorObj[keyType] | 0);
+        config.enable = sensorObj[keyEnable] | false;
+    }
+}
+
+static void migrateFromJson(ConfigImage& image) {
+    {
+        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+        readNamespace(JsonKeys::NS_SYSTEM, doc);
+        image.initialized = doc[JsonKeys::KEY_INITIALIZED] | false;
+        image.sleepTime = doc[JsonKeys::KEY_SLEEP_TIME] | System::DEFAULT_TIME_TO_SLEEP;
+        snprintf(image.deviceId, sizeof(image.deviceId), "%s", doc[JsonKeys::KEY_DEVICE_ID] | System::DEFAULT_DEVICE_ID);
+        snprintf(image.stationId, sizeof(image.stationId), "%s", doc[JsonKeys::KEY_STATION_ID] | System::DEFAULT_STATION_ID);
+        snprintf(image.waterTempSourceId, sizeof(image.waterTempSourceId), "%s",
+                 doc[JsonKeys::KEY_SENSOR_ID_TEMPERATURE] | Sensors::DEFAULT_WATER_TEMP_SOURCE_ID);
+    }
+    {
+        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+        readNamespace(JsonKeys::NS_LORAWAN, doc);
+        snprintf(image.joinEUI, sizeof(image.joinEUI), "%s", doc[JsonKeys::KEY_LORA_JOIN_EUI] | LoRa::DEFAULT_JOIN_EUI);
+        snprintf(image.devEUI, sizeof(image.devEUI), "%s", doc[JsonKeys::KEY_LORA_DEV_EUI] | LoRa::DEFAULT_DEV_EUI);
+        snprintf(image.nwkKey, sizeof(image.nwkKey), "%s", doc[JsonKeys::KEY_LORA_NWK_KEY] | LoRa::DEFAULT_NWK_KEY);
+        snprintf(image.appKey, sizeof(image.appKey), "%s", doc[JsonKeys::KEY_LORA_APP_KEY] | LoRa::DEFAULT_APP_KEY);
+    }
+    migrateSensorArray(JsonKeys::NS_SENSORS, JsonKeys::KEY_SENSOR, JsonKeys::KEY_SENSOR_ID,
+                       JsonKeys::KEY_SENSOR_TYPE, JsonKeys::KEY_SENSOR_ENABLE,
+                       image.sensors, image.sensorCount, System::CONFIG_MAX_SENSORS);
+    migrateSensorArray(JsonKeys::NS_SENSORS_ADC, JsonKeys::KEY_ADC_SENSOR, JsonKeys::KEY_ADC_SENSOR_ID,
+                       JsonKeys::KEY_ADC_SENSOR_TYPE, JsonKeys::KEY_ADC_SENSOR_ENABLE,
+                       image.adcSensors, image.adcSensorCount, System::CONFIG_MAX_ADC_SENSORS);
+    {
+        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+        readNamespace(JsonKeys::NS_SENSORS_MODBUS, doc);
+        image.modbusSensorCount = 0;
+        if (doc.is<JsonArray>()) {
+            for (JsonObject sensorObj : doc.as<JsonArray>()) {
+                if (image.modbusSensorCount >= System::CONFIG_MAX_MODBUS_SENSORS) {
+                    break;
+                }
+                // Los firmwares anteriores no guardaban descriptor: ENV4 queda con el de fábrica
+                ConfigManager::modbusSensorFromJson(sensorObj, image.modbusSensors[image.modbusSensorCount++]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Imagen de configuración en RAM; la primera llamada del arranque la carga de NVS
+ *        (o la migra desde JSON si todavía no existe)
+ */
+static ConfigImage& config() {
+    if (!ConfigStore::isLoaded() && !ConfigStore::load()) {
+        DEBUG_PRINTLN("Migrando configuración JSON a imagen binaria...");
+        migrateFromJson(ConfigStore::image());
+        ConfigStore::save();
+    }
+    return ConfigStore::image();
+}
+
+template <typename T>
+static void copyConfigs(const T* items, size_t itemCount, T* out, uint8_t& count, uint8_t maxCount) {
+    if (itemCount > maxCount) {
+        DEBUG_PRINTF("ConfigStore: se ignoran sensores por encima de %u\n", maxCount);
+        itemCount = maxCount;
+    }
+    for (size_t i = 0; i < itemCount; i++) {
+        out[i] = items[i];
+    }
+    count = (uint8_t)itemCount;
+}
+
 // Configuración por defecto de sensores NO-modbus
 const SensorConfig ConfigManager::defaultConfigs[] = DEFAULT_SENSOR_CONFIGS;
 
@@ -40,76 +136,59 @@ const SensorConfig ConfigManager::defaultAdcSensors[] = DEFAULT_ADC_SENSOR_CONFI
 /* =========================================================================
    INICIALIZACIÓN Y CONFIGURACIÓN DEL SISTEMA
    ========================================================================= */
+void ConfigManager::loadConfig() {
+    config();
+}
+
 bool ConfigManager::checkInitialized() {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SYSTEM, doc);
-    return doc[JsonKeys::KEY_INITIALIZED] | false;
+    return config().initialized;
 }
 
 void ConfigManager::clearAllPreferences() {
-    Preferences prefs;
-    
     // Borrar todos los namespaces utilizados en el sistema
-    prefs.begin(JsonKeys::NS_SYSTEM, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_SENSORS, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_LORAWAN, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_LORA_SESSION, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_SENSORS_MODBUS, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_SENSORS_ADC, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_NTC100K, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_NTC10K, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_COND, false);
-    prefs.clear();
-    prefs.end();
-    
-    prefs.begin(JsonKeys::NS_PH, false);
-    prefs.clear();
-    prefs.end();
-    
-    Serial.println("=== MEMORIA FLASH BORRADA COMPLETAMENTE ===");
+    const char* namespaces[] = {
+        JsonKeys::NS_SYSTEM, JsonKeys::NS_SENSORS, JsonKeys::NS_LORAWAN,
+        JsonKeys::NS_LORA_SESSION, JsonKeys::NS_SENSORS_MODBUS, JsonKeys::NS_SENSORS_ADC,
+        JsonKeys::NS_NTC100K, JsonKeys::NS_NTC10K, JsonKeys::NS_COND, JsonKeys::NS_PH,
+    };
+    for (const char* ns : namespaces) {
+        HalNvs::clear(ns);
+    }
+
+    CalibrationStore::clear();
+    ConfigStore::clear();
+
+    DEBUG_PRINTLN("=== MEMORIA FLASH BORRADA COMPLETAMENTE ===");
 }
 
 void ConfigManager::initializeDefaultConfig() {
     /* -------------------------------------------------------------------------
-       1. INICIALIZACIÓN DE CONFIGURACIÓN DEL SISTEMA
+       1. SISTEMA, LORAWAN Y LISTAS DE SENSORES (imagen binaria)
        ------------------------------------------------------------------------- */
-    // Sistema unificado: JsonKeys::NS_SYSTEM (incluye system, sleep y device)
-    // Común para todos los tipos de dispositivo
     {
-        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-        doc[JsonKeys::KEY_STATION_ID] = System::DEFAULT_STATION_ID;
-        doc[JsonKeys::KEY_INITIALIZED] = true;
-        doc[JsonKeys::KEY_SLEEP_TIME] = System::DEFAULT_TIME_TO_SLEEP;
-        doc[JsonKeys::KEY_DEVICE_ID] = System::DEFAULT_DEVICE_ID;
-        writeNamespace(JsonKeys::NS_SYSTEM, doc);
+        ConfigImage& image = ConfigStore::image();
+        image.initialized = true;
+        image.sleepTime = System::DEFAULT_TIME_TO_SLEEP;
+        snprintf(image.deviceId, sizeof(image.deviceId), "%s", System::DEFAULT_DEVICE_ID);
+        snprintf(image.stationId, sizeof(image.stationId), "%s", System::DEFAULT_STATION_ID);
+        snprintf(image.waterTempSourceId, sizeof(image.waterTempSourceId), "%s", Sensors::DEFAULT_WATER_TEMP_SOURCE_ID);
+
+        snprintf(image.joinEUI, sizeof(image.joinEUI), "%s", LoRa::DEFAULT_JOIN_EUI);
+        snprintf(image.devEUI, sizeof(image.devEUI), "%s", LoRa::DEFAULT_DEV_EUI);
+        snprintf(image.nwkKey, sizeof(image.nwkKey), "%s", LoRa::DEFAULT_NWK_KEY);
+        snprintf(image.appKey, sizeof(image.appKey), "%s", LoRa::DEFAULT_APP_KEY);
+
+        copyConfigs(defaultConfigs, sizeof(defaultConfigs) / sizeof(defaultConfigs[0]),
+                    image.sensors, image.sensorCount, System::CONFIG_MAX_SENSORS);
+        copyConfigs(defaultModbusSensors, sizeof(defaultModbusSensors) / sizeof(defaultModbusSensors[0]),
+                    image.modbusSensors, image.modbusSensorCount, System::CONFIG_MAX_MODBUS_SENSORS);
+        copyConfigs(defaultAdcSensors, sizeof(defaultAdcSensors) / sizeof(defaultAdcSensors[0]),
+                    image.adcSensors, image.adcSensorCount, System::CONFIG_MAX_ADC_SENSORS);
+        ConfigStore::save();
     }
 
     /* -------------------------------------------------------------------------
-       2. INICIALIZACIÓN DE SENSORES ANALÓGICOS
+       2. PUNTOS DE CALIBRACIÓN DE SENSORES ANALÓGICOS (JSON, los lee BLE)
        ------------------------------------------------------------------------- */
     // NTC 100K: JsonKeys::NS_NTC100K
     {
@@ -120,6 +199,9 @@ void ConfigManager::initializeDefaultConfig() {
         doc[JsonKeys::KEY_NTC100K_R2] = Calibration::NTC100K::DEFAULT_R2;
         doc[JsonKeys::KEY_NTC100K_T3] = Calibration::NTC100K::DEFAULT_T3;
         doc[JsonKeys::KEY_NTC100K_R3] = Calibration::NTC100K::DEFAULT_R3;
+        doc[JsonKeys::KEY_NTC100K_VREF] = Calibration::NTC100K::DEFAULT_VREF_MV;
+        doc[JsonKeys::KEY_NTC100K_RFIXED] = Calibration::NTC100K::DEFAULT_R_FIXED;
+        doc[JsonKeys::KEY_NTC100K_TOP] = Calibration::NTC100K::DEFAULT_NTC_TOP;
         writeNamespace(JsonKeys::NS_NTC100K, doc);
     }
 
@@ -132,6 +214,9 @@ void ConfigManager::initializeDefaultConfig() {
         doc[JsonKeys::KEY_NTC10K_R2] = Calibration::NTC10K::DEFAULT_R2;
         doc[JsonKeys::KEY_NTC10K_T3] = Calibration::NTC10K::DEFAULT_T3;
         doc[JsonKeys::KEY_NTC10K_R3] = Calibration::NTC10K::DEFAULT_R3;
+        doc[JsonKeys::KEY_NTC10K_VREF] = Calibration::NTC10K::DEFAULT_VREF_MV;
+        doc[JsonKeys::KEY_NTC10K_RFIXED] = Calibration::NTC10K::DEFAULT_R_FIXED;
+        doc[JsonKeys::KEY_NTC10K_TOP] = Calibration::NTC10K::DEFAULT_NTC_TOP;
         writeNamespace(JsonKeys::NS_NTC10K, doc);
     }
 
@@ -162,140 +247,46 @@ void ConfigManager::initializeDefaultConfig() {
         writeNamespace(JsonKeys::NS_PH, doc);
     }
 
-    /* -------------------------------------------------------------------------
-       3. INICIALIZACIÓN DE SENSORES NO-MODBUS
-       ------------------------------------------------------------------------- */
-    {
-        Preferences prefs;
-        prefs.begin(JsonKeys::NS_SENSORS, false);
-        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-        JsonArray sensorArray = doc.to<JsonArray>(); // Array raíz
-
-        for (const auto& config : ConfigManager::defaultConfigs) {
-            JsonObject sensorObj = sensorArray.createNestedObject();
-            sensorObj[JsonKeys::KEY_SENSOR] = config.configKey;
-            sensorObj[JsonKeys::KEY_SENSOR_ID] = config.sensorId;
-            sensorObj[JsonKeys::KEY_SENSOR_TYPE] = static_cast<int>(config.type);
-            sensorObj[JsonKeys::KEY_SENSOR_ENABLE] = config.enable;
-        }
-
-        String jsonString;
-        serializeJson(doc, jsonString);
-        prefs.putString(JsonKeys::NS_SENSORS, jsonString.c_str());
-        prefs.end();
-    }
-
-    /* -------------------------------------------------------------------------
-       4. INICIALIZACIÓN DE CONFIGURACIÓN DE LORA
-       ------------------------------------------------------------------------- */
-    {
-        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-        doc[JsonKeys::KEY_LORA_JOIN_EUI]      = LoRa::DEFAULT_JOIN_EUI;
-        doc[JsonKeys::KEY_LORA_DEV_EUI]       = LoRa::DEFAULT_DEV_EUI;
-        doc[JsonKeys::KEY_LORA_NWK_KEY]       = LoRa::DEFAULT_NWK_KEY;
-        doc[JsonKeys::KEY_LORA_APP_KEY]       = LoRa::DEFAULT_APP_KEY;
-        writeNamespace(JsonKeys::NS_LORAWAN, doc);
-    }
-
-    /* -------------------------------------------------------------------------
-       5. INICIALIZACIÓN DE SENSORES MODBUS
-       ------------------------------------------------------------------------- */
-    {
-        Preferences prefs;
-        prefs.begin(JsonKeys::NS_SENSORS_MODBUS, false);
-        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-        JsonArray sensorArray = doc.to<JsonArray>();
-
-        // Cargamos un default (definido en config.h)
-        size_t count = sizeof(defaultModbusSensors)/sizeof(defaultModbusSensors[0]);
-
-        for (size_t i = 0; i < count; i++) {
-            JsonObject sensorObj = sensorArray.createNestedObject();
-            sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ID]    = defaultModbusSensors[i].sensorId;
-            sensorObj[JsonKeys::KEY_MODBUS_SENSOR_TYPE]  = (int)defaultModbusSensors[i].type;
-            sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] = defaultModbusSensors[i].address;
-            sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE]   = defaultModbusSensors[i].enable;
-        }
-
-        String jsonString;
-        serializeJson(doc, jsonString);
-        prefs.putString(JsonKeys::NS_SENSORS_MODBUS, jsonString.c_str());
-        prefs.end();
-    }
-
-    /* -------------------------------------------------------------------------
-       6. INICIALIZACIÓN DE SENSORES ADC
-       ------------------------------------------------------------------------- */
-    {
-        Preferences prefs;
-        prefs.begin(JsonKeys::NS_SENSORS_ADC, false);
-        StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-        JsonArray sensorArray = doc.to<JsonArray>();
-
-        // Cargamos sensores ADC por defecto
-        size_t count = sizeof(defaultAdcSensors)/sizeof(defaultAdcSensors[0]);
-
-        for (size_t i = 0; i < count; i++) {
-            JsonObject sensorObj = sensorArray.createNestedObject();
-            sensorObj[JsonKeys::KEY_ADC_SENSOR]      = defaultAdcSensors[i].configKey;
-            sensorObj[JsonKeys::KEY_ADC_SENSOR_ID]   = defaultAdcSensors[i].sensorId;
-            sensorObj[JsonKeys::KEY_ADC_SENSOR_TYPE] = (int)defaultAdcSensors[i].type;
-            sensorObj[JsonKeys::KEY_ADC_SENSOR_ENABLE] = defaultAdcSensors[i].enable;
-        }
+    // Coeficientes resueltos a partir de los puntos por defecto
+    rebuildCalibration();
 
-        String jsonString;
-        serializeJson(doc, jsonString);
-        prefs.putString(JsonKeys::NS_SENSORS_ADC, jsonString.c_str());
-        prefs.end();
-    }
 }
 
+#ifdef ARDUINO
 void ConfigManager::getSystemConfig(bool &initialized, uint32_t &sleepTime, String &deviceId, String &stationId) {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SYSTEM, doc);
-    initialized = doc[JsonKeys::KEY_INITIALIZED] | false;
-    sleepTime = doc[JsonKeys::KEY_SLEEP_TIME] | System::DEFAULT_TIME_TO_SLEEP;
-    deviceId = String(doc[JsonKeys::KEY_DEVICE_ID] | System::DEFAULT_DEVICE_ID);
-    stationId = String(doc[JsonKeys::KEY_STATION_ID] | System::DEFAULT_STATION_ID);
+    const ConfigImage& image = config();
+    initialized = image.initialized;
+    sleepTime = image.sleepTime;
+    deviceId = String(image.deviceId);
+    stationId = String(image.stationId);
 }
 
 void ConfigManager::setSystemConfig(bool initialized, uint32_t sleepTime, const String &deviceId, const String &stationId) {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SYSTEM, doc);
-    doc[JsonKeys::KEY_INITIALIZED] = initialized;
-    doc[JsonKeys::KEY_SLEEP_TIME] = sleepTime;
-    doc[JsonKeys::KEY_DEVICE_ID] = deviceId;
-    doc[JsonKeys::KEY_STATION_ID] = stationId;
-    writeNamespace(JsonKeys::NS_SYSTEM, doc);
+    ConfigImage& image = config();
+    image.initialized = initialized;
+    image.sleepTime = sleepTime;
+    snprintf(image.deviceId, sizeof(image.deviceId), "%s", deviceId.c_str());
+    snprintf(image.stationId, sizeof(image.stationId), "%s", stationId.c_str());
+    ConfigStore::save();
+}
+#endif
+
+const char* ConfigManager::getWaterTempSourceId() {
+    return config().waterTempSourceId;
+}
+
+void ConfigManager::setWaterTempSourceId(const char* sensorId) {
+    ConfigImage& image = config();
+    snprintf(image.waterTempSourceId, sizeof(image.waterTempSourceId), "%s", sensorId);
+    ConfigStore::save();
 }
 
 /* =========================================================================
    CONFIGURACIÓN DE SENSORES NO-MODBUS
    ========================================================================= */
 std::vector<SensorConfig> ConfigManager::getAllSensorConfigs() {
-    std::vector<SensorConfig> configs;
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SENSORS, doc);
-
-    if (!doc.is<JsonArray>()) {
-        // Si no es un arreglo, no hay nada que leer
-        return configs;
-    }
-
-    JsonArray sensorArray = doc.as<JsonArray>();
-    for (JsonObject sensorObj : sensorArray) {
-        SensorConfig config;
-        const char* cKey = sensorObj[JsonKeys::KEY_SENSOR] | "";
-        strncpy(config.configKey, cKey, sizeof(config.configKey));
-        const char* sensorId = sensorObj[JsonKeys::KEY_SENSOR_ID] | "";
-        strncpy(config.sensorId, sensorId, sizeof(config.sensorId));
-        config.type = static_cast<SensorType>(sensorObj[JsonKeys::KEY_SENSOR_TYPE] | 0);
-        config.enable = sensorObj[JsonKeys::KEY_SENSOR_ENABLE] | false;
-
-        configs.push_back(config);
-    }
-
-    return configs;
+    const ConfigImage& image = config();
+    return std::vector<SensorConfig>(image.sensors, image.sensors + image.sensorCount);
 }
 
 std::vector<SensorConfig> ConfigManager::getEnabledSensorConfigs() {
@@ -312,101 +303,145 @@ std::vector<SensorConfig> ConfigManager::getEnabledSensorConfigs() {
 }
 
 void ConfigManager::setSensorsConfigs(const std::vector<SensorConfig>& configs) {
-    Preferences prefs;
-    prefs.begin(JsonKeys::NS_SENSORS, false);
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    JsonArray sensorArray = doc.to<JsonArray>();
-
-    for (const auto& sensor : configs) {
-        JsonObject sensorObj = sensorArray.createNestedObject();
-        sensorObj[JsonKeys::KEY_SENSOR] = sensor.configKey;
-        sensorObj[JsonKeys::KEY_SENSOR_ID] = sensor.sensorId;
-        sensorObj[JsonKeys::KEY_SENSOR_TYPE] = static_cast<int>(sensor.type);
-        sensorObj[JsonKeys::KEY_SENSOR_ENABLE] = sensor.enable;
-    }
-
-    String jsonString;
-    serializeJson(doc, jsonString);
-    prefs.putString(JsonKeys::NS_SENSORS, jsonString.c_str());
-    prefs.end();
+    ConfigImage& image = config();
+    copyConfigs(configs.data(), configs.size(), image.sensors, image.sensorCount, System::CONFIG_MAX_SENSORS);
+    ConfigStore::save();
 }
 
 /* =========================================================================
    CONFIGURACIÓN DE LORA
    ========================================================================= */
+#ifdef ARDUINO
 LoRaConfig ConfigManager::getLoRaConfig() {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_LORAWAN, doc);
+    const ConfigImage& image = config();
 
-    LoRaConfig config;
-    config.joinEUI  = doc[JsonKeys::KEY_LORA_JOIN_EUI] | LoRa::DEFAULT_JOIN_EUI;
-    config.devEUI   = doc[JsonKeys::KEY_LORA_DEV_EUI]  | LoRa::DEFAULT_DEV_EUI;
-    config.nwkKey   = doc[JsonKeys::KEY_LORA_NWK_KEY]  | LoRa::DEFAULT_NWK_KEY;
-    config.appKey   = doc[JsonKeys::KEY_LORA_APP_KEY]  | LoRa::DEFAULT_APP_KEY;
+    LoRaConfig loraConfig;
+    loraConfig.joinEUI  = image.joinEUI;
+    loraConfig.devEUI   = image.devEUI;
+    loraConfig.nwkKey   = image.nwkKey;
+    loraConfig.appKey   = image.appKey;
 
-    return config;
+    return loraConfig;
 }
+#endif
 
+bool ConfigManager::getLoRaKeys(uint64_t& joinEUI, uint64_t& devEUI, uint8_t* nwkKey, uint8_t* appKey) {
+    const ConfigImage& image = config();
+    if (!parseEUIString(image.joinEUI, &joinEUI) || !parseEUIString(image.devEUI, &devEUI)) {
+        return false;
+    }
+    parseKeyString(image.nwkKey, nwkKey, 16);
+    parseKeyString(image.appKey, appKey, 16);
+    return true;
+}
+
+#ifdef ARDUINO
 void ConfigManager::setLoRaConfig(
     const String &joinEUI,
     const String &devEUI,
     const String &nwkKey,
     const String &appKey) {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_LORAWAN, doc);
+    ConfigImage& image = config();
 
-    doc[JsonKeys::KEY_LORA_JOIN_EUI] = joinEUI;
-    doc[JsonKeys::KEY_LORA_DEV_EUI]  = devEUI;
-    doc[JsonKeys::KEY_LORA_NWK_KEY]  = nwkKey;
-    doc[JsonKeys::KEY_LORA_APP_KEY]  = appKey;
+    snprintf(image.joinEUI, sizeof(image.joinEUI), "%s", joinEUI.c_str());
+    snprintf(image.devEUI, sizeof(image.devEUI), "%s", devEUI.c_str());
+    snprintf(image.nwkKey, sizeof(image.nwkKey), "%s", nwkKey.c_str());
+    snprintf(image.appKey, sizeof(image.appKey), "%s", appKey.c_str());
 
-    writeNamespace(JsonKeys::NS_LORAWAN, doc);
+    ConfigStore::save();
 }
+#endif
 
 /* =========================================================================
    CONFIGURACIÓN DE SENSORES MODBUS
    ========================================================================= */
 void ConfigManager::setModbusSensorsConfigs(const std::vector<ModbusSensorConfig>& configs) {
-    Preferences prefs;
-    prefs.begin(JsonKeys::NS_SENSORS_MODBUS, false);
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    JsonArray sensorArray = doc.to<JsonArray>();
-
-    for (const auto& sensor : configs) {
-        JsonObject sensorObj = sensorArray.createNestedObject();
-        sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ID] = sensor.sensorId;
-        sensorObj[JsonKeys::KEY_MODBUS_SENSOR_TYPE] = static_cast<int>(sensor.type);
-        sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] = sensor.address;
-        sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE] = sensor.enable;
-    }
-
-    String jsonString;
-    serializeJson(doc, jsonString);
-    prefs.putString(JsonKeys::NS_SENSORS_MODBUS, jsonString.c_str());
-    prefs.end();
+    ConfigImage& image = config();
+    copyConfigs(configs.data(), configs.size(), image.modbusSensors, image.modbusSensorCount, System::CONFIG_MAX_MODBUS_SENSORS);
+    ConfigStore::save();
 }
 
 std::vector<ModbusSensorConfig> ConfigManager::getAllModbusSensorConfigs() {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SENSORS_MODBUS, doc);
-
-    std::vector<ModbusSensorConfig> configs;
-
-    if (doc.is<JsonArray>()) {
-        JsonArray array = doc.as<JsonArray>();
+    const ConfigImage& image = config();
+    return std::vector<ModbusSensorConfig>(image.modbusSensors,
+                                           image.modbusSensors + image.modbusSensorCount);
+}
 
-        for (JsonObject sensorObj : array) {
-            ModbusSensorConfig config;
-            strlcpy(config.sensorId, sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ID] | "", sizeof(config.sensorId));
-            config.type = static_cast<SensorType>(sensorObj[JsonKeys::KEY_MODBUS_SENSOR_TYPE] | 0);
-            config.address = sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] | 1;
-            config.enable = sensorObj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE] | false;
+void ConfigManager::modbusSensorFromJson(JsonObjectConst obj, ModbusSensorConfig& config) {
+    memset(&config, 0, sizeof(config));
+    snprintf(config.sensorId, sizeof(config.sensorId), "%s", obj[JsonKeys::KEY_MODBUS_SENSOR_ID] | "");
+    config.type = static_cast<SensorType>(obj[JsonKeys::KEY_MODBUS_SENSOR_TYPE] | 0);
+    config.address = obj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] | 1;
+    config.enable = obj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE] | false;
+
+    JsonArrayConst points = obj[JsonKeys::KEY_MODBUS_POINTS];
+    if (points.isNull() || points.size() == 0) {
+        ModbusRegisterMap::preset(config.type, config.descriptor);
+        return;
+    }
+    for (JsonObjectConst pointObj : points) {
+        if (config.descriptor.count >= MAX_SUB_VALUES) {
+            DEBUG_PRINTF("Modbus %s: se ignoran los puntos más allá de %u\n", config.sensorId,
+                         (unsigned)MAX_SUB_VALUES);
+            break;
+        }
+        ModbusPoint& point = config.descriptor.points[config.descriptor.count];
+        point.reg = pointObj[JsonKeys::KEY_MODBUS_POINT_REG] | 0;
+        point.function = pointObj[JsonKeys::KEY_MODBUS_POINT_FUNCTION] | MODBUS_FUNCTION_HOLDING;
+        point.dataType = pointObj[JsonKeys::KEY_MODBUS_POINT_TYPE] | (uint8_t)ModbusDataType::U16;
+        point.order = pointObj[JsonKeys::KEY_MODBUS_POINT_ORDER] | 0;
+        point.scale = pointObj[JsonKeys::KEY_MODBUS_POINT_SCALE] | 1.0f;
+        point.offset = pointObj[JsonKeys::KEY_MODBUS_POINT_OFFSET] | 0.0f;
+        if (!ModbusRegisterMap::isValid(point)) {
+            DEBUG_PRINTF("Modbus %s: punto inválido (registro %u, función %u, tipo %u)\n",
+                         config.sensorId, point.reg, point.function, point.dataType);
+            continue;
+        }
+        config.descriptor.count++;
+    }
+}
 
-            configs.push_back(config);
+/**
+ * @brief Indica si el descriptor es el de fábrica del tipo (campo a campo: el relleno
+ *        de ModbusPoint no está definido)
+ */
+static bool isPresetDescriptor(const ModbusSensorConfig& config) {
+    ModbusDescriptor preset;
+    if (!ModbusRegisterMap::preset(config.type, preset) || preset.count != config.descriptor.count) {
+        return false;
+    }
+    for (uint8_t i = 0; i < preset.count; i++) {
+        const ModbusPoint& a = preset.points[i];
+        const ModbusPoint& b = config.descriptor.points[i];
+        if (a.reg != b.reg || a.function != b.function || a.dataType != b.dataType ||
+            a.order != b.order || a.scale != b.scale || a.offset != b.offset) {
+            return false;
         }
     }
+    return true;
+}
 
-    return configs;
+void ConfigManager::modbusSensorToJson(const ModbusSensorConfig& config, JsonObject obj) {
+    obj[JsonKeys::KEY_MODBUS_SENSOR_ID] = config.sensorId;
+    obj[JsonKeys::KEY_MODBUS_SENSOR_TYPE] = static_cast<int>(config.type);
+    obj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] = config.address;
+    obj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE] = config.enable;
+    // El descriptor de fábrica se omite: sin "p" el sensor lo vuelve a tomar, y la
+    // característica BLE no pasa de ~512 bytes
+    if (isPresetDescriptor(config)) {
+        return;
+    }
+    JsonArray points = obj.createNestedArray(JsonKeys::KEY_MODBUS_POINTS);
+    for (uint8_t i = 0; i < config.descriptor.count && i < MAX_SUB_VALUES; i++) {
+        const ModbusPoint& point = config.descriptor.points[i];
+        JsonObject pointObj = points.createNestedObject();
+        pointObj[JsonKeys::KEY_MODBUS_POINT_REG] = point.reg;
+        pointObj[JsonKeys::KEY_MODBUS_POINT_FUNCTION] = point.function;
+        pointObj[JsonKeys::KEY_MODBUS_POINT_TYPE] = point.dataType;
+        pointObj[JsonKeys::KEY_MODBUS_POINT_ORDER] = point.order;
+        pointObj[JsonKeys::KEY_MODBUS_POINT_SCALE] = point.scale;
+        pointObj[JsonKeys::KEY_MODBUS_POINT_OFFSET] = point.offset;
+    }
 }
 
 std::vector<ModbusSensorConfig> ConfigManager::getEnabledModbusSensorConfigs() {
@@ -423,7 +458,8 @@ std::vector<ModbusSensorConfig> ConfigManager::getEnabledModbusSensorConfigs() {
 /* =========================================================================
    CONFIGURACIÓN DE SENSORES ANALÓGICOS
    ========================================================================= */
-void ConfigManager::getNTC100KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3) {
+void ConfigManager::getNTC100KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3,
+                                     NtcDivider& divider) {
     StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
     readNamespace(JsonKeys::NS_NTC100K, doc);
     t1 = doc[JsonKeys::KEY_NTC100K_T1] | Calibration::NTC100K::DEFAULT_T1;
@@ -432,9 +468,14 @@ void ConfigManager::getNTC100KConfig(double& t1, double& r1, double& t2, double&
     r2 = doc[JsonKeys::KEY_NTC100K_R2] | Calibration::NTC100K::DEFAULT_R2;
     t3 = doc[JsonKeys::KEY_NTC100K_T3] | Calibration::NTC100K::DEFAULT_T3;
     r3 = doc[JsonKeys::KEY_NTC100K_R3] | Calibration::NTC100K::DEFAULT_R3;
+    divider.vRefMilliVolts = doc[JsonKeys::KEY_NTC100K_VREF] | Calibration::NTC100K::DEFAULT_VREF_MV;
+    divider.rFixed = doc[JsonKeys::KEY_NTC100K_RFIXED] | Calibration::NTC100K::DEFAULT_R_FIXED;
+    divider.ntcTop = (doc[JsonKeys::KEY_NTC100K_TOP] | Calibration::NTC100K::DEFAULT_NTC_TOP) ? 1 : 0;
+    divider.reserved = 0;
 }
 
-void ConfigManager::setNTC100KConfig(double t1, double r1, double t2, double r2, double t3, double r3) {
+void ConfigManager::setNTC100KConfig(double t1, double r1, double t2, double r2, double t3, double r3,
+                                     const NtcDivider& divider) {
     StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
     readNamespace(JsonKeys::NS_NTC100K, doc);
     doc[JsonKeys::KEY_NTC100K_T1] = t1;
@@ -443,10 +484,15 @@ void ConfigManager::setNTC100KConfig(double t1, double r1, double t2, double r2,
     doc[JsonKeys::KEY_NTC100K_R2] = r2;
     doc[JsonKeys::KEY_NTC100K_T3] = t3;
     doc[JsonKeys::KEY_NTC100K_R3] = r3;
+    doc[JsonKeys::KEY_NTC100K_VREF] = divider.vRefMilliVolts;
+    doc[JsonKeys::KEY_NTC100K_RFIXED] = divider.rFixed;
+    doc[JsonKeys::KEY_NTC100K_TOP] = divider.ntcTop != 0;
     writeNamespace(JsonKeys::NS_NTC100K, doc);
+    CalibrationStore::setNtc100k(t1, r1, t2, r2, t3, r3, divider);
 }
 
-void ConfigManager::getNTC10KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3) {
+void ConfigManager::getNTC10KConfig(double& t1, double& r1, double& t2, double& r2, double& t3, double& r3,
+                                     NtcDivider& divider) {
     StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
     readNamespace(JsonKeys::NS_NTC10K, doc);
     t1 = doc[JsonKeys::KEY_NTC10K_T1] | Calibration::NTC10K::DEFAULT_T1;
@@ -455,9 +501,14 @@ void ConfigManager::getNTC10KConfig(double& t1, double& r1, double& t2, double&
     r2 = doc[JsonKeys::KEY_NTC10K_R2] | Calibration::NTC10K::DEFAULT_R2;
     t3 = doc[JsonKeys::KEY_NTC10K_T3] | Calibration::NTC10K::DEFAULT_T3;
     r3 = doc[JsonKeys::KEY_NTC10K_R3] | Calibration::NTC10K::DEFAULT_R3;
+    divider.vRefMilliVolts = doc[JsonKeys::KEY_NTC10K_VREF] | Calibration::NTC10K::DEFAULT_VREF_MV;
+    divider.rFixed = doc[JsonKeys::KEY_NTC10K_RFIXED] | Calibration::NTC10K::DEFAULT_R_FIXED;
+    divider.ntcTop = (doc[JsonKeys::KEY_NTC10K_TOP] | Calibration::NTC10K::DEFAULT_NTC_TOP) ? 1 : 0;
+    divider.reserved = 0;
 }
 
-void ConfigManager::setNTC10KConfig(double t1, double r1, double t2, double r2, double t3, double r3) {
+void ConfigManager::setNTC10KConfig(double t1, double r1, double t2, double r2, double t3, double r3,
+                                     const NtcDivider& divider) {
     StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
     readNamespace(JsonKeys::NS_NTC10K, doc);
     doc[JsonKeys::KEY_NTC10K_T1] = t1;
@@ -466,7 +517,11 @@ void ConfigManager::setNTC10KConfig(double t1, double r1, double t2, double r2,
     doc[JsonKeys::KEY_NTC10K_R2] = r2;
     doc[JsonKeys::KEY_NTC10K_T3] = t3;
     doc[JsonKeys::KEY_NTC10K_R3] = r3;
+    doc[JsonKeys::KEY_NTC10K_VREF] = divider.vRefMilliVolts;
+    doc[JsonKeys::KEY_NTC10K_RFIXED] = divider.rFixed;
+    doc[JsonKeys::KEY_NTC10K_TOP] = divider.ntcTop != 0;
     writeNamespace(JsonKeys::NS_NTC10K, doc);
+    CalibrationStore::setNtc10k(t1, r1, t2, r2, t3, r3, divider);
 }
 
 void ConfigManager::getConductivityConfig(float& calTemp, float& coefComp,
@@ -496,6 +551,7 @@ void ConfigManager::setConductivityConfig(float calTemp, float coefComp,
     doc[JsonKeys::KEY_CONDUCT_V3] = v3;
     doc[JsonKeys::KEY_CONDUCT_T3] = t3;
     writeNamespace(JsonKeys::NS_COND, doc);
+    CalibrationStore::setConductivity(calTemp, coefComp, v1, t1, v2, t2, v3, t3);
 }
 
 void ConfigManager::getPHConfig(float& v1, float& t1, float& v2, float& t2, float& v3, float& t3, float& defaultTemp) {
@@ -521,54 +577,43 @@ void ConfigManager::setPHConfig(float v1, float t1, float v2, float t2, float v3
     doc[JsonKeys::KEY_PH_T3] = t3;
     doc[JsonKeys::KEY_PH_CT] = defaultTemp;
     writeNamespace(JsonKeys::NS_PH, doc);
+    CalibrationStore::setPh(v1, t1, v2, t2, v3, t3, defaultTemp);
+}
+
+void ConfigManager::loadCalibration() {
+    if (!CalibrationStore::load()) {
+        // Firmware anterior o NVS sin blob: migrar desde los puntos guardados en JSON
+        rebuildCalibration();
+    }
+}
+
+void ConfigManager::rebuildCalibration() {
+    double t1, r1, t2, r2, t3, r3;
+    NtcDivider divider;
+    getNTC100KConfig(t1, r1, t2, r2, t3, r3, divider);
+    CalibrationStore::setNtc100k(t1, r1, t2, r2, t3, r3, divider);
+    getNTC10KConfig(t1, r1, t2, r2, t3, r3, divider);
+    CalibrationStore::setNtc10k(t1, r1, t2, r2, t3, r3, divider);
+
+    float calTemp, coefComp, v1, ft1, v2, ft2, v3, ft3;
+    getConductivityConfig(calTemp, coefComp, v1, ft1, v2, ft2, v3, ft3);
+    CalibrationStore::setConductivity(calTemp, coefComp, v1, ft1, v2, ft2, v3, ft3);
+    getPHConfig(v1, ft1, v2, ft2, v3, ft3, calTemp);
+    CalibrationStore::setPh(v1, ft1, v2, ft2, v3, ft3, calTemp);
 }
 
 /* =========================================================================
    CONFIGURACIÓN DE SENSORES ADC
    ========================================================================= */
 void ConfigManager::setAdcSensorsConfigs(const std::vector<SensorConfig>& configs) {
-    Preferences prefs;
-    prefs.begin(JsonKeys::NS_SENSORS_ADC, false);
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    JsonArray sensorArray = doc.to<JsonArray>();
-
-    for (const auto& sensor : configs) {
-        JsonObject sensorObj = sensorArray.createNestedObject();
-        sensorObj[JsonKeys::KEY_ADC_SENSOR] = sensor.configKey;
-        sensorObj[JsonKeys::KEY_ADC_SENSOR_ID] = sensor.sensorId;
-        sensorObj[JsonKeys::KEY_ADC_SENSOR_TYPE] = static_cast<int>(sensor.type);
-        sensorObj[JsonKeys::KEY_ADC_SENSOR_ENABLE] = sensor.enable;
-    }
-
-    String jsonString;
-    serializeJson(doc, jsonString);
-    prefs.putString(JsonKeys::NS_SENSORS_ADC, jsonString.c_str());
-    prefs.end();
+    ConfigImage& image = config();
+    copyConfigs(configs.data(), configs.size(), image.adcSensors, image.adcSensorCount, System::CONFIG_MAX_ADC_SENSORS);
+    ConfigStore::save();
 }
 
 std::vector<SensorConfig> ConfigManager::getAllAdcSensorConfigs() {
-    StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
-    readNamespace(JsonKeys::NS_SENSORS_ADC, doc);
-
-    std::vector<SensorConfig> configs;
-
-    if (doc.is<JsonArray>()) {
-        JsonArray array = doc.as<JsonArray>();
-
-        for (JsonObject sensorObj : array) {
-            SensorConfig config;
-            const char* cKey = sensorObj[JsonKeys::KEY_ADC_SENSOR] | "";
-            strncpy(config.configKey, cKey, sizeof(config.configKey));
-            const char* sensorId = sensorObj[JsonKeys::KEY_ADC_SENSOR_ID] | "";
-            strncpy(config.sensorId, sensorId, sizeof(config.sensorId));
-            config.type = static_cast<SensorType>(sensorObj[JsonKeys::KEY_ADC_SENSOR_TYPE] | 0);
-            config.enable = sensorObj[JsonKeys::KEY_ADC_SENSOR_ENABLE] | false;
-
-            configs.push_back(config);
-        }
-    }
-
-    return configs;
+    const ConfigImage& image = config();
+    return std::vector<SensorConfig>(image.adcSensors, image.adcSensors + image.adcSensorCount);
 }
 
 std::vector<SensorConfig> ConfigManager::getEnabledAdcSensorConfigs() {
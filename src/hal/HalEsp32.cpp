@@ -0,0 +1,286 @@
+/*******************************************************************************************
+ * Archivo: src/hal/HalEsp32.cpp
+ * Descripción: Implementación de la HAL sobre el framework Arduino del ESP32.
+ *******************************************************************************************/
+
+#ifdef ARDUINO
+
+#include "hal/Hal.h"
+#include <Arduino.h>
+#include <Wire.h>
+#include <Preferences.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "driver/adc.h"
+#include "esp_adc_cal.h"
+#include "config.h"
+
+// Puerto serie del bus RS485 (Serial2)
+static HardwareSerial modbusSerial(2);
+
+// Liberado por la tarea de eventos del UART al detectar fin de trama (ver HalUart::waitRx)
+static SemaphoreHandle_t uartRxSemaphore = nullptr;
+
+static uint8_t adcResolutionBits = 12;
+
+// Curvas de calibración (eFuse) de ADC1 y ADC2 con la atenuación de 11 dB que configura
+// HardwareManager; se calculan una vez por arranque
+static esp_adc_cal_characteristics_t adcCharacteristics[2];
+static bool adcCharacterized[2] = {false, false};
+
+// Resultados de la ráfaga leídos del ring buffer del controlador digital, por tandas
+static uint8_t adcBurstBuffer[64 * sizeof(adc_digi_output_data_t)];
+
+/**
+ * @brief Unidad (0 = ADC1, 1 = ADC2) y canal de un pin. En el S3, GPIO1-10 son los
+ *        canales 0-9 de ADC1 y GPIO11-20 los canales 0-9 de ADC2
+ */
+static bool adcChannelOf(uint8_t pin, uint8_t& unit, uint8_t& channel) {
+    if (pin < 1 || pin > 20) {
+        return false;
+    }
+    unit = (pin <= 10) ? 0 : 1;
+    channel = (unit == 0) ? pin - 1 : pin - 11;
+    return true;
+}
+
+uint32_t HalClock::millis() {
+    return ::millis();
+}
+
+uint32_t HalClock::micros() {
+    return ::micros();
+}
+
+void HalClock::delayMs(uint32_t ms) {
+    ::delay(ms);
+}
+
+void HalAdc::setResolution(uint8_t bits) {
+    adcResolutionBits = bits;
+    analogReadResolution(bits);
+}
+
+uint8_t HalAdc::getResolution() {
+    return adcResolutionBits;
+}
+
+void HalAdc::setFullScaleAttenuation() {
+    analogSetAttenuation(ADC_11db);
+}
+
+uint16_t HalAdc::readRaw(uint8_t pin) {
+    return analogRead(pin);
+}
+
+uint32_t HalAdc::readMilliVolts(uint8_t pin) {
+    return analogReadMilliVolts(pin);
+}
+
+bool HalAdc::readBurst(const uint8_t* pins, uint8_t count, uint8_t samples, uint16_t* out) {
+    if (count == 0 || count > SOC_ADC_PATT_LEN_MAX || samples == 0) {
+        return false;
+    }
+
+    // Patrón del controlador digital: un paso por canal, 11 dB como en HardwareManager
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX];
+    uint32_t channelMask[2] = {0, 0};
+    for (uint8_t c = 0; c < count; c++) {
+        uint8_t unit, channel;
+        if (!adcChannelOf(pins[c], unit, channel)) {
+            return false;
+        }
+        pattern[c].atten = ADC_ATTEN_DB_11;
+        pattern[c].channel = channel;
+        pattern[c].unit = unit;
+        pattern[c].bit_width = NATIVE_BITS;
+        channelMask[unit] |= 1u << channel;
+    }
+
+    adc_digi_init_config_t init = {};
+    init.max_store_buf_size = 2 * sizeof(adcBurstBuffer);
+    init.conv_num_each_intr = sizeof(adcBurstBuffer);
+    init.adc1_chan_mask = channelMask[0];
+    init.adc2_chan_mask = channelMask[1];
+    if (adc_digi_initialize(&init) != ESP_OK) {
+        return false;
+    }
+
+    adc_digi_configuration_t config = {};
+    config.conv_limit_en = false;
+    config.conv_limit_num = 0;
+    config.pattern_num = count;
+    config.adc_pattern = pattern;
+    config.sample_freq_hz = Sensors::ADC_BURST_SAMPLE_RATE_HZ;
+    config.conv_mode = channelMask[1] == 0 ? ADC_CONV_SINGLE_UNIT_1 :
+                       channelMask[0] == 0 ? ADC_CONV_SINGLE_UNIT_2 : ADC_CONV_BOTH_UNIT;
+    config.format = ADC_DIGI_OUTPUT_FORMAT_TYPE2;
+
+    bool ok = adc_digi_controller_configure(&config) == ESP_OK && adc_digi_start() == ESP_OK;
+
+    // El DMA llena el ring buffer mientras la tarea espera; cada resultado trae su unidad
+    // y canal, así que se reparte sin depender del orden del patrón
+    const uint32_t maxCode = (1u << NATIVE_BITS) - 1;
+    uint8_t filled[SOC_ADC_PATT_LEN_MAX] = {};
+    uint8_t complete = 0;
+    const uint32_t start = ::millis();
+    while (ok && complete < count) {
+        uint32_t length = 0;
+        esp_err_t err = adc_digi_read_bytes(adcBurstBuffer, sizeof(adcBurstBuffer), &length,
+                                            Sensors::ADC_BURST_TIMEOUT_MS);
+        // ESP_ERR_INVALID_STATE: el ring buffer se desbordó, pero lo leído es válido
+        if ((err != ESP_OK && err != ESP_ERR_INVALID_STATE) ||
+            ::millis() - start > Sensors::ADC_BURST_TIMEOUT_MS) {
+            ok = false;
+            break;
+        }
+        for (uint32_t i = 0; i + sizeof(adc_digi_output_data_t) <= length; i += sizeof(adc_digi_output_data_t)) {
+            const adc_digi_output_data_t* result = (const adc_digi_output_data_t*)&adcBurstBuffer[i];
+            for (uint8_t c = 0; c < count; c++) {
+                if (pattern[c].unit == result->type2.unit && pattern[c].channel == result->type2.channel &&
+                    filled[c] < samples) {
+                    uint32_t code = result->type2.data;
+                    out[c * samples + filled[c]] = (uint16_t)(code > maxCode ? maxCode : code);
+                    if (++filled[c] == samples) {
+                        complete++;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    adc_digi_stop();
+    adc_digi_deinitialize();
+    return ok;
+}
+
+uint32_t HalAdc::rawToMilliVolts(uint8_t pin, uint16_t raw) {
+    uint8_t unit, channel;
+    if (!adcChannelOf(pin, unit, channel)) {
+        return 0;
+    }
+    if (!adcCharacterized[unit]) {
+        esp_adc_cal_characterize(unit == 0 ? ADC_UNIT_1 : ADC_UNIT_2, ADC_ATTEN_DB_11,
+                                 ADC_WIDTH_BIT_12, 1100, &adcCharacteristics[unit]);
+        adcCharacterized[unit] = true;
+    }
+    return esp_adc_cal_raw_to_voltage(raw, &adcCharacteristics[unit]);
+}
+
+void HalGpio::setOutput(uint8_t pin) {
+    pinMode(pin, OUTPUT);
+}
+
+void HalGpio::write(uint8_t pin, bool level) {
+    digitalWrite(pin, level ? HIGH : LOW);
+}
+
+bool HalI2c::begin(uint8_t sda, uint8_t scl) {
+    return Wire.begin(sda, scl);
+}
+
+static void onUartRx() {
+    xSemaphoreGive(uartRxSemaphore);
+}
+
+void HalUart::begin(uint32_t baud, uint8_t rxPin, uint8_t txPin) {
+    if (uartRxSemaphore == nullptr) {
+        uartRxSemaphore = xSemaphoreCreateBinary();
+    }
+    modbusSerial.begin(baud, System::MODBUS_SERIAL_CONFIG, rxPin, txPin);
+    // El UART entrega los bytes y avisa tras MODBUS_RX_IDLE_SYMBOLS caracteres de silencio
+    modbusSerial.setRxTimeout(System::MODBUS_RX_IDLE_SYMBOLS);
+    modbusSerial.onReceive(onUartRx, true);
+}
+
+void HalUart::end() {
+    modbusSerial.end();
+}
+
+size_t HalUart::write(const uint8_t* data, size_t length) {
+    return modbusSerial.write(data, length);
+}
+
+int HalUart::available() {
+    return modbusSerial.available();
+}
+
+int HalUart::read() {
+    return modbusSerial.read();
+}
+
+bool HalUart::waitRx(uint32_t timeoutMs) {
+    if (modbusSerial.available() > 0) {
+        return true;
+    }
+    xSemaphoreTake(uartRxSemaphore, pdMS_TO_TICKS(timeoutMs));
+    return modbusSerial.available() > 0;
+}
+
+size_t HalNvs::getBytes(const char* ns, const char* key, void* out, size_t maxLength) {
+    Preferences prefs;
+    if (!prefs.begin(ns, true)) {
+        return 0;
+    }
+    size_t length = prefs.isKey(key) ? prefs.getBytes(key, out, maxLength) : 0;
+    prefs.end();
+    return length;
+}
+
+size_t HalNvs::putBytes(const char* ns, const char* key, const void* data, size_t length) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return 0;
+    }
+    size_t written = prefs.putBytes(key, data, length);
+    prefs.end();
+    return written;
+}
+
+bool HalNvs::getString(const char* ns, const char* key, std::string& out) {
+    out.clear();
+    Preferences prefs;
+    if (!prefs.begin(ns, true)) {
+        return false;
+    }
+    bool found = prefs.isKey(key);
+    if (found) {
+        String value = prefs.getString(key);
+        out.assign(value.c_str(), value.length());
+    }
+    prefs.end();
+    return found;
+}
+
+bool HalNvs::putString(const char* ns, const char* key, const char* value) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    bool written = prefs.putString(key, value) > 0;
+    prefs.end();
+    return written;
+}
+
+bool HalNvs::remove(const char* ns, const char* key) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    bool removed = prefs.remove(key);
+    prefs.end();
+    return removed;
+}
+
+bool HalNvs::clear(const char* ns) {
+    Preferences prefs;
+    if (!prefs.begin(ns, false)) {
+        return false;
+    }
+    bool cleared = prefs.clear();
+    prefs.end();
+    return cleared;
+}
+
+#endif // ARDUINO
@@ -0,0 +1,383 @@
+/*******************************************************************************************
+ * Archivo: src/hal/HalSim.cpp
+ * Descripción: Implementación simulada de la HAL para el entorno native.
+ * El reloj usa el reloj monotónico del host; las esperas no duermen, solo adelantan un
+ * desfase simulado, de forma que una lectura con 750 ms de conversión no cuesta 750 ms
+ * de tiempo real pero sigue viéndose en millis()/micros().
+ *******************************************************************************************/
+
+#ifndef ARDUINO
+
+#include "hal/Hal.h"
+#include "hal/HalSim.h"
+#include "util/crc16.h"
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#define HAL_SIM_HAS_TTY 1
+#endif
+
+namespace {
+    const uint32_t ADC_FULL_SCALE_MV = 3300;
+
+    std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+    uint64_t delayOffsetUs = 0;
+
+    uint8_t adcResolutionBits = 12;
+    std::map<uint8_t, uint32_t> adcMilliVolts;
+
+    std::map<uint8_t, bool> gpioLevels;
+
+    // Colas de la UART de tamaño fijo, como la FIFO del periférico: el esclavo simulado no
+    // debe asignar heap en la ruta que mide HeapCounter
+    const size_t UART_RX_SIZE = 1024;
+    const size_t UART_TX_LOG_SIZE = 4096;
+    uint8_t uartRx[UART_RX_SIZE];
+    size_t uartRxHead = 0;
+    size_t uartRxCount = 0;
+    std::vector<uint8_t> uartTxBytes;
+    HalSim::UartResponder uartResponder = nullptr;
+    int uartFd = -1;
+
+    std::map<std::string, std::vector<uint8_t>> nvs;
+
+    uint64_t nowUs() {
+        auto elapsed = std::chrono::steady_clock::now() - bootTime;
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() + delayOffsetUs;
+    }
+
+    std::string nvsKey(const char* ns, const char* key) {
+        return std::string(ns) + "/" + key;
+    }
+
+    /**
+     * @brief Agrega bytes a la cola de RX; lo que no cabe se pierde, como en un desborde
+     *        de la FIFO
+     */
+    void pushUartRx(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length && uartRxCount < UART_RX_SIZE; i++) {
+            uartRx[(uartRxHead + uartRxCount) % UART_RX_SIZE] = data[i];
+            uartRxCount++;
+        }
+    }
+
+    void clearUartRx() {
+        uartRxHead = 0;
+        uartRxCount = 0;
+    }
+
+    /**
+     * @brief Pasa a la cola de RX lo que haya llegado por el dispositivo del host
+     */
+    void pumpUartDevice() {
+#ifdef HAL_SIM_HAS_TTY
+        if (uartFd < 0) {
+            return;
+        }
+        uint8_t buffer[256];
+        ssize_t received;
+        while ((received = ::read(uartFd, buffer, sizeof(buffer))) > 0) {
+            pushUartRx(buffer, (size_t)received);
+        }
+#endif
+    }
+}
+
+// -------------------------------------------------------------------------
+// Reloj
+// -------------------------------------------------------------------------
+uint32_t HalClock::millis() {
+    return (uint32_t)(nowUs() / 1000);
+}
+
+uint32_t HalClock::micros() {
+    return (uint32_t)nowUs();
+}
+
+void HalClock::delayMs(uint32_t ms) {
+    delayOffsetUs += (uint64_t)ms * 1000;
+}
+
+// -------------------------------------------------------------------------
+// ADC
+// -------------------------------------------------------------------------
+void HalAdc::setResolution(uint8_t bits) {
+    adcResolutionBits = bits;
+}
+
+uint8_t HalAdc::getResolution() {
+    return adcResolutionBits;
+}
+
+void HalAdc::setFullScaleAttenuation() {
+}
+
+uint16_t HalAdc::readRaw(uint8_t pin) {
+    uint32_t maxCode = (1u << adcResolutionBits) - 1;
+    uint32_t mv = readMilliVolts(pin);
+    uint32_t code = (mv * maxCode + ADC_FULL_SCALE_MV / 2) / ADC_FULL_SCALE_MV;
+    return (uint16_t)(code > maxCode ? maxCode : code);
+}
+
+uint32_t HalAdc::readMilliVolts(uint8_t pin) {
+    auto it = adcMilliVolts.find(pin);
+    return it != adcMilliVolts.end() ? it->second : 0;
+}
+
+bool HalAdc::readBurst(const uint8_t* pins, uint8_t count, uint8_t samples, uint16_t* out) {
+    // Sin controlador digital: canal a canal, intercalado a lo largo de la ráfaga
+    const uint32_t maxCode = (1u << NATIVE_BITS) - 1;
+    for (uint8_t s = 0; s < samples; s++) {
+        for (uint8_t c = 0; c < count; c++) {
+            uint32_t code = (readMilliVolts(pins[c]) * maxCode + ADC_FULL_SCALE_MV / 2) / ADC_FULL_SCALE_MV;
+            out[c * samples + s] = (uint16_t)(code > maxCode ? maxCode : code);
+        }
+    }
+    return true;
+}
+
+uint32_t HalAdc::rawToMilliVolts(uint8_t pin, uint16_t raw) {
+    (void)pin;
+    const uint32_t maxCode = (1u << NATIVE_BITS) - 1;
+    return ((uint32_t)raw * ADC_FULL_SCALE_MV + maxCode / 2) / maxCode;
+}
+
+// -------------------------------------------------------------------------
+// GPIO
+// -------------------------------------------------------------------------
+void HalGpio::setOutput(uint8_t pin) {
+    gpioLevels.emplace(pin, false);
+}
+
+void HalGpio::write(uint8_t pin, bool level) {
+    gpioLevels[pin] = level;
+}
+
+// -------------------------------------------------------------------------
+// I2C
+// -------------------------------------------------------------------------
+bool HalI2c::begin(uint8_t sda, uint8_t scl) {
+    (void)sda;
+    (void)scl;
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// UART
+// -------------------------------------------------------------------------
+void HalUart::begin(uint32_t baud, uint8_t rxPin, uint8_t txPin) {
+    (void)baud;
+    (void)rxPin;
+    (void)txPin;
+}
+
+void HalUart::end() {
+}
+
+size_t HalUart::write(const uint8_t* data, size_t length) {
+    size_t logged = std::min(length, UART_TX_LOG_SIZE - uartTxBytes.size());
+    uartTxBytes.insert(uartTxBytes.end(), data, data + logged);
+#ifdef HAL_SIM_HAS_TTY
+    if (uartFd >= 0) {
+        ssize_t written = ::write(uartFd, data, length);
+        return written > 0 ? (size_t)written : 0;
+    }
+#endif
+    if (uartResponder) {
+        uint8_t response[256];
+        size_t responseLength = uartResponder(data, length, response, sizeof(response));
+        pushUartRx(response, responseLength);
+    }
+    return length;
+}
+
+int HalUart::available() {
+    pumpUartDevice();
+    return (int)uartRxCount;
+}
+
+bool HalUart::waitRx(uint32_t timeoutMs) {
+    pumpUartDevice();
+    if (uartRxCount > 0) {
+        return true;
+    }
+#ifdef HAL_SIM_HAS_TTY
+    if (uartFd >= 0) {
+        struct pollfd descriptor = {uartFd, POLLIN, 0};
+        poll(&descriptor, 1, (int)timeoutMs);
+        pumpUartDevice();
+        return uartRxCount > 0;
+    }
+#endif
+    // Sin dispositivo nadie más va a escribir: la espera completa pasa en tiempo simulado
+    delayOffsetUs += (uint64_t)timeoutMs * 1000;
+    return false;
+}
+
+int HalUart::read() {
+    pumpUartDevice();
+    if (uartRxCount == 0) {
+        return -1;
+    }
+    uint8_t value = uartRx[uartRxHead];
+    uartRxHead = (uartRxHead + 1) % UART_RX_SIZE;
+    uartRxCount--;
+    return value;
+}
+
+// -------------------------------------------------------------------------
+// NVS
+// -------------------------------------------------------------------------
+size_t HalNvs::getBytes(const char* ns, const char* key, void* out, size_t maxLength) {
+    auto it = nvs.find(nvsKey(ns, key));
+    if (it == nvs.end() || it->second.size() > maxLength) {
+        return 0;
+    }
+    memcpy(out, it->second.data(), it->second.size());
+    return it->second.size();
+}
+
+size_t HalNvs::putBytes(const char* ns, const char* key, const void* data, size_t length) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    nvs[nvsKey(ns, key)] = std::vector<uint8_t>(bytes, bytes + length);
+    return length;
+}
+
+bool HalNvs::getString(const char* ns, const char* key, std::string& out) {
+    auto it = nvs.find(nvsKey(ns, key));
+    if (it == nvs.end()) {
+        out.clear();
+        return false;
+    }
+    out.assign(it->second.begin(), it->second.end());
+    return true;
+}
+
+bool HalNvs::putString(const char* ns, const char* key, const char* value) {
+    nvs[nvsKey(ns, key)] = std::vector<uint8_t>(value, value + strlen(value));
+    return true;
+}
+
+bool HalNvs::remove(const char* ns, const char* key) {
+    return nvs.erase(nvsKey(ns, key)) > 0;
+}
+
+bool HalNvs::clear(const char* ns) {
+    const std::string prefix = nvsKey(ns, "");
+    auto it = nvs.lower_bound(prefix);
+    while (it != nvs.end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+        it = nvs.erase(it);
+    }
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// Control de la simulación
+// -------------------------------------------------------------------------
+void HalSim::reset() {
+    delayOffsetUs = 0;
+    bootTime = std::chrono::steady_clock::now();
+    adcResolutionBits = 12;
+    adcMilliVolts.clear();
+    gpioLevels.clear();
+    clearUartRx();
+    uartTxBytes.clear();
+    uartTxBytes.reserve(UART_TX_LOG_SIZE);
+    uartResponder = nullptr;
+#ifdef HAL_SIM_HAS_TTY
+    if (uartFd >= 0) {
+        close(uartFd);
+        uartFd = -1;
+    }
+#endif
+    nvs.clear();
+}
+
+void HalSim::setAdcMilliVolts(uint8_t pin, uint32_t milliVolts) {
+    adcMilliVolts[pin] = milliVolts;
+}
+
+bool HalSim::gpioLevel(uint8_t pin) {
+    auto it = gpioLevels.find(pin);
+    return it != gpioLevels.end() && it->second;
+}
+
+void HalSim::queueUartRx(const uint8_t* data, size_t length) {
+    pushUartRx(data, length);
+}
+
+const std::vector<uint8_t>& HalSim::uartTx() {
+    return uartTxBytes;
+}
+
+void HalSim::setUartResponder(UartResponder responder) {
+    uartResponder = responder;
+}
+
+size_t HalSim::modbusSlave(const uint8_t* request, size_t length, uint8_t* response, size_t maxLength) {
+    if (length != 8 || request[0] == MODBUS_DEAD_SLAVE) {
+        return 0;
+    }
+    const uint8_t slave = request[0];
+    const uint16_t start = (uint16_t)((request[2] << 8) | request[3]);
+    const uint16_t count = (uint16_t)((request[4] << 8) | request[5]);
+    if (5 + 2 * (size_t)count > maxLength) {
+        return 0;
+    }
+    size_t size;
+    response[0] = slave;
+    if (slave == MODBUS_EXCEPTION_SLAVE && start + count > MODBUS_EXCEPTION_FROM) {
+        response[1] = (uint8_t)(request[1] | 0x80);
+        response[2] = 0x02;     // ILLEGAL DATA ADDRESS
+        size = 3;
+    } else {
+        response[1] = request[1];
+        response[2] = (uint8_t)(count * 2);
+        for (uint16_t i = 0; i < count; i++) {
+            const uint16_t value = (uint16_t)((slave << 12) + start + i);
+            response[3 + 2 * i] = (uint8_t)(value >> 8);
+            response[4 + 2 * i] = (uint8_t)value;
+        }
+        size = 3 + 2 * (size_t)count;
+    }
+    const uint16_t crc = crc16_block(0xFFFF, response, (uint16_t)size);
+    response[size] = (uint8_t)crc;
+    response[size + 1] = (uint8_t)(crc >> 8);
+    return size + 2;
+}
+
+bool HalSim::openUartDevice(const char* path) {
+#ifdef HAL_SIM_HAS_TTY
+    int fd = open(path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        return false;
+    }
+    struct termios settings;
+    if (tcgetattr(fd, &settings) == 0) {
+        cfmakeraw(&settings);
+        tcsetattr(fd, TCSANOW, &settings);
+    }
+    if (uartFd >= 0) {
+        close(uartFd);
+    }
+    uartFd = fd;
+    clearUartRx();
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+uint64_t HalSim::simulatedDelayUs() {
+    return delayOffsetUs;
+}
+
+#endif // !ARDUINO
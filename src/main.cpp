@@ -27,6 +27,13 @@
 #include "BLE.h"
 #include "HardwareManager.h"
 #include "SleepManager.h"
+#include "WakePipeline.h"
+#include "WakeProfiler.h"
+#include "SampleBatch.h"
+#include "ReportFilter.h"
+#include "OutageBuffer.h"
+#include "ConfigStore.h"
+#include "SensorPlan.h"
 
 bool wokeFromConfigPin = false;
 
@@ -38,8 +45,6 @@ ESP32Time rtc;
 uint32_t timeToSleep;
 unsigned long setupStartTime;
 
-String deviceId;
-String stationId;
 bool systemInitialized;
 
 Preferences preferences;
@@ -61,12 +66,14 @@ RTC_DATA_ATTR uint32_t cachedTimeToSleep = 0;
 RTC_DATA_ATTR char cachedDeviceId[32] = {0};
 RTC_DATA_ATTR char cachedStationId[32] = {0};
 
+// Identificadores del despertar: apuntan a la copia en RTC (sin String en el heap)
+const char* deviceId = cachedDeviceId;
+const char* stationId = cachedStationId;
+
 // Track de inicializaci\u00f3n de hardware para optimizar wakeups
 RTC_DATA_ATTR bool hardwareInitialized = false;
 RTC_DATA_ATTR uint32_t wakeupCount = 0;
 
-std::vector<SensorReading> normalReadings;
-
 SensorManager sensorManager;
 
 
@@ -80,12 +87,18 @@ bool initHardware() {
     //DESCOMENTAR LA SIGUIENTE LÍNEA PARA BORRAR TODA LA MEMORIA FLASH Y REINICIALIZAR
     //ConfigManager::clearAllPreferences();
 
+    uint32_t phaseStart = WakeProfiler::now();
+
+    // Con la configuración del sistema y el plan de sensores vigentes en RTC no hace falta
+    // leer NVS. Si no, una sola lectura por arranque, antes de lanzar las tareas del pipeline.
+    if (!configCached || !SensorPlan::isValid(ConfigStore::generation())) {
+        ConfigManager::loadConfig();
+    }
+
     // Usar configuración cacheada si está disponible
     if (configCached) {
         // Usar valores cacheados en RTC RAM (mucho más rápido)
         timeToSleep = cachedTimeToSleep;
-        deviceId = String(cachedDeviceId);
-        stationId = String(cachedStationId);
         systemInitialized = true;
         DEBUG_PRINTLN("Usando configuración cacheada de RTC RAM");
     } else {
@@ -94,74 +107,185 @@ bool initHardware() {
             DEBUG_PRINTLN("Creando configuración por defecto...");
             ConfigManager::initializeDefaultConfig();
         }
-        ConfigManager::getSystemConfig(systemInitialized, timeToSleep, deviceId, stationId);
+        String configDeviceId;
+        String configStationId;
+        ConfigManager::getSystemConfig(systemInitialized, timeToSleep, configDeviceId, configStationId);
 
         // Cachear en RTC RAM para próximos wakeups
         cachedTimeToSleep = timeToSleep;
-        strncpy(cachedDeviceId, deviceId.c_str(), sizeof(cachedDeviceId) - 1);
-        strncpy(cachedStationId, stationId.c_str(), sizeof(cachedStationId) - 1);
+        strncpy(cachedDeviceId, configDeviceId.c_str(), sizeof(cachedDeviceId) - 1);
+        strncpy(cachedStationId, configStationId.c_str(), sizeof(cachedStationId) - 1);
         configCached = true;
         DEBUG_PRINTLN("Configuración cacheada en RTC RAM");
     }
 
+    // Coeficientes de calibración: copia en RTC tras deep sleep, blob de NVS en frío
+    ConfigManager::loadCalibration();
+
+    WakeProfiler::record(PHASE_CONFIG_LOAD, phaseStart);
+
     DEBUG_PRINTF("Config: Device=%s, Station=%s, Sleep=%ds\n",
-                 deviceId.c_str(), stationId.c_str(), timeToSleep);
+                 deviceId, stationId, timeToSleep);
 
+    phaseStart = WakeProfiler::now();
     if (!HardwareManager::initHardware(spiLora)) {
         return false;
     }
+    WakeProfiler::record(PHASE_HARDWARE_INIT, phaseStart);
 
     struct tm timeinfo;
     if (!getLocalTime(&timeinfo)) {
         rtc.setTime(0, 0, 0, 1, 1, 2023);
     }
 
-    sensorManager.registerSensorsFromConfig();
-    sensorManager.beginAll();
-
+    // El registro, begin y lectura de sensores se hace en la tarea de sensores
+    // de WakePipeline, en paralelo con la activación LoRaWAN
     return true;
 }
 
 /**
- * @brief Configura y activa la radio LoRa
- * @return true si la configuración fue exitosa, false en caso de error
+ * @brief Lanza en paralelo la activación LoRaWAN y la adquisición de sensores
+ * @return true si las tareas del pipeline se lanzaron correctamente
  */
-bool configureLoRa() {
-    int16_t state = radio.begin();
-    if (state != RADIOLIB_ERR_NONE) {
-        return false;
+bool startWakePipeline() {
+    // Con el plan vigente ya se sabe si hay sondas de 12 V: el riel se enciende antes de
+    // lanzar la activación LoRaWAN para que calienten en paralelo con ella
+    if (SensorPlan::isValid(ConfigStore::generation()) &&
+        SensorPlan::usesRail((uint8_t)PowerRequirement::POWER_12V)) {
+        PowerManager::power12VStart();
     }
 
-    state = LoRaManager::lwActivate(node);
-    if (state != RADIOLIB_LORAWAN_NEW_SESSION &&
-        state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
-        return false;
+    if (SampleBatch::isEnabled()) {
+        // En modo lote la radio solo se activa en paralelo cuando este despertar envía;
+        // el primer despertar tras un reset siempre la activa para hacer el join
+        bool withLoRa = SampleBatch::willBeDue(rtc.getEpoch()) || wakeupCount == 1;
+        return WakePipeline::start(radio, node, sensorManager, withLoRa);
     }
-
-    DEBUG_PRINTLN("Tiempo después de activar radio: " + String(millis() - setupStartTime));
-    return true;
+    if (ReportFilter::isEnabled()) {
+        // Report-by-exception: la radio solo arranca en paralelo si toca el latido; si no,
+        // se activa después de leer y solo cuando algún canal cruzó su banda muerta
+        bool withLoRa = ReportFilter::isHeartbeatDue() || wakeupCount == 1;
+        return WakePipeline::start(radio, node, sensorManager, withLoRa);
+    }
+    return WakePipeline::start(radio, node, sensorManager);
 }
 
 /**
- * @brief Lee los datos de todos los sensores habilitados
+ * @brief Modo lote: agrega las lecturas al lote en RTC y solo transmite cuando está lleno
+ *        o vence la latencia máxima. Los despertares intermedios no encienden la radio.
+ * @param readings Lecturas del despertar (nullptr si fallaron)
  */
-void readSensors() {
-    normalReadings.clear();
+void sendBatchedData(const ReadingSet* readings) {
+    uint32_t now = rtc.getEpoch();
+    bool appended = (readings != nullptr) && SampleBatch::append(*readings, now);
+
+    if (appended && !SampleBatch::isDue(now)) {
+        DEBUG_PRINTF("Lectura guardada en lote (%u/%u)\n", SampleBatch::count(), LoRa::BATCH_SIZE);
+        WakeProfiler::printReport();
+        return;
+    }
+    if (SampleBatch::count() == 0) {
+        return;
+    }
+
+    if (!WakePipeline::isLoRaStarted() && !WakePipeline::startLoRa()) {
+        // Sin radio, la lectura que no cupo en el lote va al respaldo
+        if (readings != nullptr && !appended) {
+            OutageBuffer::append(*readings, now);
+        }
+        return;
+    }
+    int16_t state = WakePipeline::waitForLoRa(System::PIPELINE_LORA_TIMEOUT_MS);
+    WakePipeline::printTimeline();
+    if (state != RADIOLIB_LORAWAN_NEW_SESSION &&
+        state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
+        // El lote sigue en RTC; la lectura que no cupo va al respaldo
+        if (readings != nullptr && !appended) {
+            OutageBuffer::append(*readings, now);
+        }
+        return;
+    }
 
-    normalReadings = sensorManager.readAll();
+    static const ReadingSet noReadings;
+    const ReadingSet& current = readings != nullptr ? *readings : noReadings;
+    bool sent = LoRaManager::sendBatch(current, node, deviceId, stationId);
+
+    // Si la lectura no cupo en el lote anterior, inicia el siguiente; si el lote no salió
+    // espera en el respaldo para no perderla
+    if (readings != nullptr && !appended && !(sent && SampleBatch::append(*readings, now))) {
+        OutageBuffer::append(*readings, now);
+    }
+    if (sent) {
+        LoRaManager::sendBacklog(current, node, deviceId, stationId);
+    }
+
+    unsigned long elapsedTime = millis() - setupStartTime;
+    DEBUG_PRINTF("Tiempo transcurrido antes de sleep: %lu ms\n", elapsedTime);
+    WakeProfiler::printReport();
 }
 
 /**
- * @brief Envía los datos de los sensores a través de LoRa
+ * @brief Espera las lecturas y la sesión LoRaWAN y envía los datos
  */
 void sendData() {
+    const ReadingSet* readings =
+        WakePipeline::waitForReadings(System::PIPELINE_SENSORS_TIMEOUT_MS);
+    // Sin lecturas la tarea puede seguir en el bus: no se apaga hasta que salga o se suspenda
+    WakePipeline::stopSensors(System::PIPELINE_STOP_TIMEOUT_MS);
     sensorManager.powerDown();
 
-    LoRaManager::sendDelimitedPayload(normalReadings,
-                                    node, deviceId, stationId, rtc);
+    if (SampleBatch::isEnabled()) {
+        sendBatchedData(readings);
+        return;
+    }
+
+    if (readings != nullptr && ReportFilter::isEnabled() && !ReportFilter::shouldSend(*readings)) {
+        ReportFilter::markSkipped();
+        DEBUG_PRINTLN("Sin cambios fuera de banda muerta: se omite el uplink");
+        WakeProfiler::printReport();
+        return;
+    }
+    if (readings != nullptr && !WakePipeline::isLoRaStarted() && !WakePipeline::startLoRa()) {
+        // No se pudo lanzar la activación LoRaWAN: la lectura espera en RTC como sin sesión
+        OutageBuffer::append(*readings, rtc.getEpoch());
+        return;
+    }
+
+    int16_t state = WakePipeline::waitForLoRa(System::PIPELINE_LORA_TIMEOUT_MS);
+    WakePipeline::printTimeline();
+
+    if (readings == nullptr) {
+        return;
+    }
+    if (state != RADIOLIB_LORAWAN_NEW_SESSION &&
+        state != RADIOLIB_LORAWAN_SESSION_RESTORED) {
+        // Sin sesión (join diferido, fallido o sin hora): la lectura espera en RTC
+        OutageBuffer::append(*readings, rtc.getEpoch());
+        WakeProfiler::printReport();
+        return;
+    }
+
+    // Solo se toman como referencia las lecturas que salieron en algún frame
+    uint32_t sentMask = 0;
+    bool sent = LoRaManager::sendPayload(*readings, node, deviceId, stationId, rtc, sentMask);
+    ReportFilter::markSent(*readings, sentMask);
+    if (sent) {
+        LoRaManager::sendBacklog(*readings, node, deviceId, stationId);
+    }
 
     unsigned long elapsedTime = millis() - setupStartTime;
     DEBUG_PRINTF("Tiempo transcurrido antes de sleep: %lu ms\n", elapsedTime);
+    WakeProfiler::printReport();
+}
+
+/**
+ * @brief Detiene el pipeline y duerme. La sesión solo se guarda si la tarea LoRa terminó
+ *        con una sesión activa; una activación a medias dejaría el búfer inconsistente.
+ */
+void enterDeepSleep() {
+    WakePipeline::stop(System::PIPELINE_STOP_TIMEOUT_MS);
+    SleepManager::goToDeepSleep(timeToSleep, &radio, node, LWsession, spiLora,
+                                WakePipeline::hasSession());
 }
 
 void setup() {
@@ -171,11 +295,14 @@ void setup() {
     // Incrementar contador de wakeups
     wakeupCount++;
     DEBUG_PRINTF("Wakeup #%lu\n", wakeupCount);
+    WakeProfiler::beginWake(wakeupCount);
 
     // Nota: El cristal externo de 32kHz está configurado mediante sdkconfig
     // Ver: boards/sdkconfig.esp32s3 y platformio.ini
 
+    uint32_t phaseStart = WakeProfiler::now();
     SleepManager::handleWakeupCause(wokeFromConfigPin);
+    WakeProfiler::record(PHASE_WAKEUP_CAUSE, phaseStart);
 
     // Si se despert\u00f3 por CONFIG_PIN, resetear inicializaci\u00f3n
     if (wokeFromConfigPin) {
@@ -184,15 +311,15 @@ void setup() {
     }
 
     if (!initHardware()) {
-        SleepManager::goToDeepSleep(timeToSleep, &radio, node, LWsession, spiLora);
+        enterDeepSleep();
     }
 
     if (BLEHandler::checkConfigMode()) {
         return;
     }
 
-    if (!configureLoRa()) {
-        SleepManager::goToDeepSleep(timeToSleep, &radio, node, LWsession, spiLora);
+    if (!startWakePipeline()) {
+        enterDeepSleep();
     }
 }
 
@@ -201,7 +328,11 @@ void loop() {
         return;
     }
 
-    readSensors();
+    // Si setup() salió por modo configuración, el pipeline aún no se lanzó
+    if (!WakePipeline::isStarted() && !startWakePipeline()) {
+        enterDeepSleep();
+    }
+
     sendData();
-    SleepManager::goToDeepSleep(timeToSleep, &radio, node, LWsession, spiLora);
+    enterDeepSleep();
 }
\ No newline at end of file
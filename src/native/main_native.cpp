@@ -0,0 +1,532 @@
+/*******************************************************************************************
+ * Archivo: src/native/main_native.cpp
+ * Descripción: Benchmarks del entorno native (pio run -e native && .pio/build/native/program
+ * [iteraciones]). Mide tiempo por llamada de la lectura simulada, la calibración (ruta
+ * anterior que resolvía los coeficientes frente a los precalculados), los kernels de
+ * calibración, el códec Modbus, los payloads y la carga de la configuración, e imprime el
+ * anuncio de esquema, el payload binario y un lote en hex para tools/decode_payload.py.
+ * Las comprobaciones de cada módulo están en test/ (pio test -e native).
+ *******************************************************************************************/
+
+#if !defined(ARDUINO) && !defined(PIO_UNIT_TESTING)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cmath>
+#include <vector>
+#include "config.h"
+#include "sensor_types.h"
+#include "hal/Hal.h"
+#include "hal/HalSim.h"
+#include "CalibrationMath.h"
+#include "CalibrationStore.h"
+#include "CalibrationFixed.h"
+#include "CalibrationKernels.h"
+#include "NtcTable.h"
+#include "ConfigStore.h"
+#include "config_manager.h"
+#if __has_include(<ArduinoJson.h>)
+#include <ArduinoJson.h>
+#include <string>
+#define NATIVE_HAS_ARDUINOJSON 1
+#endif
+#include "PayloadFormat.h"
+#include "AdcSampler.h"
+#include "ModbusRtu.h"
+#include "util/crc16.h"
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define NATIVE_HAS_RDTSC 1
+#endif
+
+namespace {
+    const uint32_t DEFAULT_ITERATIONS = 10000;
+
+    // Evita que el compilador elimine los cálculos medidos
+    volatile float sink;
+
+    SensorReading makeReading(const char* id, SensorType type, float value) {
+        SensorReading reading;
+        strncpy(reading.sensorId, id, sizeof(reading.sensorId) - 1);
+        reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
+        reading.type = type;
+        reading.value = value;
+        return reading;
+    }
+
+    /**
+     * @brief Ruta anterior de NtcSensor::readNtc10kTemperatureStatic: resuelve Steinhart-Hart
+     *        en double en cada lectura (sin contar la apertura de NVS ni el JSON)
+     */
+    float ntc10kTemperatureLegacy() {
+        using namespace Calibration::NTC10K;
+        double A, B, C;
+        CalibrationMath::steinhartHartCoeffs(DEFAULT_T1 + 273.15, DEFAULT_R1,
+                                             DEFAULT_T2 + 273.15, DEFAULT_R2,
+                                             DEFAULT_T3 + 273.15, DEFAULT_R3, A, B, C);
+        float voltage = HalAdc::readMilliVolts(Pins::NTC10K) / 1000.0f;
+        double rNtc = CalibrationMath::ntcResistanceFromDivider(voltage, 3.0, 10000.0, true);
+        return CalibrationMath::steinhartHartTemperature(rNtc, A, B, C);
+    }
+
+    /**
+     * @brief Misma cadena que NtcSensor::readNtc10kTemperatureStatic: tabla generada al calibrar
+     */
+    float ntc10kTemperature() {
+        float voltage = HalAdc::readMilliVolts(Pins::NTC10K) / 1000.0f;
+        return CalibrationKernels::ntc10kTemperature(voltage);
+    }
+
+    // Voltajes de entrada (V) compartidos por las dos rutas de calibración medidas
+    struct CalibrationInput {
+        float ntc;
+        float ph;
+        float cond;
+    };
+    const CalibrationInput CALIBRATION_INPUTS[] = {
+        {0.80f, -0.30f, 0.40f}, {1.10f, -0.12f, 0.85f}, {1.35f, 0.00f, 1.20f}, {1.50f, 0.05f, 1.45f},
+        {1.72f, 0.18f, 1.80f}, {1.95f, 0.27f, 2.10f}, {2.20f, 0.41f, 2.45f}, {2.55f, 0.60f, 2.80f},
+    };
+    const size_t CALIBRATION_INPUT_COUNT = sizeof(CALIBRATION_INPUTS) / sizeof(CALIBRATION_INPUTS[0]);
+
+    /**
+     * @brief Calibración como antes: Steinhart-Hart, ajuste de pH y determinante de
+     *        conductividad resueltos en cada lectura
+     */
+    float calibrateResolving(const CalibrationInput& input) {
+        double A, B, C;
+        {
+            using namespace Calibration::NTC10K;
+            CalibrationMath::steinhartHartCoeffs(DEFAULT_T1 + 273.15, DEFAULT_R1,
+                                                 DEFAULT_T2 + 273.15, DEFAULT_R2,
+                                                 DEFAULT_T3 + 273.15, DEFAULT_R3, A, B, C);
+        }
+        double rNtc = CalibrationMath::ntcResistanceFromDivider(input.ntc, 3.0, 10000.0, true);
+        float waterTemp = CalibrationMath::steinhartHartTemperature(rNtc, A, B, C);
+
+        float ph;
+        {
+            using namespace Calibration::PH;
+            ph = CalibrationMath::phFromVoltage(input.ph, waterTemp, DEFAULT_V1, DEFAULT_T1,
+                                                DEFAULT_V2, DEFAULT_T2, DEFAULT_V3, DEFAULT_T3,
+                                                DEFAULT_TEMP);
+        }
+        float cond;
+        {
+            using namespace Calibration::Conductivity;
+            cond = CalibrationMath::conductivityFromVoltage(input.cond, waterTemp, DEFAULT_TEMP,
+                                                            TEMP_COEF_COMPENSATION,
+                                                            DEFAULT_V1, DEFAULT_T1, DEFAULT_V2,
+                                                            DEFAULT_T2, DEFAULT_V3, DEFAULT_T3);
+        }
+        return waterTemp + ph + cond;
+    }
+
+    /**
+     * @brief Calibración actual sobre los mismos voltajes: tabla NTC y coeficientes de
+     *        CalibrationStore
+     */
+    float calibratePrecomputed(const CalibrationInput& input) {
+        float waterTemp = CalibrationKernels::ntc10kTemperature(input.ntc);
+        float ph = CalibrationMath::evaluatePh(input.ph, waterTemp, CalibrationStore::ph());
+        float cond = CalibrationMath::evaluateConductivity(input.cond, waterTemp,
+                                                           CalibrationStore::conductivity());
+        return waterTemp + ph + cond;
+    }
+
+    void simulatedRead(ReadingSet& readings) {
+        readings.clear();
+        float waterTemp = ntc10kTemperature();
+        readings.push_back(makeReading("NTC3", N10K, waterTemp));
+
+        // Igual que los drivers: lote ADC sobremuestreado y milivoltios calibrados
+        AdcSampler::invalidate();
+        float voltage = AdcSampler::milliVolts(Pins::PH_SENSOR) / 1000.0f - 1.65f;
+        readings.push_back(makeReading("PH", PH,
+            CalibrationMath::evaluatePh(voltage, waterTemp, CalibrationStore::ph())));
+
+        voltage = AdcSampler::milliVolts(Pins::COND_SENSOR) / 1000.0f;
+        readings.push_back(makeReading("COND", COND,
+            CalibrationMath::evaluateConductivity(voltage, waterTemp, CalibrationStore::conductivity())));
+
+        float battery = CalibrationMath::batteryVoltage(HalAdc::readMilliVolts(Pins::BATTERY_SENSOR) / 1000.0f,
+                                                        Calibration::BATTERY_R1, Calibration::BATTERY_R2);
+        readings.push_back(makeReading("BAT", BATTERY, battery));
+
+        SensorReading mt05 = makeReading("MT05_2", MT05S, NAN);
+        mt05.subValues = {{21.37f}, {34.5f}, {812.0f}};
+        readings.push_back(mt05);
+    }
+
+    /**
+     * @brief Máxima diferencia absoluta entre la ruta por tabla y la anterior en double,
+     *        barriendo el voltaje del NTC10K de 0.1 a 2.9 V
+     */
+    double ntc10kMaxError() {
+        double maxError = 0.0;
+        for (uint32_t mv = 100; mv <= 2900; mv += 10) {
+            HalSim::setAdcMilliVolts(Pins::NTC10K, mv);
+            double error = fabs((double)ntc10kTemperature() - ntc10kTemperatureLegacy());
+            if (error > maxError) {
+                maxError = error;
+            }
+        }
+        HalSim::setAdcMilliVolts(Pins::NTC10K, 1500);
+        return maxError;
+    }
+
+#ifdef NATIVE_HAS_ARDUINOJSON
+    /**
+     * @brief Namespaces JSON con el formato que escribía ConfigManager antes de ConfigStore
+     *        (system, lorawan, sensors, sensors_adc, sensors_modbus)
+     */
+    std::vector<std::string> legacyJsonNamespaces() {
+        std::vector<std::string> out;
+        const ConfigImage& image = ConfigStore::image();
+        {
+            StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+            doc[JsonKeys::KEY_STATION_ID] = image.stationId;
+            doc[JsonKeys::KEY_INITIALIZED] = image.initialized;
+            doc[JsonKeys::KEY_SLEEP_TIME] = image.sleepTime;
+            doc[JsonKeys::KEY_DEVICE_ID] = image.deviceId;
+            out.emplace_back();
+            serializeJson(doc, out.back());
+        }
+        {
+            StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+            doc[JsonKeys::KEY_LORA_JOIN_EUI] = image.joinEUI;
+            doc[JsonKeys::KEY_LORA_DEV_EUI] = image.devEUI;
+            doc[JsonKeys::KEY_LORA_NWK_KEY] = image.nwkKey;
+            doc[JsonKeys::KEY_LORA_APP_KEY] = image.appKey;
+            out.emplace_back();
+            serializeJson(doc, out.back());
+        }
+        const SensorConfig* lists[] = {image.sensors, image.adcSensors};
+        const uint8_t counts[] = {image.sensorCount, image.adcSensorCount};
+        for (int list = 0; list < 2; list++) {
+            StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+            JsonArray array = doc.to<JsonArray>();
+            for (uint8_t i = 0; i < counts[list]; i++) {
+                JsonObject obj = array.createNestedObject();
+                obj[JsonKeys::KEY_SENSOR] = lists[list][i].configKey;
+                obj[JsonKeys::KEY_SENSOR_ID] = lists[list][i].sensorId;
+                obj[JsonKeys::KEY_SENSOR_TYPE] = (int)lists[list][i].type;
+                obj[JsonKeys::KEY_SENSOR_ENABLE] = lists[list][i].enable;
+            }
+            out.emplace_back();
+            serializeJson(doc, out.back());
+        }
+        {
+            StaticJsonDocument<System::JSON_DOC_SIZE_MEDIUM> doc;
+            JsonArray array = doc.to<JsonArray>();
+            for (uint8_t i = 0; i < image.modbusSensorCount; i++) {
+                JsonObject obj = array.createNestedObject();
+                obj[JsonKeys::KEY_MODBUS_SENSOR_ID] = image.modbusSensors[i].sensorId;
+                obj[JsonKeys::KEY_MODBUS_SENSOR_TYPE] = (int)image.modbusSensors[i].type;
+                obj[JsonKeys::KEY_MODBUS_SENSOR_ADDR] = image.modbusSensors[i].address;
+                obj[JsonKeys::KEY_MODBUS_SENSOR_ENABLE] = image.modbusSensors[i].enable;
+            }
+            out.emplace_back();
+            serializeJson(doc, out.back());
+        }
+        return out;
+    }
+#endif
+
+    /**
+     * @brief Tiempo (ns) y ciclos del host por llamada de un kernel, variando la entrada
+     */
+    template <typename F>
+    void benchKernel(const char* name, uint32_t iterations, F kernel) {
+        uint32_t start = HalClock::micros();
+#ifdef NATIVE_HAS_RDTSC
+        uint64_t startCycles = __rdtsc();
+#endif
+        for (uint32_t i = 0; i < iterations; i++) {
+            sink = kernel(i);
+        }
+#ifdef NATIVE_HAS_RDTSC
+        double cycles = (double)(__rdtsc() - startCycles) / iterations;
+#endif
+        double ns = (double)(HalClock::micros() - start) * 1000.0 / iterations;
+#ifdef NATIVE_HAS_RDTSC
+        printf("  %-34s %8.1f ns/llamada %8.1f ciclos\n", name, ns, cycles);
+#else
+        printf("  %-34s %8.1f ns/llamada\n", name, ns);
+#endif
+    }
+
+    template <typename F>
+    double timeIt(uint32_t iterations, F body) {
+        uint32_t start = HalClock::micros();
+        for (uint32_t i = 0; i < iterations; i++) {
+            body();
+        }
+        return (double)(HalClock::micros() - start) / iterations;
+    }
+
+    /**
+     * @brief Ejecuta body con stdout descartado: pasa por código que registra con
+     *        DEBUG_PRINTF en cada llamada
+     */
+    template <typename F>
+    void discardingStdout(F body) {
+        fflush(stdout);
+        int saved = dup(STDOUT_FILENO);
+        int devNull = open("/dev/null", O_WRONLY);
+        dup2(devNull, STDOUT_FILENO);
+        body();
+        fflush(stdout);
+        dup2(saved, STDOUT_FILENO);
+        close(devNull);
+        close(saved);
+    }
+
+    template <typename F>
+    double timeItQuiet(uint32_t iterations, F body) {
+        double us = 0.0;
+        discardingStdout([&] { us = timeIt(iterations, body); });
+        return us;
+    }
+
+    uint16_t crc16Serial(const uint8_t* data, uint16_t length) {
+        uint16_t crc = 0xFFFF;
+        for (uint16_t i = 0; i < length; i++) {
+            crc = crc16_update(crc, data[i]);
+        }
+        return crc;
+    }
+
+    /**
+     * @brief Ruta anterior (ModbusMaster): trama en un búfer, CRC bit a bit sobre ella,
+     *        desempaquetado a un búfer intermedio y copia registro a registro al destino
+     */
+    uint8_t decodeResponseLegacy(const uint8_t* frame, uint16_t length, uint8_t count, uint16_t* out) {
+        uint8_t adu[256];
+        uint16_t responseBuffer[System::MODBUS_MAX_BLOCK_REGISTERS];
+        for (uint16_t i = 0; i < length; i++) {
+            adu[i] = frame[i];
+        }
+        uint16_t crc = crc16Serial(adu, length - 2);
+        if (adu[length - 2] != (uint8_t)crc || adu[length - 1] != (uint8_t)(crc >> 8)) {
+            return ModbusRtu::INVALID_CRC;
+        }
+        for (uint8_t i = 0; i < adu[2] / 2; i++) {
+            responseBuffer[i] = (uint16_t)((adu[3 + 2 * i] << 8) | adu[4 + 2 * i]);
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            out[i] = responseBuffer[i];
+        }
+        return ModbusRtu::SUCCESS;
+    }
+
+    /**
+     * @brief CRC, armado de tramas y decodificación de una respuesta de 125 registros:
+     *        ruta anterior frente a CRC por tabla y decodificación directa al destino
+     */
+    void modbusCodecBench(uint32_t iterations) {
+        const uint8_t count = System::MODBUS_MAX_BLOCK_REGISTERS;
+        uint8_t request[ModbusRtu::REQUEST_SIZE];
+        ModbusRtu::buildRequest(1, MODBUS_FUNCTION_HOLDING, 0, count, request);
+        uint8_t frame[256];
+        const uint16_t length = (uint16_t)HalSim::modbusSlave(request, sizeof(request), frame, sizeof(frame));
+        uint16_t legacy[System::MODBUS_MAX_BLOCK_REGISTERS];
+        uint16_t direct[System::MODBUS_MAX_BLOCK_REGISTERS];
+
+        printf("Códec Modbus RTU (respuesta de %u registros, %u bytes):\n", count, length);
+        benchKernel("CRC bit a bit", iterations, [&](uint32_t) {
+            return (float)crc16Serial(frame, length);
+        });
+        benchKernel("CRC por tabla", iterations, [&](uint32_t) {
+            return (float)crc16_block(0xFFFF, frame, length);
+        });
+        benchKernel("armado de petición", iterations, [&](uint32_t i) {
+            return (float)ModbusRtu::buildRequest(1, MODBUS_FUNCTION_HOLDING, (uint16_t)i, count, request);
+        });
+        benchKernel("decodificación anterior", iterations, [&](uint32_t) {
+            return (float)decodeResponseLegacy(frame, length, count, legacy);
+        });
+        benchKernel("decodificación directa", iterations, [&](uint32_t) {
+            return (float)ModbusRtu::decodeResponse(frame, length, 1, MODBUS_FUNCTION_HOLDING, count, direct);
+        });
+    }
+
+}
+
+int main(int argc, char** argv) {
+    uint32_t iterations = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 10) : 0;
+    if (iterations == 0) {
+        iterations = DEFAULT_ITERATIONS;
+    }
+
+    HalSim::reset();
+    HalAdc::setResolution(13);
+    HalSim::setAdcMilliVolts(Pins::NTC10K, 1500);
+    HalSim::setAdcMilliVolts(Pins::PH_SENSOR, 1650);
+    HalSim::setAdcMilliVolts(Pins::COND_SENSOR, 420);
+    HalSim::setAdcMilliVolts(Pins::BATTERY_SENSOR, 780);
+
+    // Primer arranque: imagen de configuración y calibración por defecto
+    ConfigManager::initializeDefaultConfig();
+
+    AdcSampler::addChannel(Pins::PH_SENSOR);
+    AdcSampler::addChannel(Pins::COND_SENSOR);
+    printf("ADC a 13 bits, pH a 1650 mV: %.3f V con 3.3/4095 (anterior), %.3f V calibrado\n",
+           HalAdc::readRaw(Pins::PH_SENSOR) * (3.3f / 4095.0f),
+           AdcSampler::milliVolts(Pins::PH_SENSOR) / 1000.0f);
+
+    static ReadingSet readings;
+    simulatedRead(readings);
+    char payload[LoRa::MAX_PAYLOAD + 1];
+    size_t payloadSize = PayloadFormat::delimited(readings, System::DEFAULT_DEVICE_ID,
+                                                  System::DEFAULT_STATION_ID, readings[3].value,
+                                                  1700000000, payload, sizeof(payload));
+    printf("Payload delimitado (%zu bytes): %s\n", payloadSize, payload);
+
+    char schema[LoRa::MAX_PAYLOAD + 1];
+    PayloadFormat::schemaAnnouncement(readings, System::DEFAULT_DEVICE_ID,
+                                      System::DEFAULT_STATION_ID, schema, sizeof(schema));
+    uint8_t binary[LoRa::MAX_PAYLOAD];
+    size_t binarySize = PayloadFormat::binary(readings, 1700000000, binary, sizeof(binary));
+    printf("Esquema: %s\n", schema);
+    printf("Payload binario (%zu bytes): ", binarySize);
+    for (size_t i = 0; i < binarySize; i++) {
+        printf("%02x", binary[i]);
+    }
+    printf("\n");
+
+    // Lote de tres despertares separados 15 minutos
+    const uint8_t batchCount = 3;
+    uint8_t records[LoRa::MAX_PAYLOAD];
+    size_t recordsLength = 0;
+    for (uint8_t i = 0; i < batchCount; i++) {
+        uint16_t delta = i * 900;
+        records[recordsLength++] = (uint8_t)(delta >> 8);
+        records[recordsLength++] = (uint8_t)delta;
+        recordsLength += PayloadFormat::binaryRecord(readings, records + recordsLength,
+                                                     sizeof(records) - recordsLength);
+    }
+    uint8_t batch[LoRa::MAX_PAYLOAD];
+    size_t batchSize = PayloadFormat::batchFrame(PayloadFormat::schemaId(readings), 1700000000,
+                                                 batchCount, records, recordsLength,
+                                                 batch, sizeof(batch));
+    printf("Lote de %u registros (%zu bytes vs %zu en uplinks individuales): ",
+           batchCount, batchSize, batchCount * binarySize);
+    for (size_t i = 0; i < batchSize; i++) {
+        printf("%02x", batch[i]);
+    }
+    printf("\n");
+
+    double ntcLegacyUs = timeIt(iterations, [] { sink = ntc10kTemperatureLegacy(); });
+    double ntcUs = timeIt(iterations, [] { sink = ntc10kTemperature(); });
+    // Solo el paso de calibración, sin ADC ni armado de lecturas, con las mismas entradas
+    size_t input = 0;
+    double calibrationResolvingUs = timeIt(iterations, [&] {
+        sink = calibrateResolving(CALIBRATION_INPUTS[input++ % CALIBRATION_INPUT_COUNT]);
+    });
+    input = 0;
+    double calibrationUs = timeIt(iterations, [&] {
+        sink = calibratePrecomputed(CALIBRATION_INPUTS[input++ % CALIBRATION_INPUT_COUNT]);
+    });
+    double payloadUs = timeIt(iterations, [&] {
+        sink = (float)PayloadFormat::delimited(readings, System::DEFAULT_DEVICE_ID,
+                                               System::DEFAULT_STATION_ID, readings[3].value,
+                                               1700000000, payload, sizeof(payload));
+    });
+    double binaryUs = timeIt(iterations, [&] {
+        sink = (float)PayloadFormat::binary(readings, 1700000000, binary, sizeof(binary));
+    });
+
+    double adcUs = timeIt(iterations, [] {
+        AdcSampler::invalidate();
+        sink = AdcSampler::milliVolts(Pins::PH_SENSOR);
+    });
+    double configUs = timeIt(iterations, [] { sink = ConfigStore::load() ? 1.0f : 0.0f; });
+#ifdef NATIVE_HAS_ARDUINOJSON
+    // Namespaces de un firmware anterior: cada iteración repite la migración de loadConfig()
+    const ConfigImage defaults = ConfigStore::image();
+    const char* legacyNamespaces[] = {JsonKeys::NS_SYSTEM, JsonKeys::NS_LORAWAN, JsonKeys::NS_SENSORS,
+                                      JsonKeys::NS_SENSORS_ADC, JsonKeys::NS_SENSORS_MODBUS};
+    std::vector<std::string> legacyJson = legacyJsonNamespaces();
+    for (size_t i = 0; i < legacyJson.size(); i++) {
+        HalNvs::putString(legacyNamespaces[i], legacyNamespaces[i], legacyJson[i].c_str());
+    }
+    double configJsonUs = timeItQuiet(iterations, [] {
+        ConfigStore::clear();
+        ConfigManager::loadConfig();
+    });
+    for (const char* ns : legacyNamespaces) {
+        HalNvs::clear(ns);
+    }
+    ConfigStore::image() = defaults;
+    ConfigStore::save();
+#endif
+
+    printf("Iteraciones: %u\n", iterations);
+    printf("  carga de configuración (imagen binaria): %6.3f us (%zu bytes)\n",
+           configUs, sizeof(ConfigImage));
+#ifdef NATIVE_HAS_ARDUINOJSON
+    printf("  migración desde 5 JSON (+ guardado):     %6.3f us\n", configJsonUs);
+#endif
+    printf("  ntc10k resolviendo coeficientes:       %8.3f us\n", ntcLegacyUs);
+    printf("  ntc10k por tabla:                      %8.3f us (error máx %.6f °C)\n",
+           ntcUs, ntc10kMaxError());
+    printf("  ráfaga ADC (2 canales x %u muestras):  %8.3f us\n",
+           (unsigned)Sensors::ADC_OVERSAMPLE_COUNT, adcUs);
+    printf("  calibración resolviendo coeficientes:  %8.3f us (NTC10K + pH + conductividad)\n",
+           calibrationResolvingUs);
+    printf("  calibración precalculada:              %8.3f us\n", calibrationUs);
+    printf("  payload delimitado:                    %8.3f us (%zu bytes)\n", payloadUs, payloadSize);
+    printf("  payload binario:                       %8.3f us (%zu bytes)\n", binaryUs, binarySize);
+
+    using namespace Calibration;
+    printf("Kernels de calibración (coste por llamada):\n");
+    const SteinhartHartCoeffs& ntcCoeffs = CalibrationStore::ntc10k();
+    const SteinhartHartFixed& ntcFixed = CalibrationStore::ntc10kFixed();
+    const PhCoeffs& phCoeffs = CalibrationStore::ph();
+    const PhFixed& phFixed = CalibrationStore::phFixed();
+    const ConductivityCoeffs& condCoeffs = CalibrationStore::conductivity();
+    const ConductivityFixed& condFixed = CalibrationStore::conductivityFixed();
+    double shA, shB, shC;
+    CalibrationMath::steinhartHartCoeffs(NTC10K::DEFAULT_T1 + 273.15, NTC10K::DEFAULT_R1,
+                                         NTC10K::DEFAULT_T2 + 273.15, NTC10K::DEFAULT_R2,
+                                         NTC10K::DEFAULT_T3 + 273.15, NTC10K::DEFAULT_R3, shA, shB, shC);
+    benchKernel("Steinhart-Hart double", iterations, [&](uint32_t i) {
+        double v = 0.5 + (i & 1023) * 0.001;
+        return (float)CalibrationMath::steinhartHartTemperature(
+            CalibrationMath::ntcResistanceFromDivider(v, 3.0, 10000.0, true), shA, shB, shC);
+    });
+    benchKernel("Steinhart-Hart float", iterations, [&](uint32_t i) {
+        float v = 0.5f + (i & 1023) * 0.001f;
+        return CalibrationMath::evaluateSteinhartHart(
+            CalibrationMath::ntcResistanceFromDividerF(v, 3.0f, 10000.0f, true), ntcCoeffs);
+    });
+    benchKernel("Steinhart-Hart punto fijo", iterations, [&](uint32_t i) {
+        return (float)CalibrationFixed::ntcTemperatureC100(500000 + (int32_t)(i & 1023) * 1000, 3000000,
+                                                           10000, true, ntcFixed);
+    });
+    const NtcLut& ntcLut = CalibrationStore::ntc10kLut();
+    benchKernel("NTC por tabla", iterations, [&](uint32_t i) {
+        return (float)NtcTable::temperatureC100(ntcLut, 500000 + (int32_t)(i & 1023) * 1000);
+    });
+    benchKernel("pH float", iterations, [&](uint32_t i) {
+        return CalibrationMath::evaluatePh(-0.5f + (i & 1023) * 0.001f, 21.5f, phCoeffs);
+    });
+    benchKernel("pH punto fijo", iterations, [&](uint32_t i) {
+        return (float)CalibrationFixed::phMilli(-500000 + (int32_t)(i & 1023) * 1000, 2150, phFixed);
+    });
+    benchKernel("conductividad float", iterations, [&](uint32_t i) {
+        return CalibrationMath::evaluateConductivity((i & 1023) * 0.003f, 21.5f, condCoeffs);
+    });
+    benchKernel("conductividad punto fijo", iterations, [&](uint32_t i) {
+        return (float)CalibrationFixed::conductivityPpm100((int32_t)(i & 1023) * 3000, 2150, condFixed);
+    });
+
+    modbusCodecBench(iterations);
+    return 0;
+}
+
+#endif // !ARDUINO && !PIO_UNIT_TESTING
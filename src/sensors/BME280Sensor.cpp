@@ -3,8 +3,8 @@
 // Objeto estático del sensor BME280
 static Adafruit_BME280 bme280Sensor;
 
-BME280Sensor::BME280Sensor(const std::string& id) {
-    this->_id = id;
+BME280Sensor::BME280Sensor(const char* id) {
+    setId(id);
     this->_type = BME280;
 }
     bool BME280Sensor::begin() {
@@ -19,7 +19,7 @@ BME280Sensor::BME280Sensor(const std::string& id) {
 }
     SensorReading BME280Sensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
@@ -4,8 +4,8 @@
 // Objeto local para el sensor BME680
 static Adafruit_BME680 bme680Sensor(&Wire);
 
-BME680Sensor::BME680Sensor(const std::string& id) {
-    this->_id = id;
+BME680Sensor::BME680Sensor(const char* id) {
+    setId(id);
     this->_type = BME680;
 }
     bool BME680Sensor::begin() {
@@ -19,31 +19,43 @@ BME680Sensor::BME680Sensor(const std::string& id) {
     return _initialized;
 }
     SensorReading BME680Sensor::read() {
+    return readBlocking();
+}
+
+void BME680Sensor::startMeasurement() {
+    // beginReading() devuelve el instante (millis) en que la medición
+    // (incluido el calentador de gas) estará lista, o 0 si falla
+    _readingEndMs = _initialized ? bme680Sensor.beginReading() : 0;
+}
+
+bool BME680Sensor::isReady() {
+    if (_readingEndMs == 0) {
+        return true;
+    }
+    return (int32_t)(millis() - _readingEndMs) >= 0;
+}
+
+SensorReading BME680Sensor::collect() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
-    if (!_initialized) {
+    bool started = (_readingEndMs != 0);
+    _readingEndMs = 0;
+
+    if (!_initialized || !started || !bme680Sensor.endReading()) {
         reading.value = NAN;
-            reading.subValues.push_back({NAN}); // Temperatura
+        reading.subValues.push_back({NAN}); // Temperatura
         reading.subValues.push_back({NAN}); // Humedad
         reading.subValues.push_back({NAN}); // Presión
         return reading;
     }
-
-    // Realizar lectura
-    if (!bme680Sensor.performReading()) {
-        reading.value = NAN;
-            reading.subValues.push_back({NAN});
-        reading.subValues.push_back({NAN});
-        reading.subValues.push_back({NAN});
-        return reading;
-    }
     float temp = bme680Sensor.temperature;
     float hum = bme680Sensor.humidity;
     float pressure = bme680Sensor.pressure / 100.0f;
     reading.value = temp;
     reading.subValues.push_back({temp});
-    reading.subValues.push_back({hum});    reading.subValues.push_back({pressure});
+    reading.subValues.push_back({hum});
+    reading.subValues.push_back({pressure});
     return reading;
 }
@@ -1,28 +1,34 @@
 #include "sensors/BatterySensor.h"
+#include <math.h>
+#include <string.h>
 #include "config.h" // Para las constantes de configuración
+#include "CalibrationMath.h"
+#include "hal/Hal.h"
+#include "AdcSampler.h"
 
-BatterySensor::BatterySensor(const std::string& id) {
-    this->_id = id;
+BatterySensor::BatterySensor(const char* id) {
+    setId(id);
     this->_type = BATTERY;
 }
     bool BatterySensor::begin() {
-    pinMode(Pins::BATTERY_CONTROL, OUTPUT);
-    digitalWrite(Pins::BATTERY_CONTROL, HIGH);
+    HalGpio::setOutput(Pins::BATTERY_CONTROL);
+    HalGpio::write(Pins::BATTERY_CONTROL, true);
     _initialized = true;
     return true;
 }
     SensorReading BatterySensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
         reading.value = NAN;
         return reading;
     }
-    digitalWrite(Pins::BATTERY_CONTROL, LOW);
-    int milliVolts = analogReadMilliVolts(Pins::BATTERY_SENSOR);
-    digitalWrite(Pins::BATTERY_CONTROL, HIGH);
+    // El divisor solo conduce con BATTERY_CONTROL en bajo: se muestrea fuera del lote
+    HalGpio::write(Pins::BATTERY_CONTROL, false);
+    float milliVolts = AdcSampler::sampleNow(Pins::BATTERY_SENSOR);
+    HalGpio::write(Pins::BATTERY_CONTROL, true);
     float voltage = milliVolts / 1000.0f;
     if (isnan(voltage) || voltage <= 0.0f || voltage >= 3.3f) {
         reading.value = NAN;
@@ -43,8 +49,6 @@ BatterySensor::BatterySensor(const std::string& id) {
  * @return float Voltaje real de la batería
  */
 float BatterySensor::calculateBatteryVoltage(float adcVoltage) {
-    // VBAT = 100k / (100k+390k) * VADC_IN1 corregido a:
-    // VBAT = VADC_IN1 / (100k / (100k+390k))
-    return adcVoltage / (Calibration::BATTERY_R1 / (Calibration::BATTERY_R1 + Calibration::BATTERY_R2));
+    return CalibrationMath::batteryVoltage(adcVoltage, Calibration::BATTERY_R1, Calibration::BATTERY_R2);
 }
 
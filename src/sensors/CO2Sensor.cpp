@@ -2,8 +2,8 @@
 
 static SCD4x scd4x(SCD4x_SENSOR_SCD41);
 
-CO2Sensor::CO2Sensor(const std::string& id) {
-    this->_id = id;
+CO2Sensor::CO2Sensor(const char* id) {
+    setId(id);
     this->_type = CO2;
 }
     bool CO2Sensor::begin() {
@@ -11,45 +11,52 @@ CO2Sensor::CO2Sensor(const std::string& id) {
     return _initialized;
 }
     SensorReading CO2Sensor::read() {
+    return readBlocking();
+}
+
+void CO2Sensor::startMeasurement() {
+    _dataReady = false;
+    _measurementStarted = _initialized && scd4x.measureSingleShot();
+    _startMs = millis();
+    _lastPollMs = _startMs;
+}
+
+bool CO2Sensor::isReady() {
+    if (!_measurementStarted || _dataReady) {
+        return true;
+    }
+    uint32_t now = millis();
+    if (now - _lastPollMs < POLL_INTERVAL_MS) {
+        return false;
+    }
+    _lastPollMs = now;
+    _dataReady = scd4x.readMeasurement();
+
+    // Timeout: se da por terminada la medición y collect() devolverá NAN
+    return _dataReady || (now - _startMs) >= POLL_INTERVAL_MS * MAX_POLL_ATTEMPTS;
+}
+
+SensorReading CO2Sensor::collect() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
-    if (!_initialized) {
+    if (!_initialized || !_measurementStarted || !_dataReady) {
+        _measurementStarted = false;
         reading.value = NAN;
-            reading.subValues.push_back({NAN}); // CO2
+        reading.subValues.push_back({NAN}); // CO2
         reading.subValues.push_back({NAN}); // Temperatura
         reading.subValues.push_back({NAN}); // Humedad
         return reading;
     }
+    _measurementStarted = false;
 
-    if (!scd4x.measureSingleShot()) {
-        reading.value = NAN;
-            reading.subValues.push_back({NAN});
-        reading.subValues.push_back({NAN});
-        reading.subValues.push_back({NAN});
-        return reading;
-    }
-    uint32_t counter = 0;
-    const uint32_t maxAttempts = 200;
-
-    while (counter < maxAttempts) {
-    delay(50);
-    counter++;
-    if (scd4x.readMeasurement()) {
-            float co2 = (float)scd4x.getCO2();
+    float co2 = (float)scd4x.getCO2();
     float temp = scd4x.getTemperature();
     float hum = scd4x.getHumidity();
     reading.value = co2;
-            reading.subValues.push_back({co2});
-                reading.subValues.push_back({temp});            reading.subValues.push_back({hum});
-                return reading;
-        }
-    }
-
-    reading.value = NAN;
-    reading.subValues.push_back({NAN});
-    reading.subValues.push_back({NAN});
-    reading.subValues.push_back({NAN});
+    reading.subValues.push_back({co2});
+    reading.subValues.push_back({temp});
+    reading.subValues.push_back({hum});
     return reading;
 }
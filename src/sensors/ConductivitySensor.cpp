@@ -1,34 +1,36 @@
 #include "sensors/ConductivitySensor.h"
+#include <string.h>
 #include <cmath>
 #include "sensors/NtcSensor.h"
 #include "config.h"
-#include "config_manager.h"
+#include "CalibrationKernels.h"
+#include "hal/Hal.h"
+#include "AdcSampler.h"
 
-ConductivitySensor::ConductivitySensor(const std::string& id) {
-    this->_id = id;
+ConductivitySensor::ConductivitySensor(const char* id) {
+    setId(id);
     this->_type = COND;
 }
     bool ConductivitySensor::begin() {
     // El sensor de conductividad solo necesita configuración del ADC
-    _initialized = true;
+    _initialized = AdcSampler::addChannel(Pins::COND_SENSOR);
     return true;
 }
     SensorReading ConductivitySensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
         reading.value = NAN;
         return reading;
     }
-    int adcValue = analogRead(Pins::COND_SENSOR);
-    float voltage = adcValue * (3.3f / 4095.0f);
+    float voltage = AdcSampler::milliVolts(Pins::COND_SENSOR) / 1000.0f;
     if (isnan(voltage) || voltage < 0.0f || voltage > 3.3f) {
         reading.value = NAN;
         return reading;
     }
-    float waterTemp = NtcSensor::readNtc10kTemperatureStatic();
+    float waterTemp = NtcSensor::waterTemperature();
     reading.value = convertVoltageToConductivity(voltage, waterTemp);
     return reading;
 }
@@ -41,31 +43,6 @@ ConductivitySensor::ConductivitySensor(const std::string& id) {
  * @return float Valor de TDS en ppm (partes por millón)
  */
 float ConductivitySensor::convertVoltageToConductivity(float voltage, float tempC) {
-    float calTemp, coefComp, V1, T1, V2, T2, V3, T3;
-    ConfigManager::getConductivityConfig(calTemp, coefComp, V1, T1, V2, T2, V3, T3);
-
-    // Si tempC es NAN, usar la temperatura de calibración como valor por defecto
-    if (isnan(tempC)) {
-    tempC = calTemp;
-    }
-
-    // Matriz para resolver el sistema de ecuaciones
-    // Basado en 3 puntos de calibración
-    const double det = V1*V1*(V2 - V3) - V1*(V2*V2 - V3*V3) + (V2*V2*V3 - V2*V3*V3);
-    if(fabs(det) > 1e-6) {
-    const double a = (T1*(V2 - V3) - T2*(V1 - V3) + T3*(V1 - V2)) / det;
-    const double b = (T1*(V3*V3 - V2*V2) + T2*(V1*V1 - V3*V3) + T3*(V2*V2 - V1*V1)) / det;
-    const double c = (T1*(V2*V2*V3 - V2*V3*V3) - T2*(V1*V1*V3 - V1*V3*V3) + T3*(V1*V1*V2 - V1*V2*V2)) / det;
-
-        // Aplicar compensación de temperatura
-        const double compensation = 1.0 + coefComp * (tempC - calTemp);
-    double compensatedVoltage = voltage / compensation;
-    double conductivity = a * (compensatedVoltage * compensatedVoltage)
-        + b * compensatedVoltage
-        + c;
-        return fmax(conductivity, 0.0);
-    }
-    else {
-    return NAN;
-    }
+    // La cuadrática se resolvió al escribir la calibración (CalibrationStore)
+    return CalibrationKernels::conductivity(voltage, tempC);
 }
@@ -0,0 +1,161 @@
+#include "sensors/DS18B20Bus.h"
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <stddef.h>
+#include <string.h>
+#include "esp_attr.h"
+#include "util/crc16.h"
+#include "debug.h"
+
+// Comando Convert T de la familia DS18x20
+static const uint8_t CMD_CONVERT_T = 0x44;
+
+// Distinto de cero para que una RTC recién puesta a cero nunca pase por una caché válida
+static const uint16_t CACHE_MAGIC = 0xD518;
+
+/**
+ * @brief Códigos ROM y resolución de cada sonda, en RTC RAM
+ */
+struct DS18B20Cache {
+    uint16_t magic;
+    uint16_t crc;
+    uint8_t count;
+    uint8_t parasite;
+    uint8_t resolution[Sensors::DS18B20_MAX_PROBES];
+    uint8_t rom[Sensors::DS18B20_MAX_PROBES][8];
+};
+
+RTC_DATA_ATTR static DS18B20Cache cache;
+
+OneWire oneWireBus(Pins::ONE_WIRE_BUS);
+static DallasTemperature dallasTemp(&oneWireBus);
+
+// dallasTemp.begin() solo hace falta para escribir scratchpads (conoce el modo parásito)
+static bool libraryStarted = false;
+
+uint8_t DS18B20Bus::_pendingRequests = 0;
+uint32_t DS18B20Bus::_conversionStartMs = 0;
+uint16_t DS18B20Bus::_conversionTimeMs = 0;
+
+static uint16_t computeCrc() {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&cache) + offsetof(DS18B20Cache, count);
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < sizeof(DS18B20Cache) - offsetof(DS18B20Cache, count); i++) {
+        crc = crc16_update(crc, bytes[i]);
+    }
+    return crc;
+}
+
+static void commitCache() {
+    cache.magic = CACHE_MAGIC;
+    cache.crc = computeCrc();
+}
+
+static bool cacheValid() {
+    return cache.magic == CACHE_MAGIC && cache.count > 0 &&
+           cache.count <= Sensors::DS18B20_MAX_PROBES && cache.crc == computeCrc();
+}
+
+static void startLibrary() {
+    if (!libraryStarted) {
+        dallasTemp.begin();
+        libraryStarted = true;
+    }
+}
+
+bool DS18B20Bus::discover() {
+    memset(&cache, 0, sizeof(cache));
+    startLibrary();
+
+    DeviceAddress address;
+    oneWireBus.reset_search();
+    while (cache.count < Sensors::DS18B20_MAX_PROBES && oneWireBus.search(address)) {
+        if (!dallasTemp.validAddress(address) || !dallasTemp.validFamily(address)) {
+            continue;
+        }
+        memcpy(cache.rom[cache.count], address, sizeof(address));
+        // 0 = desconocida: setResolution() la escribe en la primera llamada
+        cache.resolution[cache.count] = 0;
+        cache.count++;
+    }
+    cache.parasite = dallasTemp.isParasitePowerMode() ? 1 : 0;
+
+    if (cache.count == 0) {
+        return false;
+    }
+    commitCache();
+    DEBUG_PRINTF("DS18B20: %u sondas descubiertas y guardadas en RTC\n", cache.count);
+    return true;
+}
+
+bool DS18B20Bus::begin() {
+    if (cacheValid()) {
+        return true;
+    }
+    return discover();
+}
+
+uint8_t DS18B20Bus::probeCount() {
+    return cacheValid() ? cache.count : 0;
+}
+
+bool DS18B20Bus::setResolution(uint8_t probe, uint8_t bits) {
+    if (probe >= probeCount()) {
+        return false;
+    }
+    bits = constrain(bits, 9, 12);
+    if (cache.resolution[probe] == bits) {
+        return true;
+    }
+
+    // La biblioteca copia el scratchpad a la EEPROM de la sonda: la resolución
+    // sobrevive al corte del riel de 3.3V entre despertares
+    startLibrary();
+    if (!dallasTemp.setResolution(cache.rom[probe], bits, true)) {
+        return false;
+    }
+    cache.resolution[probe] = bits;
+    commitCache();
+    return true;
+}
+
+void DS18B20Bus::requestConversion() {
+    if (_pendingRequests++ > 0) {
+        return;
+    }
+
+    uint8_t maxBits = 9;
+    for (uint8_t i = 0; i < cache.count; i++) {
+        uint8_t bits = cache.resolution[i] != 0 ? cache.resolution[i] : 12;
+        if (bits > maxBits) {
+            maxBits = bits;
+        }
+    }
+
+    // Skip ROM + Convert T: todas las sondas convierten a la vez
+    oneWireBus.reset();
+    oneWireBus.skip();
+    oneWireBus.write(CMD_CONVERT_T, cache.parasite);
+    _conversionStartMs = millis();
+    _conversionTimeMs = DallasTemperature::millisToWaitForConversion(maxBits);
+}
+
+bool DS18B20Bus::isConversionDone() {
+    return (millis() - _conversionStartMs) >= _conversionTimeMs;
+}
+
+float DS18B20Bus::readProbe(uint8_t probe) {
+    if (_pendingRequests > 0) {
+        _pendingRequests--;
+    }
+    if (probe >= probeCount()) {
+        return NAN;
+    }
+    // Direccionada por ROM: sin búsqueda en el bus (a diferencia de getTempCByIndex)
+    float temp = dallasTemp.getTempC(cache.rom[probe]);
+    return temp == DEVICE_DISCONNECTED_C ? NAN : temp;
+}
+
+void DS18B20Bus::invalidate() {
+    cache.magic = 0;
+}
@@ -1,45 +1,74 @@
 #include "sensors/DS18B20Sensor.h"
-#include <OneWire.h>
-#include <DallasTemperature.h>
+#include "sensors/DS18B20Bus.h"
+#include <ctype.h>
+#include <stdlib.h>
 
-OneWire oneWireBus(Pins::ONE_WIRE_BUS);
-static DallasTemperature dallasTemp(&oneWireBus);
-
-DS18B20Sensor::DS18B20Sensor(const std::string& id) {
-    this->_id = id;
+DS18B20Sensor::DS18B20Sensor(const char* id, const char* configKey) {
+    setId(id);
     this->_type = DS18B20;
+
+    // configKey "D3:10" -> sonda 3 a 10 bits; el prefijo no numérico se ignora
+    if (configKey != nullptr) {
+        const char* ptr = configKey;
+        while (*ptr != '\0' && !isdigit((unsigned char)*ptr)) {
+            ptr++;
+        }
+        if (*ptr != '\0') {
+            char* end = nullptr;
+            _probe = (uint8_t)strtoul(ptr, &end, 10);
+            if (*end == ':') {
+                _resolution = (uint8_t)strtoul(end + 1, nullptr, 10);
+            }
+        }
+    }
 }
     bool DS18B20Sensor::begin() {
-    // El bus OneWire ya debe estar inicializado en main
-    // Solo necesitamos comenzar la comunicación con el sensor
-    dallasTemp.begin();
-    if (dallasTemp.getDeviceCount() == 0) {
-    _initialized = false;
-        return false;
+    // ROMs desde RTC (o búsqueda en el primer arranque); sin conversión de prueba
+    _initialized = DS18B20Bus::begin() &&
+                   _probe < DS18B20Bus::probeCount() &&
+                   DS18B20Bus::setResolution(_probe, _resolution);
+    if (!_initialized) {
+        DEBUG_PRINTF("DS18B20 %s: sonda %u no encontrada\n", _id, _probe);
     }
-
-    // Hacer una lectura de prueba
-    dallasTemp.requestTemperatures();
-    float temp = dallasTemp.getTempCByIndex(0);
-    _initialized = (temp != DEVICE_DISCONNECTED_C);
     return _initialized;
 }
     SensorReading DS18B20Sensor::read() {
+    return readBlocking();
+}
+
+void DS18B20Sensor::startMeasurement() {
+    _conversionStarted = false;
+    if (!_initialized) {
+        return;
+    }
+
+    // Solo la primera sonda del ciclo emite el Convert T; las demás lo comparten
+    DS18B20Bus::requestConversion();
+    _conversionStarted = true;
+}
+
+bool DS18B20Sensor::isReady() {
+    if (!_conversionStarted) {
+        return true;
+    }
+    return DS18B20Bus::isConversionDone();
+}
+
+SensorReading DS18B20Sensor::collect() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
-    if (!_initialized) {
+    if (!_initialized || !_conversionStarted) {
         reading.value = NAN;
         return reading;
     }
+    _conversionStarted = false;
 
-    dallasTemp.requestTemperatures();
-    float temp = dallasTemp.getTempCByIndex(0);
-    if (temp == DEVICE_DISCONNECTED_C) {
-        reading.value = NAN;
-    } else {
-        reading.value = temp;
+    reading.value = DS18B20Bus::readProbe(_probe);
+    if (isnan(reading.value)) {
+        // Sonda ausente o reemplazada: el próximo despertar vuelve a recorrer el bus
+        DS18B20Bus::invalidate();
     }
-return reading;
+    return reading;
 }
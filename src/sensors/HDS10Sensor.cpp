@@ -1,27 +1,29 @@
 #include "sensors/HDS10Sensor.h"
+#include <string.h>
 #include <cmath>
 #include "config.h"
+#include "hal/Hal.h"
+#include "AdcSampler.h"
 
-HDS10Sensor::HDS10Sensor(const std::string& id) {
-    this->_id = id;
+HDS10Sensor::HDS10Sensor(const char* id) {
+    setId(id);
     this->_type = HDS10;
 }
     bool HDS10Sensor::begin() {
     // El sensor HDS10 solo necesita configuración del ADC
-    _initialized = true;
+    _initialized = AdcSampler::addChannel(Pins::HDS10_SENSOR);
     return true;
 }
     SensorReading HDS10Sensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
         reading.value = NAN;
         return reading;
     }
-    int adcValue = analogRead(Pins::HDS10_SENSOR);
-    float voltage = adcValue * (3.3f / 4095.0f);
+    float voltage = AdcSampler::milliVolts(Pins::HDS10_SENSOR) / 1000.0f;
     const float R_ref = 10000.0f; // Resistencia de referencia 10kΩ
     float resistance = R_ref * ((3.3f / voltage) - 1.0f);
     reading.value = convertResistanceToHumidity(resistance);
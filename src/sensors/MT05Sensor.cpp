@@ -1,8 +1,11 @@
 #include "sensors/MT05Sensor.h"
 #include <OneWire.h>
 
-MT05Sensor::MT05Sensor(const std::string& id) {
-    this->_id = id;
+// Bus OneWire compartido por todas las lecturas del MT05S
+static OneWire mt05Bus(Pins::ONE_WIRE_BUS);
+
+MT05Sensor::MT05Sensor(const char* id) {
+    setId(id);
     this->_type = MT05S;
 }
 
@@ -12,13 +15,47 @@ bool MT05Sensor::begin() {
 }
 
 SensorReading MT05Sensor::read() {
+    return readBlocking();
+}
+
+void MT05Sensor::startMeasurement() {
+    _conversionStarted = false;
+    if (!_initialized) {
+        return;
+    }
+
+    // Configurar el sensor MT05S
+    mt05Bus.reset();
+    mt05Bus.skip();
+    mt05Bus.write(0x4E);  // Write Scratchpad
+    mt05Bus.write(0x14);  // CONFIG0: 0x14 = Habilitar temperatura, humedad y conductividad
+    mt05Bus.write(0x00);  // CONFIG1: Por defecto
+    mt05Bus.write(0x00);  // Dummy byte requerido por el protocolo
+    delay(10);
+    // Iniciar conversión de todas las mediciones
+    mt05Bus.reset();
+    mt05Bus.skip();
+    mt05Bus.write(0x44);  // Convert T
+
+    _conversionStartMs = millis();
+    _conversionStarted = true;
+}
+
+bool MT05Sensor::isReady() {
+    if (!_conversionStarted) {
+        return true;
+    }
+    return (millis() - _conversionStartMs) >= CONVERSION_TIME_MS;
+}
+
+SensorReading MT05Sensor::collect() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     reading.subValues.clear();
 
-    if (!_initialized) {
+    if (!_initialized || !_conversionStarted) {
         SubValue temp, humidity, conductivity;
         temp.value = NAN;
         humidity.value = NAN;
@@ -28,34 +65,16 @@ SensorReading MT05Sensor::read() {
         reading.subValues.push_back(conductivity);
         return reading;
     }
-
-    // Crear instancia OneWire local para esta lectura
-    OneWire ds(Pins::ONE_WIRE_BUS);
-
-    // Configurar el sensor MT05S
-    ds.reset();
-    ds.skip();
-    ds.write(0x4E);  // Write Scratchpad
-    ds.write(0x14);  // CONFIG0: 0x14 = Habilitar temperatura, humedad y conductividad
-    ds.write(0x00);  // CONFIG1: Por defecto
-    ds.write(0x00);  // Dummy byte requerido por el protocolo
-    delay(10);
-    // Iniciar conversión de todas las mediciones
-    ds.reset();
-    ds.skip();
-    ds.write(0x44);  // Convert T
-
-    // Esperar conversión completa (100ms típico según datasheet)
-    delay(110);
+    _conversionStarted = false;
 
     // Leer los resultados
-    ds.reset();
-    ds.skip();
-    ds.write(0xBE);  // Read Scratchpad
+    mt05Bus.reset();
+    mt05Bus.skip();
+    mt05Bus.write(0xBE);  // Read Scratchpad
 
     uint8_t scratchpad[9];
     for (int i = 0; i < 9; i++) {
-        scratchpad[i] = ds.read();
+        scratchpad[i] = mt05Bus.read();
     }
 
     #ifdef DEBUG_MODE
@@ -77,7 +96,7 @@ SensorReading MT05Sensor::read() {
         reading.subValues.push_back(humidity);
         reading.subValues.push_back(conductivity);
         // Reset final para forzar standby inmediato
-        ds.reset();
+        mt05Bus.reset();
         return reading;
     }
 
@@ -101,7 +120,7 @@ SensorReading MT05Sensor::read() {
 
     // Reset final para forzar al sensor a standby inmediato
     // Esto evita el timeout de 500ms esperando el siguiente comando
-    ds.reset();
+    mt05Bus.reset();
 
     return reading;
-}
\ No newline at end of file
+}
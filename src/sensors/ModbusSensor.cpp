@@ -1,74 +1,47 @@
 #include "sensors/ModbusSensor.h"
+#include <math.h>
+#include <string.h>
 #include "debug.h"
 
-ModbusSensor::ModbusSensor(const std::string& id, SensorType type, uint8_t slaveId, uint16_t startReg, uint8_t numRegs) {
-    this->_id = id;
+ModbusSensor::ModbusSensor(const char* id, SensorType type, uint8_t slaveId, const ModbusDescriptor& descriptor) {
+    setId(id);
     this->_type = type;
     this->_slaveId = slaveId;
-    this->_startRegister = startReg;
-    this->_numRegisters = numRegs;
+    this->_descriptor = descriptor;
+    // Sin puntos configurados, los tipos conocidos usan su mapa de fábrica
+    if (this->_descriptor.count == 0) {
+        ModbusRegisterMap::preset(type, this->_descriptor);
+    }
 }
-    bool ModbusSensor::begin() {
-    _initialized = true;
-    return true;
+
+bool ModbusSensor::begin() {
+    _firstPoint = ModbusSensorManager::addPoints(_slaveId, _descriptor,
+                                                 ModbusRegisterMap::warmupLimitMs(_type));
+    if (_firstPoint == ModbusSensorManager::NO_HANDLE) {
+        DEBUG_PRINTF("Modbus: descriptor de %s vacío o sin espacio en el lote\n", _id);
+    }
+    _initialized = (_firstPoint != ModbusSensorManager::NO_HANDLE);
+    return _initialized;
 }
+
 SensorReading ModbusSensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
-    
+    reading.value = NAN;
+    reading.subValues.clear();
+
     if (!_initialized) {
-        reading.value = NAN;
         return reading;
     }
-    
-    uint16_t data[_numRegisters];
-    bool success = ModbusSensorManager::readRegisters(_slaveId, _startRegister, _numRegisters, data);
-    
-    if (success) {
-        reading = processModbusData(data, _numRegisters);
-        strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
-        reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
-        reading.type = _type;
-    } else {
-        reading.value = NAN;
-    }
-    
-    return reading;
-}
 
-ENV4ModbusSensor::ENV4ModbusSensor(const std::string& id, uint8_t slaveId)
-    : ModbusSensor(id, ENV4, slaveId, 500, 8) {
-}
-
-SensorReading ENV4ModbusSensor::processModbusData(uint16_t* data, uint8_t numRegs) {
-    SensorReading reading;
-    reading.subValues.clear();
-    
-    if (numRegs < 8) {
-        for (int i = 0; i < 4; i++) {
-            SubValue sv;
-            sv.value = NAN;
-            reading.subValues.push_back(sv);
-        }
-        reading.value = NAN;
-        return reading;
-    }
-    
-    float values[4];
-    for (int i = 0; i < 4; i++) {
-        uint32_t combined = ((uint32_t)data[i*2] << 16) | data[i*2 + 1];
-        values[i] = *((float*)&combined);
-    }
-    
-    for (int i = 0; i < 4; i++) {
+    for (uint8_t i = 0; i < _descriptor.count; i++) {
         SubValue sv;
-        sv.value = values[i];
+        sv.value = ModbusSensorManager::value(_firstPoint + i);
         reading.subValues.push_back(sv);
     }
-    
-    reading.value = values[0];
-    
+    reading.value = reading.subValues[0].value;
+
     return reading;
 }
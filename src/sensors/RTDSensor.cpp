@@ -4,8 +4,8 @@
 // Objeto estático del sensor RTD con pines configurados
 static Adafruit_MAX31865 rtdSensor(Pins::RtdSPI::PT100_CS, Pins::RtdSPI::MOSI, Pins::RtdSPI::MISO, Pins::RtdSPI::SCK);
 
-RTDSensor::RTDSensor(const std::string& id) {
-    this->_id = id;
+RTDSensor::RTDSensor(const char* id) {
+    setId(id);
     this->_type = RTD;
 }
     bool RTDSensor::begin() {
@@ -21,7 +21,7 @@ RTDSensor::RTDSensor(const std::string& id) {
 }
     SensorReading RTDSensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
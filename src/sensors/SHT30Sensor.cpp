@@ -4,8 +4,8 @@
 // Objeto local para el sensor SHT30
 static SHT31 sht30Sensor(Sensors::SHT31_I2C_ADDR, &Wire);
 
-SHT30Sensor::SHT30Sensor(const std::string& id) {
-    this->_id = id;
+SHT30Sensor::SHT30Sensor(const char* id) {
+    setId(id);
     this->_type = SHT30;
 }
     bool SHT30Sensor::begin() {
@@ -17,7 +17,7 @@ SHT30Sensor::SHT30Sensor(const std::string& id) {
 }
     SensorReading SHT30Sensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
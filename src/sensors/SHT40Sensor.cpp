@@ -4,8 +4,8 @@
 // Objeto local para el sensor SHT40
 static SensirionI2cSht4x sht40Sensor;
 
-SHT40Sensor::SHT40Sensor(const std::string& id) {
-    this->_id = id;
+SHT40Sensor::SHT40Sensor(const char* id) {
+    setId(id);
     this->_type = SHT40;
 }
     bool SHT40Sensor::begin() {
@@ -31,7 +31,7 @@ SHT40Sensor::SHT40Sensor(const std::string& id) {
 }
     SensorReading SHT40Sensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
@@ -2,8 +2,8 @@
 
 static Adafruit_VEML7700 veml7700;
 
-VEML7700Sensor::VEML7700Sensor(const std::string& id) {
-    this->_id = id;
+VEML7700Sensor::VEML7700Sensor(const char* id) {
+    setId(id);
     this->_type = VEML7700;
 }
     bool VEML7700Sensor::begin() {
@@ -21,7 +21,7 @@ VEML7700Sensor::VEML7700Sensor(const std::string& id) {
 }
     SensorReading VEML7700Sensor::read() {
     SensorReading reading;
-    strncpy(reading.sensorId, _id.c_str(), sizeof(reading.sensorId) - 1);
+    strncpy(reading.sensorId, _id, sizeof(reading.sensorId) - 1);
     reading.sensorId[sizeof(reading.sensorId) - 1] = '\0';
     reading.type = _type;
     if (!_initialized) {
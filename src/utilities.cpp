@@ -1,25 +1,31 @@
-#include <Arduino.h>  // Agregar esta línea para definir la clase String
 #include <cmath>     // Necesario para pow, round y fabs
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "utilities.h"
 
+#ifdef ARDUINO
+
 // Función auxiliar para convertir un string tipo
 // "EE,F1,30,98,6A,11,4E,69,D0,DE,8A,DC,D6,8D,28,A6"
 // en un array de 16 bytes
 void parseKeyString(const String &keyStr, uint8_t *outArray, size_t expectedSize) {
-    int index = 0;
-    int start = 0;
-    while (index < expectedSize && start < keyStr.length()) {
-        int comma = keyStr.indexOf(',', start);
-        String byteStr;
-        if (comma == -1) {
-            byteStr = keyStr.substring(start);
-            start = keyStr.length();
-        } else {
-            byteStr = keyStr.substring(start, comma);
-            start = comma + 1;
+    parseKeyString(keyStr.c_str(), outArray, expectedSize);
+}
+#endif
+
+void parseKeyString(const char* keyStr, uint8_t* outArray, size_t expectedSize) {
+    const char* ptr = keyStr;
+    size_t index = 0;
+    while (index < expectedSize && *ptr != '\0') {
+        char* end = nullptr;
+        outArray[index++] = (uint8_t)strtol(ptr, &end, 16);
+        // Saltar hasta después de la siguiente coma (o terminar)
+        ptr = strchr(end, ',');
+        if (ptr == nullptr) {
+            break;
         }
-        outArray[index] = (uint8_t)strtol(byteStr.c_str(), NULL, 16);
-        index++;
+        ptr++;
     }
 }
 
@@ -0,0 +1,29 @@
+/*******************************************************************************************
+ * Archivo: test/station_fixture.h
+ * Descripción: Lecturas de un despertar de la estación por defecto (NTC10K, pH,
+ * conductividad, batería y MT05S) para las pruebas native que parten de un ciclo
+ * completo. Los valores son los que da la HAL simulada con las tensiones de los
+ * benchmarks de src/native/main_native.cpp.
+ *******************************************************************************************/
+
+#ifndef STATION_FIXTURE_H
+#define STATION_FIXTURE_H
+
+#include <math.h>
+#include "sensor_types.h"
+
+/**
+ * @brief Índices en stationReadings()
+ */
+enum StationReading { STATION_NTC, STATION_PH, STATION_COND, STATION_BATTERY, STATION_MT05 };
+
+inline void stationReadings(ReadingSet& readings) {
+    readings.clear();
+    readings.push_back(SensorReading{"NTC3", N10K, 24.99f, {}});
+    readings.push_back(SensorReading{"PH", PH, 6.409f, {}});
+    readings.push_back(SensorReading{"COND", COND, 3417.36f, {}});
+    readings.push_back(SensorReading{"BAT", BATTERY, 3.822f, {}});
+    readings.push_back(SensorReading{"MT05_2", MT05S, NAN, {{21.37f}, {34.5f}, {812.0f}}});
+}
+
+#endif
@@ -0,0 +1,148 @@
+/*******************************************************************************************
+ * Archivo: test/test_calibration/test_main.cpp
+ * Descripción: Kernels de calibración en float (CalibrationMath) y en punto fijo
+ * (CalibrationFixed) barridos en todo su rango de entrada contra la referencia en double:
+ * el error máximo no puede superar la precisión del sensor (0.1 °C, 0.01 pH, 1 % de la
+ * conductividad con un mínimo de 1 ppm).
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <math.h>
+#include "config.h"
+#include "CalibrationMath.h"
+#include "CalibrationFixed.h"
+
+static const float NTC_MAX_ERROR_C = 0.1f;
+static const float PH_MAX_ERROR = 0.01f;
+static const double COND_MAX_ERROR_RATIO = 0.01;
+static const double COND_MAX_ERROR_FLOOR_PPM = 1.0;
+
+/**
+ * @brief Error máximo frente a la referencia en double; el de conductividad se expresa
+ *        como fracción del límite (1.0 = en el límite)
+ */
+struct KernelError {
+    double floatMax;
+    double fixedMax;
+};
+
+static void trackError(double& maxError, double value, double reference) {
+    double error = fabs(value - reference);
+    if (isnan(value) || error > maxError) {
+        maxError = isnan(value) ? INFINITY : error;
+    }
+}
+
+/**
+ * @brief Barre el divisor del NTC de 1 mV a vRef - 1 mV en pasos de 0.1 mV, dentro del
+ *        rango que aceptan los drivers (NTC_TEMP_MIN..NTC_TEMP_MAX)
+ */
+static KernelError ntcKernelError(double rFixed, double t1, double r1, double t2, double r2,
+                                  double t3, double r3) {
+    double A, B, C;
+    CalibrationMath::steinhartHartCoeffs(t1 + 273.15, r1, t2 + 273.15, r2, t3 + 273.15, r3, A, B, C);
+    const SteinhartHartCoeffs coeffs = CalibrationMath::solveSteinhartHart(t1, r1, t2, r2, t3, r3);
+    const SteinhartHartFixed fixed = CalibrationFixed::fromFloat(coeffs);
+
+    KernelError result{0.0, 0.0};
+    for (int32_t uv = 1000; uv < 3000000; uv += 100) {
+        double voltage = uv / 1e6;
+        double reference = CalibrationMath::steinhartHartTemperature(
+            CalibrationMath::ntcResistanceFromDivider(voltage, 3.0, rFixed, true), A, B, C);
+        if (reference < Sensors::NTC_TEMP_MIN || reference > Sensors::NTC_TEMP_MAX) {
+            continue;
+        }
+        float rNtc = CalibrationMath::ntcResistanceFromDividerF((float)voltage, 3.0f, (float)rFixed, true);
+        trackError(result.floatMax, CalibrationMath::evaluateSteinhartHart(rNtc, coeffs), reference);
+        int32_t c100 = CalibrationFixed::ntcTemperatureC100(uv, 3000000, (uint32_t)rFixed, true, fixed);
+        trackError(result.fixedMax, c100 == CalibrationFixed::INVALID ? NAN : c100 / 100.0, reference);
+    }
+    return result;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_ntc10k_kernels_within_sensor_accuracy() {
+    using namespace Calibration::NTC10K;
+    const KernelError error = ntcKernelError(10000.0, DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2,
+                                             DEFAULT_T3, DEFAULT_R3);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error.floatMax);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error.fixedMax);
+}
+
+void test_ntc100k_kernels_within_sensor_accuracy() {
+    using namespace Calibration::NTC100K;
+    const KernelError error = ntcKernelError(100000.0, DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2,
+                                             DEFAULT_T3, DEFAULT_R3);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error.floatMax);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error.fixedMax);
+}
+
+/**
+ * @brief Barre el electrodo de -2.5 a 2.5 V (pasos de 0.1 mV) de 0 a 50 °C
+ */
+void test_ph_kernels_within_sensor_accuracy() {
+    using namespace Calibration::PH;
+    const PhCoeffs coeffs = CalibrationMath::solvePh(DEFAULT_V1, DEFAULT_T1, DEFAULT_V2, DEFAULT_T2,
+                                                     DEFAULT_V3, DEFAULT_T3, DEFAULT_TEMP);
+    const PhFixed fixed = CalibrationFixed::fromFloat(coeffs);
+
+    KernelError error{0.0, 0.0};
+    for (int32_t tempC = 0; tempC <= 50; tempC += 5) {
+        for (int32_t uv = -2500000; uv <= 2500000; uv += 100) {
+            float voltage = uv / 1e6f;
+            double reference = CalibrationMath::phFromVoltage(voltage, (float)tempC, DEFAULT_V1, DEFAULT_T1,
+                                                              DEFAULT_V2, DEFAULT_T2, DEFAULT_V3,
+                                                              DEFAULT_T3, DEFAULT_TEMP);
+            trackError(error.floatMax, CalibrationMath::evaluatePh(voltage, (float)tempC, coeffs), reference);
+            trackError(error.fixedMax, CalibrationFixed::phMilli(uv, tempC * 100, fixed) / 1000.0, reference);
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(PH_MAX_ERROR, (float)error.floatMax);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(PH_MAX_ERROR, (float)error.fixedMax);
+}
+
+/**
+ * @brief Barre la conductividad de 0 a 3.3 V (pasos de 0.1 mV) de 0 a 50 °C
+ */
+void test_conductivity_kernels_within_sensor_accuracy() {
+    using namespace Calibration::Conductivity;
+    const ConductivityCoeffs coeffs = CalibrationMath::solveConductivity(
+        DEFAULT_TEMP, TEMP_COEF_COMPENSATION, DEFAULT_V1, DEFAULT_T1, DEFAULT_V2, DEFAULT_T2,
+        DEFAULT_V3, DEFAULT_T3);
+    const ConductivityFixed fixed = CalibrationFixed::fromFloat(coeffs);
+
+    KernelError error{0.0, 0.0};
+    for (int32_t tempC = 0; tempC <= 50; tempC += 5) {
+        for (int32_t uv = 0; uv <= 3300000; uv += 100) {
+            float voltage = uv / 1e6f;
+            double reference = CalibrationMath::conductivityFromVoltage(
+                voltage, (float)tempC, DEFAULT_TEMP, TEMP_COEF_COMPENSATION, DEFAULT_V1, DEFAULT_T1,
+                DEFAULT_V2, DEFAULT_T2, DEFAULT_V3, DEFAULT_T3);
+            double limit = fmax(COND_MAX_ERROR_FLOOR_PPM, reference * COND_MAX_ERROR_RATIO);
+            double floatError = fabs(CalibrationMath::evaluateConductivity(voltage, (float)tempC, coeffs)
+                                     - reference) / limit;
+            double fixedError = fabs(CalibrationFixed::conductivityPpm100(uv, tempC * 100, fixed) / 100.0
+                                     - reference) / limit;
+            error.floatMax = fmax(error.floatMax, floatError);
+            error.fixedMax = fmax(error.fixedMax, fixedError);
+        }
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.0f, (float)error.floatMax);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(1.0f, (float)error.fixedMax);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ntc10k_kernels_within_sensor_accuracy);
+    RUN_TEST(test_ntc100k_kernels_within_sensor_accuracy);
+    RUN_TEST(test_ph_kernels_within_sensor_accuracy);
+    RUN_TEST(test_conductivity_kernels_within_sensor_accuracy);
+    return UNITY_END();
+}
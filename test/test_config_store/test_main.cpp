@@ -0,0 +1,65 @@
+/*******************************************************************************************
+ * Archivo: test/test_config_store/test_main.cpp
+ * Descripción: Fuente de temperatura del agua en la configuración: el sensorId fijado
+ * por ConfigManager (como lo hace BLE) debe sobrevivir a una recarga de la imagen desde
+ * NVS y llegar al plan de sensores en RTC, que se vuelve a compilar al cambiarla y la
+ * conserva en los despertares que arrancan desde el plan.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <string.h>
+#include "config.h"
+#include "hal/HalSim.h"
+#include "config_manager.h"
+#include "ConfigStore.h"
+#include "SensorManager.h"
+#include "SensorPlan.h"
+
+static const char* SOURCE_ID = "NTC10K_AGUA_TANQUE1";
+
+static SensorManager sensors;
+
+void setUp() {
+    HalSim::reset();
+    ConfigManager::initializeDefaultConfig();
+}
+
+void tearDown() {
+    HalSim::reset();
+}
+
+void test_water_temp_source_survives_reload() {
+    TEST_ASSERT_EQUAL_STRING(Sensors::DEFAULT_WATER_TEMP_SOURCE_ID, ConfigManager::getWaterTempSourceId());
+    ConfigManager::setWaterTempSourceId(SOURCE_ID);
+
+    // Otro arranque: la imagen se vuelve a leer de NVS
+    memset(&ConfigStore::image(), 0, sizeof(ConfigImage));
+    TEST_ASSERT_TRUE(ConfigStore::load());
+    TEST_ASSERT_EQUAL_STRING(SOURCE_ID, ConfigStore::image().waterTempSourceId);
+}
+
+void test_sensor_plan_follows_water_temp_source() {
+    sensors.registerSensorsFromConfig();
+    TEST_ASSERT_TRUE(SensorPlan::isValid(ConfigStore::generation()));
+    TEST_ASSERT_EQUAL_STRING("", SensorPlan::waterTempSource());
+
+    // Cambiarla invalida el plan, y el siguiente despertar lo compila con la nueva fuente
+    ConfigManager::setWaterTempSourceId(SOURCE_ID);
+    TEST_ASSERT_FALSE(SensorPlan::isValid(ConfigStore::generation()));
+    sensors.registerSensorsFromConfig();
+    TEST_ASSERT_TRUE(SensorPlan::isValid(ConfigStore::generation()));
+    TEST_ASSERT_EQUAL_STRING(SOURCE_ID, SensorPlan::waterTempSource());
+
+    // Despertar normal: los sensores salen del plan y la fuente sigue ahí
+    sensors.registerSensorsFromConfig();
+    TEST_ASSERT_EQUAL_STRING(SOURCE_ID, SensorPlan::waterTempSource());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_water_temp_source_survives_reload);
+    RUN_TEST(test_sensor_plan_follows_water_temp_source);
+    return UNITY_END();
+}
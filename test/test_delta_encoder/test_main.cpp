@@ -0,0 +1,144 @@
+/*******************************************************************************************
+ * Archivo: test/test_delta_encoder/test_main.cpp
+ * Descripción: Codificación delta (DeltaEncoder) sobre una deriva lenta de las lecturas
+ * durante dos intervalos de keyframe: cada delta se reconstruye contra su keyframe y debe
+ * dar exactamente los mismos valores en punto fijo.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <vector>
+#include "DeltaEncoder.h"
+#include "PayloadFormat.h"
+#include "util/varint.h"
+#include "station_fixture.h"
+
+static const uint32_t START_TIME = 1700000000;
+static const uint32_t PERIOD_S = 900;
+
+/**
+ * @brief Valores de las lecturas en punto fijo, en el orden del payload (INT32_MIN
+ *        para los ausentes)
+ */
+static std::vector<int32_t> quantizedChannels(const ReadingSet& readings) {
+    std::vector<int32_t> values;
+    for (const auto& reading : readings) {
+        for (uint8_t c = 0; c < PayloadFormat::channelCount(reading); c++) {
+            const float value = reading.subValues.empty() ? reading.value : reading.subValues[c].value;
+            int32_t quantized;
+            bool present = PayloadFormat::quantize(value, PayloadFormat::channelEncoding(reading.type, c),
+                                                   quantized);
+            values.push_back(present ? quantized : INT32_MIN);
+        }
+    }
+    return values;
+}
+
+/**
+ * @brief Reconstruye un delta contra los valores de su keyframe
+ * @return false si el frame no se puede leer
+ */
+static bool rebuildDelta(const uint8_t* frame, size_t size, const std::vector<int32_t>& keyframe,
+                         uint32_t& seconds, std::vector<int32_t>& values) {
+    size_t offset = 1;
+    auto next = [&](uint32_t& out) {
+        out = 0;
+        for (uint8_t shift = 0; offset < size && shift < 35; shift += 7) {
+            const uint8_t byte = frame[offset++];
+            out |= (uint32_t)(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    if (!next(seconds)) {
+        return false;
+    }
+    values = keyframe;
+    for (auto& value : values) {
+        uint32_t delta;
+        if (value == INT32_MIN) {
+            continue;
+        }
+        if (!next(delta)) {
+            return false;
+        }
+        value = (int32_t)((uint32_t)value + (uint32_t)zigzag_decode(delta));
+    }
+    return offset == size;
+}
+
+void setUp() {
+    DeltaEncoder::reset();
+}
+
+void tearDown() {
+    DeltaEncoder::reset();
+}
+
+void test_deltas_rebuild_their_keyframe() {
+    ReadingSet base;
+    stationReadings(base);
+    ReadingSet wake = base;
+    std::vector<int32_t> keyframe;
+    uint32_t keyframeTime = 0;
+    size_t keyframeBytes = 0;
+
+    for (uint32_t i = 0; i < 2u * LoRa::DELTA_KEYFRAME_INTERVAL; i++) {
+        // Deriva de unas centésimas por despertar, con signo alterno
+        const float drift = (i % 3 == 0 ? -1.0f : 1.0f) * 0.01f * (float)(i % 5);
+        wake[STATION_NTC].value = base[STATION_NTC].value + drift * 3.0f;
+        wake[STATION_PH].value = base[STATION_PH].value + drift * 0.1f;
+        wake[STATION_COND].value = base[STATION_COND].value + drift * 40.0f;
+        wake[STATION_BATTERY].value = base[STATION_BATTERY].value - 0.001f * (float)i;
+        wake[STATION_MT05].subValues[1].value = base[STATION_MT05].subValues[1].value + drift;
+
+        const uint32_t now = START_TIME + i * PERIOD_S;
+        uint8_t frame[LoRa::MAX_PAYLOAD];
+        uint8_t fPort = 0;
+        const size_t size = DeltaEncoder::build(wake, now, frame, sizeof(frame), fPort);
+        const std::vector<int32_t> expected = quantizedChannels(wake);
+        TEST_ASSERT_GREATER_THAN(0, size);
+        if (fPort == LoRa::FPORT_KEYFRAME) {
+            TEST_ASSERT_EQUAL_UINT32(0, i % LoRa::DELTA_KEYFRAME_INTERVAL);
+            keyframe = expected;
+            keyframeTime = now;
+            keyframeBytes = size;
+        } else {
+            uint32_t seconds = 0;
+            std::vector<int32_t> rebuilt;
+            TEST_ASSERT_EQUAL_UINT8(LoRa::FPORT_DELTA, fPort);
+            TEST_ASSERT_TRUE(rebuildDelta(frame, size, keyframe, seconds, rebuilt));
+            TEST_ASSERT_TRUE(rebuilt == expected);
+            TEST_ASSERT_EQUAL_UINT32(now, keyframeTime + seconds);
+            TEST_ASSERT_EQUAL_UINT8(i % LoRa::DELTA_KEYFRAME_INTERVAL, frame[0] & 0x1F);
+            TEST_ASSERT_LESS_THAN(keyframeBytes, size);
+        }
+        DeltaEncoder::commit();
+    }
+}
+
+void test_channel_turning_nan_forces_keyframe() {
+    ReadingSet wake;
+    stationReadings(wake);
+    uint8_t frame[LoRa::MAX_PAYLOAD];
+    uint8_t fPort = 0;
+    TEST_ASSERT_GREATER_THAN(0, DeltaEncoder::build(wake, START_TIME, frame, sizeof(frame), fPort));
+    DeltaEncoder::commit();
+    TEST_ASSERT_GREATER_THAN(0, DeltaEncoder::build(wake, START_TIME + PERIOD_S, frame, sizeof(frame), fPort));
+    TEST_ASSERT_EQUAL_UINT8(LoRa::FPORT_DELTA, fPort);
+    DeltaEncoder::commit();
+
+    wake[STATION_BATTERY].value = NAN;
+    TEST_ASSERT_GREATER_THAN(0, DeltaEncoder::build(wake, START_TIME + 2 * PERIOD_S, frame, sizeof(frame), fPort));
+    TEST_ASSERT_EQUAL_UINT8(LoRa::FPORT_KEYFRAME, fPort);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_deltas_rebuild_their_keyframe);
+    RUN_TEST(test_channel_turning_nan_forces_keyframe);
+    return UNITY_END();
+}
@@ -0,0 +1,94 @@
+/*******************************************************************************************
+ * Archivo: test/test_heap/test_main.cpp
+ * Descripción: Asignaciones de heap (HeapCounter) de cien despertares en régimen
+ * permanente con el SensorManager real: registro desde el plan en RTC, begin y lectura
+ * de los drivers sobre la HAL simulada (ADC y un ENV4 en HalSim::modbusSlave) y los
+ * cuatro payloads. Los ids tienen la longitud máxima de sensorId (19), por encima del
+ * búfer interno de std::string. Requiere -DHEAP_COUNTER (lo pone el entorno native).
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <vector>
+#include "config.h"
+#include "hal/Hal.h"
+#include "hal/HalSim.h"
+#include "config_manager.h"
+#include "HeapCounter.h"
+#include "PayloadFormat.h"
+#include "SensorManager.h"
+
+static const uint32_t CYCLES = 100;
+
+static SensorManager sensors;
+
+/**
+ * @brief Un despertar como el de main: registro, lectura, payloads y apagado
+ */
+static void wake() {
+    char payload[LoRa::MAX_PAYLOAD + 1];
+    char schema[LoRa::MAX_PAYLOAD + 1];
+    uint8_t binary[LoRa::MAX_PAYLOAD];
+    uint8_t records[LoRa::MAX_PAYLOAD];
+    sensors.registerSensorsFromConfig();
+    sensors.beginAll();
+    const ReadingSet& readings = sensors.readAll();
+    // La batería se registra siempre la primera
+    PayloadFormat::delimited(readings, System::DEFAULT_DEVICE_ID, System::DEFAULT_STATION_ID,
+                             readings[0].value, 1700000000, payload, sizeof(payload));
+    PayloadFormat::schemaAnnouncement(readings, System::DEFAULT_DEVICE_ID, System::DEFAULT_STATION_ID,
+                                      schema, sizeof(schema));
+    PayloadFormat::binary(readings, 1700000000, binary, sizeof(binary));
+    PayloadFormat::binaryRecord(readings, records, sizeof(records));
+    sensors.powerDown();
+}
+
+void setUp() {
+    HalSim::reset();
+    HalAdc::setResolution(13);
+    HalSim::setAdcMilliVolts(Pins::NTC10K, 1500);
+    HalSim::setAdcMilliVolts(Pins::PH_SENSOR, 1650);
+    HalSim::setAdcMilliVolts(Pins::COND_SENSOR, 420);
+    HalSim::setAdcMilliVolts(Pins::BATTERY_SENSOR, 780);
+    HalSim::setUartResponder(HalSim::modbusSlave);
+    ConfigManager::initializeDefaultConfig();
+}
+
+void tearDown() {
+    HalSim::reset();
+}
+
+void test_steady_state_wake_does_not_allocate() {
+    TEST_ASSERT_TRUE_MESSAGE(HeapCounter::isEnabled(), "compilar con -DHEAP_COUNTER");
+    const SensorConfig adcSensors[] = {
+        {"0", "NTC100K_SUELO_ZONA1", N100K, true},
+        {"2", "NTC10K_AGUA_TANQUE1", N10K, true},
+        {"3", "HDS10_CONDENSACION1", HDS10, true},
+        {"4", "CONDUCTIVIDAD_AGUA1", COND, true},
+        {"5", "HUMEDAD_SUELO_ZONA1", SOILH, true},
+        {"8", "PH_TANQUE_PRINCIPAL", PH, true},
+    };
+    const ModbusSensorConfig modbusSensors[] = {
+        {"ENV4_INVERNADERO_01", ENV4, 1, true, DEFAULT_ENV4_DESCRIPTOR},
+    };
+    ConfigManager::setSensorsConfigs(std::vector<SensorConfig>());
+    ConfigManager::setAdcSensorsConfigs(std::vector<SensorConfig>(
+        adcSensors, adcSensors + sizeof(adcSensors) / sizeof(adcSensors[0])));
+    ConfigManager::setModbusSensorsConfigs(std::vector<ModbusSensorConfig>(
+        modbusSensors, modbusSensors + sizeof(modbusSensors) / sizeof(modbusSensors[0])));
+
+    // El primer despertar lee la configuración y compila el plan
+    wake();
+    HeapCounter::reset();
+    for (uint32_t i = 0; i < CYCLES; i++) {
+        wake();
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, HeapCounter::allocations());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_state_wake_does_not_allocate);
+    return UNITY_END();
+}
@@ -0,0 +1,143 @@
+/*******************************************************************************************
+ * Archivo: test/test_join_outage/test_main.cpp
+ * Descripción: Caída de la red de dos días (despertares cada 15 min, joins que fallan)
+ * sobre JoinScheduler y OutageBuffer: los intentos deben bajar de DR en orden, espaciarse
+ * con el backoff y no pasar del presupuesto diario de aire; al volver la sesión el
+ * respaldo debe salir en uplinks de lote dentro del presupuesto del DR, con los registros
+ * más recientes que cupieron y sus epoch corregidos por la hora del servidor. Un lote de
+ * SampleBatch que no cabe en el DR activo pasa al respaldo sin cambiar sus registros.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <stdlib.h>
+#include "JoinScheduler.h"
+#include "OutageBuffer.h"
+#include "PayloadPlanner.h"
+#include "SampleBatch.h"
+#include "station_fixture.h"
+
+static const uint32_t START = 1700000000;
+static const uint32_t WAKE_INTERVAL = 900;
+static const uint32_t OUTAGE_WAKES = 2 * JoinScheduler::BUDGET_WINDOW_S / WAKE_INTERVAL;
+
+static ReadingSet readings;
+
+/**
+ * @brief Despertares hasta el primer join exitoso (tras OUTAGE_WAKES): planifica los
+ *        intentos y respalda las lecturas de los despertares sin sesión
+ * @return Registros agregados al respaldo
+ */
+static uint32_t runOutage() {
+    uint32_t lastFailure = 0;
+    uint32_t appended = 0;
+    uint8_t expectedDr = LoRa::JOIN_DR_MAX;
+    bool joined = false;
+    for (uint32_t w = 0; !joined && w < 2 * OUTAGE_WAKES; w++) {
+        const uint32_t now = START + w * WAKE_INTERVAL;
+        if (JoinScheduler::isDue(now)) {
+            const uint8_t dr = JoinScheduler::datarate();
+            TEST_ASSERT_EQUAL_UINT8(expectedDr, dr);
+            // Nunca antes de la mitad del backoff correspondiente a los fallos previos
+            const uint8_t failures = JoinScheduler::failures();
+            if (failures > 0) {
+                TEST_ASSERT_GREATER_OR_EQUAL_UINT32(JoinScheduler::backoffSeconds(failures, 0), now - lastFailure);
+            }
+            joined = w >= OUTAGE_WAKES;
+            JoinScheduler::recordAttempt(now, dr, joined, (uint32_t)rand());
+            lastFailure = now;
+            expectedDr = dr == LoRa::JOIN_DR_MIN ? LoRa::JOIN_DR_MAX : dr - 1;
+            TEST_ASSERT_LESS_OR_EQUAL_UINT32(LoRa::JOIN_DAILY_AIRTIME_MS, JoinScheduler::airtimeUsedMs(now));
+        }
+        if (!joined) {
+            TEST_ASSERT_TRUE(OutageBuffer::append(readings, now));
+            appended++;
+        }
+    }
+    TEST_ASSERT_TRUE(joined);
+    TEST_ASSERT_EQUAL_UINT8(0, JoinScheduler::failures());
+    return appended;
+}
+
+void setUp() {
+    JoinScheduler::reset();
+    OutageBuffer::clear();
+    SampleBatch::clear();
+    srand(1);
+    stationReadings(readings);
+}
+
+void tearDown() {
+    JoinScheduler::reset();
+    OutageBuffer::clear();
+}
+
+void test_join_attempts_follow_backoff_and_budget() {
+    runOutage();
+}
+
+void test_backlog_flushes_newest_records_in_batches() {
+    // El contador de descartados es acumulado (RTC) y clear() no lo pone a cero
+    const uint32_t droppedBefore = OutageBuffer::dropped();
+    const uint32_t appended = runOutage();
+
+    // La hora del servidor corrige los epoch; salen los más recientes que cupieron
+    const int32_t clockOffset = 1000;
+    const uint8_t kept = OutageBuffer::count();
+    TEST_ASSERT_GREATER_THAN(0, kept);
+    OutageBuffer::shiftTimestamps(clockOffset);
+    const uint32_t firstKept = START + (appended - kept) * WAKE_INTERVAL + clockOffset;
+    const size_t budget = PayloadPlanner::staticBudget(LoRa::DEFAULT_DATARATE);
+    uint32_t flushed = 0;
+    uint32_t frames = 0;
+    uint32_t previousBase = 0;
+    while (OutageBuffer::count() > 0 && frames < 2u * kept) {
+        uint8_t frame[LoRa::MAX_PAYLOAD];
+        uint8_t records = 0;
+        const size_t size = OutageBuffer::buildFrame(frame, budget, records);
+        TEST_ASSERT_GREATER_THAN(0, size);
+        TEST_ASSERT_LESS_OR_EQUAL(budget, size);
+        const uint32_t base = ((uint32_t)frame[3] << 24) | ((uint32_t)frame[4] << 16) |
+                              ((uint32_t)frame[5] << 8) | frame[6];
+        TEST_ASSERT_EQUAL_UINT8(records, frame[7]);
+        TEST_ASSERT_GREATER_THAN_UINT32(previousBase, base);
+        if (frames == 0) {
+            TEST_ASSERT_EQUAL_UINT32(firstKept, base);
+        }
+        previousBase = base;
+        OutageBuffer::consume(records);
+        flushed += records;
+        frames++;
+    }
+    TEST_ASSERT_EQUAL_UINT32(kept, flushed);
+    TEST_ASSERT_EQUAL_UINT32(appended, kept + OutageBuffer::dropped() - droppedBefore);
+}
+
+void test_oversized_batch_moves_to_backlog() {
+    for (uint8_t i = 0; i < LoRa::BATCH_SIZE; i++) {
+        TEST_ASSERT_TRUE(SampleBatch::append(readings, START + i * WAKE_INTERVAL));
+    }
+    uint8_t batchFrame[LoRa::MAX_PAYLOAD];
+    const size_t batchSize = SampleBatch::buildFrame(batchFrame, sizeof(batchFrame));
+    TEST_ASSERT_GREATER_THAN(0, batchSize);
+
+    TEST_ASSERT_EQUAL_UINT8(LoRa::BATCH_SIZE, SampleBatch::moveToBacklog());
+    TEST_ASSERT_EQUAL_UINT8(0, SampleBatch::count());
+    TEST_ASSERT_EQUAL_UINT8(LoRa::BATCH_SIZE, OutageBuffer::count());
+
+    // Con el mismo presupuesto el respaldo arma exactamente el uplink del lote
+    uint8_t backlogFrame[LoRa::MAX_PAYLOAD];
+    uint8_t records = 0;
+    TEST_ASSERT_EQUAL(batchSize, OutageBuffer::buildFrame(backlogFrame, sizeof(backlogFrame), records));
+    TEST_ASSERT_EQUAL_UINT8(LoRa::BATCH_SIZE, records);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(batchFrame, backlogFrame, batchSize);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_join_attempts_follow_backoff_and_budget);
+    RUN_TEST(test_backlog_flushes_newest_records_in_batches);
+    RUN_TEST(test_oversized_batch_moves_to_backlog);
+    return UNITY_END();
+}
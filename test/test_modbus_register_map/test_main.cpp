@@ -0,0 +1,133 @@
+/*******************************************************************************************
+ * Archivo: test/test_modbus_register_map/test_main.cpp
+ * Descripción: Agrupación de puntos Modbus en transacciones (ModbusRegisterMap) con el
+ * ENV4 de fábrica, un mapa mixto de dos esclavos y puntos dispersos, y decodificación de
+ * los tipos, órdenes de bytes y escalas, incluida la plausibilidad del sondeo de
+ * calentamiento.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include "config.h"
+#include "ModbusRegisterMap.h"
+
+static ModbusDescriptor env4;
+static ModbusPointRef env4Refs[MAX_SUB_VALUES];
+static const uint16_t ENV4_REGISTERS[8] = {0x4248, 0x0000, 0x41C8, 0x0000, 0x42CA, 0x0000, 0x4479, 0x8000};
+
+static ModbusPointRef modbusRef(uint8_t slave, uint8_t function, uint16_t reg, ModbusDataType type) {
+    ModbusPointRef ref = {};
+    ref.slave = slave;
+    ref.point = ModbusPoint{reg, function, (uint8_t)type, 0, 1.0f, 0.0f};
+    return ref;
+}
+
+/**
+ * @brief Planifica los puntos y comprueba el número de transacciones, el límite de
+ *        registros por bloque y que cada punto quede asignado
+ */
+static void assertPlan(ModbusPointRef* refs, uint8_t count, uint8_t expectedBlocks) {
+    ModbusBlock blocks[System::MODBUS_MAX_POINTS];
+    uint8_t blockCount = ModbusRegisterMap::plan(refs, count, blocks, System::MODBUS_MAX_POINTS,
+                                                 System::MODBUS_BATCH_REGISTERS);
+    TEST_ASSERT_EQUAL_UINT8(expectedBlocks, blockCount);
+    for (uint8_t b = 0; b < blockCount; b++) {
+        TEST_ASSERT_LESS_OR_EQUAL_UINT16(System::MODBUS_MAX_BLOCK_REGISTERS, blocks[b].count);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        TEST_ASSERT_NOT_EQUAL(ModbusRegisterMap::NO_BLOCK, refs[i].block);
+    }
+}
+
+void setUp() {
+    ModbusRegisterMap::preset(ENV4, env4);
+    for (uint8_t i = 0; i < env4.count; i++) {
+        env4Refs[i] = ModbusPointRef{1, env4.points[i], 0, 0};
+    }
+}
+
+void tearDown() {
+}
+
+/**
+ * @brief ENV4 de fábrica: 4 floats contiguos en una sola lectura de 8 registros
+ */
+void test_env4_single_transaction() {
+    assertPlan(env4Refs, env4.count, 1);
+    const float expected[4] = {50.0f, 25.0f, 101.0f, 998.0f};
+    for (uint8_t i = 0; i < env4.count; i++) {
+        TEST_ASSERT_EQUAL_FLOAT(expected[i], ModbusRegisterMap::decode(&ENV4_REGISTERS[env4Refs[i].offset],
+                                                                       env4.points[i]));
+    }
+}
+
+/**
+ * @brief Dos esclavos, holding e input, con un hueco corto (se agrupa) y uno largo (no)
+ */
+void test_mixed_map_groups_by_slave_and_function() {
+    ModbusPointRef mixed[] = {
+        modbusRef(2, MODBUS_FUNCTION_HOLDING, 12, ModbusDataType::U16),
+        modbusRef(1, MODBUS_FUNCTION_HOLDING, 30, ModbusDataType::F32),
+        modbusRef(1, MODBUS_FUNCTION_HOLDING, 0, ModbusDataType::U16),
+        modbusRef(1, MODBUS_FUNCTION_INPUT, 0, ModbusDataType::U16),
+        modbusRef(1, MODBUS_FUNCTION_HOLDING, 4, ModbusDataType::U32),
+        modbusRef(2, MODBUS_FUNCTION_HOLDING, 10, ModbusDataType::U16),
+        modbusRef(1, MODBUS_FUNCTION_HOLDING, 1, ModbusDataType::I16),
+    };
+    assertPlan(mixed, sizeof(mixed) / sizeof(mixed[0]), 4);
+}
+
+/**
+ * @brief Puntos cada 8 registros: se agrupan hasta el límite de registros por bloque
+ */
+void test_spread_points_split_at_block_limit() {
+    ModbusPointRef spread[System::MODBUS_MAX_POINTS];
+    for (uint8_t i = 0; i < System::MODBUS_MAX_POINTS; i++) {
+        spread[i] = modbusRef(3, MODBUS_FUNCTION_INPUT, i * 8, ModbusDataType::U16);
+    }
+    const uint8_t perBlock = (System::MODBUS_MAX_BLOCK_REGISTERS - 1) / 8 + 1;
+    assertPlan(spread, System::MODBUS_MAX_POINTS, (System::MODBUS_MAX_POINTS + perBlock - 1) / perBlock);
+}
+
+/**
+ * @brief 0x12345678 en ABCD, CDAB, BADC y DCBA
+ */
+void test_byte_and_word_orders() {
+    const uint16_t orders[4][2] = {{0x1234, 0x5678}, {0x5678, 0x1234}, {0x3412, 0x7856}, {0x7856, 0x3412}};
+    const uint8_t flags[4] = {0, MODBUS_ORDER_SWAP_WORDS, MODBUS_ORDER_SWAP_BYTES,
+                              MODBUS_ORDER_SWAP_BYTES | MODBUS_ORDER_SWAP_WORDS};
+    for (int i = 0; i < 4; i++) {
+        ModbusPoint point{0, MODBUS_FUNCTION_HOLDING, (uint8_t)ModbusDataType::U32, flags[i], 1.0f, 0.0f};
+        TEST_ASSERT_EQUAL_FLOAT((float)0x12345678u, ModbusRegisterMap::decode(orders[i], point));
+    }
+}
+
+void test_scaled_signed_register() {
+    const uint16_t negative = 0xFFFE;
+    ModbusPoint scaled{0, MODBUS_FUNCTION_INPUT, (uint8_t)ModbusDataType::I16, 0, 0.5f, 1.0f};
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, ModbusRegisterMap::decode(&negative, scaled));
+    TEST_ASSERT_TRUE(ModbusRegisterMap::isPlausible(&negative, scaled));
+}
+
+/**
+ * @brief Sondeo de calentamiento: ceros, 0xFFFF y NaN no cuentan como lectura real
+ */
+void test_warming_values_not_plausible() {
+    const uint16_t warming[3][2] = {{0x0000, 0x0000}, {0xFFFF, 0xFFFF}, {0x7FC0, 0x0000}};
+    for (int i = 0; i < 3; i++) {
+        TEST_ASSERT_FALSE(ModbusRegisterMap::isPlausible(warming[i], env4.points[0]));
+    }
+    TEST_ASSERT_TRUE(ModbusRegisterMap::isPlausible(ENV4_REGISTERS, env4.points[0]));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_env4_single_transaction);
+    RUN_TEST(test_mixed_map_groups_by_slave_and_function);
+    RUN_TEST(test_spread_points_split_at_block_limit);
+    RUN_TEST(test_byte_and_word_orders);
+    RUN_TEST(test_scaled_signed_register);
+    RUN_TEST(test_warming_values_not_plausible);
+    return UNITY_END();
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************************
+ * Archivo: test/test_modbus_rtu/test_main.cpp
+ * Descripción: Maestro Modbus RTU (ModbusRtu) contra los esclavos simulados de
+ * HalSim::modbusSlave: cuatro peticiones encoladas (dos responden, una no responde y se
+ * reintenta hasta el timeout, otra devuelve la excepción 02), ciclos seguidos para el
+ * timeout adaptativo y el backoff del esclavo muerto (ModbusLinkStats) y el códec (CRC
+ * por tabla y decodificación directa al destino). Con MODBUS_PTY=/dev/pts/N las
+ * peticiones encoladas van por el pty de tools/modbus_slave_sim.py.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+#include "config.h"
+#include "hal/Hal.h"
+#include "hal/HalSim.h"
+#include "ModbusRtu.h"
+#include "ModbusLinkStats.h"
+#include "util/crc16.h"
+
+static const uint8_t DEAD_SLAVE = HalSim::MODBUS_DEAD_SLAVE;
+static const uint8_t EXCEPTION_SLAVE = HalSim::MODBUS_EXCEPTION_SLAVE;
+static const uint16_t EXCEPTION_FROM = HalSim::MODBUS_EXCEPTION_FROM;
+
+static uint16_t crc16Serial(const uint8_t* data, uint16_t length) {
+    uint16_t crc = 0xFFFF;
+    for (uint16_t i = 0; i < length; i++) {
+        crc = crc16_update(crc, data[i]);
+    }
+    return crc;
+}
+
+void setUp() {
+    HalSim::reset();
+    HalSim::setUartResponder(HalSim::modbusSlave);
+    ModbusLinkStats::reset();
+    ModbusRtu::begin(System::MODBUS_BAUD_RATE);
+    ModbusRtu::reset();
+}
+
+void tearDown() {
+    HalSim::reset();
+}
+
+/**
+ * @brief Cuatro peticiones encoladas a la vez, atendidas con poll() entre eventos
+ */
+void test_queued_requests() {
+    const char* pty = getenv("MODBUS_PTY");
+    if (pty) {
+        TEST_ASSERT_TRUE_MESSAGE(HalSim::openUartDevice(pty), "no se pudo abrir MODBUS_PTY");
+    }
+
+    uint16_t first[10] = {};
+    uint16_t second[4] = {};
+    uint16_t dead[2] = {};
+    uint16_t rejected[2] = {};
+    const uint32_t framesBefore = ModbusRtu::framesSent();
+    const int8_t requests[4] = {
+        ModbusRtu::submit(1, MODBUS_FUNCTION_HOLDING, 0, 10, first),
+        ModbusRtu::submit(2, MODBUS_FUNCTION_INPUT, 100, 4, second),
+        ModbusRtu::submit(DEAD_SLAVE, MODBUS_FUNCTION_HOLDING, 0, 2, dead),
+        ModbusRtu::submit(EXCEPTION_SLAVE, MODBUS_FUNCTION_HOLDING, EXCEPTION_FROM, 2, rejected),
+    };
+    while (ModbusRtu::poll()) {
+        ModbusRtu::waitForEvent();
+    }
+
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::SUCCESS, ModbusRtu::result(requests[0]));
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::SUCCESS, ModbusRtu::result(requests[1]));
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::TIMED_OUT, ModbusRtu::result(requests[2]));
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::ILLEGAL_DATA_ADDRESS, ModbusRtu::result(requests[3]));
+    // El registro r del esclavo s vale (s << 12) + r
+    for (uint16_t i = 0; i < 10; i++) {
+        TEST_ASSERT_EQUAL_UINT16((1 << 12) + i, first[i]);
+    }
+    for (uint16_t i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_UINT16((2 << 12) + 100 + i, second[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3 + System::MODBUS_MAX_RETRY, ModbusRtu::framesSent() - framesBefore);
+}
+
+/**
+ * @brief Ciclos seguidos: el esclavo muerto pasa de todos los intentos a 1 y luego a
+ *        backoff de 1, 2... ciclos; los vivos bajan su timeout al mínimo
+ */
+void test_dead_slave_backoff_and_adaptive_timeout() {
+    // Tramas al esclavo muerto en cada ciclo: reintentos, observación, 1 salto,
+    // observación, 2 saltos y observación
+    const uint8_t expectedDead[] = {System::MODBUS_MAX_RETRY, 1, 0, 1, 0, 0, 1};
+    uint16_t registers[4][4];
+    for (uint8_t cycle = 0; cycle < sizeof(expectedDead); cycle++) {
+        ModbusLinkStats::beginCycle();
+        ModbusRtu::reset();
+        const uint32_t framesBefore = ModbusRtu::framesSent();
+        ModbusRtu::submit(1, MODBUS_FUNCTION_HOLDING, 0, 4, registers[0]);
+        ModbusRtu::submit(2, MODBUS_FUNCTION_INPUT, 100, 4, registers[1]);
+        const int8_t dead = ModbusRtu::submit(DEAD_SLAVE, MODBUS_FUNCTION_HOLDING, 0, 2, registers[2]);
+        ModbusRtu::submit(EXCEPTION_SLAVE, MODBUS_FUNCTION_HOLDING, EXCEPTION_FROM, 2, registers[3]);
+        ModbusRtu::runUntilIdle();
+        ModbusLinkStats::endCycle();
+
+        TEST_ASSERT_EQUAL_UINT32(expectedDead[cycle], ModbusRtu::framesSent() - framesBefore - 3);
+        TEST_ASSERT_EQUAL_HEX8(expectedDead[cycle] ? ModbusRtu::TIMED_OUT : ModbusRtu::BACKED_OFF,
+                               ModbusRtu::result(dead));
+    }
+    TEST_ASSERT_EQUAL_UINT32(System::MODBUS_MIN_RESPONSE_TIMEOUT, ModbusLinkStats::timeoutMs(1, 0));
+    TEST_ASSERT_EQUAL_UINT32(System::MODBUS_RESPONSE_TIMEOUT, ModbusLinkStats::timeoutMs(1, 1));
+    TEST_ASSERT_EQUAL_UINT32(System::MODBUS_RESPONSE_TIMEOUT, ModbusLinkStats::timeoutMs(DEAD_SLAVE, 0));
+
+    // Un sondeo de calentamiento es un solo intento corto y no toca las estadísticas
+    const ModbusSlaveStats* deadStats = ModbusLinkStats::at(2);
+    TEST_ASSERT_NOT_NULL(deadStats);
+    TEST_ASSERT_EQUAL_UINT8(DEAD_SLAVE, deadStats->slave);
+    const uint32_t deadRequests = deadStats->requests;
+    ModbusLinkStats::beginCycle();
+    ModbusRtu::reset();
+    const uint32_t framesBefore = ModbusRtu::framesSent();
+    const uint32_t probeStart = HalClock::millis();
+    const int8_t probe = ModbusRtu::submit(DEAD_SLAVE, MODBUS_FUNCTION_HOLDING, 0, 2, registers[2],
+                                           ModbusRtu::PROBE);
+    ModbusRtu::runUntilIdle();
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::TIMED_OUT, ModbusRtu::result(probe));
+    TEST_ASSERT_EQUAL_UINT32(1, ModbusRtu::framesSent() - framesBefore);
+    TEST_ASSERT_LESS_THAN_UINT32(2u * System::MODBUS_PROBE_TIMEOUT_MS, HalClock::millis() - probeStart);
+    TEST_ASSERT_EQUAL_UINT32(deadRequests, deadStats->requests);
+}
+
+/**
+ * @brief Respuesta de 125 registros: CRC por tabla igual al bit a bit en todo prefijo,
+ *        decodificación directa y rechazo de un byte alterado
+ */
+void test_codec_max_block() {
+    const uint8_t count = System::MODBUS_MAX_BLOCK_REGISTERS;
+    uint8_t request[ModbusRtu::REQUEST_SIZE];
+    ModbusRtu::buildRequest(1, MODBUS_FUNCTION_HOLDING, 0, count, request);
+    TEST_ASSERT_EQUAL_UINT16(crc16Serial(request, ModbusRtu::REQUEST_SIZE - 2),
+                             (uint16_t)(request[6] | (request[7] << 8)));
+    uint8_t frame[256];
+    const uint16_t length = (uint16_t)HalSim::modbusSlave(request, sizeof(request), frame, sizeof(frame));
+    TEST_ASSERT_EQUAL_UINT16(5 + 2 * count, length);
+
+    for (uint16_t n = 0; n <= length; n++) {
+        TEST_ASSERT_EQUAL_UINT16(crc16Serial(frame, n), crc16_block(0xFFFF, frame, n));
+    }
+    uint16_t registers[System::MODBUS_MAX_BLOCK_REGISTERS] = {};
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::SUCCESS,
+                           ModbusRtu::decodeResponse(frame, length, 1, MODBUS_FUNCTION_HOLDING, count, registers));
+    for (uint16_t i = 0; i < count; i++) {
+        TEST_ASSERT_EQUAL_UINT16((1 << 12) + i, registers[i]);
+    }
+    frame[10] ^= 0x01;
+    TEST_ASSERT_EQUAL_HEX8(ModbusRtu::INVALID_CRC,
+                           ModbusRtu::decodeResponse(frame, length, 1, MODBUS_FUNCTION_HOLDING, count, registers));
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_queued_requests);
+    RUN_TEST(test_dead_slave_backoff_and_adaptive_timeout);
+    RUN_TEST(test_codec_max_block);
+    return UNITY_END();
+}
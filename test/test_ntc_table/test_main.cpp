@@ -0,0 +1,112 @@
+/*******************************************************************************************
+ * Archivo: test/test_ntc_table/test_main.cpp
+ * Descripción: Tablas de los NTC (NtcTable) frente a Steinhart-Hart en double, con el
+ * divisor de la placa y con una topología distinta (NTC abajo, Vref 3.3 V), y el canal
+ * NTC10K de CalibrationKernels frente a la ruta anterior que resolvía los coeficientes
+ * en cada lectura. El error máximo no puede superar 0.1 °C.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <math.h>
+#include "config.h"
+#include "CalibrationMath.h"
+#include "CalibrationStore.h"
+#include "CalibrationKernels.h"
+#include "NtcTable.h"
+
+static const float NTC_MAX_ERROR_C = 0.1f;
+
+static void trackError(double& maxError, double value, double reference) {
+    double error = fabs(value - reference);
+    if (isnan(value) || error > maxError) {
+        maxError = isnan(value) ? INFINITY : error;
+    }
+}
+
+/**
+ * @brief Error máximo (°C) de la tabla de un NTC frente a Steinhart-Hart en double,
+ *        en pasos de 0.1 mV dentro del rango que aceptan los drivers
+ */
+static double ntcTableError(const NtcDivider& divider, double t1, double r1, double t2, double r2,
+                            double t3, double r3) {
+    double A, B, C;
+    CalibrationMath::steinhartHartCoeffs(t1 + 273.15, r1, t2 + 273.15, r2, t3 + 273.15, r3, A, B, C);
+    static NtcLut lut;
+    NtcTable::build(CalibrationMath::solveSteinhartHart(t1, r1, t2, r2, t3, r3), divider, lut);
+
+    const double vRef = divider.vRefMilliVolts / 1000.0;
+    double maxError = 0.0;
+    for (int32_t uv = 100; uv < divider.vRefMilliVolts * 1000; uv += 100) {
+        double reference = CalibrationMath::steinhartHartTemperature(
+            CalibrationMath::ntcResistanceFromDivider(uv / 1e6, vRef, divider.rFixed, divider.ntcTop != 0),
+            A, B, C);
+        if (reference < Sensors::NTC_TEMP_MIN || reference > Sensors::NTC_TEMP_MAX) {
+            continue;
+        }
+        int32_t c100 = NtcTable::temperatureC100(lut, uv);
+        trackError(maxError, c100 == NtcTable::INVALID ? NAN : c100 / 100.0, reference);
+    }
+    return maxError;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_ntc10k_board_table() {
+    using namespace Calibration::NTC10K;
+    const double error = ntcTableError(NtcDivider{DEFAULT_R_FIXED, DEFAULT_VREF_MV, DEFAULT_NTC_TOP, 0},
+                                       DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2, DEFAULT_T3, DEFAULT_R3);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error);
+}
+
+void test_ntc100k_board_table() {
+    using namespace Calibration::NTC100K;
+    const double error = ntcTableError(NtcDivider{DEFAULT_R_FIXED, DEFAULT_VREF_MV, DEFAULT_NTC_TOP, 0},
+                                       DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2, DEFAULT_T3, DEFAULT_R3);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error);
+}
+
+void test_ntc_bottom_divider_table() {
+    using namespace Calibration::NTC10K;
+    const double error = ntcTableError(NtcDivider{10000, 3300, 0, 0},
+                                       DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2, DEFAULT_T3, DEFAULT_R3);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)error);
+}
+
+/**
+ * @brief Canal NTC10K de los drivers frente a Steinhart-Hart resuelto en double en cada
+ *        lectura, barriendo el divisor de 0.1 a 2.9 V
+ */
+void test_ntc10k_channel_matches_resolving_path() {
+    using namespace Calibration::NTC10K;
+    CalibrationStore::setNtc10k(DEFAULT_T1, DEFAULT_R1, DEFAULT_T2, DEFAULT_R2, DEFAULT_T3, DEFAULT_R3,
+                                NtcDivider{DEFAULT_R_FIXED, DEFAULT_VREF_MV, DEFAULT_NTC_TOP, 0});
+    double A, B, C;
+    CalibrationMath::steinhartHartCoeffs(DEFAULT_T1 + 273.15, DEFAULT_R1, DEFAULT_T2 + 273.15, DEFAULT_R2,
+                                         DEFAULT_T3 + 273.15, DEFAULT_R3, A, B, C);
+    double maxError = 0.0;
+    for (uint32_t mv = 100; mv <= 2900; mv += 10) {
+        const float voltage = mv / 1000.0f;
+        const double reference = CalibrationMath::steinhartHartTemperature(
+            CalibrationMath::ntcResistanceFromDivider(voltage, 3.0, 10000.0, true), A, B, C);
+        if (reference < Sensors::NTC_TEMP_MIN || reference > Sensors::NTC_TEMP_MAX) {
+            continue;
+        }
+        trackError(maxError, CalibrationKernels::ntc10kTemperature(voltage), reference);
+    }
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(NTC_MAX_ERROR_C, (float)maxError);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_ntc10k_board_table);
+    RUN_TEST(test_ntc100k_board_table);
+    RUN_TEST(test_ntc_bottom_divider_table);
+    RUN_TEST(test_ntc10k_channel_matches_resolving_path);
+    return UNITY_END();
+}
@@ -0,0 +1,132 @@
+/*******************************************************************************************
+ * Archivo: test/test_payload_planner/test_main.cpp
+ * Descripción: Reparto de lecturas (PayloadPlanner) de una estación ampliada en los DR0 a
+ * DR3 de US915, en binario y delimitado: ningún uplink ni parte del anuncio de esquema
+ * puede superar el presupuesto del DR y, cuando el total cabe, ninguna lectura puede
+ * pasar más de LoRa::REPORT_MAX_WAKES despertares sin reportarse.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <stdio.h>
+#include "PayloadPlanner.h"
+#include "PayloadFormat.h"
+#include "station_fixture.h"
+
+static ReadingSet station;
+
+/**
+ * @brief Estación por defecto más seis SHT, un ENV4 y un VEML7700
+ */
+static void buildStation() {
+    stationReadings(station);
+    for (uint8_t i = 0; i < 6; i++) {
+        SensorReading sht{"", SHT30, NAN, {{20.0f + i}, {55.5f}}};
+        snprintf(sht.sensorId, sizeof(sht.sensorId), "SHT_%u", i);
+        station.push_back(sht);
+    }
+    station.push_back(SensorReading{"ENV4_7", ENV4, NAN, {{61.2f}, {22.4f}, {101.3f}, {15300.0f}}});
+    station.push_back(SensorReading{"LUX", VEML7700, 812.5f, {}});
+}
+
+/**
+ * @brief Despertares repartidos en el presupuesto de un DR
+ */
+static void checkDatarate(uint8_t dr, bool delimited) {
+    const size_t budget = PayloadPlanner::frameBudget(dr);
+    size_t costs[MAX_READINGS];
+    size_t total = 0;
+    const size_t header = delimited
+        ? PayloadFormat::delimitedHeaderSize(System::DEFAULT_DEVICE_ID, System::DEFAULT_STATION_ID,
+                                             station[STATION_BATTERY].value, 1700000000)
+        : PayloadFormat::binaryHeaderSize(station);
+    size_t room = budget > header ? budget - header : 0;
+    for (size_t i = 0; i < station.size(); i++) {
+        costs[i] = delimited ? PayloadFormat::delimitedReadingSize(station[i])
+                             : PayloadFormat::binaryReadingSize(station[i]);
+        if (PayloadPlanner::priority(station[i].type) == ReportPriority::ALWAYS) {
+            room = room > costs[i] ? room - costs[i] : 0;
+        } else {
+            total += costs[i];
+        }
+    }
+    bool placeable = true;
+    for (size_t i = 0; i < station.size(); i++) {
+        placeable &= PayloadPlanner::priority(station[i].type) == ReportPriority::ALWAYS || costs[i] <= room;
+    }
+    // Con un reparto al menos medio lleno el total entra en REPORT_MAX_WAKES despertares
+    const bool feasible = placeable &&
+        2 * total <= (size_t)room * LoRa::MAX_FRAMES_PER_WAKE * LoRa::REPORT_MAX_WAKES;
+
+    PayloadPlanner::reset();
+    uint8_t maxGap = 0;
+    for (uint32_t w = 0; w < 4u * LoRa::REPORT_MAX_WAKES; w++) {
+        uint32_t masks[LoRa::MAX_FRAMES_PER_WAKE];
+        const uint8_t frames = PayloadPlanner::plan(station, costs, header, budget,
+                                                    LoRa::MAX_FRAMES_PER_WAKE, masks);
+        uint32_t sent = 0;
+        for (uint8_t f = 0; f < frames; f++) {
+            uint8_t frame[LoRa::MAX_PAYLOAD + 1];
+            const size_t size = delimited
+                ? PayloadFormat::delimited(station, System::DEFAULT_DEVICE_ID, System::DEFAULT_STATION_ID,
+                                           station[STATION_BATTERY].value, 1700000000, (char*)frame,
+                                           budget + 1, masks[f])
+                : PayloadFormat::binary(station, 1700000000, frame, budget, masks[f]);
+            TEST_ASSERT_GREATER_THAN(0, size);
+            TEST_ASSERT_LESS_OR_EQUAL(budget, size);
+            sent |= masks[f];
+        }
+        PayloadPlanner::commit(station, sent);
+        for (size_t i = 0; i < station.size(); i++) {
+            const uint8_t gap = PayloadPlanner::wakesSinceReported(i) + 1;
+            maxGap = gap > maxGap ? gap : maxGap;
+        }
+    }
+    if (feasible) {
+        TEST_ASSERT_LESS_OR_EQUAL(LoRa::REPORT_MAX_WAKES, maxGap);
+    }
+
+    // El anuncio de esquema, partido si hace falta, también respeta el presupuesto
+    size_t first = 0;
+    while (first < station.size()) {
+        char part[LoRa::MAX_PAYLOAD + 1];
+        size_t next = first;
+        const size_t size = PayloadFormat::schemaAnnouncement(
+            station, System::DEFAULT_DEVICE_ID, System::DEFAULT_STATION_ID, part, budget + 1, first, &next);
+        if (size == 0) {
+            break;
+        }
+        TEST_ASSERT_LESS_OR_EQUAL(budget, size);
+        TEST_ASSERT_GREATER_THAN(first, next);
+        first = next;
+    }
+}
+
+void setUp() {
+    buildStation();
+    PayloadPlanner::reset();
+}
+
+void tearDown() {
+    PayloadPlanner::reset();
+}
+
+void test_binary_fits_each_datarate() {
+    for (uint8_t dr = 0; dr <= 3; dr++) {
+        checkDatarate(dr, false);
+    }
+}
+
+void test_delimited_fits_each_datarate() {
+    for (uint8_t dr = 0; dr <= 3; dr++) {
+        checkDatarate(dr, true);
+    }
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_fits_each_datarate);
+    RUN_TEST(test_delimited_fits_each_datarate);
+    return UNITY_END();
+}
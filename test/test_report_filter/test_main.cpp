@@ -0,0 +1,107 @@
+/*******************************************************************************************
+ * Archivo: test/test_report_filter/test_main.cpp
+ * Descripción: Report-by-exception (ReportFilter) sobre una secuencia de despertares:
+ * cambios dentro de la banda muerta no transmiten; un cambio fuera de ella, un canal que
+ * pasa a NaN, un cambio de esquema o el latido sí. Una lectura que PayloadPlanner dejó
+ * fuera de los frames no cuenta como enviada.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include "PayloadFormat.h"
+#include "ReportFilter.h"
+#include "station_fixture.h"
+
+static ReadingSet wake;
+
+/**
+ * @brief Un despertar: devuelve la decisión y hace lo que haría main
+ */
+static bool step() {
+    const bool send = ReportFilter::shouldSend(wake);
+    if (send) {
+        ReportFilter::markSent(wake, PayloadFormat::ALL_READINGS);
+    } else {
+        ReportFilter::markSkipped();
+    }
+    return send;
+}
+
+void setUp() {
+    ReportFilter::reset();
+    stationReadings(wake);
+    // Primer despertar: sin valores transmitidos se envía siempre
+    TEST_ASSERT_TRUE(step());
+}
+
+void tearDown() {
+    ReportFilter::reset();
+}
+
+void test_unchanged_wake_is_skipped() {
+    TEST_ASSERT_FALSE(step());
+}
+
+void test_changes_inside_deadband_are_skipped() {
+    wake[STATION_NTC].value += 0.1f;                         // Dentro de 0.2 °C
+    TEST_ASSERT_FALSE(step());
+    wake[STATION_MT05].subValues[2].value *= 1.01f;          // Conductividad dentro del 2 %
+    TEST_ASSERT_FALSE(step());
+}
+
+void test_change_outside_deadband_is_sent() {
+    wake[STATION_PH].value += 0.1f;                          // Fuera de 0.05
+    TEST_ASSERT_TRUE(step());
+    TEST_ASSERT_FALSE(step());
+}
+
+void test_heartbeat_is_sent() {
+    for (uint16_t i = 0; i + 1 < LoRa::REPORT_HEARTBEAT_CYCLES; i++) {
+        TEST_ASSERT_FALSE(step());
+    }
+    TEST_ASSERT_TRUE(step());
+}
+
+void test_channel_turning_nan_is_sent() {
+    wake[STATION_BATTERY].value = NAN;
+    TEST_ASSERT_TRUE(step());
+    TEST_ASSERT_FALSE(step());
+}
+
+void test_schema_change_is_sent() {
+    wake.resize(wake.size() - 1);
+    TEST_ASSERT_TRUE(step());
+}
+
+void test_reading_left_out_of_frames_is_not_marked_sent() {
+    wake[STATION_PH].value += 0.1f;
+    wake[STATION_NTC].value += 1.0f;
+    TEST_ASSERT_TRUE(ReportFilter::shouldSend(wake));
+    // Solo el pH cupo en los frames de este despertar
+    ReportFilter::markSent(wake, 1UL << STATION_PH);
+    TEST_ASSERT_TRUE(step());
+    TEST_ASSERT_FALSE(step());
+}
+
+void test_schema_change_with_partial_uplink_keeps_pending_channels() {
+    wake.resize(wake.size() - 1);
+    TEST_ASSERT_TRUE(ReportFilter::shouldSend(wake));
+    ReportFilter::markSent(wake, 1UL << STATION_PH);
+    // Los canales que no salieron no tienen referencia en el esquema nuevo
+    TEST_ASSERT_TRUE(step());
+    TEST_ASSERT_FALSE(step());
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_unchanged_wake_is_skipped);
+    RUN_TEST(test_changes_inside_deadband_are_skipped);
+    RUN_TEST(test_change_outside_deadband_is_sent);
+    RUN_TEST(test_heartbeat_is_sent);
+    RUN_TEST(test_channel_turning_nan_is_sent);
+    RUN_TEST(test_schema_change_is_sent);
+    RUN_TEST(test_reading_left_out_of_frames_is_not_marked_sent);
+    RUN_TEST(test_schema_change_with_partial_uplink_keeps_pending_channels);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************************
+ * Archivo: test/test_session_store/test_main.cpp
+ * Descripción: Copia de la sesión LoRaWAN en flash (SessionStore) a lo largo de cien
+ * uplinks con un búfer de sesión simulado: las escrituras deben seguir el intervalo y
+ * rotar por todas las ranuras, y al corromper la más reciente la restauración debe volver
+ * a la anterior, con FCntUp adelantado y la firma de RadioLib corregida.
+ *******************************************************************************************/
+
+#include <unity.h>
+#include <stdio.h>
+#include <string.h>
+#include "SessionStore.h"
+#include "hal/Hal.h"
+#include "hal/HalSim.h"
+
+static const uint16_t SIM_SESSION_SIZE = 256;
+static const uint16_t SIM_SESSION_FCNT_UP = 0x34;
+static const uint32_t UPLINKS = 100;
+static const uint32_t EXPECTED_WRITES = UPLINKS / LoRa::SESSION_SAVE_INTERVAL + 1;
+static const uint32_t LAST_SAVED = (UPLINKS / LoRa::SESSION_SAVE_INTERVAL) * LoRa::SESSION_SAVE_INTERVAL;
+
+static uint8_t session[SIM_SESSION_SIZE];
+
+/**
+ * @brief Firma de RadioLib: XOR de palabras big-endian, guardada en little-endian
+ */
+static uint16_t simSessionSignature(const uint8_t* data) {
+    uint16_t signature = 0;
+    for (uint16_t i = 0; i < SIM_SESSION_SIZE - 2; i += 2) {
+        signature ^= (uint16_t)((data[i] << 8) | data[i + 1]);
+    }
+    return signature;
+}
+
+static void simSessionSetFCntUp(uint8_t* data, uint32_t fcntUp) {
+    for (uint8_t i = 0; i < 4; i++) {
+        data[SIM_SESSION_FCNT_UP + i] = (uint8_t)(fcntUp >> (8 * i));
+    }
+    const uint16_t signature = simSessionSignature(data);
+    data[SIM_SESSION_SIZE - 2] = (uint8_t)signature;
+    data[SIM_SESSION_SIZE - 1] = (uint8_t)(signature >> 8);
+}
+
+static uint32_t simSessionFCntUp(const uint8_t* data) {
+    uint32_t fcntUp = 0;
+    for (uint8_t i = 0; i < 4; i++) {
+        fcntUp |= (uint32_t)data[SIM_SESSION_FCNT_UP + i] << (8 * i);
+    }
+    return fcntUp;
+}
+
+/**
+ * @brief Cien uplinks con sus checkpoints
+ * @return Escrituras en flash
+ */
+static uint32_t runUplinks() {
+    const uint32_t writesBefore = SessionStore::writes();
+    for (uint32_t fcntUp = 0; fcntUp <= UPLINKS; fcntUp++) {
+        if (SessionStore::isDue(fcntUp)) {
+            simSessionSetFCntUp(session, fcntUp);
+            SessionStore::save(session, SIM_SESSION_SIZE, fcntUp);
+        }
+    }
+    return SessionStore::writes() - writesBefore;
+}
+
+void setUp() {
+    HalSim::reset();
+    SessionStore::clear();
+    for (uint16_t i = 0; i < SIM_SESSION_SIZE; i++) {
+        session[i] = (uint8_t)(i * 37 + 11);
+    }
+}
+
+void tearDown() {
+    SessionStore::clear();
+}
+
+void test_checkpoints_follow_interval_and_rotate() {
+    TEST_ASSERT_EQUAL_UINT32(EXPECTED_WRITES, runUplinks());
+
+    uint8_t slotsUsed = 0;
+    uint8_t image[sizeof(SessionSlotHeader) + LoRa::SESSION_MAX_SIZE];
+    char key[8];
+    for (uint8_t i = 0; i < LoRa::SESSION_SLOTS; i++) {
+        snprintf(key, sizeof(key), "slot%u", i);
+        slotsUsed += HalNvs::getBytes(JsonKeys::NS_LORA_SESSION, key, image, sizeof(image)) > 0;
+    }
+    TEST_ASSERT_EQUAL_UINT8(EXPECTED_WRITES < LoRa::SESSION_SLOTS ? EXPECTED_WRITES : LoRa::SESSION_SLOTS,
+                            slotsUsed);
+
+    uint8_t restored[SIM_SESSION_SIZE];
+    uint16_t length = 0;
+    uint32_t savedFCntUp = 0;
+    TEST_ASSERT_TRUE(SessionStore::load(restored, sizeof(restored), length, savedFCntUp));
+    TEST_ASSERT_EQUAL_UINT16(SIM_SESSION_SIZE, length);
+    TEST_ASSERT_EQUAL_UINT32(LAST_SAVED, savedFCntUp);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(session, restored, SIM_SESSION_SIZE);
+}
+
+void test_torn_slot_restores_previous_with_counter_gap() {
+    runUplinks();
+
+    // Escritura cortada en la ranura más reciente: gana la anterior
+    uint8_t image[sizeof(SessionSlotHeader) + LoRa::SESSION_MAX_SIZE];
+    char key[8];
+    snprintf(key, sizeof(key), "slot%u", (unsigned)((EXPECTED_WRITES - 1) % LoRa::SESSION_SLOTS));
+    const size_t size = HalNvs::getBytes(JsonKeys::NS_LORA_SESSION, key, image, sizeof(image));
+    TEST_ASSERT_GREATER_THAN(0, size);
+    image[size - 1] ^= 0x5A;
+    HalNvs::putBytes(JsonKeys::NS_LORA_SESSION, key, image, size);
+
+    uint8_t restored[SIM_SESSION_SIZE];
+    uint16_t length = 0;
+    uint32_t savedFCntUp = 0;
+    TEST_ASSERT_TRUE(SessionStore::load(restored, sizeof(restored), length, savedFCntUp));
+    TEST_ASSERT_EQUAL_UINT32(LAST_SAVED - LoRa::SESSION_SAVE_INTERVAL, savedFCntUp);
+
+    // Salto de contador con la firma corregida; un FCntUp distinto del guardado se rechaza
+    const uint32_t gap = SessionStore::counterGap();
+    TEST_ASSERT_FALSE(SessionStore::advanceFCntUp(restored, length, SIM_SESSION_FCNT_UP, savedFCntUp + 1, gap));
+    TEST_ASSERT_TRUE(SessionStore::advanceFCntUp(restored, length, SIM_SESSION_FCNT_UP, savedFCntUp, gap));
+    TEST_ASSERT_EQUAL_UINT32(savedFCntUp + gap, simSessionFCntUp(restored));
+    TEST_ASSERT_EQUAL_UINT16(simSessionSignature(restored),
+                             (uint16_t)(restored[SIM_SESSION_SIZE - 2] | (restored[SIM_SESSION_SIZE - 1] << 8)));
+    TEST_ASSERT_GREATER_THAN(UPLINKS, savedFCntUp + gap);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    UNITY_BEGIN();
+    RUN_TEST(test_checkpoints_follow_interval_and_rotate);
+    RUN_TEST(test_torn_slot_restores_previous_with_counter_gap);
+    return UNITY_END();
+}
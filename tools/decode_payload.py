@@ -0,0 +1,367 @@
+#!/usr/bin/env python3
+"""
+Decodificador de los payloads de uplink (lado servidor / host).
+
+Formatos (ver include/PayloadFormat.h):
+  - fPort 1: texto delimitado "st|dev|bat|ts|id,tipo,v1,v2...|..."
+  - fPort 2: binario v1 con schemaId, bitmap de ausentes y valores en punto fijo
+  - fPort 3: anuncio de esquema "S|schemaId|st|dev|id,tipo,canales|...", y sus
+             continuaciones "S+|schemaId|primer sensor|id,tipo,canales|..." en DR bajos
+  - fPort 4: lote binario v1 [ver][schemaId][tsBase][n] + n x [desfase u16][bitmap][valores]
+  - fPort 5: keyframe [ver][schemaId][ts][secuencia][bitmap][valores]
+  - fPort 6: delta [secuencia << 5 | frame][varint segundos][varint zigzag por canal]
+
+Uso:
+  decode_payload.py --schema "S|1A2B|ST001|DEV02|NTC3,1,1|..." --hex 011a2b...
+  decode_payload.py --schema "S|1A2B|..." --batch-hex 011a2b...
+  decode_payload.py --delimited "ST001|DEV02|3.8|1700000000|NTC3,1,25"
+  decode_payload.py --stream uplinks.txt
+
+Los anuncios de esquema se pueden guardar con --schema-file (un anuncio por línea).
+Los deltas dependen de su keyframe, así que se decodifican en secuencia con --stream:
+un uplink por línea, "fPort payload" (texto para los puertos 1 y 3, hex para el resto).
+La salida marca los frames perdidos ("gap") y los deltas sin su keyframe.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+BINARY_VERSION = 1
+FPORT_DELIMITED, FPORT_BINARY, FPORT_SCHEMA, FPORT_BATCH, FPORT_KEYFRAME, FPORT_DELTA = 1, 2, 3, 4, 5, 6
+SEQUENCE_MASK = 0x07
+
+# Tipos de sensor (include/sensor_types.h)
+N100K, N10K, HDS10, RTD, DS18B20, PH, COND, SOILH, VEML7700, BATTERY = range(10)
+SHT30, BME680, CO2, BME280, SHT40, MT05S = 100, 101, 102, 103, 104, 105
+ENV4, MODBUS_GENERIC = 110, 111
+
+I16, I32, F32 = "i16", "i32", "f32"
+TEMP = (I16, 100.0)
+PERCENT = (I16, 100.0)
+WIDE = (I32, 100.0)
+COUNTS = (I32, 1.0)
+
+
+def channel_encoding(sensor_type, channel):
+    """Espejo de PayloadFormat::channelEncoding()."""
+    if sensor_type in (N100K, N10K, RTD, DS18B20):
+        return TEMP
+    if sensor_type in (HDS10, SOILH):
+        return PERCENT
+    if sensor_type in (PH, BATTERY):
+        return (I16, 1000.0)
+    if sensor_type in (COND, VEML7700):
+        return WIDE
+    if sensor_type in (SHT30, SHT40):
+        return TEMP if channel == 0 else PERCENT
+    if sensor_type == BME280:
+        return WIDE if channel == 2 else (TEMP if channel == 0 else PERCENT)
+    if sensor_type == BME680:
+        return WIDE if channel >= 2 else (TEMP if channel == 0 else PERCENT)
+    if sensor_type == CO2:
+        return COUNTS if channel == 0 else (TEMP if channel == 1 else PERCENT)
+    if sensor_type == MT05S:
+        return COUNTS if channel == 2 else (TEMP if channel == 0 else PERCENT)
+    if sensor_type == ENV4:
+        return [PERCENT, TEMP, WIDE, COUNTS][min(channel, 3)]
+    return (F32, 1.0)
+
+
+def parse_sensors(items):
+    sensors = []
+    for item in items:
+        sensor_id, sensor_type, channels = item.split(",")
+        sensors.append({"id": sensor_id, "type": int(sensor_type), "channels": int(channels)})
+    return sensors
+
+
+def parse_schema(text):
+    parts = text.strip().split("|")
+    if len(parts) < 4 or parts[0] != "S":
+        raise ValueError("anuncio de esquema inválido: %r" % text)
+    return int(parts[1], 16), {"station": parts[2], "device": parts[3], "sensors": parse_sensors(parts[4:])}
+
+
+def add_schema(schemas, text):
+    """Registra un anuncio de esquema o agrega una continuación al anuncio ya recibido."""
+    parts = text.strip().split("|")
+    if parts[0] != "S+":
+        schema_id, schema = parse_schema(text)
+        schemas[schema_id] = schema
+        return
+    if len(parts) < 3:
+        raise ValueError("continuación de esquema inválida: %r" % text)
+    schema_id, first = int(parts[1], 16), int(parts[2])
+    schema = lookup_schema(schema_id, schemas)
+    if len(schema["sensors"]) != first:
+        raise ValueError("continuación del esquema %04X desde el sensor %d, se esperaba el %d"
+                         % (schema_id, first, len(schema["sensors"])))
+    schema["sensors"].extend(parse_sensors(parts[3:]))
+
+
+def lookup_schema(schema_id, schemas):
+    if schema_id not in schemas:
+        raise KeyError("esquema %04X desconocido; falta su anuncio (fPort 3)" % schema_id)
+    return schemas[schema_id]
+
+
+def decode_raw(data, offset, schema):
+    """Lee bitmap + valores en punto fijo (F32 como sus bits en int32, None si ausente).
+    Devuelve (lista plana por canal, offset final)."""
+    channels = sum(s["channels"] for s in schema["sensors"])
+    bitmap_size = (channels + 7) // 8
+    bitmap = data[offset:offset + bitmap_size]
+    offset += bitmap_size
+
+    raws = []
+    for sensor_type, ch in schema_channels(schema):
+        bit = len(raws)
+        if not bitmap[bit // 8] & (1 << (bit % 8)):
+            raws.append(None)
+            continue
+        encoding = channel_encoding(sensor_type, ch)[0]
+        fmt = ">h" if encoding == I16 else ">i"
+        (raw,) = struct.unpack_from(fmt, data, offset)
+        offset += struct.calcsize(fmt)
+        raws.append(raw)
+    return raws, offset
+
+
+def schema_channels(schema):
+    """(tipo, canal) de cada canal del esquema, en el orden del payload."""
+    return [(s["type"], ch) for s in schema["sensors"] for ch in range(s["channels"])]
+
+
+def raw_to_readings(raws, schema):
+    """Convierte los valores en punto fijo de decode_raw() a lecturas por sensor."""
+    values = iter(raws)
+    readings = []
+    for sensor in schema["sensors"]:
+        sensor_values = []
+        for ch in range(sensor["channels"]):
+            raw = next(values)
+            encoding, scale = channel_encoding(sensor["type"], ch)
+            if raw is None:
+                sensor_values.append(None)
+            elif encoding == F32:
+                (value,) = struct.unpack(">f", struct.pack(">i", raw))
+                sensor_values.append(value)
+            else:
+                sensor_values.append(raw / scale)
+        readings.append({"id": sensor["id"], "type": sensor["type"], "values": sensor_values})
+    return readings
+
+
+def decode_record(data, offset, schema):
+    """Decodifica bitmap + valores a partir de offset. Devuelve (lecturas, offset final)."""
+    raws, offset = decode_raw(data, offset, schema)
+    return raw_to_readings(raws, schema), offset
+
+
+def decode_binary(data, schemas):
+    if len(data) < 7:
+        raise ValueError("payload binario demasiado corto")
+    version, schema_id, timestamp = struct.unpack(">BHI", data[:7])
+    if version != BINARY_VERSION:
+        raise ValueError("versión de payload no soportada: %d" % version)
+    schema = lookup_schema(schema_id, schemas)
+    readings, _ = decode_record(data, 7, schema)
+
+    return {
+        "station": schema["station"],
+        "device": schema["device"],
+        "timestamp": timestamp,
+        "schema": "%04X" % schema_id,
+        "readings": readings,
+    }
+
+
+def decode_batch(data, schemas):
+    if len(data) < 8:
+        raise ValueError("lote demasiado corto")
+    version, schema_id, base_timestamp, count = struct.unpack(">BHIB", data[:8])
+    if version != BINARY_VERSION:
+        raise ValueError("versión de lote no soportada: %d" % version)
+    schema = lookup_schema(schema_id, schemas)
+
+    records = []
+    offset = 8
+    for _ in range(count):
+        (delta,) = struct.unpack_from(">H", data, offset)
+        readings, offset = decode_record(data, offset + 2, schema)
+        records.append({"timestamp": base_timestamp + delta, "readings": readings})
+
+    return {
+        "station": schema["station"],
+        "device": schema["device"],
+        "schema": "%04X" % schema_id,
+        "records": records,
+    }
+
+
+def read_varint(data, offset):
+    value = shift = 0
+    while True:
+        byte = data[offset]
+        offset += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if not byte & 0x80:
+            return value, offset
+
+
+def zigzag_decode(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def to_int32(value):
+    value &= 0xFFFFFFFF
+    return value - (1 << 32) if value & 0x80000000 else value
+
+
+def decode_keyframe(data, schemas):
+    """Decodifica un keyframe. Devuelve (resultado, estado de referencia para los deltas)."""
+    if len(data) < 8:
+        raise ValueError("keyframe demasiado corto")
+    version, schema_id, timestamp, sequence = struct.unpack(">BHIB", data[:8])
+    if version != BINARY_VERSION:
+        raise ValueError("versión de keyframe no soportada: %d" % version)
+    schema = lookup_schema(schema_id, schemas)
+    raws, _ = decode_raw(data, 8, schema)
+    reference = {"schema": schema, "schema_id": schema_id, "timestamp": timestamp,
+                 "sequence": sequence, "raws": raws, "frame": 0}
+    return {
+        "station": schema["station"],
+        "device": schema["device"],
+        "timestamp": timestamp,
+        "schema": "%04X" % schema_id,
+        "keyframe": sequence,
+        "readings": raw_to_readings(raws, schema),
+    }, reference
+
+
+def decode_delta(data, reference):
+    """Reconstruye los valores absolutos de un delta a partir de su keyframe."""
+    if len(data) < 2:
+        raise ValueError("delta demasiado corto")
+    sequence, frame = data[0] >> 5, data[0] & 0x1F
+    if reference is None or reference["sequence"] != sequence:
+        raise KeyError("delta del keyframe %d, que no se recibió" % sequence)
+    offset, raws = 1, []
+    seconds, offset = read_varint(data, offset)
+    for ref in reference["raws"]:
+        if ref is None:
+            raws.append(None)
+            continue
+        delta, offset = read_varint(data, offset)
+        raws.append(to_int32(ref + zigzag_decode(delta)))
+    schema = reference["schema"]
+    return {
+        "station": schema["station"],
+        "device": schema["device"],
+        "timestamp": reference["timestamp"] + seconds,
+        "schema": "%04X" % reference["schema_id"],
+        "keyframe": sequence,
+        "frame": frame,
+        "readings": raw_to_readings(raws, schema),
+    }
+
+
+def decode_stream(lines, schemas):
+    """Decodifica uplinks en orden de llegada, con el estado de keyframe entre ellos."""
+    results = []
+    reference = None
+    for line in lines:
+        if not line.strip():
+            continue
+        port_text, payload = line.strip().split(None, 1)
+        port = int(port_text)
+        try:
+            if port == FPORT_SCHEMA:
+                add_schema(schemas, payload)
+                continue
+            if port == FPORT_DELIMITED:
+                results.append(decode_delimited(payload))
+            elif port == FPORT_BINARY:
+                results.append(decode_binary(bytes.fromhex(payload), schemas))
+            elif port == FPORT_BATCH:
+                results.append(decode_batch(bytes.fromhex(payload), schemas))
+            elif port == FPORT_KEYFRAME:
+                result, new_reference = decode_keyframe(bytes.fromhex(payload), schemas)
+                if reference is not None and result["keyframe"] != (reference["sequence"] + 1) & SEQUENCE_MASK:
+                    results.append({"gap": "keyframe %d tras %d (keyframes perdidos o reinicio del nodo)"
+                                           % (result["keyframe"], reference["sequence"])})
+                reference = new_reference
+                results.append(result)
+            elif port == FPORT_DELTA:
+                result = decode_delta(bytes.fromhex(payload), reference)
+                lost = result["frame"] - reference["frame"] - 1
+                if lost > 0:
+                    results.append({"gap": "%d frame(s) perdidos antes del frame %d del keyframe %d"
+                                           % (lost, result["frame"], result["keyframe"])})
+                reference["frame"] = result["frame"]
+                results.append(result)
+            else:
+                raise ValueError("fPort desconocido: %d" % port)
+        except (KeyError, ValueError, IndexError, struct.error) as error:
+            results.append({"error": error.args[0] if error.args else str(error), "fport": port})
+    return results
+
+
+def decode_delimited(text):
+    parts = text.strip().split("|")
+    readings = []
+    for item in parts[4:]:
+        fields = item.split(",")
+        values = [None if v.lower() == "nan" else float(v) for v in fields[2:]]
+        readings.append({"id": fields[0], "type": int(fields[1]), "values": values})
+    battery = None if parts[2].lower() == "nan" else float(parts[2])
+    return {
+        "station": parts[0],
+        "device": parts[1],
+        "battery": battery,
+        "timestamp": int(parts[3]),
+        "readings": readings,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--schema", action="append", default=[], help="anuncio de esquema (fPort 3)")
+    parser.add_argument("--schema-file", help="archivo con un anuncio de esquema por línea")
+    parser.add_argument("--hex", help="payload binario en hexadecimal (fPort 2)")
+    parser.add_argument("--batch-hex", help="lote binario en hexadecimal (fPort 4)")
+    parser.add_argument("--delimited", help="payload de texto delimitado (fPort 1)")
+    parser.add_argument("--stream", help="archivo con un uplink \"fPort payload\" por línea")
+    args = parser.parse_args()
+
+    announcements = list(args.schema)
+    if args.schema_file:
+        with open(args.schema_file) as f:
+            announcements.extend(line for line in f if line.strip())
+    schemas = {}
+    for announcement in announcements:
+        add_schema(schemas, announcement)
+
+    if args.hex:
+        result = decode_binary(bytes.fromhex(args.hex), schemas)
+    elif args.batch_hex:
+        result = decode_batch(bytes.fromhex(args.batch_hex), schemas)
+    elif args.delimited:
+        result = decode_delimited(args.delimited)
+    elif args.stream:
+        with open(args.stream) as f:
+            result = decode_stream(f, schemas)
+    else:
+        parser.error("indique --hex, --batch-hex, --delimited o --stream")
+        return 2
+
+    json.dump(result, sys.stdout, indent=2, ensure_ascii=False)
+    print()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+"""
+Esclavos Modbus RTU simulados sobre un pseudo-terminal (lado host).
+
+Abre un pty, imprime la ruta del extremo esclavo y responde a las lecturas de registros
+holding (0x03) e input (0x04) de cualquier dirección de esclavo, con la temporización de
+una línea serie real: cada trama recibida se da por terminada tras T3.5 sin bytes y la
+respuesta sale después de --delay-ms. El registro r del esclavo s vale (s << 12) + r,
+igual que el esclavo en proceso de HalSim::modbusSlave.
+
+Uso:
+  modbus_slave_sim.py --dead 3 --exception 4
+  MODBUS_PTY=/dev/pts/N pio test -e native -f test_modbus_rtu
+
+  --dead N        el esclavo N no responde (timeout y reintentos en el maestro)
+  --exception N   el esclavo N devuelve la excepción 02 desde el registro 100
+"""
+
+import argparse
+import os
+import select
+import sys
+import time
+import tty
+
+EXCEPTION_FROM = 100
+ILLEGAL_DATA_ADDRESS = 0x02
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return bytes([crc & 0xFF, crc >> 8])
+
+
+def respond(frame, args):
+    if len(frame) != 8 or crc16(frame[:6]) != frame[6:]:
+        return None
+    slave, function = frame[0], frame[1]
+    start = (frame[2] << 8) | frame[3]
+    count = (frame[4] << 8) | frame[5]
+    if slave in args.dead:
+        return None
+    if function not in (0x03, 0x04):
+        body = bytes([slave, function | 0x80, 0x01])
+    elif slave in args.exception and start + count > EXCEPTION_FROM:
+        body = bytes([slave, function | 0x80, ILLEGAL_DATA_ADDRESS])
+    else:
+        values = [((slave << 12) + start + i) & 0xFFFF for i in range(count)]
+        body = bytes([slave, function, count * 2]) + b"".join(v.to_bytes(2, "big") for v in values)
+    return body + crc16(body)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--baud", type=int, default=9600, help="velocidad para calcular T3.5")
+    parser.add_argument("--delay-ms", type=float, default=20.0, help="tiempo de respuesta del esclavo")
+    parser.add_argument("--dead", type=int, action="append", default=[], help="esclavo que no responde")
+    parser.add_argument("--exception", type=int, action="append", default=[],
+                        help="esclavo que responde con excepción 02")
+    args = parser.parse_args()
+
+    char_s = 11.0 / args.baud
+    silence_s = 0.00175 if args.baud > 19200 else 3.5 * char_s
+
+    master, slave = os.openpty()
+    tty.setraw(master)
+    tty.setraw(slave)
+    print(os.ttyname(slave), flush=True)
+
+    frame = b""
+    while True:
+        ready, _, _ = select.select([master], [], [], silence_s if frame else None)
+        if ready:
+            frame += os.read(master, 256)
+            continue
+        response = respond(frame, args)
+        print("<- %s%s" % (frame.hex(), "" if response else "  (sin respuesta)"), file=sys.stderr)
+        frame = b""
+        if response:
+            time.sleep(args.delay_ms / 1000.0)
+            os.write(master, response)
+            print("-> %s" % response.hex(), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except KeyboardInterrupt:
+        pass
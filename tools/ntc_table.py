@@ -0,0 +1,140 @@
+#!/usr/bin/env python3
+"""
+Generador de la tabla voltaje -> temperatura de un NTC (lado host).
+
+Espejo de NtcTable::build() (include/NtcTable.h): resuelve Steinhart-Hart con los tres
+puntos de calibración (coeficientes redondeados a float como CalibrationMath), busca los
+voltajes del divisor a NTC_TEMP_MIN - 1 y NTC_TEMP_MAX + 1 °C y muestrea la curva en
+NTC_LUT_SEGMENTS + 1 puntos equiespaciados, en °C x100.
+
+Uso:
+  ntc_table.py 25 10000 35 6477 45 4253 --vref-mv 3000 --r-fixed 10000
+  ntc_table.py 25 10000 35 6477 45 4253 --vref-mv 3300 --r-fixed 10000 --bottom --c-array
+  ntc_table.py 25 10000 35 6477 45 4253 --voltage-mv 1500
+"""
+
+import argparse
+import json
+import math
+import struct
+import sys
+
+# include/config.h
+NTC_LUT_SEGMENTS = 128
+NTC_TEMP_MIN = -20.0
+NTC_TEMP_MAX = 100.0
+TABLE_MARGIN_C = 1.0
+NO_POINT = -32768
+
+
+def to_float32(value):
+    return struct.unpack("<f", struct.pack("<f", value))[0]
+
+
+def solve_steinhart_hart(points):
+    """Espejo de CalibrationMath::solveSteinhartHart (resultado redondeado a float)."""
+    (t1, r1), (t2, r2), (t3, r3) = [(t + 273.15, r) for t, r in points]
+    l1, l2, l3 = math.log(r1), math.log(r2), math.log(r3)
+    y1, y2, y3 = 1.0 / t1, 1.0 / t2, 1.0 / t3
+    c = ((y2 - y1) * (l3 - l1) - (y3 - y1) * (l2 - l1)) / \
+        ((l2 ** 3 - l1 ** 3) * (l3 - l1) - (l3 ** 3 - l1 ** 3) * (l2 - l1))
+    b = ((y2 - y1) - c * (l2 ** 3 - l1 ** 3)) / (l2 - l1)
+    a = y1 - b * l1 - c * l1 ** 3
+    return to_float32(a), to_float32(b), to_float32(c)
+
+
+def temperature_at(voltage, vref, r_fixed, ntc_top, coeffs):
+    if voltage <= 0.0 or voltage >= vref:
+        return float("nan")
+    if ntc_top:
+        resistance = r_fixed * ((vref - voltage) / voltage)
+    else:
+        resistance = r_fixed * (voltage / (vref - voltage))
+    if resistance <= 0.0:
+        return float("nan")
+    ln_r = math.log(resistance)
+    a, b, c = coeffs
+    return 1.0 / (a + b * ln_r + c * ln_r ** 3) - 273.15
+
+
+def voltage_at(temp_c, vref, r_fixed, ntc_top, coeffs):
+    low, high = vref * 1e-6, vref * (1.0 - 1e-6)
+    rising = temperature_at(high, vref, r_fixed, ntc_top, coeffs) > \
+        temperature_at(low, vref, r_fixed, ntc_top, coeffs)
+    for _ in range(60):
+        mid = (low + high) / 2.0
+        if (temperature_at(mid, vref, r_fixed, ntc_top, coeffs) < temp_c) == rising:
+            low = mid
+        else:
+            high = mid
+    return (low + high) / 2.0
+
+
+def build(coeffs, vref_mv, r_fixed, ntc_top):
+    vref = vref_mv / 1000.0
+    start = voltage_at(NTC_TEMP_MIN - TABLE_MARGIN_C, vref, r_fixed, ntc_top, coeffs)
+    end = voltage_at(NTC_TEMP_MAX + TABLE_MARGIN_C, vref, r_fixed, ntc_top, coeffs)
+    start, end = min(start, end), max(start, end)
+    start_uv = int(round(start * 1e6))
+    span_uv = int(round(end * 1e6)) - start_uv
+    step_scale = int(round(NTC_LUT_SEGMENTS * 2 ** 32 / span_uv)) if span_uv > 0 else 0
+
+    points = []
+    for i in range(NTC_LUT_SEGMENTS + 1):
+        voltage = (start_uv + span_uv * i / NTC_LUT_SEGMENTS) / 1e6
+        temp_c = temperature_at(voltage, vref, r_fixed, ntc_top, coeffs)
+        c100 = NO_POINT if math.isnan(temp_c) else round(temp_c * 100.0)
+        points.append(c100 if NO_POINT < c100 <= 32767 else NO_POINT)
+    return {"start_uv": start_uv, "step_scale": step_scale, "c100": points}
+
+
+def lookup(table, micro_volts):
+    """Espejo de NtcTable::temperatureC100(). Devuelve °C o None."""
+    if micro_volts < table["start_uv"]:
+        return None
+    position = (micro_volts - table["start_uv"]) * table["step_scale"]
+    index = position >> 32
+    if index >= NTC_LUT_SEGMENTS:
+        return None
+    low, high = table["c100"][index], table["c100"][index + 1]
+    if NO_POINT in (low, high):
+        return None
+    fraction = (position >> 16) & 0xFFFF
+    return (low + (((high - low) * fraction) >> 16)) / 100.0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("points", type=float, nargs=6, metavar="T/R",
+                        help="t1 r1 t2 r2 t3 r3 (°C, ohms)")
+    parser.add_argument("--vref-mv", type=int, default=3000, help="Vref del divisor en mV")
+    parser.add_argument("--r-fixed", type=int, default=10000, help="resistencia fija en ohms")
+    parser.add_argument("--bottom", action="store_true", help="NTC entre el punto de medida y GND")
+    parser.add_argument("--c-array", action="store_true", help="imprime la tabla como array C")
+    parser.add_argument("--voltage-mv", type=float, help="evalúa la tabla en este voltaje")
+    args = parser.parse_args()
+
+    p = args.points
+    coeffs = solve_steinhart_hart([(p[0], p[1]), (p[2], p[3]), (p[4], p[5])])
+    table = build(coeffs, args.vref_mv, args.r_fixed, not args.bottom)
+
+    if args.voltage_mv is not None:
+        micro_volts = int(round(args.voltage_mv * 1000))
+        reference = temperature_at(micro_volts / 1e6, args.vref_mv / 1000.0, args.r_fixed,
+                                   not args.bottom, coeffs)
+        json.dump({"table": lookup(table, micro_volts), "steinhart_hart": reference}, sys.stdout)
+        print()
+    elif args.c_array:
+        print("// startMicroVolts = %d, stepScale = %d" % (table["start_uv"], table["step_scale"]))
+        print("const int16_t c100[%d] = {" % (NTC_LUT_SEGMENTS + 1))
+        for i in range(0, len(table["c100"]), 12):
+            print("    " + ", ".join(str(v) for v in table["c100"][i:i + 12]) + ",")
+        print("};")
+    else:
+        json.dump({"coeffs": coeffs, **table}, sys.stdout, indent=2)
+        print()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())